@@ -17,6 +17,7 @@
 #include <map>
 #include <memory>
 #include "MyDB_Page.h"
+#include "MyDB_PageCompressor.h"
 #include "MyDB_PageHandle.h"
 #include "MyDB_Table.h"
 #include "PageCompare.h"
@@ -55,9 +56,16 @@ public:
 	// gets a temporary page, like getPage (), except that this one is pinned
 	MyDB_PageHandle getPinnedPage ();
 
+	// pins the page referred to by an existing handle, and returns a new handle to it;
+	// like any other pinned page, it is unpinned once all of its handles are gone
+	MyDB_PageHandle getPinnedPage (MyDB_PageHandle samePage);
+
 	// un-pins the specified page
 	void unpin (MyDB_PagePtr unpinMe);
 
+	// true if the page is pinned: its bytes are in RAM, and it is not in the LRU list
+	bool isPinned (MyDB_PagePtr checkMe);
+
 	// creates an LRU buffer manager... params are as follows:
 	// 1) the size of each page is pageSize 
 	// 2) the number of pages managed by the buffer manager is numPages;
@@ -70,6 +78,18 @@ public:
 
 	// returns the page size
 	size_t getPageSize ();
+
+	// returns the number of pages managed by the buffer manager
+	size_t getNumPages ();
+
+	// the pages of a table for which isCompressed () is true are compressed as they are written
+	// out, and are decompressed as they are read back in.  Each page still has its own pageSize
+	// bytes in the file, but only the compressed bytes are written and read, and the rest of
+	// the space is left as a hole in the file.  This returns the number of bytes in the pages
+	// that have been written out, the number of bytes that were written for them, the number
+	// of bytes that have been decompressed, and the number of seconds spent decompressing
+	void getCompressionCounts (size_t &bytesIn, size_t &bytesOut, size_t &bytesDecompressed,
+		double &decompressSeconds);
 	
 private:
 
@@ -103,6 +123,16 @@ private:
 	// the number of buffer pages
 	size_t numPages;
 
+	// used to compress pages, along with a page's worth of space for the compressed bytes
+	MyDB_PageCompressor compressor;
+	vector <char> compressed;
+
+	// the counts returned by getCompressionCounts ()
+	size_t bytesIn;
+	size_t bytesOut;
+	size_t bytesDecompressed;
+	double decompressSeconds;
+
 	// so that the page can access these private methods
 	friend class MyDB_Page;
 	friend class SortMergeJoin;
@@ -116,6 +146,10 @@ private:
 	// removes all traces of the page from the buffer manager
 	void killPage (MyDB_PagePtr killMe);
 
+	// reads the page's bytes from its file, or writes them to the file
+	void readPage (MyDB_PagePtr readMe);
+	void writePage (MyDB_PagePtr writeMe);
+
 };
 
 #endif
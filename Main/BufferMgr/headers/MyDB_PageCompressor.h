@@ -0,0 +1,42 @@
+
+#ifndef PAGE_COMPRESSOR_H
+#define PAGE_COMPRESSOR_H
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+using namespace std;
+
+// This is a small LZ77 codec (it uses the same kind of sequences as LZ4) that is used by the
+// buffer manager to compress the pages of a table as they are written out.  Since the buffer
+// manager does not know what is on a page, the codec just looks for bytes that it has seen
+// before; on a page of records this finds the repeated strings and the runs of zeros, and the
+// parts of numbers that do not change from one record to the next.
+//
+// The compressed bytes are a list of sequences, each of which is a token byte (the high four
+// bits are the number of literal bytes, and the low four bits are the length of the match, less
+// four), more length bytes if either of these is fifteen or more, the literal bytes, and the
+// (two-byte) distance back to the match.  The last sequence only has literal bytes
+class MyDB_PageCompressor {
+
+public:
+
+	MyDB_PageCompressor ();
+
+	// compresses the numBytes bytes at compressMe into intoMe, which has room for maxBytes bytes;
+	// returns the size of the compressed bytes, or zero if they do not fit
+	size_t compress (const char *compressMe, size_t numBytes, char *intoMe, size_t maxBytes);
+
+	// decompresses the numBytes bytes at decompressMe into intoMe, which must end up with exactly
+	// outBytes bytes; returns false if the compressed bytes are not valid
+	bool decompress (const char *decompressMe, size_t numBytes, char *intoMe, size_t outBytes);
+
+private:
+
+	// for each hash of four bytes, the last position where they were seen; the positions are
+	// not cleared from one call to compress () to the next, since a match is always checked
+	vector <uint32_t> lastSeen;
+};
+
+#endif
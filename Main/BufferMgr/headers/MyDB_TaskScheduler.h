@@ -0,0 +1,166 @@
+
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// scratch memory for a task: allocate () just hands out the next bytes in a block, and
+// nothing is freed on its own.  Each thread has one (see MyDB_TaskScheduler :: getScratch ()),
+// and anything that a task allocates from it is given back once the task is done; so this is
+// for memory that is needed only while a task runs, and that would otherwise be malloc'ed and
+// freed over and over
+class MyDB_ScratchArena {
+
+public:
+
+	MyDB_ScratchArena ();
+
+	// returns numBytes bytes, aligned for any type
+	void *allocate (size_t numBytes);
+
+	// gives back all of the memory allocated since getMark () returned mark
+	pair <size_t, size_t> getMark ();
+	void release (pair <size_t, size_t> mark);
+
+private:
+
+	// the blocks, the one being allocated from, and the number of bytes used in it
+	vector <vector <char>> blocks;
+	size_t whichBlock;
+	size_t used;
+};
+
+class MyDB_TaskScheduler;
+class MyDB_TaskGroup;
+typedef shared_ptr <MyDB_TaskGroup> MyDB_TaskGroupPtr;
+
+// a set of tasks that can be waited for (or cancelled) together
+class MyDB_TaskGroup : public enable_shared_from_this <MyDB_TaskGroup> {
+
+public:
+
+	MyDB_TaskGroup (MyDB_TaskScheduler &scheduler);
+
+	// adds a task to the group; it is run by one of the scheduler's workers
+	void submit (function <void ()> task);
+
+	// waits until all of the tasks that have been submitted are done.  If this is called by
+	// one of the scheduler's workers (from inside of a task), then the worker runs other tasks
+	// while it waits, so that a task can submit more tasks and wait for them
+	void join ();
+
+	// tasks in the group that have not started yet are skipped; a long-running task can check
+	// isCancelled () to see if it should stop early
+	void cancel ();
+	bool isCancelled ();
+
+private:
+
+	friend class MyDB_TaskScheduler;
+
+	// called by the scheduler once one of the group's tasks is done (or skipped)
+	void taskDone ();
+
+	MyDB_TaskScheduler &scheduler;
+	atomic <int> pending;
+	atomic <bool> cancelled;
+	mutex lock;
+	condition_variable allDone;
+};
+
+// This is the pool of worker threads that all of the parallel parts of the system share
+// (loading, ANALYZE, the parallel selections), rather than each of them starting up threads
+// of its own.  Work is submitted as tasks in a MyDB_TaskGroup.
+//
+// Each worker has its own deque of tasks: a task submitted from inside of a task goes on the
+// bottom of the worker's own deque, and the worker takes tasks from the bottom, so it works
+// on the newest (and cache-hot) task first.  A worker that runs out of tasks steals from the
+// top of another worker's deque, taking the oldest task there; tasks submitted from outside
+// of the pool are dealt out to the workers' deques in turn
+class MyDB_TaskScheduler {
+
+public:
+
+	// the scheduler that is shared by everything; it starts out with one worker per core
+	static MyDB_TaskScheduler &getScheduler ();
+
+	// the scratch arena for the calling thread
+	static MyDB_ScratchArena &getScratch ();
+
+	// starts up the given number of workers
+	MyDB_TaskScheduler (int numWorkers);
+
+	// stops the workers, once the tasks that they have are done
+	~MyDB_TaskScheduler ();
+
+	// makes a new, empty group of tasks
+	MyDB_TaskGroupPtr makeGroup ();
+
+	// the number of workers; this can only be changed while no tasks are being run
+	int getNumWorkers ();
+	void setNumWorkers (int numWorkers);
+
+	// says, for each worker, the share of the time since the workers were started (or since
+	// resetUtilization () was called) that it spent running tasks, how many tasks it ran, and
+	// how many of those it stole from other workers
+	string getUtilization ();
+	void resetUtilization ();
+
+private:
+
+	friend class MyDB_TaskGroup;
+
+	struct Task {
+		function <void ()> run;
+		MyDB_TaskGroupPtr group;
+	};
+
+	struct Worker {
+		mutex lock;
+		deque <Task> tasks;
+		thread myThread;
+		atomic <long long> busyNanos;
+		atomic <size_t> numRun;
+		atomic <size_t> numStolen;
+	};
+
+	// adds a task to a deque, and wakes up a worker if one is sleeping
+	void submit (Task &addMe);
+
+	// looks for a task for the given worker: first at the bottom of its own deque, and then at
+	// the top of the others
+	bool findTask (int whichWorker, Task &intoMe);
+
+	// runs a task on the calling thread
+	void runTask (int whichWorker, Task &runMe);
+
+	// what each worker does until the scheduler is stopped
+	void work (int whichWorker);
+
+	void start (int numWorkers);
+	void stop ();
+
+	vector <unique_ptr <Worker>> workers;
+
+	// the number of tasks in the deques; a worker sleeps until this is non-zero
+	atomic <long> numQueued;
+	atomic <size_t> nextWorker;
+	mutex sleepLock;
+	condition_variable wakeUp;
+	bool stopping;
+
+	chrono :: steady_clock :: time_point countingSince;
+};
+
+#endif
@@ -13,6 +13,7 @@
 #ifndef BUFFER_MGR_C
 #define BUFFER_MGR_C
 
+#include <chrono>
 #include <fcntl.h>
 #include <iostream>
 #include "MyDB_BufferManager.h"
@@ -24,10 +25,89 @@
 
 using namespace std;
 
+// a compressed page starts with this, followed by the number of compressed bytes; a page that
+// does not get any smaller is written as it is, and it cannot be mistaken for a compressed page,
+// since it starts with its (small) page type
+#define COMPRESSED_PAGE_MAGIC 0x5A4C4442U
+struct CompressedPageHeader {
+	uint32_t magic;
+	uint32_t numBytes;
+};
+
 size_t MyDB_BufferManager :: getPageSize () {
 	return pageSize;
 }
 
+size_t MyDB_BufferManager :: getNumPages () {
+	return numPages;
+}
+
+void MyDB_BufferManager :: getCompressionCounts (size_t &bytesInOut, size_t &bytesOutOut,
+	size_t &bytesDecompressedOut, double &decompressSecondsOut) {
+	bytesInOut = bytesIn;
+	bytesOutOut = bytesOut;
+	bytesDecompressedOut = bytesDecompressed;
+	decompressSecondsOut = decompressSeconds;
+}
+
+void MyDB_BufferManager :: readPage (MyDB_PagePtr readMe) {
+
+	int fd = fds[readMe->myTable];
+	off_t where = readMe->pos * pageSize;
+	if (readMe->myTable != nullptr && readMe->myTable->isCompressed ()) {
+
+		// see if the page was compressed
+		CompressedPageHeader header;
+		if (pread (fd, &header, sizeof (header), where) == sizeof (header) && header.magic == COMPRESSED_PAGE_MAGIC &&
+			header.numBytes <= pageSize - sizeof (header)) {
+
+			pread (fd, compressed.data (), header.numBytes, where + sizeof (header));
+			auto start = chrono :: steady_clock :: now ();
+			if (!compressor.decompress (compressed.data (), header.numBytes, (char *) readMe->bytes, pageSize)) {
+				cout << "Bad: page " << readMe->pos << " of " << readMe->myTable->getName () <<
+					" could not be decompressed.\n";
+				exit (1);
+			}
+			decompressSeconds += chrono :: duration <double> (chrono :: steady_clock :: now () - start).count ();
+			bytesDecompressed += pageSize;
+			return;
+		}
+	}
+
+	lseek (fd, where, SEEK_SET);
+	read (fd, readMe->bytes, pageSize);
+}
+
+void MyDB_BufferManager :: writePage (MyDB_PagePtr writeMe) {
+
+	int fd = fds[writeMe->myTable];
+	off_t where = writeMe->pos * pageSize;
+	if (writeMe->myTable != nullptr && writeMe->myTable->isCompressed ()) {
+
+		bytesIn += pageSize;
+		CompressedPageHeader header;
+		header.magic = COMPRESSED_PAGE_MAGIC;
+		header.numBytes = compressor.compress ((char *) writeMe->bytes, pageSize, compressed.data () + sizeof (header),
+			pageSize - sizeof (header));
+		if (header.numBytes > 0) {
+			memcpy (compressed.data (), &header, sizeof (header));
+			pwrite (fd, compressed.data (), sizeof (header) + header.numBytes, where);
+			bytesOut += sizeof (header) + header.numBytes;
+
+			// give back the space after the compressed bytes, which may be left from before
+#ifdef FALLOC_FL_PUNCH_HOLE
+			fallocate (fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, where + sizeof (header) + header.numBytes,
+				pageSize - sizeof (header) - header.numBytes);
+#endif
+			return;
+		}
+		bytesOut += pageSize;
+	}
+
+	lseek (fd, where, SEEK_SET);
+	write (fd, writeMe->bytes, pageSize);
+}
+
 MyDB_PageHandle MyDB_BufferManager :: getPage (MyDB_TablePtr whichTable, long i) {
 		
 	// open the file, if it is not open
@@ -94,8 +174,7 @@ void MyDB_BufferManager :: kickOutPage () {
 
 	// write it back if necessary
 	if (page->isDirty) {
-		lseek (fds[page->myTable], page->pos * pageSize, SEEK_SET);
-		write (fds[page->myTable], page->bytes, pageSize);
+		writePage (page);
 		page->isDirty = false;
 	}
 
@@ -144,7 +223,7 @@ void MyDB_BufferManager :: killPage (MyDB_PagePtr killMe) {
 void MyDB_BufferManager :: access (MyDB_PagePtr updateMe) {
 	
 	// if this page was just accessed, get outta here
-	if (updateMe->timeTick > lastTimeTick - (numPages / 2) && updateMe->bytes != nullptr) {
+	if (updateMe->timeTick > lastTimeTick - (long) (numPages / 2) && updateMe->bytes != nullptr) {
 		return;
 	}
 
@@ -175,8 +254,7 @@ void MyDB_BufferManager :: access (MyDB_PagePtr updateMe) {
 		availableRam.pop_back ();
 
 		// and read it
-		lseek (fds[updateMe->myTable], updateMe->pos * pageSize, SEEK_SET);
-		read (fds[updateMe->myTable], updateMe->bytes, pageSize);
+		readPage (updateMe);
 
 		updateMe->timeTick = ++lastTimeTick;
 		lastUsed.insert (updateMe);
@@ -236,8 +314,7 @@ MyDB_PageHandle MyDB_BufferManager :: getPinnedPage (MyDB_TablePtr whichTable, l
 		availableRam.pop_back ();
 
 		// and read it
-		lseek (fds[returnVal->myTable], returnVal->pos * pageSize, SEEK_SET);
-		read (fds[returnVal->myTable], returnVal->bytes, pageSize);
+		readPage (returnVal);
 
 	}	
 
@@ -265,11 +342,32 @@ MyDB_PageHandle MyDB_BufferManager :: getPinnedPage () {
 	return returnVal;
 }
 
+MyDB_PageHandle MyDB_BufferManager :: getPinnedPage (MyDB_PageHandle samePage) {
+
+	MyDB_PagePtr page = samePage->page;
+
+	// a page from a table is pinned in the usual way
+	if (page->myTable != nullptr) 
+		return getPinnedPage (page->myTable, page->pos);
+
+	// an anonymous page just needs to be brought in and taken out of the LRU list
+	page->getBytes (page);
+	if (lastUsed.count (page) != 0) {
+		auto found = *(lastUsed.find (page));
+		lastUsed.erase (found);
+	}
+	return make_shared <MyDB_PageHandleBase> (page);
+}
+
 void MyDB_BufferManager :: unpin (MyDB_PagePtr unpinMe) {
 	unpinMe->timeTick = ++lastTimeTick;
 	lastUsed.insert (unpinMe);
 }
 
+bool MyDB_BufferManager :: isPinned (MyDB_PagePtr checkMe) {
+	return checkMe->bytes != nullptr && lastUsed.count (checkMe) == 0;
+}
+
 MyDB_BufferManager :: MyDB_BufferManager (size_t pageSizeIn, size_t numPagesIn, string tempFileIn) {
 
 	// remember the inputs
@@ -287,6 +385,11 @@ MyDB_BufferManager :: MyDB_BufferManager (size_t pageSizeIn, size_t numPagesIn,
 	// the number of pages
 	numPages = numPagesIn;
 
+	// nothing has been compressed yet
+	compressed.resize (pageSize);
+	bytesIn = bytesOut = bytesDecompressed = 0;
+	decompressSeconds = 0;
+
 	// create all of the RAM
 	for (size_t i = 0; i < numPages; i++) {
 		availableRam.push_back (malloc (pageSizeIn));
@@ -300,10 +403,8 @@ MyDB_BufferManager :: ~MyDB_BufferManager () {
 		if (page.second->bytes != nullptr) {
 
 			// write it back if necessary
-			if (page.second->isDirty) {
-				lseek (fds[page.second->myTable], page.second->pos * pageSize, SEEK_SET);
-				write (fds[page.second->myTable], page.second->bytes, pageSize);
-			}
+			if (page.second->isDirty)
+				writePage (page.second);
 
 			free (page.second->bytes);
 			page.second->bytes = nullptr;
@@ -0,0 +1,154 @@
+
+#ifndef PAGE_COMPRESSOR_C
+#define PAGE_COMPRESSOR_C
+
+#include <algorithm>
+#include "MyDB_PageCompressor.h"
+
+#define HASH_BITS 16
+#define MIN_MATCH 4
+#define MAX_DISTANCE 65535
+
+// matches are not looked for in the last few bytes, so that four bytes can always be read
+#define LAST_LITERALS 8
+
+static inline uint32_t read32 (const char *fromMe) {
+	uint32_t val;
+	memcpy (&val, fromMe, sizeof (val));
+	return val;
+}
+
+static inline uint32_t hash32 (uint32_t hashMe) {
+	return (hashMe * 2654435761U) >> (32 - HASH_BITS);
+}
+
+// writes a length that did not fit in the four bits of the token
+static inline char *writeLength (char *out, size_t len) {
+	for (; len >= 255; len -= 255)
+		*out++ = (char) 255;
+	*out++ = (char) len;
+	return out;
+}
+
+// reads one back, returning false if the compressed bytes run out
+static inline bool readLength (const unsigned char *&in, const unsigned char *end, size_t &len) {
+	unsigned char next;
+	do {
+		if (in == end)
+			return false;
+		next = *in++;
+		len += next;
+	} while (next == 255);
+	return true;
+}
+
+MyDB_PageCompressor :: MyDB_PageCompressor () {
+	lastSeen.resize (1 << HASH_BITS, 0);
+}
+
+size_t MyDB_PageCompressor :: compress (const char *in, size_t numBytes, char *out, size_t maxBytes) {
+
+	const char *outStart = out, *outEnd = out + maxBytes;
+	size_t anchor = 0, pos = 0, misses = 0;
+	size_t limit = numBytes > LAST_LITERALS ? numBytes - LAST_LITERALS : 0;
+
+	// adds a sequence with the literals from anchor to pos, and then a match (if matchLen is
+	// not zero); the worst case for the length bytes is checked before anything is written
+	auto emit = [&] (size_t distance, size_t matchLen) {
+		size_t numLiterals = pos - anchor;
+		if ((size_t) (outEnd - out) < 1 + numLiterals + numLiterals / 255 + 1 + 2 + matchLen / 255 + 1)
+			return false;
+		char *token = out++;
+		*token = (char) ((numLiterals < 15 ? numLiterals : 15) << 4);
+		if (numLiterals >= 15)
+			out = writeLength (out, numLiterals - 15);
+		memcpy (out, in + anchor, numLiterals);
+		out += numLiterals;
+		if (matchLen == 0)
+			return true;
+		*out++ = (char) (distance & 0xFF);
+		*out++ = (char) (distance >> 8);
+		matchLen -= MIN_MATCH;
+		*token |= (char) (matchLen < 15 ? matchLen : 15);
+		if (matchLen >= 15)
+			out = writeLength (out, matchLen - 15);
+		return true;
+	};
+
+	while (pos < limit) {
+
+		uint32_t here = read32 (in + pos);
+		uint32_t &seen = lastSeen[hash32 (here)];
+		size_t candidate = seen;
+		seen = (uint32_t) pos;
+
+		// a position that was left over from an earlier page is never after this one, and
+		// if it is not a real match the bytes will not be the same
+		if (candidate >= pos || pos - candidate > MAX_DISTANCE || read32 (in + candidate) != here) {
+
+			// the longer that no match is found, the faster the bytes are skipped over
+			pos += 1 + (misses++ >> 5);
+			continue;
+		}
+
+		size_t matchLen = MIN_MATCH;
+		while (pos + matchLen < numBytes && in[candidate + matchLen] == in[pos + matchLen])
+			matchLen++;
+		if (!emit (pos - candidate, matchLen))
+			return 0;
+		pos += matchLen;
+		anchor = pos;
+		misses = 0;
+	}
+
+	pos = numBytes;
+	if (!emit (0, 0))
+		return 0;
+	return out - outStart;
+}
+
+bool MyDB_PageCompressor :: decompress (const char *decompressMe, size_t numBytes, char *intoMe, size_t outBytes) {
+
+	const unsigned char *in = (const unsigned char *) decompressMe, *inEnd = in + numBytes;
+	char *out = intoMe, *outEnd = intoMe + outBytes;
+	while (in < inEnd) {
+
+		// copy over the literals
+		unsigned char token = *in++;
+		size_t numLiterals = token >> 4;
+		if (numLiterals == 15 && !readLength (in, inEnd, numLiterals))
+			return false;
+		if (numLiterals > (size_t) (inEnd - in) || numLiterals > (size_t) (outEnd - out))
+			return false;
+		memcpy (out, in, numLiterals);
+		in += numLiterals;
+		out += numLiterals;
+
+		// the last sequence has no match
+		if (in == inEnd)
+			break;
+
+		if (inEnd - in < 2)
+			return false;
+		size_t distance = in[0] | (in[1] << 8);
+		in += 2;
+		size_t matchLen = token & 15;
+		if (matchLen == 15 && !readLength (in, inEnd, matchLen))
+			return false;
+		matchLen += MIN_MATCH;
+		if (distance == 0 || distance > (size_t) (out - intoMe) || matchLen > (size_t) (outEnd - out))
+			return false;
+		// and then the match; if it overlaps the bytes that it is copied to (as with a run of
+		// zeros), it is copied in pieces that do not, each one twice as long as the last
+		const char *from = out - distance;
+		while (matchLen > 0) {
+			size_t chunk = min ((size_t) (out - from), matchLen);
+			memcpy (out, from, chunk);
+			out += chunk;
+			matchLen -= chunk;
+		}
+	}
+	return out == outEnd;
+}
+
+#endif
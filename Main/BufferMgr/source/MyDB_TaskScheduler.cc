@@ -0,0 +1,264 @@
+
+#ifndef TASK_SCHEDULER_C
+#define TASK_SCHEDULER_C
+
+#include "MyDB_TaskScheduler.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+// scratch memory is handed out of blocks of (at least) this many bytes
+#define SCRATCH_BLOCK_SIZE (1024 * 1024)
+#define SCRATCH_ALIGNMENT 16
+
+// the worker that the calling thread is (or -1, if it is not a worker), the scheduler that it
+// belongs to, and how many tasks it is running, one inside of the other
+static thread_local int myWorker = -1;
+static thread_local MyDB_TaskScheduler *myScheduler = nullptr;
+static thread_local int taskDepth = 0;
+
+MyDB_ScratchArena :: MyDB_ScratchArena () {
+	whichBlock = 0;
+	used = 0;
+}
+
+void *MyDB_ScratchArena :: allocate (size_t numBytes) {
+
+	numBytes = (numBytes + SCRATCH_ALIGNMENT - 1) / SCRATCH_ALIGNMENT * SCRATCH_ALIGNMENT;
+
+	// move on to the next block that is big enough, making one if there is none
+	while (whichBlock < blocks.size () && used + numBytes > blocks[whichBlock].size ()) {
+		whichBlock++;
+		used = 0;
+	}
+	if (whichBlock == blocks.size ()) {
+		blocks.push_back (vector <char> (max ((size_t) SCRATCH_BLOCK_SIZE, numBytes + SCRATCH_ALIGNMENT)));
+		used = 0;
+	}
+
+	// the vector's storage is only aligned for a char, so the first allocation is lined up
+	char *start = blocks[whichBlock].data ();
+	if (used == 0)
+		used = (SCRATCH_ALIGNMENT - ((size_t) start % SCRATCH_ALIGNMENT)) % SCRATCH_ALIGNMENT;
+	void *returnVal = start + used;
+	used += numBytes;
+	return returnVal;
+}
+
+pair <size_t, size_t> MyDB_ScratchArena :: getMark () {
+	return make_pair (whichBlock, used);
+}
+
+void MyDB_ScratchArena :: release (pair <size_t, size_t> mark) {
+	whichBlock = mark.first;
+	used = mark.second;
+}
+
+MyDB_TaskGroup :: MyDB_TaskGroup (MyDB_TaskScheduler &schedulerIn) : scheduler (schedulerIn) {
+	pending = 0;
+	cancelled = false;
+}
+
+void MyDB_TaskGroup :: submit (function <void ()> task) {
+	pending++;
+	MyDB_TaskScheduler :: Task addMe {task, shared_from_this ()};
+	scheduler.submit (addMe);
+}
+
+void MyDB_TaskGroup :: taskDone () {
+	if (--pending == 0) {
+		lock_guard <mutex> guard (lock);
+		allDone.notify_all ();
+	}
+}
+
+void MyDB_TaskGroup :: join () {
+
+	// a worker keeps busy while it waits, since otherwise, every worker could end up waiting
+	if (myScheduler == &scheduler) {
+		MyDB_TaskScheduler :: Task task;
+		while (pending > 0) {
+			if (scheduler.findTask (myWorker, task)) {
+				scheduler.runTask (myWorker, task);
+			} else {
+				unique_lock <mutex> guard (lock);
+				allDone.wait_for (guard, chrono :: microseconds (100), [this] {return pending == 0;});
+			}
+		}
+		return;
+	}
+
+	unique_lock <mutex> guard (lock);
+	allDone.wait (guard, [this] {return pending == 0;});
+}
+
+void MyDB_TaskGroup :: cancel () {
+	cancelled = true;
+}
+
+bool MyDB_TaskGroup :: isCancelled () {
+	return cancelled;
+}
+
+MyDB_TaskScheduler &MyDB_TaskScheduler :: getScheduler () {
+	static MyDB_TaskScheduler scheduler (max (1, (int) thread :: hardware_concurrency ()));
+	return scheduler;
+}
+
+MyDB_ScratchArena &MyDB_TaskScheduler :: getScratch () {
+	static thread_local MyDB_ScratchArena scratch;
+	return scratch;
+}
+
+MyDB_TaskScheduler :: MyDB_TaskScheduler (int numWorkers) {
+	start (numWorkers);
+}
+
+MyDB_TaskScheduler :: ~MyDB_TaskScheduler () {
+	stop ();
+}
+
+MyDB_TaskGroupPtr MyDB_TaskScheduler :: makeGroup () {
+	return make_shared <MyDB_TaskGroup> (*this);
+}
+
+int MyDB_TaskScheduler :: getNumWorkers () {
+	return workers.size ();
+}
+
+void MyDB_TaskScheduler :: setNumWorkers (int numWorkers) {
+	stop ();
+	start (numWorkers);
+}
+
+void MyDB_TaskScheduler :: start (int numWorkers) {
+	numQueued = 0;
+	nextWorker = 0;
+	stopping = false;
+	workers.clear ();
+	for (int i = 0; i < max (1, numWorkers); i++)
+		workers.push_back (unique_ptr <Worker> (new Worker ()));
+	resetUtilization ();
+	for (int i = 0; i < (int) workers.size (); i++)
+		workers[i]->myThread = thread (&MyDB_TaskScheduler :: work, this, i);
+}
+
+void MyDB_TaskScheduler :: stop () {
+	{
+		lock_guard <mutex> guard (sleepLock);
+		stopping = true;
+	}
+	wakeUp.notify_all ();
+	for (auto &w : workers)
+		w->myThread.join ();
+}
+
+void MyDB_TaskScheduler :: resetUtilization () {
+	for (auto &w : workers) {
+		w->busyNanos = 0;
+		w->numRun = 0;
+		w->numStolen = 0;
+	}
+	countingSince = chrono :: steady_clock :: now ();
+}
+
+string MyDB_TaskScheduler :: getUtilization () {
+	double elapsed = chrono :: duration <double, nano> (chrono :: steady_clock :: now () - countingSince).count ();
+	stringstream ss;
+	for (int i = 0; i < (int) workers.size (); i++) {
+		double busy = elapsed > 0 ? 100.0 * workers[i]->busyNanos / elapsed : 0.0;
+		ss << "worker " << i << ": " << fixed << setprecision (1) << busy << "% busy, " <<
+			workers[i]->numRun << " tasks (" << workers[i]->numStolen << " stolen)\n";
+	}
+	return ss.str ();
+}
+
+void MyDB_TaskScheduler :: submit (Task &addMe) {
+
+	// a worker puts the task on its own deque; a thread outside of the pool deals tasks out
+	int whichWorker = (myScheduler == this) ? myWorker : (int) (nextWorker++ % workers.size ());
+	numQueued++;
+	{
+		lock_guard <mutex> guard (workers[whichWorker]->lock);
+		workers[whichWorker]->tasks.push_back (addMe);
+	}
+
+	// the lock is taken so that a worker cannot miss this between checking numQueued and sleeping
+	{
+		lock_guard <mutex> guard (sleepLock);
+	}
+	wakeUp.notify_one ();
+}
+
+bool MyDB_TaskScheduler :: findTask (int whichWorker, Task &intoMe) {
+
+	// the newest task in the worker's own deque
+	{
+		Worker &me = *workers[whichWorker];
+		lock_guard <mutex> guard (me.lock);
+		if (!me.tasks.empty ()) {
+			intoMe = me.tasks.back ();
+			me.tasks.pop_back ();
+			numQueued--;
+			return true;
+		}
+	}
+
+	// or the oldest one from someone else
+	for (size_t i = 1; i < workers.size (); i++) {
+		Worker &victim = *workers[(whichWorker + i) % workers.size ()];
+		lock_guard <mutex> guard (victim.lock);
+		if (!victim.tasks.empty ()) {
+			intoMe = victim.tasks.front ();
+			victim.tasks.pop_front ();
+			numQueued--;
+			workers[whichWorker]->numStolen++;
+			return true;
+		}
+	}
+	return false;
+}
+
+void MyDB_TaskScheduler :: runTask (int whichWorker, Task &runMe) {
+
+	// whatever the task gets from the scratch arena is given back once it is done; the time
+	// is only counted for the outermost task, since a task that waits runs others inside of it
+	MyDB_ScratchArena &scratch = getScratch ();
+	pair <size_t, size_t> mark = scratch.getMark ();
+	auto start = chrono :: steady_clock :: now ();
+	taskDepth++;
+	if (!runMe.group->isCancelled ())
+		runMe.run ();
+	taskDepth--;
+	if (taskDepth == 0)
+		workers[whichWorker]->busyNanos += chrono :: duration_cast <chrono :: nanoseconds> (chrono :: steady_clock :: now () - start).count ();
+	workers[whichWorker]->numRun++;
+	scratch.release (mark);
+
+	// the task is let go of before the group hears that it is done, so that anything that it
+	// holds on to is gone by the time that join () returns
+	MyDB_TaskGroupPtr group = runMe.group;
+	runMe = Task ();
+	group->taskDone ();
+}
+
+void MyDB_TaskScheduler :: work (int whichWorker) {
+
+	myWorker = whichWorker;
+	myScheduler = this;
+	Task task;
+	while (true) {
+		if (findTask (whichWorker, task)) {
+			runTask (whichWorker, task);
+			continue;
+		}
+
+		// sleep until there is something to do
+		unique_lock <mutex> guard (sleepLock);
+		wakeUp.wait (guard, [this] {return stopping || numQueued > 0;});
+		if (stopping && numQueued == 0)
+			return;
+	}
+}
+
+#endif
@@ -5,6 +5,7 @@
 #include "MyDB_BufferManager.h"
 #include "MyDB_PageHandle.h"
 #include "MyDB_Table.h"
+#include "MyDB_TaskScheduler.h"
 #include "QUnit.h"
 #include <cstring>
 #include <iostream>
@@ -271,6 +272,98 @@ int main () {
 	}
 	cout << "COMPLETE" << endl << flush;
 	QUNIT_IS_TRUE(flag9);
+
+	// compressed pages
+	bool flag10 = true;
+	cout << "TEST 10..." << flush;
+	{
+		cout << "create manager..." << flush;
+		MyDB_BufferManager myMgr(4096, 16, "tempDSFSD");
+		MyDB_TablePtr table1 = make_shared <MyDB_Table>("table1", "file1");
+		table1->setCompressed(true);
+
+		// every eighth page is noise, which does not compress
+		auto expected = [] (int i, int j) {
+			if (i % 8 == 7)
+				return (char) (((j + 1) * 2654435761U * (i + 1)) >> 13);
+			return (char)('A' + (j / 100 + i) % 26);
+		};
+		cout << "write bytes..." << flush;
+		for (int i = 0; i < 64; i++) {
+			MyDB_PageHandle page = myMgr.getPage(table1, i);
+			char *bytes = (char *)page->getBytes();
+			for (int j = 0; j < 4096; j++)
+				bytes[j] = expected(i, j);
+			page->wroteBytes();
+		}
+		cout << "read bytes..." << flush;
+		for (int i = 0; i < 64; i++) {
+			MyDB_PageHandle page = myMgr.getPage(table1, i);
+			char *bytes = (char *)page->getBytes();
+			for (int j = 0; j < 4096; j++) {
+				if (bytes[j] != expected(i, j)) flag10 = false;
+			}
+		}
+		size_t bytesIn, bytesOut, bytesDecompressed;
+		double seconds;
+		myMgr.getCompressionCounts(bytesIn, bytesOut, bytesDecompressed, seconds);
+		if (bytesIn == 0 || bytesOut * 2 > bytesIn || bytesDecompressed == 0) flag10 = false;
+		if (flag10) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag10);
+
+	// task scheduler: tasks that submit and wait for more tasks, cancelling, and scratch memory
+	bool flag11 = true;
+	cout << "TEST 11..." << flush;
+	{
+		cout << "start scheduler..." << flush;
+		MyDB_TaskScheduler scheduler(3);
+		MyDB_TaskGroupPtr outer = scheduler.makeGroup();
+		vector <long> sums(8, 0);
+		cout << "run nested tasks..." << flush;
+		for (int i = 0; i < 8; i++) {
+			long &sum = sums[i];
+			outer->submit([&scheduler, &sum, i] {
+				MyDB_TaskGroupPtr inner = scheduler.makeGroup();
+				vector <long> parts(10, 0);
+				for (int j = 0; j < 10; j++) {
+					long &part = parts[j];
+					inner->submit([&part, i, j] {
+						long *scratch = (long *)MyDB_TaskScheduler::getScratch().allocate(1000 * sizeof(long));
+						for (int k = 0; k < 1000; k++)
+							scratch[k] = i * 10000 + j * 1000 + k;
+						for (int k = 0; k < 1000; k++)
+							part += scratch[k];
+					});
+				}
+				inner->join();
+				for (long part : parts)
+					sum += part;
+			});
+		}
+		outer->join();
+		for (int i = 0; i < 8; i++) {
+			if (sums[i] != 100000000L * i + 45000000L + 4995000L) flag11 = false;
+		}
+
+		cout << "cancel tasks..." << flush;
+		MyDB_TaskGroupPtr cancelled = scheduler.makeGroup();
+		cancelled->cancel();
+		int numRun = 0;
+		for (int i = 0; i < 100; i++)
+			cancelled->submit([&numRun] {numRun++;});
+		cancelled->join();
+		if (numRun != 0) flag11 = false;
+		if (scheduler.getUtilization().find("worker 2:") == string::npos) flag11 = false;
+		if (flag11) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown scheduler..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag11);
 }
 
 #endif
@@ -0,0 +1,131 @@
+
+#ifndef ATT_STATS_H
+#define ATT_STATS_H
+
+#include "MyDB_Catalog.h"
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// a HyperLogLog sketch, which estimates the number of distinct values in a multiset from the
+// hashes of its items, using a few bytes per register.  The sketch of the union of two sets is
+// obtained by merging their sketches
+class MyDB_HyperLogLog {
+
+public:
+
+	// there are 2^BITS registers; the standard error is about 1.04 / sqrt (2^BITS), or 3%
+	static const int BITS = 10;
+
+	// an empty sketch
+	MyDB_HyperLogLog ();
+
+	// adds an item, given its (well-mixed, 64-bit) hash
+	inline void add (size_t hash) {
+		size_t which = hash >> (64 - BITS);
+		size_t rest = hash << BITS;
+		unsigned char rank = (rest == 0) ? 64 - BITS + 1 : __builtin_clzll (rest) + 1;
+		if (rank > registers[which])
+			registers[which] = rank;
+	}
+
+	// adds all of the items in the other sketch to this one
+	void merge (MyDB_HyperLogLog &other);
+
+	// the estimated number of distinct items added
+	size_t estimate ();
+
+	// writes out the registers, one printable character each, and reads them back in
+	string toString ();
+	void fromString (string &fromMe);
+
+private:
+
+	vector <unsigned char> registers;
+};
+
+// create a smart pointer for attribute statistics
+class MyDB_AttStats;
+typedef shared_ptr <MyDB_AttStats> MyDB_AttStatsPtr;
+
+// This holds what is known about the values of one attribute of a table: the number of
+// distinct values (as a HyperLogLog sketch), the smallest and largest values, the most common
+// values along with the fraction of the records having each, and an equi-depth histogram of
+// the rest of the values.  The histogram is a list of bucket boundaries, such that about the
+// same fraction of the values that are not most common fall between each pair of boundaries.
+//
+// Values are kept as doubles for numeric attributes (int, double, and date) and as strings for
+// all others.  The statistics are built from the sketch, the exact smallest and largest
+// values, and a uniform random sample of the values
+class MyDB_AttStats {
+
+public:
+
+	static const int NUM_BUCKETS = 32;
+	static const int NUM_MCVS = 8;
+
+	// builds the statistics for a numeric attribute (the sample is sorted by this)
+	MyDB_AttStats (MyDB_HyperLogLog &distinct, double low, double high, vector <double> &sample);
+
+	// builds the statistics for a non-numeric attribute (the sample is sorted by this)
+	MyDB_AttStats (MyDB_HyperLogLog &distinct, string low, string high, vector <string> &sample);
+
+	// empty statistics; use fromCatalog () to fill them in
+	MyDB_AttStats ();
+
+	// the estimated number of distinct values
+	size_t getDistinctValues ();
+
+	// sets the number of distinct values to use in place of the sketch's estimate
+	void setDistinctValues (size_t toMe);
+
+	// used when the statistics were built from only some of a table's records: estimates the
+	// number of distinct values in all of the table's numRecs records from how many values in
+	// the sample were seen only once, and uses it in place of the sketch's estimate
+	void scaleToTable (size_t numRecs);
+
+	// true if the values are kept as doubles
+	bool isNumeric ();
+
+	// the estimated fraction of the records whose value is equal to (or less than) the given
+	// one; a numeric value is given as a double, and any other as a string
+	double fractionEqual (double val);
+	double fractionEqual (string val);
+	double fractionLess (double val);
+	double fractionLess (string val);
+
+	// the smallest and largest values, as text
+	string getLow ();
+	string getHigh ();
+
+	// write the statistics to the catalog as entries whose keys start with the prefix, and
+	// read them back in; fromCatalog () returns false if they are not there
+	void putInCatalog (string prefix, MyDB_CatalogPtr catalog);
+	bool fromCatalog (string prefix, MyDB_CatalogPtr catalog);
+
+private:
+
+	MyDB_HyperLogLog distinct;
+	size_t distinctOverride;
+	bool numeric;
+
+	// only one of each of these pairs is used, depending upon whether the values are numeric
+	double numLow, numHigh;
+	vector <double> numBounds;
+	vector <pair <double, double>> numMCVs;
+	string strLow, strHigh;
+	vector <string> strBounds;
+	vector <pair <string, double>> strMCVs;
+
+	// the fraction of the records whose values are not most common
+	double restFraction;
+
+	// the number of values in the sample, the number of distinct ones, and the number that
+	// appear only once; these are not kept in the catalog
+	size_t sampleSize, sampleDistinct, sampleSingletons;
+};
+
+#endif
@@ -24,6 +24,11 @@ public:
 	virtual MyDB_AttValPtr createAttMax () = 0;
 	virtual string toString () = 0;
 	virtual bool isBool () = 0;
+	virtual bool isDate () = 0;
+
+	// the number of bytes that a value of this type takes up in a record on a page (counting
+	// the two bytes at the front that hold the size), or -1 if this differs from value to value
+	virtual int getBinarySize () = 0;
 };
 
 class MyDB_IntAttType : public MyDB_AttType {
@@ -50,6 +55,14 @@ public:
 		return false;
 	}
 
+	bool isDate () {
+		return false;
+	}
+
+	int getBinarySize () {
+		return (int) (sizeof (short) + sizeof (int));
+	}
+
 	MyDB_AttValPtr createAtt () {
 		return make_shared <MyDB_IntAttVal> ();
 	}	
@@ -86,6 +99,14 @@ public:
 		return false;
 	}
 
+	bool isDate () {
+		return false;
+	}
+
+	int getBinarySize () {
+		return (int) (sizeof (short) + sizeof (double));
+	}
+
 	MyDB_AttValPtr createAtt () {
 		return make_shared <MyDB_DoubleAttVal> ();
 	}	
@@ -97,6 +118,75 @@ public:
 	}	
 };
 
+// a number with a fixed number of digits after the decimal point (the scale), stored as an
+// integer that counts units of 10^-scale; so sums and differences over decimals are exact, and
+// do not depend on the order that they are done in.  A decimal can be promoted to a double
+class MyDB_DecimalAttType;
+typedef shared_ptr <MyDB_DecimalAttType> MyDB_DecimalAttTypePtr;
+
+class MyDB_DecimalAttType : public MyDB_AttType {
+
+public:
+
+	MyDB_DecimalAttType (int precisionIn, int scaleIn) {
+		precision = precisionIn;
+		scale = scaleIn;
+	}
+
+	bool promotableToInt () {
+		return false;
+	}
+
+	bool promotableToDouble () {
+		return true;
+	}
+
+	bool promotableToString () {
+		return true;
+	}
+
+	string toString () {
+		return "decimal(" + to_string (precision) + "," + to_string (scale) + ")";
+	}
+
+	bool isBool () {
+		return false;
+	}
+
+	bool isDate () {
+		return false;
+	}
+
+	int getBinarySize () {
+		return (int) (sizeof (short) + sizeof (long long));
+	}
+
+	MyDB_AttValPtr createAtt () {
+		return make_shared <MyDB_DecimalAttVal> (precision, scale);
+	}
+
+	// this is only used as a key in the internal nodes of a B+-Tree, where keys are compared
+	// as doubles, so it need not be a decimal
+	MyDB_AttValPtr createAttMax () {
+		MyDB_DoubleAttValPtr retVal = make_shared <MyDB_DoubleAttVal> ();
+		retVal->set (1.79769e+308);
+		return retVal;
+	}
+
+	int getPrecision () {
+		return precision;
+	}
+
+	int getScale () {
+		return scale;
+	}
+
+private:
+
+	int precision;
+	int scale;
+};
+
 class MyDB_StringAttType : public MyDB_AttType {
 
 public: 
@@ -117,6 +207,14 @@ public:
 		return false;
 	}
 
+	bool isDate () {
+		return false;
+	}
+
+	int getBinarySize () {
+		return -1;
+	}
+
 	string toString () {
 		return "string";
 	}
@@ -132,6 +230,69 @@ public:
 	}	
 };
 
+// a string of at most width characters that always takes up the same amount of space on a
+// page: the characters, padded with nulls to width, and then a null.  It acts just like a
+// string, but a record made of attributes like this one has each attribute at the same place
+// every time, and an equality with a literal is done by comparing the bytes on the page
+class MyDB_CharAttType;
+typedef shared_ptr <MyDB_CharAttType> MyDB_CharAttTypePtr;
+
+class MyDB_CharAttType : public MyDB_AttType {
+
+public: 
+	
+	MyDB_CharAttType (int widthIn) {
+		width = widthIn;
+	}
+
+	bool promotableToInt () {
+		return false;
+	}
+
+	bool promotableToDouble () {
+		return false;
+	}
+
+	bool promotableToString () {
+		return true;
+	}
+
+	bool isBool () {
+		return false;
+	}
+
+	bool isDate () {
+		return false;
+	}
+
+	int getBinarySize () {
+		return (int) sizeof (short) + width + 1;
+	}
+
+	string toString () {
+		return "char(" + to_string (width) + ")";
+	}
+
+	MyDB_AttValPtr createAtt () {
+		return make_shared <MyDB_CharAttVal> (width);
+	}	
+
+	// this is only used as a key in the internal nodes of a B+-Tree, so it need not fit
+	MyDB_AttValPtr createAttMax () {
+		MyDB_StringAttValPtr retVal = make_shared <MyDB_StringAttVal> ();
+		retVal->set ("~~~~~~~~~");
+		return retVal;	
+	}	
+
+	int getWidth () {
+		return width;
+	}
+
+private:
+
+	int width;
+};
+
 class MyDB_BoolAttType : public MyDB_AttType {
 
 public: 
@@ -152,6 +313,14 @@ public:
 		return true;
 	}
 
+	bool isDate () {
+		return false;
+	}
+
+	int getBinarySize () {
+		return (int) (sizeof (short) + sizeof (char));
+	}
+
 	string toString () {
 		return "bool";
 	}
@@ -167,4 +336,178 @@ public:
 	}	
 };
 
+// a string that is stored as a code from a dictionary that belongs to the attribute; it
+// acts just like a string, but it takes two bytes on a page, and an equality between the
+// attribute and a literal is checked by just comparing the codes
+class MyDB_DictStringAttType;
+typedef shared_ptr <MyDB_DictStringAttType> MyDB_DictStringAttTypePtr;
+
+class MyDB_DictStringAttType : public MyDB_AttType {
+
+public: 
+	
+	MyDB_DictStringAttType () {
+		myDictionary = make_shared <MyDB_StringDictionary> ();
+	}
+
+	MyDB_DictStringAttType (MyDB_StringDictionaryPtr myDictionaryIn) {
+		myDictionary = myDictionaryIn;
+	}
+
+	bool promotableToInt () {
+		return false;
+	}
+
+	bool promotableToDouble () {
+		return false;
+	}
+
+	bool promotableToString () {
+		return true;
+	}
+
+	bool isBool () {
+		return false;
+	}
+
+	bool isDate () {
+		return false;
+	}
+
+	int getBinarySize () {
+		return (int) (sizeof (short) + sizeof (unsigned short));
+	}
+
+	string toString () {
+		return "dictstring";
+	}
+
+	MyDB_AttValPtr createAtt () {
+		return make_shared <MyDB_DictStringAttVal> (myDictionary);
+	}	
+
+	// this is only used as a key in the internal nodes of a B+-Tree, so it need not be encoded
+	MyDB_AttValPtr createAttMax () {
+		MyDB_StringAttValPtr retVal = make_shared <MyDB_StringAttVal> ();
+		retVal->set ("~~~~~~~~~");
+		return retVal;	
+	}	
+
+	MyDB_StringDictionaryPtr getDictionary () {
+		return myDictionary;
+	}
+
+private:
+
+	MyDB_StringDictionaryPtr myDictionary;
+};
+
+// a string that is stored out of line, in an overflow file that belongs to the attribute (see
+// MyDB_OverflowFile); it acts just like a string, but it takes ten bytes on a page, so that a
+// long value that is seldom used does not make every scan and every copy of the record bigger
+class MyDB_OverflowAttType;
+typedef shared_ptr <MyDB_OverflowAttType> MyDB_OverflowAttTypePtr;
+
+class MyDB_OverflowAttType : public MyDB_AttType {
+
+public: 
+	
+	MyDB_OverflowAttType (string fileName) {
+		myFile = MyDB_OverflowFile :: getFile (fileName);
+	}
+
+	bool promotableToInt () {
+		return false;
+	}
+
+	bool promotableToDouble () {
+		return false;
+	}
+
+	bool promotableToString () {
+		return true;
+	}
+
+	bool isBool () {
+		return false;
+	}
+
+	bool isDate () {
+		return false;
+	}
+
+	int getBinarySize () {
+		return (int) (sizeof (short) + sizeof (long long));
+	}
+
+	string toString () {
+		return "overflowstring";
+	}
+
+	MyDB_AttValPtr createAtt () {
+		return make_shared <MyDB_OverflowAttVal> (myFile);
+	}	
+
+	// this is only used as a key in the internal nodes of a B+-Tree, so it need not be stored
+	MyDB_AttValPtr createAttMax () {
+		MyDB_StringAttValPtr retVal = make_shared <MyDB_StringAttVal> ();
+		retVal->set ("~~~~~~~~~");
+		return retVal;	
+	}	
+
+	MyDB_OverflowFilePtr getOverflowFile () {
+		return myFile;
+	}
+
+private:
+
+	MyDB_OverflowFilePtr myFile;
+};
+
+// a date is an int (the number of days since 1970-01-01) that is written as YYYY-MM-DD; so
+// dates are compared and grouped as ints, but they print (and are promoted to strings) as dates
+class MyDB_DateAttType : public MyDB_AttType {
+
+public: 
+	
+	bool promotableToInt () {
+		return true;
+	}
+
+	bool promotableToDouble () {
+		return true;
+	}
+
+	string toString () {
+		return "date";
+	}
+
+	bool promotableToString () {
+		return true;
+	}
+
+	bool isBool () {
+		return false;
+	}
+
+	bool isDate () {
+		return true;
+	}
+
+	int getBinarySize () {
+		return (int) (sizeof (short) + sizeof (int));
+	}
+
+	MyDB_AttValPtr createAtt () {
+		return make_shared <MyDB_DateAttVal> ();
+	}	
+
+	MyDB_AttValPtr createAttMax () {
+		MyDB_DateAttValPtr retVal = make_shared <MyDB_DateAttVal> ();
+		retVal->set (INT_MAX);
+		return retVal;	
+	}	
+	
+};
+
 #endif
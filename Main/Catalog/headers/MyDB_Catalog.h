@@ -43,6 +43,11 @@ public:
 	void putDoubleList (string key, vector <double> value);
 	void putLong (string key, vector <long> value);
 
+	// makes an arbitrary string safe to store in the catalog (even as an entry in a string
+	// list), and undoes this
+	static string escape (const string &escapeMe);
+	static string unescape (const string &unescapeMe);
+
 	// creates an instance of the catalog.  If the specified file does
 	// not exist, it is created.  Otherwise, the existing file is 
 	// opened.
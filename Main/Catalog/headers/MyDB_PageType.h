@@ -1,3 +1,4 @@
 
-// this lists all of the different page types
-enum MyDB_PageType {RegularPage, DirectoryPage};
+// this lists all of the different page types; a PAXPage holds records just like a RegularPage
+// does, but it keeps the values of each attribute together (see MyDB_PageReaderWriter)
+enum MyDB_PageType {RegularPage, DirectoryPage, PAXPage};
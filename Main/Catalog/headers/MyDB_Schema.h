@@ -24,6 +24,11 @@ public:
 	// get the list of all of the attributes... the pair is the name and the type
 	vector <pair <string, MyDB_AttTypePtr>> &getAtts ();
 
+	// where the given attribute is in a record on a page (the number of bytes from the start
+	// of the record to the start of the attribute), if every attribute before it always takes
+	// up the same amount of space; otherwise, -1
+	int getFixedOffset (int whichAtt);
+
 	// append another attribute to the schema
 	void appendAtt (pair <string, MyDB_AttTypePtr> addAtt);
 
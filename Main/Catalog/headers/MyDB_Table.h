@@ -3,12 +3,18 @@
 #define TABLE_H
 
 #include <iostream>
+#include "MyDB_AttStats.h"
 #include "MyDB_Catalog.h"
 #include "MyDB_Schema.h"
 #include "MyDB_Table.h"
 #include <memory>
 #include <string>
 
+// the version of the layout of the pages that a table's file is written in.  Version 1 (the
+// tables in catalogs written before the version was kept) had the records back to back after the
+// page header; version 2 adds the slot directory at the end of each page (see MyDB_PageReaderWriter)
+#define MYDB_PAGE_FORMAT 2
+
 // create a smart pointer for database tables
 using namespace std;
 class MyDB_Table;
@@ -71,7 +77,8 @@ public:
 	// the sort att
 	string &getSortAtt ();
 
-	// the file type (ex: "heap" or "bplustree")
+	// the file type (ex: "heap" or "bplustree"); a "pax" file is a heap file whose pages are
+	// re-written as PAXPages once they are full (see MyDB_PageReaderWriter)
 	string &getFileType ();
 
 	// get/set the root location
@@ -89,6 +96,36 @@ public:
         void setTupleCount (size_t toMe);
         size_t getTupleCount ();
 
+	// get/set the statistics for each attribute (these are collected when the table is loaded,
+	// or by MyDB_TableReaderWriter.analyze ()); getAttStats () returns nullptr if there are
+	// none for the attribute
+	vector <MyDB_AttStatsPtr> &getAttStats ();
+	MyDB_AttStatsPtr getAttStats (string forMe);
+	void setAttStats (vector <MyDB_AttStatsPtr> &toMe);
+
+	// estimates the fraction of the table's records that are accepted by a predicate, written
+	// in the prefix notation accepted by MyDB_Record.compileComputation (), using the statistics
+	// for each attribute.  The && of two predicates is assumed to accept the product of their
+	// fractions, and an == between two attributes is assumed to accept one over the larger
+	// number of distinct values; anything that cannot be estimated accepts a third
+	double estimateSelectivity (string predicate);
+
+	// get/set the attributes that get a Bloom filter on each page of the table, so that a scan
+	// can skip the pages that cannot have a value that is checked for with an == (see
+	// MyDB_ZoneMap); these are only built as records are written to the table
+	vector <string> &getBloomAtts ();
+	void setBloomAtts (vector <string> &toMe);
+
+	// get/set whether the buffer manager compresses the table's pages as they are written to
+	// the file (see MyDB_PageCompressor); this is not seen by anything above the buffer manager
+	bool isCompressed ();
+	void setCompressed (bool toMe);
+
+	// get/set the version of the page layout that the table's file is written in (see
+	// MYDB_PAGE_FORMAT); a new table is always written in the current version
+	int getPageFormat ();
+	void setPageFormat (int toMe);
+
 	// make a deep copy of the one we are given
 	MyDB_Table (MyDB_Table &setToMe);
 
@@ -97,6 +134,18 @@ private:
 	// the distinct value counts
 	vector <size_t> allCounts;
 
+	// the statistics for each attribute
+	vector <MyDB_AttStatsPtr> attStats;
+
+	// the attributes with Bloom filters
+	vector <string> bloomAtts;
+
+	// whether the pages are compressed
+	bool compressed;
+
+	// the version of the page layout
+	int pageFormat;
+
 	// the number of tuples
 	int count;
 
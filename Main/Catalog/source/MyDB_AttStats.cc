@@ -0,0 +1,363 @@
+
+#ifndef ATT_STATS_C
+#define ATT_STATS_C
+
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include "MyDB_AttStats.h"
+
+MyDB_HyperLogLog :: MyDB_HyperLogLog () {
+	registers.resize (((size_t) 1) << BITS, 0);
+}
+
+void MyDB_HyperLogLog :: merge (MyDB_HyperLogLog &other) {
+	for (size_t i = 0; i < registers.size (); i++) {
+		if (other.registers[i] > registers[i])
+			registers[i] = other.registers[i];
+	}
+}
+
+size_t MyDB_HyperLogLog :: estimate () {
+
+	double m = (double) registers.size ();
+	double sum = 0.0;
+	size_t numZero = 0;
+	for (unsigned char r : registers) {
+		sum += ldexp (1.0, -(int) r);
+		if (r == 0)
+			numZero++;
+	}
+
+	// the raw estimate is biased upward when few items have been added; in that case, linear
+	// counting over the empty registers is more accurate
+	double alpha = 0.7213 / (1.0 + 1.079 / m);
+	double result = alpha * m * m / sum;
+	if (result <= 2.5 * m && numZero > 0)
+		result = m * log (m / (double) numZero);
+
+	return (size_t) (result + 0.5);
+}
+
+string MyDB_HyperLogLog :: toString () {
+	string result;
+	for (unsigned char r : registers)
+		result += (char) ('A' + r);
+	return result;
+}
+
+void MyDB_HyperLogLog :: fromString (string &fromMe) {
+	for (size_t i = 0; i < registers.size () && i < fromMe.size (); i++)
+		registers[i] = (unsigned char) (fromMe[i] - 'A');
+}
+
+// within a histogram bucket, numeric values are assumed to be spread evenly; nothing is known
+// about the spread of strings, so a string is assumed to be half way through
+static double fractionWithin (double val, double low, double high) {
+	if (high <= low)
+		return 0.5;
+	return (val - low) / (high - low);
+}
+
+static double fractionWithin (const string &, const string &, const string &) {
+	return 0.5;
+}
+
+// builds the most common values and the histogram bounds from a sorted sample
+template <class T>
+static void buildFromSample (vector <T> &sample, size_t ndv, T &low, T &high,
+	vector <pair <T, double>> &mcvs, vector <T> &bounds, double &restFraction, size_t &sampleDistinct,
+	size_t &sampleSingletons) {
+
+	restFraction = 1.0;
+	sampleDistinct = sampleSingletons = 0;
+	if (sample.size () == 0)
+		return;
+
+	// find the runs of equal values in the sample
+	vector <pair <size_t, size_t>> runs;
+	for (size_t i = 0; i < sample.size ();) {
+		size_t j = i + 1;
+		while (j < sample.size () && !(sample[i] < sample[j]))
+			j++;
+		runs.push_back (make_pair (j - i, i));
+		if (j - i == 1)
+			sampleSingletons++;
+		i = j;
+	}
+	sampleDistinct = runs.size ();
+
+	// a value is most common if it appears more than once, and notably more often than the
+	// average value does; if there are only a few values, then all of them are most common
+	double n = (double) sample.size ();
+	double avg = n / (double) max ((size_t) 1, max (ndv, runs.size ()));
+	bool allCommon = runs.size () <= (size_t) MyDB_AttStats :: NUM_MCVS && ndv <= (size_t) MyDB_AttStats :: NUM_MCVS;
+	stable_sort (runs.begin (), runs.end (), [] (const pair <size_t, size_t> &a, const pair <size_t, size_t> &b) {
+		return a.first > b.first;
+	});
+	vector <bool> isCommon (sample.size (), false);
+	for (auto &run : runs) {
+		if (mcvs.size () == (size_t) MyDB_AttStats :: NUM_MCVS)
+			break;
+		if (!allCommon && (run.first < 2 || run.first <= 1.25 * avg))
+			break;
+		mcvs.push_back (make_pair (sample[run.second], run.first / n));
+		restFraction -= run.first / n;
+		for (size_t i = run.second; i < run.second + run.first; i++)
+			isCommon[i] = true;
+	}
+
+	// and the histogram is built over the rest
+	vector <T> rest;
+	for (size_t i = 0; i < sample.size (); i++) {
+		if (!isCommon[i])
+			rest.push_back (sample[i]);
+	}
+
+	if (rest.size () == 0) {
+		restFraction = 0.0;
+		return;
+	}
+
+	for (int i = 0; i <= MyDB_AttStats :: NUM_BUCKETS; i++)
+		bounds.push_back (rest[(size_t) i * (rest.size () - 1) / MyDB_AttStats :: NUM_BUCKETS]);
+
+	// the sample may have missed the extreme values
+	if (low < bounds.front ())
+		bounds.front () = low;
+	if (bounds.back () < high)
+		bounds.back () = high;
+}
+
+template <class T>
+static double fractionEqualHelper (T &val, size_t ndv, T &low, T &high, vector <pair <T, double>> &mcvs,
+	double restFraction) {
+
+	for (auto &mcv : mcvs) {
+		if (!(mcv.first < val) && !(val < mcv.first))
+			return mcv.second;
+	}
+
+	if (val < low || high < val)
+		return 0.0;
+
+	// the rest of the records are spread evenly over the rest of the values
+	if (ndv <= mcvs.size ())
+		return 0.0;
+	return restFraction / (double) (ndv - mcvs.size ());
+}
+
+template <class T>
+static double fractionLessHelper (T &val, T &low, T &high, vector <pair <T, double>> &mcvs,
+	vector <T> &bounds, double restFraction) {
+
+	if (!(low < val))
+		return 0.0;
+	if (high < val)
+		return 1.0;
+
+	double result = 0.0;
+	for (auto &mcv : mcvs) {
+		if (mcv.first < val)
+			result += mcv.second;
+	}
+
+	// with no histogram, the rest of the values are taken to be spread evenly between the
+	// smallest and largest ones
+	if (bounds.size () < 2)
+		return result + restFraction * fractionWithin (val, low, high);
+
+	// otherwise, find the bucket that the value falls in
+	if (!(bounds.front () < val))
+		return result;
+	if (bounds.back () < val)
+		return result + restFraction;
+
+	size_t which = lower_bound (bounds.begin (), bounds.end (), val) - bounds.begin () - 1;
+	double numBuckets = (double) (bounds.size () - 1);
+	double inBucket = fractionWithin (val, bounds[which], bounds[which + 1]);
+	return result + restFraction * (which + inBucket) / numBuckets;
+}
+
+MyDB_AttStats :: MyDB_AttStats (MyDB_HyperLogLog &distinctIn, double low, double high, vector <double> &sample) {
+	distinct = distinctIn;
+	distinctOverride = 0;
+	numeric = true;
+	numLow = low;
+	numHigh = high;
+	sampleSize = sample.size ();
+	buildFromSample (sample, getDistinctValues (), numLow, numHigh, numMCVs, numBounds, restFraction,
+		sampleDistinct, sampleSingletons);
+}
+
+MyDB_AttStats :: MyDB_AttStats (MyDB_HyperLogLog &distinctIn, string low, string high, vector <string> &sample) {
+	distinct = distinctIn;
+	distinctOverride = 0;
+	numeric = false;
+	numLow = numHigh = 0.0;
+	strLow = low;
+	strHigh = high;
+	sampleSize = sample.size ();
+	buildFromSample (sample, getDistinctValues (), strLow, strHigh, strMCVs, strBounds, restFraction,
+		sampleDistinct, sampleSingletons);
+}
+
+MyDB_AttStats :: MyDB_AttStats () {
+	distinctOverride = 0;
+	sampleSize = sampleDistinct = sampleSingletons = 0;
+	numeric = true;
+	numLow = numHigh = 0.0;
+	restFraction = 1.0;
+}
+
+size_t MyDB_AttStats :: getDistinctValues () {
+	if (distinctOverride != 0)
+		return distinctOverride;
+	return distinct.estimate ();
+}
+
+void MyDB_AttStats :: setDistinctValues (size_t toMe) {
+	distinctOverride = toMe;
+}
+
+void MyDB_AttStats :: scaleToTable (size_t numRecs) {
+
+	// this is the Haas-Stokes estimator, n * d / (n - f1 + f1 * n / N), where the sample has n
+	// values, d distinct ones, and f1 that are seen only once.  If every value in the sample is
+	// seen only once, then they are all taken to be unique
+	size_t estimate;
+	double n = (double) sampleSize;
+	if (sampleSize == 0 || numRecs <= sampleSize)
+		return;
+	else if (sampleSingletons == sampleSize)
+		estimate = numRecs;
+	else
+		estimate = (size_t) (n * sampleDistinct / (n - sampleSingletons + sampleSingletons * n / numRecs));
+
+	// there are at least as many as were seen by the sketch
+	distinctOverride = min (numRecs, max (estimate, distinct.estimate ()));
+}
+
+bool MyDB_AttStats :: isNumeric () {
+	return numeric;
+}
+
+double MyDB_AttStats :: fractionEqual (double val) {
+	if (!numeric)
+		return fractionEqual (to_string (val));
+	return fractionEqualHelper (val, getDistinctValues (), numLow, numHigh, numMCVs, restFraction);
+}
+
+double MyDB_AttStats :: fractionEqual (string val) {
+	if (numeric)
+		return fractionEqual (atof (val.c_str ()));
+	return fractionEqualHelper (val, getDistinctValues (), strLow, strHigh, strMCVs, restFraction);
+}
+
+double MyDB_AttStats :: fractionLess (double val) {
+	if (!numeric)
+		return fractionLess (to_string (val));
+	return fractionLessHelper (val, numLow, numHigh, numMCVs, numBounds, restFraction);
+}
+
+double MyDB_AttStats :: fractionLess (string val) {
+	if (numeric)
+		return fractionLess (atof (val.c_str ()));
+	return fractionLessHelper (val, strLow, strHigh, strMCVs, strBounds, restFraction);
+}
+
+string MyDB_AttStats :: getLow () {
+	if (!numeric)
+		return strLow;
+	char buf[32];
+	snprintf (buf, sizeof (buf), "%g", numLow);
+	return buf;
+}
+
+string MyDB_AttStats :: getHigh () {
+	if (!numeric)
+		return strHigh;
+	char buf[32];
+	snprintf (buf, sizeof (buf), "%g", numHigh);
+	return buf;
+}
+
+void MyDB_AttStats :: putInCatalog (string prefix, MyDB_CatalogPtr catalog) {
+
+	catalog->putString (prefix + ".hll", distinct.toString ());
+	catalog->putString (prefix + ".ndv", to_string (distinctOverride));
+	catalog->putString (prefix + ".numeric", numeric ? "true" : "false");
+	catalog->putDouble (prefix + ".restFraction", restFraction);
+
+	vector <double> freqs;
+	if (numeric) {
+		catalog->putDouble (prefix + ".low", numLow);
+		catalog->putDouble (prefix + ".high", numHigh);
+		catalog->putDoubleList (prefix + ".bounds", numBounds);
+		vector <double> vals;
+		for (auto &mcv : numMCVs) {
+			vals.push_back (mcv.first);
+			freqs.push_back (mcv.second);
+		}
+		catalog->putDoubleList (prefix + ".mcvs", vals);
+	} else {
+		catalog->putString (prefix + ".low", MyDB_Catalog :: escape (strLow));
+		catalog->putString (prefix + ".high", MyDB_Catalog :: escape (strHigh));
+		vector <string> bounds, vals;
+		for (auto &s : strBounds)
+			bounds.push_back (MyDB_Catalog :: escape (s));
+		catalog->putStringList (prefix + ".bounds", bounds);
+		for (auto &mcv : strMCVs) {
+			vals.push_back (MyDB_Catalog :: escape (mcv.first));
+			freqs.push_back (mcv.second);
+		}
+		catalog->putStringList (prefix + ".mcvs", vals);
+	}
+	catalog->putDoubleList (prefix + ".mcvFreqs", freqs);
+}
+
+bool MyDB_AttStats :: fromCatalog (string prefix, MyDB_CatalogPtr catalog) {
+
+	string temp;
+	if (!catalog->getString (prefix + ".hll", temp))
+		return false;
+	distinct.fromString (temp);
+
+	catalog->getString (prefix + ".ndv", temp);
+	distinctOverride = stoull (temp);
+	catalog->getString (prefix + ".numeric", temp);
+	numeric = (temp == "true");
+	catalog->getDouble (prefix + ".restFraction", restFraction);
+
+	vector <double> freqs;
+	catalog->getDoubleList (prefix + ".mcvFreqs", freqs);
+	if (numeric) {
+		catalog->getDouble (prefix + ".low", numLow);
+		catalog->getDouble (prefix + ".high", numHigh);
+		numBounds.clear ();
+		catalog->getDoubleList (prefix + ".bounds", numBounds);
+		vector <double> vals;
+		catalog->getDoubleList (prefix + ".mcvs", vals);
+		numMCVs.clear ();
+		for (size_t i = 0; i < vals.size () && i < freqs.size (); i++)
+			numMCVs.push_back (make_pair (vals[i], freqs[i]));
+	} else {
+		catalog->getString (prefix + ".low", temp);
+		strLow = MyDB_Catalog :: unescape (temp);
+		catalog->getString (prefix + ".high", temp);
+		strHigh = MyDB_Catalog :: unescape (temp);
+		vector <string> bounds, vals;
+		catalog->getStringList (prefix + ".bounds", bounds);
+		strBounds.clear ();
+		for (auto &s : bounds)
+			strBounds.push_back (MyDB_Catalog :: unescape (s));
+		catalog->getStringList (prefix + ".mcvs", vals);
+		strMCVs.clear ();
+		for (size_t i = 0; i < vals.size () && i < freqs.size (); i++)
+			strMCVs.push_back (make_pair (MyDB_Catalog :: unescape (vals[i]), freqs[i]));
+	}
+
+	return true;
+}
+
+#endif
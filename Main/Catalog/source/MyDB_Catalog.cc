@@ -6,6 +6,7 @@
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <stdio.h>
 #include <string>
 
 #include "MyDB_AttType.h"
@@ -75,6 +76,84 @@ bool MyDB_Catalog :: getInt (string key, int &value) {
 	return true;
 }
 
+bool MyDB_Catalog :: getDouble (string key, double &value) {
+
+	// verify the entry is in the map
+	if (myData.count (key) == 0)
+		return false;
+
+	// it is, so convert it to a double
+	try {
+		value = std::stod (myData [key]);
+
+	// exception means that we could not convert
+	} catch (...) {
+		return false;
+	}
+	
+	return true;
+}
+
+bool MyDB_Catalog :: getDoubleList (string key, vector <double> &returnVal) {
+
+	vector <string> temp;
+	if (!getStringList (key, temp))
+		return false;
+
+	try {
+		for (string &s : temp)
+			returnVal.push_back (std::stod (s));
+	} catch (...) {
+		return false;
+	}
+	return true;
+}
+
+void MyDB_Catalog :: putDouble (string key, double value) {
+	char buf[32];
+	snprintf (buf, sizeof (buf), "%.17g", value);
+	myData [key] = buf;
+}
+
+void MyDB_Catalog :: putDoubleList (string key, vector <double> value) {
+	vector <string> temp;
+	for (double d : value) {
+		char buf[32];
+		snprintf (buf, sizeof (buf), "%.17g", d);
+		temp.push_back (buf);
+	}
+	putStringList (key, temp);
+}
+
+// the characters that the catalog uses ('|', '#', and the end of a line) and '%' are escaped
+// as %XX, and there is an '=' in front, so that the empty string can be written in a list
+string MyDB_Catalog :: escape (const string &escapeMe) {
+	string returnVal = "=";
+	for (char c : escapeMe) {
+		if (c == '|' || c == '#' || c == '%' || c == '\n' || c == '\r') {
+			char buf[8];
+			snprintf (buf, sizeof (buf), "%%%02X", (unsigned char) c);
+			returnVal += buf;
+		} else {
+			returnVal += c;
+		}
+	}
+	return returnVal;
+}
+
+string MyDB_Catalog :: unescape (const string &unescapeMe) {
+	string returnVal;
+	for (size_t i = 1; i < unescapeMe.size (); i++) {
+		if (unescapeMe[i] == '%' && i + 2 < unescapeMe.size ()) {
+			returnVal += (char) stoi (unescapeMe.substr (i + 1, 2), nullptr, 16);
+			i += 2;
+		} else {
+			returnVal += unescapeMe[i];
+		}
+	}
+	return returnVal;
+}
+
 MyDB_Catalog :: MyDB_Catalog (string fNameIn) {
 
 	// remember the catalog name
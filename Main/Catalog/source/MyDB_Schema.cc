@@ -3,6 +3,8 @@
 #define SCHEMA_C
 
 #include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
 #include "MyDB_Schema.h"
 
 using namespace std;
@@ -41,6 +43,21 @@ void MyDB_Schema :: addAtt (string tableName, pair <string, MyDB_AttTypePtr> att
 	}
 	catalog->putStringList (tableName + ".attList", myAtts);
 	catalog->putString (tableName + "." + attToAdd.first + ".type", attToAdd.second->toString ());
+
+	// a dictionary-encoded attribute needs its dictionary, in code order
+	MyDB_DictStringAttTypePtr dictType = dynamic_pointer_cast <MyDB_DictStringAttType> (attToAdd.second);
+	if (dictType != nullptr) {
+		MyDB_StringDictionaryPtr dictionary = dictType->getDictionary ();
+		vector <string> allVals;
+		for (int i = 0; i < dictionary->size (); i++)
+			allVals.push_back (MyDB_Catalog :: escape (dictionary->decode (i)));
+		catalog->putStringList (tableName + "." + attToAdd.first + ".dictionary", allVals);
+	}
+
+	// and an attribute that is stored out of line needs its file
+	MyDB_OverflowAttTypePtr overflowType = dynamic_pointer_cast <MyDB_OverflowAttType> (attToAdd.second);
+	if (overflowType != nullptr)
+		catalog->putString (tableName + "." + attToAdd.first + ".overflowFile", overflowType->getOverflowFile ()->getFileName ());
 }
 
 
@@ -54,6 +71,7 @@ void MyDB_Schema :: fromCatalog (string tableName, MyDB_CatalogPtr catalog) {
 	// get the type of each attribute
 	for (string s : myAtts) {
 		string attType;
+		int precision, scale;
 		catalog->getString (tableName + "." + s + ".type", attType);
 		if (attType == "int") {
 			allAtts.push_back (make_pair (s, make_shared <MyDB_IntAttType> ()));
@@ -63,6 +81,27 @@ void MyDB_Schema :: fromCatalog (string tableName, MyDB_CatalogPtr catalog) {
 			allAtts.push_back (make_pair (s, make_shared <MyDB_StringAttType> ()));
 		} else if (attType == "bool") {
 			allAtts.push_back (make_pair (s, make_shared <MyDB_BoolAttType> ()));
+		} else if (attType == "dictstring") {
+			MyDB_StringDictionaryPtr dictionary = make_shared <MyDB_StringDictionary> ();
+			vector <string> allVals;
+			catalog->getStringList (tableName + "." + s + ".dictionary", allVals);
+			for (string &val : allVals) {
+				string unescaped = MyDB_Catalog :: unescape (val);
+				dictionary->encode (MyDB_StringView (unescaped.data (), unescaped.size ()));
+			}
+			allAtts.push_back (make_pair (s, make_shared <MyDB_DictStringAttType> (dictionary)));
+		} else if (attType == "overflowstring") {
+			string fileName;
+			catalog->getString (tableName + "." + s + ".overflowFile", fileName);
+			allAtts.push_back (make_pair (s, make_shared <MyDB_OverflowAttType> (fileName)));
+		} else if (attType == "date") {
+			allAtts.push_back (make_pair (s, make_shared <MyDB_DateAttType> ()));
+		} else if (attType.compare (0, 5, "char(") == 0 && atoi (attType.c_str () + 5) >= 1 &&
+			atoi (attType.c_str () + 5) <= MAX_CHAR_WIDTH) {
+			allAtts.push_back (make_pair (s, make_shared <MyDB_CharAttType> (atoi (attType.c_str () + 5))));
+		} else if (sscanf (attType.c_str (), "decimal(%d,%d)", &precision, &scale) == 2 && precision >= 1 &&
+			precision <= MAX_DECIMAL_PRECISION && scale >= 0 && scale <= precision) {
+			allAtts.push_back (make_pair (s, make_shared <MyDB_DecimalAttType> (precision, scale)));
 		} else {
 			cout << "Bad att type for attribute " << s << ": " << attType << "\n";
 			exit (1);
@@ -70,6 +109,19 @@ void MyDB_Schema :: fromCatalog (string tableName, MyDB_CatalogPtr catalog) {
 	}
 }
 
+int MyDB_Schema :: getFixedOffset (int whichAtt) {
+
+	// a record starts with its size, and then each attribute starts with its own
+	int offset = sizeof (short);
+	for (int i = 0; i < whichAtt; i++) {
+		int size = allAtts[i].second->getBinarySize ();
+		if (size == -1)
+			return -1;
+		offset += size;
+	}
+	return offset;
+}
+
 void MyDB_Schema :: appendAtt (pair <string, MyDB_AttTypePtr> addAtt) {
 	allAtts.push_back (addAtt);
 }
@@ -2,6 +2,7 @@
 #ifndef TABLE_C
 #define TABLE_C
 
+#include "MyDB_Expr.h"
 #include "MyDB_Table.h"
 
 MyDB_Table :: MyDB_Table (string name, string storageLocIn) {
@@ -11,10 +12,14 @@ MyDB_Table :: MyDB_Table (string name, string storageLocIn) {
 	fileType = "heap";
 	sortAtt = "none";
 	rootLocation = -1;
+	compressed = false;
+	pageFormat = MYDB_PAGE_FORMAT;
 }
 
 MyDB_Table :: MyDB_Table (MyDB_Table &toMe) {
 	allCounts = toMe.allCounts;
+	attStats = toMe.attStats;
+	bloomAtts = toMe.bloomAtts;
 	count = toMe.count;
 	sortAtt = toMe.sortAtt;
 	fileType = toMe.fileType;
@@ -26,6 +31,8 @@ MyDB_Table :: MyDB_Table (MyDB_Table &toMe) {
 		mySchema->getAtts ().push_back (make_pair (a.first, a.second));
 	}
 	rootLocation = toMe.rootLocation;
+	compressed = toMe.compressed;
+	pageFormat = toMe.pageFormat;
 }
 
 MyDB_Table :: MyDB_Table (string name, string storageLocIn, MyDB_SchemaPtr mySchemaIn) {
@@ -36,6 +43,8 @@ MyDB_Table :: MyDB_Table (string name, string storageLocIn, MyDB_SchemaPtr mySch
 	fileType = "heap";
 	sortAtt = "none";
 	rootLocation = -1;
+	compressed = false;
+	pageFormat = MYDB_PAGE_FORMAT;
 }
 
 MyDB_Table :: MyDB_Table (string name, string storageLocIn, MyDB_SchemaPtr mySchemaIn, string fileTypeIn, string sortAttIn) {
@@ -46,6 +55,8 @@ MyDB_Table :: MyDB_Table (string name, string storageLocIn, MyDB_SchemaPtr mySch
 	fileType = fileTypeIn;
 	sortAtt = sortAttIn;
 	rootLocation = -1;
+	compressed = false;
+	pageFormat = MYDB_PAGE_FORMAT;
 }
 
 MyDB_Table :: ~MyDB_Table () {}
@@ -78,6 +89,113 @@ size_t MyDB_Table :: getTupleCount () {
         return count;
 }
 
+vector <MyDB_AttStatsPtr> &MyDB_Table :: getAttStats () {
+	return attStats;
+}
+
+MyDB_AttStatsPtr MyDB_Table :: getAttStats (string forMe) {
+	auto res = mySchema->getAttByName (forMe);
+	if (res.first == -1 || res.first >= (int) attStats.size ())
+		return nullptr;
+	return attStats[res.first];
+}
+
+void MyDB_Table :: setAttStats (vector <MyDB_AttStatsPtr> &toMe) {
+	attStats = toMe;
+}
+
+vector <string> &MyDB_Table :: getBloomAtts () {
+	return bloomAtts;
+}
+
+void MyDB_Table :: setBloomAtts (vector <string> &toMe) {
+	bloomAtts = toMe;
+}
+
+bool MyDB_Table :: isCompressed () {
+	return compressed;
+}
+
+void MyDB_Table :: setCompressed (bool toMe) {
+	compressed = toMe;
+}
+
+int MyDB_Table :: getPageFormat () {
+	return pageFormat;
+}
+
+void MyDB_Table :: setPageFormat (int toMe) {
+	pageFormat = toMe;
+}
+
+// the fraction of the records with the attribute compared to the literal as given
+static double attVsLiteralSelectivity (MyDB_AttStatsPtr stats, MyDB_ExprOp cmp, MyDB_ExprPtr literal) {
+
+	double equal, less;
+	if (literal->getOp () == stringOp) {
+		equal = stats->fractionEqual (literal->getString ());
+		less = stats->fractionLess (literal->getString ());
+	} else {
+		double val = (literal->getOp () == intOp) ? literal->getInt () : literal->getDouble ();
+		equal = stats->fractionEqual (val);
+		less = stats->fractionLess (val);
+	}
+
+	if (cmp == eqOp)
+		return equal;
+	else if (cmp == neqOp)
+		return 1.0 - equal;
+	else if (cmp == ltOp)
+		return less;
+	else
+		return max (0.0, 1.0 - less - equal);
+}
+
+static double estimateSelectivity (MyDB_Table &forMe, MyDB_ExprPtr pred) {
+
+	MyDB_ExprOp op = pred->getOp ();
+	if (op == andOp)
+		return estimateSelectivity (forMe, pred->getLHS ()) * estimateSelectivity (forMe, pred->getRHS ());
+
+	if (op == orOp) {
+		double lhs = estimateSelectivity (forMe, pred->getLHS ());
+		double rhs = estimateSelectivity (forMe, pred->getRHS ());
+		return lhs + rhs - lhs * rhs;
+	}
+
+	if (op == notOp)
+		return 1.0 - estimateSelectivity (forMe, pred->getLHS ());
+
+	if (op == boolOp)
+		return pred->getBool () ? 1.0 : 0.0;
+
+	// a comparison of an attribute with a literal is estimated using the attribute's statistics
+	int whichAtt;
+	MyDB_ExprOp cmp;
+	MyDB_ExprPtr literal;
+	if (pred->isAttVsLiteral (whichAtt, cmp, literal) && whichAtt < (int) forMe.getAttStats ().size ())
+		return attVsLiteralSelectivity (forMe.getAttStats ()[whichAtt], cmp, literal);
+
+	// and the equality of two attributes uses the number of distinct values
+	if (op == eqOp && pred->getLHS ()->getOp () == attOp && pred->getRHS ()->getOp () == attOp) {
+		size_t distinct = 1;
+		for (MyDB_ExprPtr att : {pred->getLHS (), pred->getRHS ()}) {
+			int which = att->getAttIndex ();
+			if (which < (int) forMe.getAttStats ().size ())
+				distinct = max (distinct, forMe.getAttStats ()[which]->getDistinctValues ());
+		}
+		return 1.0 / distinct;
+	}
+
+	return 1.0 / 3.0;
+}
+
+double MyDB_Table :: estimateSelectivity (string predicate) {
+	MyDB_ExprPtr pred = MyDB_Expr :: parse (predicate);
+	pred->resolve (mySchema);
+	return :: estimateSelectivity (*this, pred);
+}
+
 void MyDB_Table :: setRootLocation (int toMe) {
 	rootLocation = toMe;
 }
@@ -117,7 +235,10 @@ map <string, MyDB_TablePtr> MyDB_Table :: getAllTables (MyDB_CatalogPtr fromMe)
 	return returnVal;
 }
 
-MyDB_Table :: MyDB_Table () {}
+MyDB_Table :: MyDB_Table () {
+	compressed = false;
+	pageFormat = MYDB_PAGE_FORMAT;
+}
 
 int MyDB_Table :: lastPage () {
 	return last;
@@ -161,6 +282,30 @@ bool MyDB_Table :: fromCatalog (string tableNameIn, MyDB_CatalogPtr catalog) {
 	// get the number of tuples
 	catalog->getInt (tableName + ".numTuples", count);
 
+	// and the attributes with Bloom filters
+	bloomAtts.clear ();
+	catalog->getStringList (tableName + ".bloomAtts", bloomAtts);
+
+	// and whether the pages are compressed
+	int isCompressed = 0;
+	catalog->getInt (tableName + ".compressed", isCompressed);
+	compressed = isCompressed;
+
+	// and the page layout; a table from before the version was kept is in version 1
+	pageFormat = 1;
+	catalog->getInt (tableName + ".pageFormat", pageFormat);
+
+	// and the statistics for each attribute, if there are any
+	attStats.clear ();
+	for (auto &a : mySchema->getAtts ()) {
+		MyDB_AttStatsPtr stats = make_shared <MyDB_AttStats> ();
+		if (!stats->fromCatalog (tableName + ".stats." + a.first, catalog)) {
+			attStats.clear ();
+			break;
+		}
+		attStats.push_back (stats);
+	}
+
 	return true;
 }
 
@@ -203,11 +348,24 @@ void MyDB_Table :: putInCatalog (MyDB_CatalogPtr catalog) {
 	// and the sort att
 	catalog->putString (tableName + ".sortAtt", sortAtt);
 
+	// and the attributes with Bloom filters
+	catalog->putStringList (tableName + ".bloomAtts", bloomAtts);
+
+	// and whether the pages are compressed
+	catalog->putInt (tableName + ".compressed", compressed);
+
+	// and the page layout
+	catalog->putInt (tableName + ".pageFormat", pageFormat);
+
 	// remember the last page in the file
         catalog->putInt (tableName + ".lastPage", last);
 
 	// and add the schema in 
 	mySchema->putInCatalog (tableName, catalog);	
+
+	// along with the statistics for each attribute
+	for (size_t i = 0; i < attStats.size () && i < mySchema->getAtts ().size (); i++)
+		attStats[i]->putInCatalog (tableName + ".stats." + mySchema->getAtts ()[i].first, catalog);
 }
 
 MyDB_SchemaPtr MyDB_Table :: getSchema () {
@@ -37,9 +37,18 @@ public:
 	// return all records with a key value in the range [low, high], inclusive
         MyDB_RecordIteratorAltPtr getSortedRangeIteratorAlt (MyDB_AttValPtr low, MyDB_AttValPtr high);
 	
+	// the leaf pages that might have records with a key value in the range [low, high], in the
+	// order that getRangeIteratorAlt () goes through them, along with a function that says if the
+	// record checkMe has a key in the range; these are used to split up a range among threads
+	vector <MyDB_PageReaderWriter> getRangePages (MyDB_AttValPtr low, MyDB_AttValPtr high);
+	function <bool ()> getRangeCheck (MyDB_RecordPtr checkMe, MyDB_AttValPtr low, MyDB_AttValPtr high);
+
 	// append a record to the B+-Tree
 	void append (MyDB_RecordPtr appendMe);
 
+	// append the records in a page image to the B+-Tree, one at a time
+	void appendPageImage (void *page);
+
 	// print the contents of the tree to the screen
 	void printTree ();
 
@@ -0,0 +1,62 @@
+
+#ifndef PAX_PAGE_REC_ITER_ALT_H
+#define PAX_PAGE_REC_ITER_ALT_H
+
+#include "MyDB_PageReaderWriter.h"
+#include "MyDB_Record.h"
+#include "MyDB_RecordIteratorAlt.h"
+#include <vector>
+
+using namespace std;
+
+// This iterates through the records on a PAXPage.  getColumnBatch () reads the values right out
+// of the page's minipages; the first time that whole records are asked for (via getCurrent (),
+// getCurrentPointer (), advance () or getBatch ()), the records are written into a RegularPage,
+// and the iteration goes on over that page
+class MyDB_PAXPageRecIteratorAlt : public MyDB_RecordIteratorAlt {
+
+public:
+
+        // load the current record into the parameter
+        void getCurrent (MyDB_RecordPtr intoMe) override;
+
+        // after a call to advance (), a call to getCurrentPointer () will get the address
+        // of the record.  At a later time, it is then possible to reconstitute the record
+        // by calling MyDB_Record.fromBinary (obtainedPointer)... ASSUMING that the page that
+        // the record is located on has not been swapped out
+        void *getCurrentPointer () override;
+
+        // advance to the next record... returns true if there is a next record, and
+        // false if there are no more records to iterate over.  Not that this cannot
+        // be called until after getCurrent () has been called
+        bool advance () override;
+
+	// gets the records' locations on the RegularPage version of the page
+	int getBatch (void **intoMe, int maxRecs) override;
+
+	// gets the locations of the values from the minipages
+	int getColumnBatch (vector <int> &whichAtts, vector <void **> &intoMe, int maxRecs) override;
+
+	// destructor and contructor
+	MyDB_PAXPageRecIteratorAlt (MyDB_PageReaderWriter myPageIn);
+	~MyDB_PAXPageRecIteratorAlt ();
+
+private:
+
+	// the iterator over the RegularPage version of the page, which is made the first time
+	// that it is needed
+	MyDB_RecordIteratorAltPtr getRowIter ();
+
+	MyDB_PageReaderWriter myPage;
+	MyDB_PageReaderWriter rows;
+	MyDB_RecordIteratorAltPtr rowIter;
+
+	// the next record that getColumnBatch () returns; for the attributes whose values are
+	// written with their sizes, this has the record that each was last read up to, and where
+	// that record's value is in the minipage
+	int nextRec;
+	vector <int> cursorRec;
+	vector <char *> cursorPos;
+};
+
+#endif
@@ -39,15 +39,33 @@ public:
         // be called until after getCurrent () has been called
         bool advance () override;
 
+	// gets a batch from the current page, moving on to the next page when it runs dry; the page
+	// is pinned while its records are being handed out
+	int getBatch (void **intoMe, int maxRecs) override;
+
+	// likewise, gets the locations of values from the current page
+	int getColumnBatch (vector <int> &whichAtts, vector <void **> &intoMe, int maxRecs) override;
+
 	// destructor and contructor
 	MyDB_PageListIteratorAlt (vector <MyDB_PageReaderWriter> &forUs);
 	~MyDB_PageListIteratorAlt ();
 
 private:
 
+	// makes myIter an iterator over a pinned copy of the current page, if it is not already
+	void pinCurPage ();
+
+	// unpins the page that pinCurPage () last pinned, if it was not pinned to begin with
+	void unpinLastPage ();
+
 	MyDB_RecordIteratorAltPtr myIter;
 	vector <MyDB_PageReaderWriter> forUs;
 	int curPage;
+	bool curPagePinned;
+
+	// the pinned copy of the current page, and whether we are the ones who pinned it
+	MyDB_PageReaderWriter pinnedPage;
+	bool mustUnpin;
 };
 
 #endif
@@ -38,7 +38,7 @@ public:
 				if (!lowComparator () && !highComparator ()) {
 					return true;
 				}
-			} else if (curPage == forUs.size () - 1) {
+			} else if (curPage == (int) forUs.size () - 1) {
 				return false;
 			} else {
 				curPage++;
@@ -49,6 +49,44 @@ public:
 		}
 	}
 
+	// gets a batch of the records on the current (pinned) page that fall in the range;
+	// once a page is used up, it is unpinned (if it was not pinned before we got to it), and
+	// our handle to it is dropped
+	int getBatch (void **intoMe, int maxRecs) override {
+		while (true) {
+			if (batchIter == nullptr) {
+				myIter = nullptr;
+				mustUnpin = !forUs[curPage].isPinned ();
+				pinnedPage = forUs[curPage].getPinned ();
+				batchIter = pinnedPage.getIteratorAlt ();
+			}
+
+			int numRecs = batchIter->getBatch (intoMe, maxRecs);
+			if (numRecs == 0) {
+				if (curPage == (int) forUs.size () - 1)
+					return 0;
+				batchIter = nullptr;
+				unpinLastPage ();
+				pinnedPage = MyDB_PageReaderWriter ();
+				forUs[curPage] = MyDB_PageReaderWriter ();
+				curPage++;
+				if (sortOrNot)
+					forUs[curPage].sortInPlace (comparator, lhs, rhs);	
+				continue;
+			}
+
+			// keep only the guys that are in range
+			int numKept = 0;
+			for (int i = 0; i < numRecs; i++) {
+				myRec->fromBinary (intoMe[i]);
+				if (!lowComparator () && !highComparator ()) 
+					intoMe[numKept++] = intoMe[i];
+			}
+			if (numKept > 0)
+				return numKept;
+		}
+	}
+
 	// destructor and contructor
 	MyDB_PageListIteratorSelfSortingAlt (vector <MyDB_PageReaderWriter> &forUsIn, MyDB_RecordPtr lhsIn, 
 		MyDB_RecordPtr rhsIn, function <bool ()> comparatorIn, MyDB_RecordPtr myRecIn, function <bool ()> lowComparatorIn, 
@@ -69,13 +107,26 @@ public:
 		if (sortOrNot)
 			forUs[curPage].sortInPlace (comparator, lhs, rhs);	
 		myIter = forUsIn[curPage].getIteratorAlt ();
+		mustUnpin = false;
 	}
 
-	~MyDB_PageListIteratorSelfSortingAlt () {}
+	~MyDB_PageListIteratorSelfSortingAlt () {
+		unpinLastPage ();
+	}
 
 private:
 
+	// unpins the page that getBatch () last pinned, if it was not pinned to begin with
+	void unpinLastPage () {
+		if (mustUnpin)
+			pinnedPage.unpin ();
+		mustUnpin = false;
+	}
+
 	MyDB_RecordIteratorAltPtr myIter;
+	MyDB_RecordIteratorAltPtr batchIter;
+	MyDB_PageReaderWriter pinnedPage;
+	bool mustUnpin;
 	vector <MyDB_PageReaderWriter> forUs;
 	MyDB_RecordPtr lhs, rhs;
 	function <bool ()> comparator;
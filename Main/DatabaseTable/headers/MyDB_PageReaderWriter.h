@@ -42,6 +42,20 @@ public:
 	// constructor for an anonymous page that can be pinned, if desired
 	MyDB_PageReaderWriter (bool pinned, MyDB_BufferManager &parent);
 
+	// returns a reader/writer for this same page that keeps it pinned in RAM for as
+	// long as the returned object (or an iterator obtained from it) is around.  Note that
+	// the page stays pinned until all of the handles to it are gone, including unpinned ones
+	// such as this one; see unpin ()
+	MyDB_PageReaderWriter getPinned ();
+
+	// true if the page is pinned in RAM
+	bool isPinned ();
+
+	// unpins the page now, even if there are handles to it; this is for someone who pinned a
+	// page that was not pinned before (see isPinned ()), and is done with it, but cannot get rid
+	// of the other handles (as with a list of pages that is being iterated over)
+	void unpin ();
+
 	// empties out the contents of this page, so that it has no records in it
 	// the type of the page is set to MyDB_PageType :: RegularPage
 	void clear ();	
@@ -59,7 +73,7 @@ public:
 	friend MyDB_RecordIteratorAltPtr getIteratorAlt (vector <MyDB_PageReaderWriter> &forUs);
 
 	// appends a record to this page... return false is the append fails because
-	// there is not enough space on the page; otherwise, return true
+	// there is not enough space on the page (or it is a PAXPage); otherwise, return true
 	bool append (MyDB_RecordPtr appendMe);
 
 	// appends a record to this page... return a pointer to the location of where
@@ -67,6 +81,78 @@ public:
 	// a nullptr
 	void *appendAndReturnLocation (MyDB_RecordPtr appendMe);
 
+	// these are just like clear () and append (), but they work on a page image that is not in
+	// the buffer manager (for example, one that is being filled while a table is loaded)
+	static void clear (void *page, size_t pageSize);
+	static bool append (void *page, size_t pageSize, MyDB_RecordPtr appendMe);
+
+	// the first byte of the first record in a RegularPage image, and the byte just past the last
+	// one; the records are back-to-back in between, in the order that they were appended in
+	static pair <void *, void *> getRecordBytes (void *page);
+
+	// a page ends with its slot array: the very last bytes hold the number of records on the
+	// page, and just before that is the offset of each record from the start of the page, with
+	// the first slot closest to the end.  The slots are in the order that the records are
+	// iterated in, which is the order that they were appended in unless the page was sorted
+	static inline unsigned *getSlotCount (void *page, size_t pageSize) {
+		return ((unsigned *) (((char *) page) + pageSize)) - 1;
+	}
+
+	static inline int getNumRecords (void *page, size_t pageSize) {
+		return (int) *getSlotCount (page, pageSize);
+	}
+
+	static inline void *getRecord (void *page, size_t pageSize, int whichSlot) {
+		return ((char *) page) + getSlotCount (page, pageSize)[-1 - whichSlot];
+	}
+
+	// the number of records on this page, and the location of the record in the given slot; a
+	// record stays in the same slot until the page is sorted or cleared, so the page number and
+	// the slot identify it
+	int getNumRecords ();
+	void *getRecord (int whichSlot);
+
+	// does a binary search over a sorted page: returns the first slot for which isIt () returns
+	// true once the record in that slot has been loaded into loadMe, assuming that isIt () is
+	// false for all of the records before it and true for all of the ones after; if it is
+	// never true, then this returns getNumRecords ()
+	int findFirst (function <bool ()> isIt, MyDB_RecordPtr loadMe);
+
+	// a PAXPage holds the same records as a RegularPage, but the values of each attribute are
+	// together, in a "minipage" for the attribute.  After the page header comes the number of
+	// attributes, and then the offset of each attribute's minipage along with the number of
+	// bytes that each of its values takes up (counting the size at the front of the value).  If
+	// the values on the page do not all take the same amount of space, this is zero, and the
+	// values are written just as they are in a record; otherwise, only the values' contents are
+	// written, one after the other.  The number of records is at the end of the page, just as on
+	// a RegularPage, but there are no slots
+	static inline unsigned *getPAXAtts (void *page) {
+		return (unsigned *) (((char *) page) + 2 * sizeof (size_t));
+	}
+
+	static inline unsigned getPAXOffset (void *page, int whichAtt) {
+		return getPAXAtts (page)[1 + 2 * whichAtt];
+	}
+
+	static inline unsigned getPAXValueSize (void *page, int whichAtt) {
+		return getPAXAtts (page)[2 + 2 * whichAtt];
+	}
+
+	// re-writes a full RegularPage image as a PAXPage image, keeping the records in the same
+	// order; if the PAXPage version would not fit, the page is left alone and false is returned
+	static bool toPAX (void *page, size_t pageSize);
+	bool toPAX ();
+
+	// writes the records on a PAXPage image into a RegularPage image
+	static void fromPAX (void *pax, void *rows, size_t pageSize);
+
+	// the records on this page in a RegularPage; this is just the page itself, unless it is a
+	// PAXPage, in which case they are written into a new, pinned anonymous page
+	MyDB_PageReaderWriter getRows ();
+
+	// overwrites the contents of this page with a page image
+	void copyFrom (void *page);
+
 	// gets the type of this page... this is just a value from an ennumeration
 	// that is stored within the page
 	MyDB_PageType getType ();
@@ -74,13 +160,14 @@ public:
 	// sets the type of the page
 	void setType (MyDB_PageType toMe);
 	
-	// sorts the contents of the page... the boolean lambda that is sent into
+	// sorts the contents of the page (a PAXPage is written into a RegularPage first)... the boolean lambda that is sent into
 	// this function must check to see if the contents of the record pointed to
 	// by lhs are less than the contens of the record pointed to by rhs... typically,
 	// this lambda would have been created via a call to buildRecordComparator
 	MyDB_PageReaderWriterPtr sort (function <bool ()> comparator, MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs);
 
-	// like the above, except that the sorting is done in place, on the page
+	// like the above, except that the sorting is done in place, on a RegularPage; only the slot
+	// array is re-ordered, and the records themselves are not moved
 	void sortInPlace (function <bool ()> comparator, MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs);
 
 	// returns the page size
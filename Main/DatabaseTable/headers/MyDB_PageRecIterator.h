@@ -35,14 +35,16 @@ public:
         void *getCurrentPointer () override;
 
 	// destructor and contructor
-	MyDB_PageRecIterator (MyDB_PageHandle myPageIn, MyDB_RecordPtr myRecIn); 
+	MyDB_PageRecIterator (MyDB_PageHandle myPageIn, size_t pageSizeIn, MyDB_RecordPtr myRecIn); 
 	~MyDB_PageRecIterator ();
 
 private:
 
-	int bytesConsumed;
+	// the slot of the record that getNext () loads next
+	int whichSlot;
 	MyDB_PageHandle myPage;
 	MyDB_RecordPtr myRec;
+	size_t pageSize;
 	
 };
 
@@ -35,15 +35,21 @@ public:
         // be called until after getCurrent () has been called
         bool advance () override;
 
+	// reads the records' locations from the page's slot array
+	int getBatch (void **intoMe, int maxRecs) override;
+
 	// destructor and contructor
-	MyDB_PageRecIteratorAlt (MyDB_PageHandle myPageIn); 
+	MyDB_PageRecIteratorAlt (MyDB_PageHandle myPageIn, size_t pageSizeIn); 
 	~MyDB_PageRecIteratorAlt ();
 
 private:
 
-	int bytesConsumed;
-	int nextRecSize;
+	// the slot of the current record, and how far advance () moves from it (the first call
+	// to advance () goes to the first record, so it does not move at all)
+	int whichSlot;
+	int step;
 	MyDB_PageHandle myPage;
+	size_t pageSize;
 };
 
 #endif
@@ -3,9 +3,13 @@
 #define REC_ITER_ALT_H
 
 #include <memory>
+#include <vector>
 #include "MyDB_Record.h"
 using namespace std;
 
+// the largest number of record addresses that an operator asks for in one call to getBatch ()
+#define MAX_BATCH_SIZE 1024
+
 // This pure virtual class is used to iterate through the records in a page or file
 // Instances of this class will be created via calls to MyDB_PageReaderWriter.getIteratorAlt ()
 // or MyDB_FileReaderWriter.getIteratorAlt ().  
@@ -31,6 +35,42 @@ public:
 	// be called until after getCurrent () has been called
 	virtual bool advance () = 0;
 
+	// writes the addresses of up to maxRecs of the next records into intoMe, and returns
+	// the number written; zero means that there are no more records.  Each address can be
+	// passed to MyDB_Record.fromBinary ().  An iterator over a table or over a list of pages
+	// keeps the page holding a batch pinned, so the addresses stay good until the next call to
+	// getBatch (); an iterator over a single page (MyDB_PageReaderWriter.getIteratorAlt ()) does
+	// not pin it, so that page should be pinned by the caller.  A caller should use either
+	// getBatch () or advance ()/getCurrent () on an iterator, not both
+	virtual int getBatch (void **intoMe, int maxRecs) {
+		int numRecs = 0;
+		while (numRecs < maxRecs && advance ())
+			intoMe[numRecs++] = getCurrentPointer ();
+		return numRecs;
+	}
+
+	// like getBatch (), except that rather than the address of each record, this gets the address
+	// of each of the listed attributes' values (the attributes are given by their positions in
+	// the schema, in increasing order): intoMe[k][i] is set to the address of the i^th record's
+	// value for the attribute whichAtts[k], just past the size at the front of the value.  On a
+	// PAXPage, the values are read without putting the records together
+	virtual int getColumnBatch (vector <int> &whichAtts, vector <void **> &intoMe, int maxRecs) {
+		void *recs[MAX_BATCH_SIZE];
+		int numRecs = getBatch (recs, maxRecs < MAX_BATCH_SIZE ? maxRecs : MAX_BATCH_SIZE);
+		for (int i = 0; i < numRecs; i++) {
+
+			// skip the record size, and then hop from attribute to attribute
+			char *pos = ((char *) recs[i]) + sizeof (short);
+			int whichAtt = 0;
+			for (size_t k = 0; k < whichAtts.size (); k++) {
+				for (; whichAtt < whichAtts[k]; whichAtt++)
+					pos += *((short *) pos);
+				intoMe[k][i] = pos + sizeof (short);
+			}
+		}
+		return numRecs;
+	}
+
 	// destructor and contructor
 	MyDB_RecordIteratorAlt () {};
 	virtual ~MyDB_RecordIteratorAlt () {};
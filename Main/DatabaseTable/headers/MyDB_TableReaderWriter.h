@@ -19,6 +19,7 @@
 #include "MyDB_RecordIterator.h"
 #include "MyDB_RecordIteratorAlt.h"
 #include "MyDB_Table.h"
+#include "MyDB_ZoneMap.h"
 #include <set>
 #include <vector>
 
@@ -39,12 +40,22 @@ public:
 	// be modified independently of the original
 	MyDB_TableReaderWriter (MyDB_TableReaderWriterPtr fromMe);
 
+	// if the table has Bloom filters (see MyDB_Table.getBloomAtts ()), then the zones are
+	// written to a file next to the table's file when the last reader/writer for the table
+	// goes away, so that they can be read back the next time the table is opened
+	virtual ~MyDB_TableReaderWriter ();
+
 	// gets an empty record from this table
 	MyDB_RecordPtr getEmptyRecord ();
 
 	// append a record to the table
 	virtual void append (MyDB_RecordPtr appendMe);
 
+	// append all of the records in a page image (filled using MyDB_PageReaderWriter :: append ())
+	// to the table; the image is copied into a new page at the end of the table (or into the last
+	// page, if it is empty)
+	virtual void appendPageImage (void *page);
+
 	// return an itrator over this table... each time returnVal->next () is
 	// called, the resulting record will be placed into the record pointed to
 	// by iterateIntoMe
@@ -52,33 +63,62 @@ public:
 
         // gets an instance of an alternate iterator over the table... this is an
         // iterator that has the alternate getCurrent ()/advance () interface
-        MyDB_RecordIteratorAltPtr getIteratorAlt ();
+        virtual MyDB_RecordIteratorAltPtr getIteratorAlt ();
 
 	// gets an instance of an alternate iterator over the page; this iterator
 	// works on a range of pages in the file, and iterates from lowPage through
 	// highPage inclusive
-	MyDB_RecordIteratorAltPtr getIteratorAlt (int lowPage, int highPage);
+	virtual MyDB_RecordIteratorAltPtr getIteratorAlt (int lowPage, int highPage);
+
+	// gets an iterator over the whole table that does not read the pages for which
+	// readPage () returns false; this is used with getPageFilter ()
+	virtual MyDB_RecordIteratorAltPtr getIteratorAlt (function <bool (int)> readPage);
+
+	// returns a function that says if a page might have a record that is accepted by the given
+	// selection predicate (either as a string, or resolved over the table's schema), using the
+	// zone map that is kept for the table's pages (see MyDB_ZoneMap).  The zones are kept
+	// up-to-date by append () and loadFromTextFile ()
+	function <bool (int)> getPageFilter (string selectionPredicate);
+	function <bool (int)> getPageFilter (MyDB_ExprPtr selectionPredicate);
+
+	// says how many pages the last page filter skipped (see MyDB_ZoneMap.getSkipCounts ())
+	string getSkipCounts ();
 
 	// load a text file into this table... this returns a pair where the first
 	// entry is a list of (approximate) distinct value counts for each of the
 	// attributes in the table, and the second entry is the number of tuples that
 	// have been loaded into the table
+	//
+	// The file is parsed by several threads at once, each working on a different part
+	// of the file and filling its own page images; the images are then appended to the
+	// table (using appendPageImage ()) in the same order as the lines in the file
+	//
+	// While the file is loaded, the statistics for each attribute (see MyDB_AttStats) are
+	// collected, and are stored in the table object.  If a dictionary-encoded string attribute
+	// has too many distinct values (see MyDB_StringDictionary), the load stops, the table is
+	// left empty, and the counts are all zero
 	pair <vector <size_t>, size_t> loadFromTextFile (string fromMe);
 
+	// re-computes the statistics for each attribute from a sample of (at most 1024) pages of
+	// the file, which are read by several threads at once.  The statistics, along with the
+	// estimated number of distinct values of each attribute and the estimated number of
+	// records, are stored in the table object
+	void analyze ();
+
 	// dump the contents of this table into a text file
 	void writeIntoTextFile (string toMe);
 
 	// access the i^th page in this file
-	MyDB_PageReaderWriter operator [] (size_t i);
+	virtual MyDB_PageReaderWriter operator [] (size_t i);
 
 	// access the i^th page in this file... getting a pinned version of the page
-	MyDB_PageReaderWriter getPinned (size_t i);
+	virtual MyDB_PageReaderWriter getPinned (size_t i);
 
 	// access the last page in the file
-	MyDB_PageReaderWriter last ();
+	virtual MyDB_PageReaderWriter last ();
 
 	// get the number of pages in the file
-	int getNumPages ();
+	virtual int getNumPages ();
 
 	// get access to the buffer manager	
 	MyDB_BufferManagerPtr getBufferMgr ();
@@ -89,6 +129,12 @@ public:
 	// gets the table object for this guy
 	MyDB_TablePtr getTable ();
 
+protected:
+
+	// makes a reader/writer for a table that has no file; this is for a subclass that keeps the
+	// table's pages somewhere else (see MyDB_TempTableReaderWriter), or that does not keep them
+	MyDB_TableReaderWriter (MyDB_SchemaPtr mySchema, MyDB_BufferManagerPtr myBuffer);
+
 private:
 
 	friend class MyDB_PageReaderWriter;
@@ -96,6 +142,13 @@ private:
 	MyDB_TablePtr forMe;
 	MyDB_BufferManagerPtr myBuffer;
 	shared_ptr <MyDB_PageReaderWriter> lastPage;
+	MyDB_ZoneMapPtr zones;
+
+	// where the zones are saved, and a hash of the first page, the number of pages, and the
+	// number of records on each page, which is used to check that the saved zones are for the
+	// current contents of the file
+	string getZoneFileName ();
+	size_t getFingerprint ();
 	
 };
 
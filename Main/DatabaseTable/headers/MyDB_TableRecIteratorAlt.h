@@ -36,18 +36,39 @@ public:
         // be called until after getCurrent () has been called
         bool advance () override;
 
+	// gets a batch of records from the current page, which is re-obtained pinned the
+	// first time that a batch is taken from it; DirectoryPages are skipped
+	int getBatch (void **intoMe, int maxRecs) override;
+
+	// just like getBatch (), but this gets the locations of values from the current page
+	int getColumnBatch (vector <int> &whichAtts, vector <void **> &intoMe, int maxRecs) override;
+
 	// destructor and contructor
 	MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn);
 	~MyDB_TableRecIteratorAlt ();
 	MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn, int lowPage, int highPage);
 
+	// this one iterates over the whole table, but it does not read the pages for which
+	// readPage () returns false
+	MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn, function <bool (int)> readPage);
+
 private:
 
+	// used by getBatch () and getColumnBatch (): re-obtains the current page pinned, if this
+	// has not yet been done, and sets myIter to iterate over it (or to nullptr, if it is a
+	// DirectoryPage or a page that is not read)
+	void pinCurPage ();
+
+	// gets an iterator over the current page, or nullptr if the page is not read
+	MyDB_RecordIteratorAltPtr getPageIter ();
+
 	MyDB_RecordIteratorAltPtr myIter;
 	int curPage;
 	int highPage;	
+	bool curPagePinned;
 	MyDB_TableReaderWriter &myParent;
 	MyDB_TablePtr myTable;
+	function <bool (int)> readPage;
 };
 
 #endif
@@ -0,0 +1,44 @@
+
+#ifndef TEMP_TABLE_RW_H
+#define TEMP_TABLE_RW_H
+
+#include "MyDB_PageReaderWriter.h"
+#include "MyDB_TableReaderWriter.h"
+#include <vector>
+
+// This is a table whose pages are anonymous pages from the buffer manager, rather than the pages
+// of a file.  It is used to hold an intermediate result that has to be all there before it can
+// be used (for example, one side of a SortMergeJoin whose records are pushed to it), so that the
+// result does not need a file of its own: if the buffer fills up, the pages are written to the
+// buffer manager's temporary file, and they are gone once the table goes away.
+//
+// The table can be used anywhere that a MyDB_TableReaderWriter can be read from.  None of the
+// pages has a zone, so every page filter reads all of them
+class MyDB_TempTableReaderWriter;
+typedef shared_ptr <MyDB_TempTableReaderWriter> MyDB_TempTableReaderWriterPtr;
+
+class MyDB_TempTableReaderWriter : public MyDB_TableReaderWriter {
+
+public:
+
+	// makes an empty table with the given schema
+	MyDB_TempTableReaderWriter (MyDB_SchemaPtr mySchema, MyDB_BufferManagerPtr myBuffer);
+
+	// these are just like in MyDB_TableReaderWriter
+	void append (MyDB_RecordPtr appendMe);
+	void appendPageImage (void *page);
+	MyDB_RecordIteratorAltPtr getIteratorAlt ();
+	MyDB_RecordIteratorAltPtr getIteratorAlt (int lowPage, int highPage);
+	MyDB_RecordIteratorAltPtr getIteratorAlt (function <bool (int)> readPage);
+	MyDB_PageReaderWriter operator [] (size_t i);
+	MyDB_PageReaderWriter getPinned (size_t i);
+	MyDB_PageReaderWriter last ();
+	int getNumPages ();
+
+private:
+
+	// the pages, which are not pinned; there is always at least one, as with a table in a file
+	vector <MyDB_PageReaderWriter> pages;
+};
+
+#endif
@@ -0,0 +1,139 @@
+
+#ifndef ZONE_MAP_H
+#define ZONE_MAP_H
+
+#include "MyDB_Expr.h"
+#include "MyDB_Record.h"
+#include "MyDB_Schema.h"
+#include <functional>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// This keeps, for each page of a table, the smallest and the largest value on the page of each
+// of the table's int, date and double attributes.  Given a selection predicate, it is used to
+// find the pages that cannot have any record that is accepted by the predicate, so that a scan
+// need not read them: the predicate's conjuncts that compare one of these attributes with a
+// literal, such as < ([l_quantity], int[5]), are checked against each page's range.
+//
+// For a string attribute, the range is over the first eight bytes of the values (see
+// getPrefix ()), which keeps the zones small; strings that share those bytes cannot be told
+// apart, so a page is only skipped if the literal's prefix is outside of the page's range.
+// This is enough for dates that are kept as strings, as in > ([l_shipdate], string[1998-06-01]).
+//
+// The table can also ask for a Bloom filter on some of its attributes (see MyDB_Table.
+// getBloomAtts ()); each page then gets a filter holding the hashes of the attribute's values
+// on the page, and a page is not read if an == between the attribute and a literal is and-ed
+// into the predicate, but the literal's hash is not in the filter.  This helps when the values
+// are not clustered, so that the ranges are of no use.
+//
+// A page only has a zone if all of the records on it went through add (); the others (for
+// example, the pages of a file that was written before the table was opened) are always read
+class MyDB_ZoneMap;
+typedef shared_ptr <MyDB_ZoneMap> MyDB_ZoneMapPtr;
+
+class MyDB_ZoneMap {
+
+public:
+
+	// set up an empty zone map for a table with the given schema, with Bloom filters on the
+	// named attributes; each Bloom filter has one bit for every byte on a page
+	MyDB_ZoneMap (MyDB_SchemaPtr mySchema, vector <string> &bloomAtts, size_t pageSize);
+
+	// forgets all of the zones
+	void clear ();
+
+	// gives the page an empty zone; this is done before the first record is added to it
+	void startPage (int whichPage);
+
+	// widens the page's zone so that it takes in the record; nothing happens if the page
+	// does not have a zone
+	void add (int whichPage, MyDB_RecordPtr rec);
+
+	// sets the page's zone to be the same as the zone of fromPage in fromMe (which is a
+	// zone map for a table with the same schema)
+	void copyPage (int whichPage, MyDB_ZoneMap &fromMe, int fromPage);
+
+	// forgets the zone of the page, so that it is always read
+	void forget (int whichPage);
+
+	// returns a function that says if a page might have a record that is accepted by the
+	// predicate, which has been resolved over the table's schema; the function uses this zone
+	// map, so it should not be used after the zone map is gone.  This also starts the counts
+	// of the pages that are skipped over again
+	function <bool (int)> getPageFilter (MyDB_ExprPtr predicate);
+	function <bool (int)> getPageFilter (string predicate);
+
+	// says how many pages the last page filter was asked about, and how many were skipped
+	// because of each range or Bloom filter, as in "2000 pages, skipped 1230 (range l_shipdate:
+	// 1200, bloom l_orderkey: 30)"; this is empty if no pages were skipped
+	string getSkipCounts ();
+
+	// true if any attribute has a range or a Bloom filter; if not, there is nothing to keep
+	bool hasZones ();
+
+	// writes the zones to the given file, or reads them back; fingerprint identifies the
+	// contents of the table, and the zones are only read if it matches the one that they were
+	// written with.  The zone of the last page that was written is not read, since records may
+	// have been added to the page afterwards
+	void save (string fileName, size_t fingerprint);
+	void load (string fileName, size_t fingerprint, int numPages);
+
+	// true if a page has been started or forgotten since the zones were last saved or loaded
+	bool isChanged ();
+
+private:
+
+	// the position of bit number which in the Bloom filter for an attribute on a page
+	inline uint64_t *bloomWord (int whichPage, int whichBloom, size_t which) {
+		return &blooms[(whichPage * bloomAtts.size () + whichBloom) * bloomWords + (which / 64) % bloomWords];
+	}
+
+	MyDB_SchemaPtr mySchema;
+
+	// the attributes with zones, and for each attribute in the schema, its position in
+	// zoneAtts (or -1); an int or date attribute is read with toInt (), a double with toDouble ()
+	vector <int> zoneAtts;
+	vector <int> zoneForAtt;
+	vector <bool> isInt;
+
+	// likewise, the string attributes with zones
+	vector <int> stringZoneAtts;
+	vector <int> stringZoneForAtt;
+
+	// the first eight bytes of a string (padded with zeros), as a number that orders strings
+	// just like MyDB_StringView :: compare () does, except that strings with the same first eight
+	// bytes are equal
+	static uint64_t getPrefix (const char *data, size_t length);
+
+	// likewise, the attributes with Bloom filters, and the number of 64-bit words in each filter
+	vector <int> bloomAtts;
+	vector <int> bloomForAtt;
+	size_t bloomWords;
+
+	// for each page, whether it has a zone; the low and high values of the i^th attribute
+	// with a zone on page p are at position p * zoneAtts.size () + i, and the Bloom filters
+	// for the page come one after the other
+	vector <bool> hasZone;
+	vector <double> lows;
+	vector <double> highs;
+	vector <uint64_t> blooms;
+
+	// the same as lows and highs, for the string attributes with zones
+	vector <uint64_t> stringLows;
+	vector <uint64_t> stringHighs;
+
+	// used by isChanged ()
+	bool changed;
+
+	// used by getSkipCounts ()
+	size_t pagesChecked;
+	vector <size_t> zoneSkips;
+	vector <size_t> stringZoneSkips;
+	vector <size_t> bloomSkips;
+};
+
+#endif
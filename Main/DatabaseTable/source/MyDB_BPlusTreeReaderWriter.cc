@@ -75,6 +75,22 @@ MyDB_RecordIteratorAltPtr MyDB_BPlusTreeReaderWriter :: getRangeIteratorAlt (MyD
 }
 
 
+vector <MyDB_PageReaderWriter> MyDB_BPlusTreeReaderWriter :: getRangePages (MyDB_AttValPtr low, MyDB_AttValPtr high) {
+	vector <MyDB_PageReaderWriter> list;
+	discoverPages (rootLocation, list, low, high);
+	return list;
+}
+
+function <bool ()> MyDB_BPlusTreeReaderWriter :: getRangeCheck (MyDB_RecordPtr checkMe, MyDB_AttValPtr low, MyDB_AttValPtr high) {
+	MyDB_INRecordPtr llow = getINRecord ();
+	llow->setKey (low);
+	MyDB_INRecordPtr hhigh = getINRecord ();
+	hhigh->setKey (high);
+	function <bool ()> lowComparator = buildComparator (checkMe, llow);
+	function <bool ()> highComparator = buildComparator (hhigh, checkMe);
+	return [lowComparator, highComparator] {return !lowComparator () && !highComparator ();};
+}
+
 bool MyDB_BPlusTreeReaderWriter :: discoverPages (int whichPage, vector <MyDB_PageReaderWriter> &list,
 	MyDB_AttValPtr low, MyDB_AttValPtr high) {
 
@@ -133,6 +149,15 @@ bool MyDB_BPlusTreeReaderWriter :: discoverPages (int whichPage, vector <MyDB_Pa
 	return false;
 }
 
+void MyDB_BPlusTreeReaderWriter :: appendPageImage (void *page) {
+	MyDB_RecordPtr rec = getEmptyRecord ();
+	pair <void *, void *> bytes = MyDB_PageReaderWriter :: getRecordBytes (page);
+	for (void *pos = bytes.first; pos < bytes.second;) {
+		pos = rec->fromBinary (pos);
+		append (rec);
+	}
+}
+
 void MyDB_BPlusTreeReaderWriter :: append (MyDB_RecordPtr appendMe) {
 
 	// this file has never had any data in it, because the smallest B+-Tree has two pages
@@ -188,8 +213,6 @@ void MyDB_BPlusTreeReaderWriter :: append (MyDB_RecordPtr appendMe) {
 	}
 }
 
-#define NUM_BYTES_USED *((size_t *) (((char *) temp) + sizeof (size_t)))
-
 MyDB_RecordPtr MyDB_BPlusTreeReaderWriter :: split (MyDB_PageReaderWriter splitMe, MyDB_RecordPtr andMe) {
 	
 	// get a new page for the lower one half
@@ -220,14 +243,10 @@ MyDB_RecordPtr MyDB_BPlusTreeReaderWriter :: split (MyDB_PageReaderWriter splitM
 	// positions of the records
 	vector <void *> positions;
 
-	// compute where all of the records are located
-	int bytesConsumed = sizeof (size_t) * 2;
-	while (bytesConsumed != NUM_BYTES_USED) {
-		void *pos = bytesConsumed + (char *) temp;
-		positions.push_back (pos);
-		void *nextPos = lhs->fromBinary (pos);
-		bytesConsumed += ((char *) nextPos) - ((char *) pos);
-	}
+	// get where all of the records are located from the slot array
+	int numRecords = MyDB_PageReaderWriter :: getNumRecords (temp, splitMe.getPageSize ());
+	for (int i = 0; i < numRecords; i++)
+		positions.push_back (MyDB_PageReaderWriter :: getRecord (temp, splitMe.getPageSize (), i));
 	
 	// and get a postition for the last guy
 	void *spaceForLastGuy = malloc (andMe->getBinarySize ());
@@ -293,38 +312,34 @@ MyDB_RecordPtr MyDB_BPlusTreeReaderWriter :: append (int whichPage, MyDB_RecordP
 		// if we cannot, then split the page
 		return split (pageToAddTo, appendMe);	
 		
-	// we have an internal node, so find the subtree to insert into
+	// we have an internal node, so find the subtree to insert into; the directory records are
+	// kept sorted, so do a binary search for the first one whose key is bigger than the new key
 	} else {
 
-		// iterate through the various subtrees
-		MyDB_RecordIteratorAltPtr temp = pageToAddTo.getIteratorAlt ();
 		MyDB_INRecordPtr otherRec = getINRecord ();
 		function <bool ()> comparator = buildComparator (appendMe, otherRec);
-		while (temp->advance ()) {
-			
-			// see if the new key is less than the key in the directory record
-			temp->getCurrent (otherRec);
-			if (comparator ()) {
-
-				// recursively append
-				auto res = append (otherRec->getPtr (), appendMe);
-
-				// we got a child split
-				if (res != nullptr) {
-
-					// attempt to add the new one	
-					if (pageToAddTo.append (res)) {
-						MyDB_INRecordPtr otherRec = getINRecord ();
-						function <bool ()> comparator = buildComparator (res, otherRec);	
-						pageToAddTo.sortInPlace (comparator, res, otherRec);
-						return nullptr;
-					}
-
-					// could not fit the new one, so split it
-					return split (pageToAddTo, res);
+		int whichSlot = pageToAddTo.findFirst (comparator, otherRec);
+		if (whichSlot < pageToAddTo.getNumRecords ()) {
+
+			// recursively append
+			otherRec->fromBinary (pageToAddTo.getRecord (whichSlot));
+			auto res = append (otherRec->getPtr (), appendMe);
+
+			// we got a child split
+			if (res != nullptr) {
+
+				// attempt to add the new one	
+				if (pageToAddTo.append (res)) {
+					MyDB_INRecordPtr otherRec = getINRecord ();
+					function <bool ()> comparator = buildComparator (res, otherRec);	
+					pageToAddTo.sortInPlace (comparator, res, otherRec);
+					return nullptr;
 				}
-				return nullptr;
+
+				// could not fit the new one, so split it
+				return split (pageToAddTo, res);
 			}
+			return nullptr;
 		}
 	}
 
@@ -0,0 +1,86 @@
+
+#ifndef PAX_PAGE_REC_ITER_ALT_C
+#define PAX_PAGE_REC_ITER_ALT_C
+
+#include "MyDB_PAXPageRecIteratorAlt.h"
+
+void MyDB_PAXPageRecIteratorAlt :: getCurrent (MyDB_RecordPtr intoMe) {
+	getRowIter ()->getCurrent (intoMe);
+}
+
+void *MyDB_PAXPageRecIteratorAlt :: getCurrentPointer () {
+	return getRowIter ()->getCurrentPointer ();
+}
+
+bool MyDB_PAXPageRecIteratorAlt :: advance () {
+	return getRowIter ()->advance ();
+}
+
+int MyDB_PAXPageRecIteratorAlt :: getBatch (void **intoMe, int maxRecs) {
+	return getRowIter ()->getBatch (intoMe, maxRecs);
+}
+
+int MyDB_PAXPageRecIteratorAlt :: getColumnBatch (vector <int> &whichAtts, vector <void **> &intoMe, int maxRecs) {
+
+	char *bytes = (char *) myPage.getBytes ();
+	int numRecs = MyDB_PageReaderWriter :: getNumRecords (bytes, myPage.getPageSize ()) - nextRec;
+	if (numRecs > maxRecs)
+		numRecs = maxRecs;
+	if (numRecs <= 0)
+		return 0;
+
+	if (cursorRec.empty ()) {
+		int numAtts = MyDB_PageReaderWriter :: getPAXAtts (bytes)[0];
+		cursorRec.resize (numAtts, 0);
+		for (int j = 0; j < numAtts; j++)
+			cursorPos.push_back (bytes + MyDB_PageReaderWriter :: getPAXOffset (bytes, j));
+	}
+
+	for (size_t k = 0; k < whichAtts.size (); k++) {
+
+		// if all of the values are the same size, we can go right to them
+		int whichAtt = whichAtts[k];
+		unsigned valueSize = MyDB_PageReaderWriter :: getPAXValueSize (bytes, whichAtt);
+		if (valueSize != 0) {
+			char *pos = bytes + MyDB_PageReaderWriter :: getPAXOffset (bytes, whichAtt) +
+				nextRec * (valueSize - sizeof (short));
+			for (int i = 0; i < numRecs; i++) {
+				intoMe[k][i] = pos;
+				pos += valueSize - sizeof (short);
+			}
+			continue;
+		}
+
+		// otherwise, hop over values using their sizes, starting from where we last were
+		char *pos = cursorPos[whichAtt];
+		for (; cursorRec[whichAtt] < nextRec; cursorRec[whichAtt]++)
+			pos += *((short *) pos);
+		for (int i = 0; i < numRecs; i++) {
+			intoMe[k][i] = pos + sizeof (short);
+			pos += *((short *) pos);
+		}
+		cursorPos[whichAtt] = pos;
+		cursorRec[whichAtt] = nextRec + numRecs;
+	}
+
+	nextRec += numRecs;
+	return numRecs;
+}
+
+MyDB_RecordIteratorAltPtr MyDB_PAXPageRecIteratorAlt :: getRowIter () {
+	if (rowIter == nullptr) {
+		rows = myPage.getRows ();
+		rowIter = rows.getIteratorAlt ();
+	}
+	return rowIter;
+}
+
+MyDB_PAXPageRecIteratorAlt :: MyDB_PAXPageRecIteratorAlt (MyDB_PageReaderWriter myPageIn) {
+	myPage = myPageIn;
+	rowIter = nullptr;
+	nextRec = 0;
+}
+
+MyDB_PAXPageRecIteratorAlt :: ~MyDB_PAXPageRecIteratorAlt () {}
+
+#endif
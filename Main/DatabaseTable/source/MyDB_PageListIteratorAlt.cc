@@ -25,7 +25,7 @@ bool MyDB_PageListIteratorAlt :: advance () {
 	if (myIter->advance ())
 		return true;
 
-	if (curPage == forUs.size () - 1)
+	if (curPage == (int) forUs.size () - 1)
 		return false;
 
 	curPage++;
@@ -33,6 +33,52 @@ bool MyDB_PageListIteratorAlt :: advance () {
 	return advance ();
 }
 
+void MyDB_PageListIteratorAlt :: pinCurPage () {
+
+	// the last page is unpinned first, if it was not pinned before we got to it; forUs still
+	// has a handle to it, so letting go of ours would not be enough
+	if (!curPagePinned) {
+		myIter = nullptr;
+		unpinLastPage ();
+		mustUnpin = !forUs[curPage].isPinned ();
+		pinnedPage = forUs[curPage].getPinned ();
+		myIter = pinnedPage.getIteratorAlt ();
+		curPagePinned = true;
+	}
+}
+
+void MyDB_PageListIteratorAlt :: unpinLastPage () {
+	if (mustUnpin)
+		pinnedPage.unpin ();
+	mustUnpin = false;
+}
+
+int MyDB_PageListIteratorAlt :: getBatch (void **intoMe, int maxRecs) {
+
+	while (true) {
+		pinCurPage ();
+		int numRecs = myIter->getBatch (intoMe, maxRecs);
+		if (numRecs > 0 || curPage == (int) forUs.size () - 1)
+			return numRecs;
+
+		curPage++;
+		curPagePinned = false;
+	}
+}
+
+int MyDB_PageListIteratorAlt :: getColumnBatch (vector <int> &whichAtts, vector <void **> &intoMe, int maxRecs) {
+
+	while (true) {
+		pinCurPage ();
+		int numRecs = myIter->getColumnBatch (whichAtts, intoMe, maxRecs);
+		if (numRecs > 0 || curPage == (int) forUs.size () - 1)
+			return numRecs;
+
+		curPage++;
+		curPagePinned = false;
+	}
+}
+
 void *MyDB_PageListIteratorAlt :: getCurrentPointer () {
 	return myIter->getCurrentPointer ();
 }
@@ -41,8 +87,12 @@ MyDB_PageListIteratorAlt :: MyDB_PageListIteratorAlt (vector <MyDB_PageReaderWri
 	forUs = forUsIn;
 	curPage = 0;
 	myIter = forUsIn[curPage].getIteratorAlt ();		
+	curPagePinned = false;
+	mustUnpin = false;
 }
 
-MyDB_PageListIteratorAlt :: ~MyDB_PageListIteratorAlt () {}
+MyDB_PageListIteratorAlt :: ~MyDB_PageListIteratorAlt () {
+	unpinLastPage ();
+}
 
 #endif
@@ -18,11 +18,15 @@
 #include "MyDB_PageRecIterator.h"
 #include "MyDB_PageRecIteratorAlt.h"
 #include "MyDB_PageListIteratorAlt.h"
+#include "MyDB_PAXPageRecIteratorAlt.h"
 #include "RecordComparator.h"
 
-#define PAGE_TYPE *((MyDB_PageType *) ((char *) myPage->getBytes ()))
-#define NUM_BYTES_USED *((size_t *) (((char *) myPage->getBytes ()) + sizeof (size_t)))
-#define NUM_BYTES_LEFT (pageSize - NUM_BYTES_USED)
+#define PAGE_TYPE_OF(page) *((MyDB_PageType *) ((char *) (page)))
+#define NUM_BYTES_USED_OF(page) *((size_t *) (((char *) (page)) + sizeof (size_t)))
+#define PAGE_TYPE PAGE_TYPE_OF (myPage->getBytes ())
+#define NUM_BYTES_USED NUM_BYTES_USED_OF (myPage->getBytes ())
+#define NUM_RECORDS_OF(page, pageSize) *getSlotCount (page, pageSize)
+#define NUM_RECORDS NUM_RECORDS_OF (myPage->getBytes (), pageSize)
 
 MyDB_PageReaderWriter :: MyDB_PageReaderWriter () {
 	myPage = nullptr;
@@ -64,12 +68,187 @@ MyDB_PageReaderWriter :: MyDB_PageReaderWriter (bool pinned, MyDB_BufferManager
 	clear ();
 }
 
+MyDB_PageReaderWriter MyDB_PageReaderWriter :: getPinned () {
+	MyDB_PageReaderWriter returnVal;
+	returnVal.myPage = myPage->getParent ().getPinnedPage (myPage);
+	returnVal.pageSize = pageSize;
+	return returnVal;
+}
+
+bool MyDB_PageReaderWriter :: isPinned () {
+	return myPage->getParent ().isPinned (myPage->page);
+}
+
+void MyDB_PageReaderWriter :: unpin () {
+	if (isPinned ())
+		myPage->getParent ().unpin (myPage->page);
+}
+
 void MyDB_PageReaderWriter :: clear () {
-	NUM_BYTES_USED = 2 * sizeof (size_t);
-	PAGE_TYPE = MyDB_PageType :: RegularPage;
+	clear (myPage->getBytes (), pageSize);
 	myPage->wroteBytes ();	
 }
 
+void MyDB_PageReaderWriter :: clear (void *page, size_t pageSize) {
+	NUM_BYTES_USED_OF (page) = 2 * sizeof (size_t);
+	PAGE_TYPE_OF (page) = MyDB_PageType :: RegularPage;
+	NUM_RECORDS_OF (page, pageSize) = 0;
+}
+
+pair <void *, void *> MyDB_PageReaderWriter :: getRecordBytes (void *page) {
+	return make_pair (2 * sizeof (size_t) + (char *) page, NUM_BYTES_USED_OF (page) + (char *) page);
+}
+
+void MyDB_PageReaderWriter :: copyFrom (void *page) {
+	memcpy (myPage->getBytes (), page, pageSize);
+	myPage->wroteBytes ();
+}
+
+int MyDB_PageReaderWriter :: getNumRecords () {
+	return NUM_RECORDS;
+}
+
+void *MyDB_PageReaderWriter :: getRecord (int whichSlot) {
+	return getRecord (myPage->getBytes (), pageSize, whichSlot);
+}
+
+int MyDB_PageReaderWriter :: findFirst (function <bool ()> isIt, MyDB_RecordPtr loadMe) {
+	int low = 0;
+	int high = NUM_RECORDS;
+	while (low < high) {
+		int mid = low + (high - low) / 2;
+		loadMe->fromBinary (getRecord (mid));
+		if (isIt ())
+			high = mid;
+		else
+			low = mid + 1;
+	}
+	return low;
+}
+
+bool MyDB_PageReaderWriter :: toPAX () {
+	if (!toPAX (myPage->getBytes (), pageSize))
+		return false;
+	myPage->wroteBytes ();
+	return true;
+}
+
+bool MyDB_PageReaderWriter :: toPAX (void *page, size_t pageSize) {
+
+	int numRecs = getNumRecords (page, pageSize);
+	if (PAGE_TYPE_OF (page) != MyDB_PageType :: RegularPage || numRecs == 0)
+		return false;
+
+	// count the attributes, using the first record
+	char *firstRec = (char *) getRecord (page, pageSize, 0);
+	int numAtts = 0;
+	for (char *pos = firstRec + sizeof (short); pos < firstRec + *((short *) firstRec); pos += *((short *) pos))
+		numAtts++;
+
+	// find the attributes whose values all take up the same space, and the size of each minipage
+	vector <unsigned> valueSize (numAtts), miniPageSize (numAtts, 0);
+	for (int i = 0; i < numRecs; i++) {
+		char *pos = ((char *) getRecord (page, pageSize, i)) + sizeof (short);
+		for (int j = 0; j < numAtts; j++) {
+			unsigned size = *((short *) pos);
+			if (i == 0)
+				valueSize[j] = size;
+			else if (valueSize[j] != size)
+				valueSize[j] = 0;
+			miniPageSize[j] += size;
+			pos += size;
+		}
+	}
+
+	size_t bytesUsed = 2 * sizeof (size_t) + (1 + 2 * numAtts) * sizeof (unsigned);
+	for (int j = 0; j < numAtts; j++) {
+		if (valueSize[j] != 0)
+			miniPageSize[j] -= numRecs * sizeof (short);
+		bytesUsed += miniPageSize[j];
+	}
+	if (bytesUsed + sizeof (unsigned) > pageSize)
+		return false;
+
+	// lay out the minipages, and then copy each value into its minipage
+	vector <char> pax (pageSize);
+	unsigned *atts = getPAXAtts (pax.data ());
+	atts[0] = numAtts;
+	vector <char *> miniPage (numAtts);
+	char *next = pax.data () + 2 * sizeof (size_t) + (1 + 2 * numAtts) * sizeof (unsigned);
+	for (int j = 0; j < numAtts; j++) {
+		atts[1 + 2 * j] = (unsigned) (next - pax.data ());
+		atts[2 + 2 * j] = valueSize[j];
+		miniPage[j] = next;
+		next += miniPageSize[j];
+	}
+
+	for (int i = 0; i < numRecs; i++) {
+		char *pos = ((char *) getRecord (page, pageSize, i)) + sizeof (short);
+		for (int j = 0; j < numAtts; j++) {
+			unsigned size = *((short *) pos);
+			if (valueSize[j] != 0) {
+				memcpy (miniPage[j], pos + sizeof (short), size - sizeof (short));
+				miniPage[j] += size - sizeof (short);
+			} else {
+				memcpy (miniPage[j], pos, size);
+				miniPage[j] += size;
+			}
+			pos += size;
+		}
+	}
+
+	PAGE_TYPE_OF (pax.data ()) = MyDB_PageType :: PAXPage;
+	NUM_BYTES_USED_OF (pax.data ()) = bytesUsed;
+	NUM_RECORDS_OF (pax.data (), pageSize) = numRecs;
+	memcpy (page, pax.data (), pageSize);
+	return true;
+}
+
+void MyDB_PageReaderWriter :: fromPAX (void *pax, void *rows, size_t pageSize) {
+
+	int numAtts = getPAXAtts (pax)[0];
+	vector <char *> miniPage (numAtts);
+	for (int j = 0; j < numAtts; j++)
+		miniPage[j] = ((char *) pax) + getPAXOffset (pax, j);
+
+	// put each record back together, one value from each minipage
+	clear (rows, pageSize);
+	int numRecs = getNumRecords (pax, pageSize);
+	unsigned *slotCount = getSlotCount (rows, pageSize);
+	char *pos = ((char *) rows) + NUM_BYTES_USED_OF (rows);
+	for (int i = 0; i < numRecs; i++) {
+		char *rec = pos;
+		pos += sizeof (short);
+		for (int j = 0; j < numAtts; j++) {
+			short size = (short) getPAXValueSize (pax, j);
+			if (size != 0) {
+				*((short *) pos) = size;
+				memcpy (pos + sizeof (short), miniPage[j], size - sizeof (short));
+				miniPage[j] += size - sizeof (short);
+			} else {
+				size = *((short *) miniPage[j]);
+				memcpy (pos, miniPage[j], size);
+				miniPage[j] += size;
+			}
+			pos += size;
+		}
+		*((short *) rec) = (short) (pos - rec);
+		slotCount[-1 - i] = (unsigned) (rec - (char *) rows);
+	}
+	*slotCount = numRecs;
+	NUM_BYTES_USED_OF (rows) = pos - (char *) rows;
+}
+
+MyDB_PageReaderWriter MyDB_PageReaderWriter :: getRows () {
+	if (PAGE_TYPE != MyDB_PageType :: PAXPage)
+		return *this;
+
+	MyDB_PageReaderWriter returnVal (true, myPage->getParent ());
+	fromPAX (myPage->getBytes (), returnVal.myPage->getBytes (), pageSize);
+	returnVal.myPage->wroteBytes ();
+	return returnVal;
+}
+
 MyDB_PageType MyDB_PageReaderWriter :: getType () {
 	return PAGE_TYPE;
 }
@@ -79,11 +258,15 @@ MyDB_RecordIteratorAltPtr getIteratorAlt (vector <MyDB_PageReaderWriter> &forUs)
 }
 
 MyDB_RecordIteratorPtr MyDB_PageReaderWriter :: getIterator (MyDB_RecordPtr iterateIntoMe) {
-	return make_shared <MyDB_PageRecIterator> (myPage, iterateIntoMe);
+	if (PAGE_TYPE == MyDB_PageType :: PAXPage)
+		return getRows ().getIterator (iterateIntoMe);
+	return make_shared <MyDB_PageRecIterator> (myPage, pageSize, iterateIntoMe);
 }
 
 MyDB_RecordIteratorAltPtr MyDB_PageReaderWriter :: getIteratorAlt () {
-	return make_shared <MyDB_PageRecIteratorAlt> (myPage);
+	if (PAGE_TYPE == MyDB_PageType :: PAXPage)
+		return make_shared <MyDB_PAXPageRecIteratorAlt> (*this);
+	return make_shared <MyDB_PageRecIteratorAlt> (myPage, pageSize);
 }
 
 void MyDB_PageReaderWriter :: setType (MyDB_PageType toMe) {
@@ -101,80 +284,57 @@ void *MyDB_PageReaderWriter :: appendAndReturnLocation (MyDB_RecordPtr appendMe)
 
 bool MyDB_PageReaderWriter :: append (MyDB_RecordPtr appendMe) {
 	
+	if (!append (myPage->getBytes (), pageSize, appendMe))
+		return false;
+	myPage->wroteBytes ();
+	return true;
+}
+
+bool MyDB_PageReaderWriter :: append (void *page, size_t pageSize, MyDB_RecordPtr appendMe) {
+
+	// the record needs room for itself and for its slot, in between the last record and the slot array
+	if (PAGE_TYPE_OF (page) == MyDB_PageType :: PAXPage)
+		return false;
 	size_t recSize = appendMe->getBinarySize ();
-	if (recSize > NUM_BYTES_LEFT)
+	unsigned *slotCount = getSlotCount (page, pageSize);
+	size_t slotBytes = (*slotCount + 2) * sizeof (unsigned);
+	if (recSize + slotBytes > pageSize - NUM_BYTES_USED_OF (page))
 		return false;
 
-	// write at the end
-	void *address = myPage->getBytes ();
-	appendMe->toBinary (NUM_BYTES_USED + (char *) address);
-	NUM_BYTES_USED += recSize;
-	myPage->wroteBytes ();
+	// write at the end of the records, and put its offset in the next slot
+	appendMe->toBinary (NUM_BYTES_USED_OF (page) + (char *) page);
+	slotCount[-1 - (int) *slotCount] = (unsigned) NUM_BYTES_USED_OF (page);
+	(*slotCount)++;
+	NUM_BYTES_USED_OF (page) += recSize;
 	return true;
 }
 
 void MyDB_PageReaderWriter :: 
 	sortInPlace (function <bool ()> comparator, MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs) {
 
-	void *temp = malloc (pageSize);
-	memcpy (temp, myPage->getBytes (), pageSize);
-
-	// first, read in the positions of all of the records
-	vector <void *> positions;
-	
-	// this basically iterates through all of the records on the page
-	int bytesConsumed = sizeof (size_t) * 2;
-	while (bytesConsumed != NUM_BYTES_USED) {
-		void *pos = bytesConsumed + (char *) temp;
-		positions.push_back (pos);
-		void *nextPos = lhs->fromBinary (pos);
-		bytesConsumed += ((char *) nextPos) - ((char *) pos);
-	}
+	// the first slot is the one closest to the end of the page, so the slots are sorted backwards
+	char *bytes = (char *) myPage->getBytes ();
+	unsigned *slotCount = getSlotCount (bytes, pageSize);
+	reverse_iterator <unsigned *> firstSlot (slotCount), lastSlot (slotCount - *slotCount);
 
-	// and now we sort the vector of positions, using the record contents to build a comparator
+	// sort the offsets, using the record contents to build a comparator
 	RecordComparator myComparator (comparator, lhs, rhs);
-	std::stable_sort (positions.begin (), positions.end (), myComparator);
-
-	// and write the guys back
-	NUM_BYTES_USED = 2 * sizeof (size_t);
+	std::stable_sort (firstSlot, lastSlot, [&] (unsigned lhsOffset, unsigned rhsOffset) {
+		return myComparator (bytes + lhsOffset, bytes + rhsOffset);
+	});
 	myPage->wroteBytes ();	
-	for (void *pos : positions) {
-		lhs->fromBinary (pos);
-		append (lhs);
-	}
-
-	free (temp);
 }
 
 MyDB_PageReaderWriterPtr MyDB_PageReaderWriter :: 
 	sort (function <bool ()> comparator, MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs) {
 
-	// first, read in the positions of all of the records
-	vector <void *> positions;
-	
-	// this basically iterates through all of the records on the page
-	int bytesConsumed = sizeof (size_t) * 2;
-	while (bytesConsumed != NUM_BYTES_USED) {
-		void *pos = bytesConsumed + (char *) myPage->getBytes ();
-		positions.push_back (pos);
-		void *nextPos = lhs->fromBinary (pos);
-		bytesConsumed += ((char *) nextPos) - ((char *) pos);
-	}
-
-	// and now we sort the vector of positions, using the record contents to build a comparator
-	RecordComparator myComparator (comparator, lhs, rhs);
-	std::stable_sort (positions.begin (), positions.end (), myComparator);
-
-	// and now create the page to return
+	// the new page is a copy of this one, with its slots sorted
 	MyDB_PageReaderWriterPtr returnVal = make_shared <MyDB_PageReaderWriter> (myPage->getParent ());
-	returnVal->clear ();
-	
-	// loop through all of the sorted records and write them out
-	for (void *pos : positions) {
-		lhs->fromBinary (pos);
-		returnVal->append (lhs);
-	}
-
+	if (PAGE_TYPE == MyDB_PageType :: PAXPage)
+		fromPAX (myPage->getBytes (), returnVal->getBytes (), pageSize);
+	else
+		returnVal->copyFrom (myPage->getBytes ());
+	returnVal->sortInPlace (comparator, lhs, rhs);
 	return returnVal;
 }
 
@@ -13,29 +13,27 @@
 #ifndef PAGE_REC_ITER_C
 #define PAGE_REC_ITER_C
 
+#include "MyDB_PageReaderWriter.h"
 #include "MyDB_PageRecIterator.h"
-#include "MyDB_PageType.h"
-
-#define NUM_BYTES_USED *((size_t *) (((char *) myPage->getBytes ()) + sizeof (size_t)))
 
 void MyDB_PageRecIterator :: getNext () {
-	void *pos = bytesConsumed + (char *) myPage->getBytes ();
- 	void *nextPos = myRec->fromBinary (pos);
-	bytesConsumed += ((char *) nextPos) - ((char *) pos);	
+	myRec->fromBinary (getCurrentPointer ());
+	whichSlot++;
 }
 
 void *MyDB_PageRecIterator :: getCurrentPointer () {
-	return bytesConsumed + (char *) myPage->getBytes ();
+	return MyDB_PageReaderWriter :: getRecord (myPage->getBytes (), pageSize, whichSlot);
 }
 
 bool MyDB_PageRecIterator :: hasNext () {
-	return bytesConsumed != NUM_BYTES_USED;
+	return whichSlot < MyDB_PageReaderWriter :: getNumRecords (myPage->getBytes (), pageSize);
 }
 
-MyDB_PageRecIterator :: MyDB_PageRecIterator (MyDB_PageHandle myPageIn, MyDB_RecordPtr myRecIn) {
-	bytesConsumed = sizeof (size_t) * 2;
+MyDB_PageRecIterator :: MyDB_PageRecIterator (MyDB_PageHandle myPageIn, size_t pageSizeIn, MyDB_RecordPtr myRecIn) {
+	whichSlot = 0;
 	myPage = myPageIn;
 	myRec = myRecIn;
+	pageSize = pageSizeIn;
 }
 
 MyDB_PageRecIterator :: ~MyDB_PageRecIterator () {}
@@ -13,35 +13,41 @@
 #ifndef PAGE_REC_ITER_ALT_C
 #define PAGE_REC_ITER_ALT_C
 
+#include "MyDB_PageReaderWriter.h"
 #include "MyDB_PageRecIteratorAlt.h"
-#include "MyDB_PageType.h"
-
-#define NUM_BYTES_USED *((size_t *) (((char *) myPage->getBytes ()) + sizeof (size_t)))
 
 void MyDB_PageRecIteratorAlt :: getCurrent (MyDB_RecordPtr intoMe) {
-	void *pos = bytesConsumed + (char *) myPage->getBytes ();
- 	void *nextPos = intoMe->fromBinary (pos);
-	nextRecSize = ((char *) nextPos) - ((char *) pos);	
+	intoMe->fromBinary (getCurrentPointer ());
 }
 
 void *MyDB_PageRecIteratorAlt :: getCurrentPointer () {
-	return bytesConsumed + (char *) myPage->getBytes ();
+	return MyDB_PageReaderWriter :: getRecord (myPage->getBytes (), pageSize, whichSlot);
 }
 
 bool MyDB_PageRecIteratorAlt :: advance () {
-	if (nextRecSize == -1) {
-		cout << "You can't call advance without calling getCurrent!!\n";
-		exit (1);
-	}
-	bytesConsumed += nextRecSize;
-	nextRecSize = -1;
-	return bytesConsumed != NUM_BYTES_USED;
+
+	// the first call to advance () stays on the first record
+	whichSlot += step;
+	step = 1;
+	return whichSlot < MyDB_PageReaderWriter :: getNumRecords (myPage->getBytes (), pageSize);
+}
+
+int MyDB_PageRecIteratorAlt :: getBatch (void **intoMe, int maxRecs) {
+
+	void *bytes = myPage->getBytes ();
+	int numRecs = MyDB_PageReaderWriter :: getNumRecords (bytes, pageSize) - whichSlot;
+	if (numRecs > maxRecs)
+		numRecs = maxRecs;
+	for (int i = 0; i < numRecs; i++)
+		intoMe[i] = MyDB_PageReaderWriter :: getRecord (bytes, pageSize, whichSlot++);
+	return numRecs;
 }
 
-MyDB_PageRecIteratorAlt :: MyDB_PageRecIteratorAlt (MyDB_PageHandle myPageIn) {
-	bytesConsumed = sizeof (size_t) * 2;
+MyDB_PageRecIteratorAlt :: MyDB_PageRecIteratorAlt (MyDB_PageHandle myPageIn, size_t pageSizeIn) {
+	whichSlot = 0;
+	step = 0;
 	myPage = myPageIn;
-	nextRecSize = 0;
+	pageSize = pageSizeIn;
 }
 
 MyDB_PageRecIteratorAlt :: ~MyDB_PageRecIteratorAlt () {}
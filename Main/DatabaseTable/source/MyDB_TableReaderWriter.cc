@@ -13,13 +13,24 @@
 #ifndef TABLE_RW_C
 #define TABLE_RW_C
 
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
 #include <fstream>
 #include <limits>
 #include <queue>
+#include <random>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "MyDB_AttStats.h"
+#include "MyDB_Hash.h"
 #include "MyDB_PageReaderWriter.h"
+#include "MyDB_StringDictionary.h"
 #include "MyDB_TableRecIterator.h"
 #include "MyDB_TableRecIteratorAlt.h"
 #include "MyDB_TableReaderWriter.h"
+#include "MyDB_TaskScheduler.h"
 #include <set>
 #include <vector>
 #include "Sorting.h"
@@ -29,6 +40,7 @@ using namespace std;
 MyDB_TableReaderWriter :: MyDB_TableReaderWriter (MyDB_TableReaderWriterPtr fromMe) {
 	forMe = make_shared <MyDB_Table> (*fromMe->forMe);
 	myBuffer = fromMe->myBuffer;
+	zones = fromMe->zones;
 
 	if (forMe->lastPage () == -1) {
 		forMe->setLastPage (0);
@@ -42,6 +54,21 @@ MyDB_TableReaderWriter :: MyDB_TableReaderWriter (MyDB_TableReaderWriterPtr from
 MyDB_TableReaderWriter :: MyDB_TableReaderWriter (MyDB_TablePtr forMeIn, MyDB_BufferManagerPtr myBufferIn) {
 	forMe = forMeIn;
 	myBuffer = myBufferIn;
+	zones = make_shared <MyDB_ZoneMap> (forMe->getSchema (), forMe->getBloomAtts (), myBuffer->getPageSize ());
+
+	// the pages of a file written in an older layout cannot be read, so the table is emptied
+	// out (along with its zones) and takes on the current layout; it has to be loaded again
+	if (forMe->getPageFormat () != MYDB_PAGE_FORMAT) {
+		if (forMe->lastPage () != -1) {
+			cout << "Table " << forMe->getName () << " was written with page format " << forMe->getPageFormat ()
+				<< ", but this build reads format " << MYDB_PAGE_FORMAT << "; it has been emptied, and needs to be loaded again\n";
+			if (truncate (forMe->getStorageLoc ().c_str (), 0) != 0 && errno != ENOENT)
+				cout << "Could not empty the file " << forMe->getStorageLoc () << "\n";
+			unlink (getZoneFileName ().c_str ());
+			forMe->setLastPage (-1);
+		}
+		forMe->setPageFormat (MYDB_PAGE_FORMAT);
+	}
 
 	if (forMe->lastPage () == -1) {
 		forMe->setLastPage (0);
@@ -49,9 +76,40 @@ MyDB_TableReaderWriter :: MyDB_TableReaderWriter (MyDB_TablePtr forMeIn, MyDB_Bu
 		lastPage->clear ();
 	} else {
 		lastPage = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());	
+		if (zones->hasZones ())
+			zones->load (getZoneFileName (), getFingerprint (), getNumPages ());
 	}
 }
 
+MyDB_TableReaderWriter :: MyDB_TableReaderWriter (MyDB_SchemaPtr mySchema, MyDB_BufferManagerPtr myBufferIn) {
+	forMe = make_shared <MyDB_Table> ("temp", "", mySchema);
+	myBuffer = myBufferIn;
+	zones = make_shared <MyDB_ZoneMap> (forMe->getSchema (), forMe->getBloomAtts (), myBuffer->getPageSize ());
+}
+
+MyDB_TableReaderWriter :: ~MyDB_TableReaderWriter () {
+
+	// a table made from just a schema has no file, so its zones are not kept
+	if (zones.use_count () == 1 && zones->hasZones () && zones->isChanged () && forMe->getStorageLoc () != "")
+		zones->save (getZoneFileName (), getFingerprint ());
+}
+
+string MyDB_TableReaderWriter :: getZoneFileName () {
+	return forMe->getStorageLoc () + ".zones";
+}
+
+size_t MyDB_TableReaderWriter :: getFingerprint () {
+
+	// the first page, the number of pages, and the number of records on each of them; this reads
+	// every page's slot count, but it is only done when the table is opened and closed
+	MyDB_PageReaderWriter firstPage (*this, 0);
+	size_t fingerprint = hashBytes ((char *) firstPage.getBytes (), firstPage.getPageSize ());
+	fingerprint = hashCombine (fingerprint, hashInt (forMe->lastPage ()));
+	for (int i = 0; i <= forMe->lastPage (); i++)
+		fingerprint = hashCombine (fingerprint, hashInt (MyDB_PageReaderWriter (*this, i).getNumRecords ()));
+	return fingerprint;
+}
+
 MyDB_BufferManagerPtr MyDB_TableReaderWriter :: getBufferMgr () {
 	return myBuffer;
 }
@@ -95,14 +153,255 @@ MyDB_PageReaderWriter MyDB_TableReaderWriter :: last () {
 
 void MyDB_TableReaderWriter :: append (MyDB_RecordPtr appendMe) {
 
+	// the zone of a page is started when its first record is appended
+	if (lastPage->getNumRecords () == 0)
+		zones->startPage (forMe->lastPage ());
+
 	// try to append the record on the current page...
 	if (!lastPage->append (appendMe)) {
 
+		// in a PAX file, a page is re-written with each attribute's values together once it is full
+		if (forMe->getFileType () == "pax")
+			lastPage->toPAX ();
+
 		// if we cannot, then get a new last page and append
 		forMe->setLastPage (forMe->lastPage () + 1);
 		lastPage = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());
 		lastPage->clear ();
 		lastPage->append (appendMe);
+		zones->startPage (forMe->lastPage ());
+	}
+	zones->add (forMe->lastPage (), appendMe);
+}
+
+void MyDB_TableReaderWriter :: appendPageImage (void *page) {
+
+	// if the last page has records on it, then we need a new one
+	if (lastPage->getNumRecords () > 0) {
+		forMe->setLastPage (forMe->lastPage () + 1);
+		lastPage = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());
+	}
+	lastPage->copyFrom (page);
+	zones->forget (forMe->lastPage ());
+	if (forMe->getFileType () == "pax")
+		lastPage->toPAX ();
+}
+
+#define SAMPLE_ROWS 4096
+
+// this collects what is needed to build the statistics for each attribute of a table (see
+// MyDB_AttStats) from the records that are added to it: a HyperLogLog sketch of the values, the
+// smallest and largest values, and a uniform random sample of the records.  Each record gets a
+// random priority, and the SAMPLE_ROWS records with the smallest priorities are kept, so two
+// samples of different parts of the same table can be merged.
+//
+// Dictionary-encoded strings are only looked at through their codes until finish () is called,
+// since while a table is being loaded, other threads may be adding to the dictionary
+struct TableSample {
+
+	enum AttKind {numericAtt, stringAtt, dictAtt};
+
+	vector <AttKind> kinds;
+	vector <MyDB_HyperLogLog> sketches;
+	vector <double> numLow, numHigh;
+	vector <string> strLow, strHigh;
+	vector <vector <bool>> codesSeen;
+	size_t numRecs = 0;
+
+	// when pages are sampled, this is the number of distinct values of each attribute on each
+	// page, summed over the pages
+	vector <size_t> distinctPerPage;
+	priority_queue <pair <size_t, string>> sample;
+	mt19937_64 random;
+
+	TableSample (MyDB_SchemaPtr mySchema, size_t seed) : random (seed) {
+		for (auto &a : mySchema->getAtts ()) {
+			if (a.second->promotableToDouble ())
+				kinds.push_back (numericAtt);
+			else if (a.second->toString () == "dictstring")
+				kinds.push_back (dictAtt);
+			else
+				kinds.push_back (stringAtt);
+			codesSeen.push_back (vector <bool> (kinds.back () == dictAtt ? MyDB_StringDictionary :: MAX_CODES : 0));
+		}
+		sketches.resize (kinds.size ());
+		distinctPerPage.resize (kinds.size (), 0);
+		numLow.resize (kinds.size ());
+		numHigh.resize (kinds.size ());
+		strLow.resize (kinds.size ());
+		strHigh.resize (kinds.size ());
+	}
+
+	void add (MyDB_RecordPtr rec) {
+		for (size_t i = 0; i < kinds.size (); i++) {
+			MyDB_AttValPtr &att = rec->getAtt (i);
+			if (kinds[i] == numericAtt) {
+				sketches[i].add (att->hash ());
+				double val = att->toDouble ();
+				if (numRecs == 0 || val < numLow[i])
+					numLow[i] = val;
+				if (numRecs == 0 || val > numHigh[i])
+					numHigh[i] = val;
+			} else if (kinds[i] == stringAtt) {
+				sketches[i].add (att->hash ());
+				MyDB_StringView val = att->toStringView ();
+				if (numRecs == 0 || val.compare (MyDB_StringView (strLow[i].data (), strLow[i].size ())) < 0)
+					strLow[i] = val.toString ();
+				if (numRecs == 0 || val.compare (MyDB_StringView (strHigh[i].data (), strHigh[i].size ())) > 0)
+					strHigh[i] = val.toString ();
+			} else {
+				codesSeen[i][((MyDB_DictStringAttVal *) att.get ())->getCode ()] = true;
+			}
+		}
+		numRecs++;
+
+		size_t priority = random ();
+		if (sample.size () < SAMPLE_ROWS || priority < sample.top ().first) {
+			string bytes (rec->getBinarySize (), 0);
+			rec->toBinary (&bytes[0]);
+			addToSample (priority, bytes);
+		}
+	}
+
+	void addToSample (size_t priority, string &bytes) {
+		if (sample.size () == SAMPLE_ROWS) {
+			if (priority >= sample.top ().first)
+				return;
+			sample.pop ();
+		}
+		sample.push (make_pair (priority, bytes));
+	}
+
+	void merge (TableSample &other) {
+		for (size_t i = 0; i < kinds.size (); i++) {
+			sketches[i].merge (other.sketches[i]);
+			distinctPerPage[i] += other.distinctPerPage[i];
+			if (other.numRecs == 0)
+				continue;
+			if (numRecs == 0 || other.numLow[i] < numLow[i])
+				numLow[i] = other.numLow[i];
+			if (numRecs == 0 || other.numHigh[i] > numHigh[i])
+				numHigh[i] = other.numHigh[i];
+			if (numRecs == 0 || other.strLow[i] < strLow[i])
+				strLow[i] = other.strLow[i];
+			if (numRecs == 0 || other.strHigh[i] > strHigh[i])
+				strHigh[i] = other.strHigh[i];
+			for (size_t j = 0; j < codesSeen[i].size (); j++)
+				if (other.codesSeen[i][j])
+					codesSeen[i][j] = true;
+		}
+		numRecs += other.numRecs;
+		for (; !other.sample.empty (); other.sample.pop ()) {
+			pair <size_t, string> next = other.sample.top ();
+			addToSample (next.first, next.second);
+		}
+	}
+
+	// builds the statistics; rec is used to read the sampled records back in
+	vector <MyDB_AttStatsPtr> finish (MyDB_RecordPtr rec) {
+
+		// the values of the dictionary-encoded strings can now be looked up
+		for (size_t i = 0; i < kinds.size (); i++) {
+			if (kinds[i] != dictAtt)
+				continue;
+			MyDB_StringDictionaryPtr dictionary = ((MyDB_DictStringAttVal *) rec->getAtt (i).get ())->getDictionary ();
+			bool first = true;
+			for (size_t j = 0; j < codesSeen[i].size (); j++) {
+				if (!codesSeen[i][j])
+					continue;
+				sketches[i].add (dictionary->getHash (j));
+				const string &val = dictionary->decode (j);
+				if (first || val < strLow[i])
+					strLow[i] = val;
+				if (first || val > strHigh[i])
+					strHigh[i] = val;
+				first = false;
+			}
+		}
+
+		// pull the sampled values out of the records
+		vector <vector <double>> numSample (kinds.size ());
+		vector <vector <string>> strSample (kinds.size ());
+		for (; !sample.empty (); sample.pop ()) {
+			string bytes = sample.top ().second;
+			rec->fromBinary (&bytes[0]);
+			for (size_t i = 0; i < kinds.size (); i++) {
+				if (kinds[i] == numericAtt)
+					numSample[i].push_back (rec->getAtt (i)->toDouble ());
+				else
+					strSample[i].push_back (rec->getAtt (i)->toString ());
+			}
+		}
+
+		vector <MyDB_AttStatsPtr> result;
+		for (size_t i = 0; i < kinds.size (); i++) {
+			if (kinds[i] == numericAtt) {
+				sort (numSample[i].begin (), numSample[i].end ());
+				result.push_back (make_shared <MyDB_AttStats> (sketches[i], numLow[i], numHigh[i], numSample[i]));
+			} else {
+				sort (strSample[i].begin (), strSample[i].end ());
+				result.push_back (make_shared <MyDB_AttStats> (sketches[i], strLow[i], strHigh[i], strSample[i]));
+			}
+		}
+		return result;
+	}
+};
+
+// the records from one part of a text file, in page images
+struct LoadedChunk {
+	LoadedChunk (MyDB_SchemaPtr mySchema, vector <string> &bloomAtts, size_t pageSize) :
+		zones (mySchema, bloomAtts, pageSize) {}
+	vector <char> pages;
+	MyDB_ZoneMap zones;
+	size_t numPages = 0;
+	size_t numRecs = 0;
+};
+
+// parses the lines between start and end into page images, adding the records to the sample
+static void loadChunk (const char *start, const char *end, MyDB_RecordPtr rec, size_t pageSize,
+	TableSample &sample, LoadedChunk &toMe) {
+
+	toMe.pages.clear ();
+	toMe.zones.clear ();
+	toMe.numPages = 0;
+	toMe.numRecs = 0;
+	string lastLine;
+	while (start < end) {
+
+		// find the end of the line; if the last line of the file has no newline, it is copied,
+		// so that the parsing of the last value does not run off of the end of the file
+		const char *lineEnd = (const char *) memchr (start, '\n', end - start);
+		const char *next;
+		if (lineEnd == nullptr) {
+			lastLine.assign (start, end);
+			start = lastLine.data ();
+			lineEnd = next = start + lastLine.size ();
+			end = next;
+		} else {
+			next = lineEnd + 1;
+		}
+
+		if (lineEnd == start) {
+			start = next;
+			continue;
+		}
+		rec->fromText (start, lineEnd);
+		start = next;
+
+		// this is used for the statistics
+		sample.add (rec);
+
+		// write the record, starting a new page if needed
+		char *page = (toMe.numPages == 0) ? nullptr : &toMe.pages[(toMe.numPages - 1) * pageSize];
+		if (page == nullptr || !MyDB_PageReaderWriter :: append (page, pageSize, rec)) {
+			toMe.pages.resize (++toMe.numPages * pageSize);
+			page = &toMe.pages[(toMe.numPages - 1) * pageSize];
+			MyDB_PageReaderWriter :: clear (page, pageSize);
+			MyDB_PageReaderWriter :: append (page, pageSize, rec);
+			toMe.zones.startPage (toMe.numPages - 1);
+		}
+		toMe.zones.add (toMe.numPages - 1, rec);
+		toMe.numRecs++;
 	}
 }
 
@@ -112,68 +411,234 @@ pair <vector <size_t>, size_t>  MyDB_TableReaderWriter :: loadFromTextFile (stri
 	forMe->setLastPage (0);
 	lastPage = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());
 	lastPage->clear ();
+	zones->clear ();
+	for (auto &a : forMe->getSchema ()->getAtts ()) {
+		MyDB_OverflowAttTypePtr overflowType = dynamic_pointer_cast <MyDB_OverflowAttType> (a.second);
+		if (overflowType != nullptr)
+			overflowType->getOverflowFile ()->clear ();
+	}
 
-	// try to open the file
-	string line;
-	ifstream myfile (fName);
-
-	MyDB_RecordPtr tempRec = getEmptyRecord ();
+	// try to map the file into memory
+	const char *data = nullptr;
+	size_t fileSize = 0;
+	int fd = open (fName.c_str (), O_RDONLY);
+	struct stat fileInfo;
+	if (fd >= 0 && fstat (fd, &fileInfo) == 0 && fileInfo.st_size > 0) {
+		fileSize = fileInfo.st_size;
+		void *mapped = mmap (nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapped == MAP_FAILED) {
+			fileSize = 0;
+		} else {
+			data = (const char *) mapped;
+			madvise (mapped, fileSize, MADV_SEQUENTIAL);
+		}
+	}
 
-	// this data structure is used for apporoximate counting of the number of distinct
-	// values of each attribute
-	vector <pair <set <size_t>, int>> allHashes;
-	for (int i = 0; i < tempRec->getSchema ()->getAtts ().size (); i++) {
-		set <size_t> temp1;
-		allHashes.push_back (make_pair (temp1, 1));
+	// each task gets its own record to parse into, and its own sample for the statistics
+	MyDB_TaskScheduler &scheduler = MyDB_TaskScheduler :: getScheduler ();
+	int numThreads = scheduler.getNumWorkers ();
+	vector <MyDB_RecordPtr> recs;
+	vector <TableSample> allSamples;
+	for (int i = 0; i < numThreads; i++) {
+		recs.push_back (getEmptyRecord ());
+		allSamples.push_back (TableSample (forMe->getSchema (), i + 1));
 	}
 
-	// if we opened it, read the contents
+	// the dictionaries of the dictionary-encoded strings, which are checked after each round
+	vector <pair <string, MyDB_StringDictionaryPtr>> dictionaries;
+	for (auto &a : forMe->getSchema ()->getAtts ()) {
+		MyDB_DictStringAttTypePtr dictType = dynamic_pointer_cast <MyDB_DictStringAttType> (a.second);
+		if (dictType != nullptr)
+			dictionaries.push_back (make_pair (a.first, dictType->getDictionary ()));
+	}
+	string fullDictionary = "";
+
+	// the file is loaded in rounds; in each round, there is a task for each worker, which parses
+	// a chunk of the file that ends at the end of a line, and while the tasks run, the page
+	// images from the last round are appended to the table
+	#define CHUNK_SIZE (8 * 1024 * 1024)
+	size_t pageSize = myBuffer->getPageSize ();
+	LoadedChunk emptyChunk (forMe->getSchema (), forMe->getBloomAtts (), pageSize);
+	vector <LoadedChunk> parsing (numThreads, emptyChunk);
+	vector <LoadedChunk> parsed (numThreads, emptyChunk);
+	int numParsed = 0;
 	size_t counter = 0;
-	if (myfile.is_open()) {
-
-		// loop through all of the lines
-		while (getline (myfile,line)) {
-			tempRec->fromString (line);		
-			counter++;
-			// hash all of the attributes... this is used for counting
-			int i = 0;
-			for (auto &a : allHashes) {
-
-				// insert the hash
-				size_t hash = tempRec->getAtt (i)->hash ();
-				i++;
-				if (hash % a.second != 0)
-					continue;
+	const char *pos = data, *end = data + fileSize;
+	while (true) {
+
+		// hand out the chunks
+		MyDB_TaskGroupPtr tasks = scheduler.makeGroup ();
+		int numChunks = 0;
+		while (numChunks < numThreads && pos < end) {
+			const char *chunkEnd = pos + min ((size_t) CHUNK_SIZE, (size_t) (end - pos));
+			const char *lineEnd = (const char *) memchr (chunkEnd - 1, '\n', end - chunkEnd + 1);
+			chunkEnd = (lineEnd == nullptr) ? end : lineEnd + 1;
+			int which = numChunks++;
+			tasks->submit ([=, &recs, &allSamples, &parsing] {
+				loadChunk (pos, chunkEnd, recs[which], pageSize, allSamples[which], parsing[which]);});
+			pos = chunkEnd;
+		}
 
-				a.first.insert (hash);
-
-				// if we have too many items, compact them
-				#define MAX_SIZE 1000
-				if (a.first.size () > MAX_SIZE) {
-					a.second *= 2;
-					set <size_t> newSet;
-					for (auto &num : a.first) {
-						if (num % a.second == 0)
-							newSet.insert (num);
-					}
-					a.first = newSet;	
-				}
+		// write the last round into the table, along with the zones of the pages (a B+-Tree
+		// puts the records wherever they go, so it does not keep zones)
+		for (int i = 0; i < numParsed; i++) {
+			for (size_t j = 0; j < parsed[i].numPages; j++) {
+				appendPageImage (&parsed[i].pages[j * pageSize]);
+				if (forMe->getFileType () != "bplustree")
+					zones->copyPage (forMe->lastPage (), parsed[i].zones, j);
 			}
-			append (tempRec);
+			counter += parsed[i].numRecs;
 		}
-		myfile.close ();
+
+		tasks->join ();
+		if (numChunks == 0)
+			break;
+		swap (parsing, parsed);
+		numParsed = numChunks;
+
+		// once a dictionary is full, the values that did not fit were stored as empty strings,
+		// so the load is stopped
+		for (auto &d : dictionaries)
+			if (d.second->isFull ())
+				fullDictionary = d.first;
+		if (fullDictionary != "")
+			break;
 	}
-	cout << "Loaded " << counter << " records.\n";
 
-	// finally, compute the vector of estimates
-	vector <size_t> returnVal;
-	for (auto &a : allHashes) {
-		size_t est = ((size_t) a.first.size ()) * a.second;
-		returnVal.push_back (est);
+	if (data != nullptr)
+		munmap ((void *) data, fileSize);
+	if (fd >= 0)
+		close (fd);
+
+	// if the load was stopped, the table is left empty
+	if (fullDictionary != "") {
+		cout << "Could not load " << fName << ": " << fullDictionary << " has more distinct values than a " <<
+			"dictionary-encoded string can hold, so it should be a plain string.\n";
+		forMe->setLastPage (0);
+		lastPage = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());
+		lastPage->clear ();
+		zones->clear ();
+		for (auto &a : forMe->getSchema ()->getAtts ()) {
+			MyDB_OverflowAttTypePtr overflowType = dynamic_pointer_cast <MyDB_OverflowAttType> (a.second);
+			if (overflowType != nullptr)
+				overflowType->getOverflowFile ()->clear ();
+		}
+		return make_pair (vector <size_t> (forMe->getSchema ()->getAtts ().size (), 0), 0);
+	}
+
+	cout << "Loaded " << counter << " records.\n";
+	for (auto &a : forMe->getSchema ()->getAtts ()) {
+		MyDB_OverflowAttTypePtr overflowType = dynamic_pointer_cast <MyDB_OverflowAttType> (a.second);
+		if (overflowType != nullptr)
+			overflowType->getOverflowFile ()->flush ();
 	}
+	if (zones->hasZones ())
+		zones->save (getZoneFileName (), getFingerprint ());
+
+	// finally, compute the statistics and the vector of estimates
+	for (int i = 1; i < numThreads; i++)
+		allSamples[0].merge (allSamples[i]);
+	vector <MyDB_AttStatsPtr> stats = allSamples[0].finish (recs[0]);
+	forMe->setAttStats (stats);
+	vector <size_t> returnVal;
+	for (auto &s : stats)
+		returnVal.push_back (s->getDistinctValues ());
 	return make_pair (returnVal, counter);
 }
 
+// adds all of the records in a page image to the sample, along with the number of distinct
+// values of each attribute on the page; the hashes of the values are only needed while the
+// page is looked at, so they go in the task's scratch arena
+static void samplePage (void *page, size_t pageSize, MyDB_RecordPtr rec, TableSample &sample) {
+	size_t numAtts = sample.kinds.size ();
+	size_t numRecs = MyDB_PageReaderWriter :: getNumRecords (page, pageSize);
+	size_t *hashes = (size_t *) MyDB_TaskScheduler :: getScratch ().allocate (numAtts * numRecs * sizeof (size_t));
+	pair <void *, void *> recs = MyDB_PageReaderWriter :: getRecordBytes (page);
+	size_t whichRec = 0;
+	for (void *pos = recs.first; pos < recs.second; whichRec++) {
+		pos = rec->fromBinary (pos);
+		sample.add (rec);
+		for (size_t i = 0; i < numAtts; i++)
+			hashes[i * numRecs + whichRec] = rec->getAtt (i)->hash ();
+	}
+	for (size_t i = 0; i < numAtts; i++) {
+		size_t *first = hashes + i * numRecs;
+		sort (first, first + whichRec);
+		sample.distinctPerPage[i] += unique (first, first + whichRec) - first;
+	}
+}
+
+#define MAX_ANALYZE_PAGES 1024
+#define MAX_ANALYZE_TASKS 8
+
+void MyDB_TableReaderWriter :: analyze () {
+
+	// pick the pages to look at, evenly spaced through the file
+	size_t numPages = getNumPages ();
+	vector <size_t> pages;
+	for (size_t i = 0; i < min (numPages, (size_t) MAX_ANALYZE_PAGES); i++)
+		pages.push_back (i * numPages / min (numPages, (size_t) MAX_ANALYZE_PAGES));
+
+	MyDB_TaskScheduler &scheduler = MyDB_TaskScheduler :: getScheduler ();
+	int numThreads = min (MAX_ANALYZE_TASKS, scheduler.getNumWorkers ());
+	vector <MyDB_RecordPtr> recs;
+	vector <TableSample> samples;
+	for (int i = 0; i < numThreads; i++) {
+		recs.push_back (getEmptyRecord ());
+		samples.push_back (TableSample (forMe->getSchema (), i + 1));
+	}
+
+	// in each round, a page is pinned for each task, which reads the records right off of the
+	// page (so that only this thread uses the buffer manager); the pages of a B+-Tree that are
+	// not leaves are skipped, and PAXPages are first written into RegularPages
+	size_t pageSize = myBuffer->getPageSize ();
+	for (size_t pos = 0; pos < pages.size (); pos += numThreads) {
+		vector <MyDB_PageReaderWriter> pinned;
+		MyDB_TaskGroupPtr tasks = scheduler.makeGroup ();
+		for (int i = 0; i < numThreads && pos + i < pages.size (); i++) {
+			MyDB_PageReaderWriter page = getPinned (pages[pos + i]);
+			if (page.getType () == MyDB_PageType :: DirectoryPage)
+				continue;
+			pinned.push_back (page.getRows ());
+			void *bytes = pinned.back ().getBytes ();
+			MyDB_RecordPtr rec = recs[i];
+			TableSample &sample = samples[i];
+			tasks->submit ([bytes, pageSize, rec, &sample] {samplePage (bytes, pageSize, rec, sample);});
+		}
+		tasks->join ();
+	}
+
+	for (int i = 1; i < numThreads; i++)
+		samples[0].merge (samples[i]);
+	size_t numSampled = samples[0].numRecs;
+	vector <MyDB_AttStatsPtr> stats = samples[0].finish (recs[0]);
+
+	// if only some of the pages were looked at, then the number of records is scaled up, and so
+	// is the number of distinct values of each attribute.  If the values of an attribute are
+	// repeated on a page but not seen on more than one page, they are clustered (as when the
+	// file is sorted on them), and the number of them grows with the number of pages; otherwise,
+	// the sample of records is used to estimate how many values were not seen
+	size_t numRecs = numSampled;
+	if (pages.size () < numPages && numSampled > 0) {
+		numRecs = (size_t) ((double) numSampled * numPages / pages.size ());
+		for (size_t i = 0; i < stats.size (); i++) {
+			size_t seen = stats[i]->getDistinctValues ();
+			size_t perPage = samples[0].distinctPerPage[i];
+			if (perPage <= numSampled / 2 && seen >= 0.9 * perPage)
+				stats[i]->setDistinctValues (min (numRecs, (size_t) ((double) seen * numPages / pages.size ())));
+			else
+				stats[i]->scaleToTable (numRecs);
+		}
+	}
+
+	vector <size_t> counts;
+	for (auto &s : stats)
+		counts.push_back (s->getDistinctValues ());
+	forMe->setAttStats (stats);
+	forMe->setDistinctValues (counts);
+	forMe->setTupleCount (numRecs);
+}
+
 MyDB_RecordIteratorPtr MyDB_TableReaderWriter :: getIterator (MyDB_RecordPtr iterateIntoMe) {
 	return make_shared <MyDB_TableRecIterator> (*this, forMe, iterateIntoMe);
 }
@@ -186,6 +651,22 @@ MyDB_RecordIteratorAltPtr MyDB_TableReaderWriter :: getIteratorAlt (int lowPage,
 	return make_shared <MyDB_TableRecIteratorAlt> (*this, forMe, lowPage, highPage);
 }
 
+MyDB_RecordIteratorAltPtr MyDB_TableReaderWriter :: getIteratorAlt (function <bool (int)> readPage) {
+	return make_shared <MyDB_TableRecIteratorAlt> (*this, forMe, readPage);
+}
+
+function <bool (int)> MyDB_TableReaderWriter :: getPageFilter (string selectionPredicate) {
+	return zones->getPageFilter (selectionPredicate);
+}
+
+function <bool (int)> MyDB_TableReaderWriter :: getPageFilter (MyDB_ExprPtr selectionPredicate) {
+	return zones->getPageFilter (selectionPredicate);
+}
+
+string MyDB_TableReaderWriter :: getSkipCounts () {
+	return zones->getSkipCounts ();
+}
+
 void MyDB_TableReaderWriter :: writeIntoTextFile (string fName) {
 	
 	// open up the output file
@@ -26,24 +26,95 @@ void *MyDB_TableRecIteratorAlt :: getCurrentPointer () {
 
 bool MyDB_TableRecIteratorAlt :: advance () {
 
-	if (myParent[curPage].getType () == MyDB_PageType :: RegularPage && myIter->advance ())
+	if (myIter != nullptr && myParent[curPage].getType () != MyDB_PageType :: DirectoryPage && myIter->advance ())
 		return true;
 
 	if (curPage == myTable->lastPage () || curPage == highPage)
 		return false;
 
 	curPage++;
-	myIter = myParent[curPage].getIteratorAlt ();
+	myIter = getPageIter ();
 	return advance ();
 }
 
+MyDB_RecordIteratorAltPtr MyDB_TableRecIteratorAlt :: getPageIter () {
+	if (!readPage (curPage))
+		return nullptr;
+	return myParent[curPage].getIteratorAlt ();
+}
+
+void MyDB_TableRecIteratorAlt :: pinCurPage () {
+
+	// pin the page, so that the addresses we hand out stay valid
+	if (!curPagePinned) {
+		curPagePinned = true;
+		myIter = nullptr;
+		if (!readPage (curPage))
+			return;
+		MyDB_PageReaderWriter pinnedPage = myParent.getPinned (curPage);
+		if (pinnedPage.getType () != MyDB_PageType :: DirectoryPage)
+			myIter = pinnedPage.getIteratorAlt ();
+	}
+}
+
+int MyDB_TableRecIteratorAlt :: getBatch (void **intoMe, int maxRecs) {
+
+	while (true) {
+
+		pinCurPage ();
+		if (myIter != nullptr) {
+			int numRecs = myIter->getBatch (intoMe, maxRecs);
+			if (numRecs > 0)
+				return numRecs;
+		}
+
+		if (curPage == myTable->lastPage () || curPage == highPage)
+			return 0;
+
+		curPage++;
+		curPagePinned = false;
+	}
+}
+
+int MyDB_TableRecIteratorAlt :: getColumnBatch (vector <int> &whichAtts, vector <void **> &intoMe, int maxRecs) {
+
+	while (true) {
+
+		pinCurPage ();
+		if (myIter != nullptr) {
+			int numRecs = myIter->getColumnBatch (whichAtts, intoMe, maxRecs);
+			if (numRecs > 0)
+				return numRecs;
+		}
+
+		if (curPage == myTable->lastPage () || curPage == highPage)
+			return 0;
+
+		curPage++;
+		curPagePinned = false;
+	}
+}
+
 MyDB_TableRecIteratorAlt :: MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn,
 	int lowPage, int highPageIn) :
 	myParent (myParent) {
 	myTable = myTableIn;
 	curPage = lowPage;
 	highPage = highPageIn;
-	myIter = myParent[curPage].getIteratorAlt ();		
+	curPagePinned = false;
+	readPage = [] (int) {return true;};
+	myIter = getPageIter ();
+}
+
+MyDB_TableRecIteratorAlt :: MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn,
+	function <bool (int)> readPageIn) :
+	myParent (myParent) {
+	myTable = myTableIn;
+	curPage = 0;
+	highPage = 1999999999;
+	curPagePinned = false;
+	readPage = readPageIn;
+	myIter = getPageIter ();
 }
 
 MyDB_TableRecIteratorAlt :: MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn) :
@@ -51,7 +122,9 @@ MyDB_TableRecIteratorAlt :: MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &my
 	myTable = myTableIn;
 	curPage = 0;
 	highPage = 1999999999;
-	myIter = myParent[curPage].getIteratorAlt ();		
+	curPagePinned = false;
+	readPage = [] (int) {return true;};
+	myIter = getPageIter ();
 }
 
 MyDB_TableRecIteratorAlt :: ~MyDB_TableRecIteratorAlt () {}
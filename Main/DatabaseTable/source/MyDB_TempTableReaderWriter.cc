@@ -0,0 +1,67 @@
+
+#ifndef TEMP_TABLE_RW_C
+#define TEMP_TABLE_RW_C
+
+#include "MyDB_TempTableReaderWriter.h"
+
+MyDB_TempTableReaderWriter :: MyDB_TempTableReaderWriter (MyDB_SchemaPtr mySchema, MyDB_BufferManagerPtr myBuffer) :
+	MyDB_TableReaderWriter (mySchema, myBuffer) {
+
+	pages.push_back (MyDB_PageReaderWriter (*myBuffer));
+}
+
+void MyDB_TempTableReaderWriter :: append (MyDB_RecordPtr appendMe) {
+	if (!pages.back ().append (appendMe)) {
+		pages.push_back (MyDB_PageReaderWriter (*getBufferMgr ()));
+		pages.back ().append (appendMe);
+	}
+}
+
+void MyDB_TempTableReaderWriter :: appendPageImage (void *page) {
+	if (pages.back ().getNumRecords () > 0)
+		pages.push_back (MyDB_PageReaderWriter (*getBufferMgr ()));
+	pages.back ().copyFrom (page);
+}
+
+MyDB_RecordIteratorAltPtr MyDB_TempTableReaderWriter :: getIteratorAlt () {
+	return :: getIteratorAlt (pages);
+}
+
+MyDB_RecordIteratorAltPtr MyDB_TempTableReaderWriter :: getIteratorAlt (int lowPage, int highPage) {
+	vector <MyDB_PageReaderWriter> range (pages.begin () + lowPage, pages.begin () + highPage + 1);
+	return :: getIteratorAlt (range);
+}
+
+MyDB_RecordIteratorAltPtr MyDB_TempTableReaderWriter :: getIteratorAlt (function <bool (int)> readPage) {
+
+	// if none of the pages is read, the iterator is over a single empty page
+	vector <MyDB_PageReaderWriter> toRead;
+	for (size_t i = 0; i < pages.size (); i++)
+		if (readPage (i))
+			toRead.push_back (pages[i]);
+	if (toRead.empty ())
+		toRead.push_back (MyDB_PageReaderWriter (*getBufferMgr ()));
+	return :: getIteratorAlt (toRead);
+}
+
+MyDB_PageReaderWriter MyDB_TempTableReaderWriter :: operator [] (size_t i) {
+
+	// see if we are going off of the end of the table... if so, then add empty pages
+	while (i >= pages.size ())
+		pages.push_back (MyDB_PageReaderWriter (*getBufferMgr ()));
+	return pages[i];
+}
+
+MyDB_PageReaderWriter MyDB_TempTableReaderWriter :: getPinned (size_t i) {
+	return (*this)[i].getPinned ();
+}
+
+MyDB_PageReaderWriter MyDB_TempTableReaderWriter :: last () {
+	return pages.back ();
+}
+
+int MyDB_TempTableReaderWriter :: getNumPages () {
+	return pages.size ();
+}
+
+#endif
@@ -0,0 +1,378 @@
+
+#ifndef ZONE_MAP_C
+#define ZONE_MAP_C
+
+#include "MyDB_Hash.h"
+#include "MyDB_StringView.h"
+#include "MyDB_ZoneMap.h"
+#include <algorithm>
+#include <float.h>
+#include <fstream>
+#include <iostream>
+
+// used to write the zones to a file and read them back
+template <class T>
+static void writeVector (ofstream &toMe, vector <T> &writeMe) {
+	size_t len = writeMe.size ();
+	toMe.write ((char *) &len, sizeof (len));
+	toMe.write ((char *) writeMe.data (), len * sizeof (T));
+}
+
+template <class T>
+static bool readVector (ifstream &fromMe, vector <T> &intoMe) {
+	size_t len = 0;
+	if (!fromMe.read ((char *) &len, sizeof (len)) || len > (1ULL << 36) / sizeof (T))
+		return false;
+	intoMe.resize (len);
+	return (bool) fromMe.read ((char *) intoMe.data (), len * sizeof (T));
+}
+
+MyDB_ZoneMap :: MyDB_ZoneMap (MyDB_SchemaPtr mySchemaIn, vector <string> &bloomAttNames, size_t pageSize) {
+
+	mySchema = mySchemaIn;
+	pagesChecked = 0;
+	changed = false;
+
+	// a filter with one bit per byte on the page holds a page of small records with few
+	// false positives, and it is only one eighth as big as the page
+	bloomWords = pageSize / 64 / 8;
+	if (bloomWords == 0)
+		bloomWords = 1;
+
+	for (auto &a : mySchema->getAtts ()) {
+
+		bool isBloom = false;
+		for (auto &b : bloomAttNames)
+			if (b == a.first)
+				isBloom = true;
+		if (isBloom && !a.second->isBool ()) {
+			bloomForAtt.push_back (bloomAtts.size ());
+			bloomAtts.push_back (bloomForAtt.size () - 1);
+		} else {
+			bloomForAtt.push_back (-1);
+		}
+
+		// this matches the modes that MyDB_Expr uses for comparisons with literals
+		MyDB_AttTypePtr type = a.second;
+		bool isDecimal = dynamic_pointer_cast <MyDB_DecimalAttType> (type) != nullptr;
+		if (!type->isBool () && !isDecimal && !type->promotableToDouble ()) {
+			stringZoneForAtt.push_back (stringZoneAtts.size ());
+			stringZoneAtts.push_back (stringZoneForAtt.size () - 1);
+		} else {
+			stringZoneForAtt.push_back (-1);
+		}
+		if (type->isBool () || isDecimal || !type->promotableToDouble ()) {
+			zoneForAtt.push_back (-1);
+			continue;
+		}
+		zoneForAtt.push_back (zoneAtts.size ());
+		zoneAtts.push_back (zoneForAtt.size () - 1);
+		isInt.push_back (type->promotableToInt ());
+	}
+
+	zoneSkips.resize (zoneAtts.size ());
+	stringZoneSkips.resize (stringZoneAtts.size ());
+	bloomSkips.resize (bloomAtts.size ());
+}
+
+uint64_t MyDB_ZoneMap :: getPrefix (const char *data, size_t length) {
+	uint64_t prefix = 0;
+	for (size_t i = 0; i < 8; i++)
+		prefix = (prefix << 8) | (i < length ? (unsigned char) data[i] : 0);
+	return prefix;
+}
+
+void MyDB_ZoneMap :: clear () {
+	hasZone.clear ();
+	lows.clear ();
+	highs.clear ();
+	stringLows.clear ();
+	stringHighs.clear ();
+	blooms.clear ();
+	changed = true;
+}
+
+bool MyDB_ZoneMap :: hasZones () {
+	return zoneAtts.size () > 0 || stringZoneAtts.size () > 0 || bloomAtts.size () > 0;
+}
+
+bool MyDB_ZoneMap :: isChanged () {
+	return changed;
+}
+
+void MyDB_ZoneMap :: startPage (int whichPage) {
+	if ((int) hasZone.size () <= whichPage) {
+		hasZone.resize (whichPage + 1, false);
+		lows.resize ((whichPage + 1) * zoneAtts.size ());
+		highs.resize ((whichPage + 1) * zoneAtts.size ());
+		stringLows.resize ((whichPage + 1) * stringZoneAtts.size ());
+		stringHighs.resize ((whichPage + 1) * stringZoneAtts.size ());
+		blooms.resize ((whichPage + 1) * bloomAtts.size () * bloomWords);
+	}
+	hasZone[whichPage] = true;
+	changed = true;
+	for (size_t i = 0; i < zoneAtts.size (); i++) {
+		lows[whichPage * zoneAtts.size () + i] = DBL_MAX;
+		highs[whichPage * zoneAtts.size () + i] = -DBL_MAX;
+	}
+	for (size_t i = 0; i < stringZoneAtts.size (); i++) {
+		stringLows[whichPage * stringZoneAtts.size () + i] = UINT64_MAX;
+		stringHighs[whichPage * stringZoneAtts.size () + i] = 0;
+	}
+	if (bloomAtts.size () > 0)
+		fill (bloomWord (whichPage, 0, 0), bloomWord (whichPage, 0, 0) + bloomAtts.size () * bloomWords, 0);
+}
+
+// the bits that stand for a hash in a Bloom filter with the given number of words; these are
+// found by double hashing, with a second hash that is made odd so it is never zero
+#define NUM_BLOOM_BITS 4
+#define FOR_EACH_BLOOM_BIT(hashVal, bit) \
+	for (size_t k = 0, h2 = hashInt (hashVal) | 1, bit = hashVal; k < NUM_BLOOM_BITS; k++, bit += h2)
+
+void MyDB_ZoneMap :: add (int whichPage, MyDB_RecordPtr rec) {
+	if (whichPage >= (int) hasZone.size () || !hasZone[whichPage])
+		return;
+	for (size_t i = 0; i < zoneAtts.size (); i++) {
+		MyDB_AttValPtr att = rec->getAtt (zoneAtts[i]);
+		double val = isInt[i] ? att->toInt () : att->toDouble ();
+		size_t pos = whichPage * zoneAtts.size () + i;
+		if (val < lows[pos])
+			lows[pos] = val;
+		if (val > highs[pos])
+			highs[pos] = val;
+	}
+	for (size_t i = 0; i < stringZoneAtts.size (); i++) {
+		MyDB_StringView val = rec->getAtt (stringZoneAtts[i])->toStringView ();
+		uint64_t prefix = getPrefix (val.data, val.length);
+		size_t pos = whichPage * stringZoneAtts.size () + i;
+		if (prefix < stringLows[pos])
+			stringLows[pos] = prefix;
+		if (prefix > stringHighs[pos])
+			stringHighs[pos] = prefix;
+	}
+	for (size_t i = 0; i < bloomAtts.size (); i++) {
+		size_t hashVal = rec->getAtt (bloomAtts[i])->hash ();
+		FOR_EACH_BLOOM_BIT (hashVal, bit)
+			*bloomWord (whichPage, i, bit) |= 1ULL << (bit % 64);
+	}
+}
+
+void MyDB_ZoneMap :: copyPage (int whichPage, MyDB_ZoneMap &fromMe, int fromPage) {
+	if (fromPage >= (int) fromMe.hasZone.size () || !fromMe.hasZone[fromPage]) {
+		forget (whichPage);
+		return;
+	}
+	startPage (whichPage);
+	for (size_t i = 0; i < zoneAtts.size (); i++) {
+		lows[whichPage * zoneAtts.size () + i] = fromMe.lows[fromPage * zoneAtts.size () + i];
+		highs[whichPage * zoneAtts.size () + i] = fromMe.highs[fromPage * zoneAtts.size () + i];
+	}
+	for (size_t i = 0; i < stringZoneAtts.size (); i++) {
+		stringLows[whichPage * stringZoneAtts.size () + i] = fromMe.stringLows[fromPage * stringZoneAtts.size () + i];
+		stringHighs[whichPage * stringZoneAtts.size () + i] = fromMe.stringHighs[fromPage * stringZoneAtts.size () + i];
+	}
+	if (bloomAtts.size () > 0)
+		copy (fromMe.bloomWord (fromPage, 0, 0), fromMe.bloomWord (fromPage, 0, 0) + bloomAtts.size () * bloomWords,
+			bloomWord (whichPage, 0, 0));
+}
+
+void MyDB_ZoneMap :: forget (int whichPage) {
+	if (whichPage < (int) hasZone.size ())
+		hasZone[whichPage] = false;
+	changed = true;
+}
+
+function <bool (int)> MyDB_ZoneMap :: getPageFilter (string predicate) {
+	MyDB_ExprPtr pred = MyDB_Expr :: parse (predicate);
+	pred->resolve (mySchema);
+	return getPageFilter (pred);
+}
+
+function <bool (int)> MyDB_ZoneMap :: getPageFilter (MyDB_ExprPtr predicate) {
+
+	pagesChecked = 0;
+	fill (zoneSkips.begin (), zoneSkips.end (), 0);
+	fill (stringZoneSkips.begin (), stringZoneSkips.end (), 0);
+	fill (bloomSkips.begin (), bloomSkips.end (), 0);
+
+	// find the conjuncts that compare an attribute with a zone to a literal, and the
+	// equalities between an attribute with a Bloom filter and a literal
+	vector <MyDB_ExprPtr> conjuncts;
+	MyDB_Expr :: getConjuncts (predicate, conjuncts);
+	vector <int> whichZone;
+	vector <MyDB_ExprOp> cmps;
+	vector <double> constants;
+	vector <int> whichStringZone;
+	vector <MyDB_ExprOp> stringCmps;
+	vector <uint64_t> prefixes;
+	vector <int> whichBloom;
+	vector <size_t> hashes;
+	for (auto &c : conjuncts) {
+		int whichAtt;
+		MyDB_ExprOp cmp;
+		MyDB_ExprPtr literal;
+		if (!c->isAttVsLiteral (whichAtt, cmp, literal))
+			continue;
+		bool isNumber = literal->getOp () == intOp || literal->getOp () == doubleOp;
+		if (isNumber && zoneForAtt[whichAtt] != -1) {
+			whichZone.push_back (zoneForAtt[whichAtt]);
+			cmps.push_back (cmp);
+			constants.push_back (literal->getOp () == intOp ? (double) literal->getInt () : literal->getDouble ());
+		}
+
+		// values that differ only after the prefix look the same, so != never skips a page
+		if (literal->getOp () == stringOp && stringZoneForAtt[whichAtt] != -1 && cmp != neqOp) {
+			string &val = literal->getString ();
+			whichStringZone.push_back (stringZoneForAtt[whichAtt]);
+			stringCmps.push_back (cmp);
+			prefixes.push_back (getPrefix (val.data (), val.size ()));
+		}
+
+		// the literal must be hashed just like an equal value of the attribute
+		if (cmp != eqOp || bloomForAtt[whichAtt] == -1)
+			continue;
+		MyDB_AttTypePtr type = mySchema->getAtts ()[whichAtt].second;
+		if (isNumber && type->promotableToDouble ()) {
+			whichBloom.push_back (bloomForAtt[whichAtt]);
+			hashes.push_back (literal->getOp () == intOp ? hashInt (literal->getInt ()) : hashDouble (literal->getDouble ()));
+		} else if (literal->getOp () == stringOp && !type->promotableToDouble ()) {
+			string &val = literal->getString ();
+			whichBloom.push_back (bloomForAtt[whichAtt]);
+			hashes.push_back (MyDB_StringView (val.data (), val.size ()).hash ());
+		}
+	}
+
+	if (cmps.empty () && stringCmps.empty () && hashes.empty ())
+		return [] (int) {return true;};
+
+	// a page might have a match unless one of the conjuncts is false for its whole range, or
+	// one of the literals is not in its Bloom filter
+	return [this, whichZone, cmps, constants, whichStringZone, stringCmps, prefixes, whichBloom, hashes] (int whichPage) {
+		if (whichPage >= (int) hasZone.size () || !hasZone[whichPage])
+			return true;
+		pagesChecked++;
+		for (size_t j = 0; j < cmps.size (); j++) {
+			size_t pos = whichPage * zoneAtts.size () + whichZone[j];
+			double low = lows[pos], high = highs[pos], val = constants[j];
+			if (low > high ||
+				(cmps[j] == gtOp && !(high > val)) ||
+				(cmps[j] == ltOp && !(low < val)) ||
+				(cmps[j] == eqOp && !(low <= val && val <= high)) ||
+				(cmps[j] == neqOp && low == val && high == val)) {
+				zoneSkips[whichZone[j]]++;
+				return false;
+			}
+		}
+
+		// a value whose prefix is the same as the literal's may be on either side of it
+		for (size_t j = 0; j < stringCmps.size (); j++) {
+			size_t pos = whichPage * stringZoneAtts.size () + whichStringZone[j];
+			uint64_t low = stringLows[pos], high = stringHighs[pos], val = prefixes[j];
+			if (low > high ||
+				(stringCmps[j] == gtOp && high < val) ||
+				(stringCmps[j] == ltOp && low > val) ||
+				(stringCmps[j] == eqOp && (val < low || val > high))) {
+				stringZoneSkips[whichStringZone[j]]++;
+				return false;
+			}
+		}
+		for (size_t j = 0; j < hashes.size (); j++) {
+			FOR_EACH_BLOOM_BIT (hashes[j], bit) {
+				if (!(*bloomWord (whichPage, whichBloom[j], bit) & (1ULL << (bit % 64)))) {
+					bloomSkips[whichBloom[j]]++;
+					return false;
+				}
+			}
+		}
+		return true;
+	};
+}
+
+string MyDB_ZoneMap :: getSkipCounts () {
+	size_t total = 0;
+	string counts;
+	for (size_t i = 0; i < zoneAtts.size (); i++) {
+		if (zoneSkips[i] == 0)
+			continue;
+		total += zoneSkips[i];
+		counts += (counts == "" ? "" : ", ") + string ("range ") + mySchema->getAtts ()[zoneAtts[i]].first +
+			": " + to_string (zoneSkips[i]);
+	}
+	for (size_t i = 0; i < stringZoneAtts.size (); i++) {
+		if (stringZoneSkips[i] == 0)
+			continue;
+		total += stringZoneSkips[i];
+		counts += (counts == "" ? "" : ", ") + string ("range ") + mySchema->getAtts ()[stringZoneAtts[i]].first +
+			": " + to_string (stringZoneSkips[i]);
+	}
+	for (size_t i = 0; i < bloomAtts.size (); i++) {
+		if (bloomSkips[i] == 0)
+			continue;
+		total += bloomSkips[i];
+		counts += (counts == "" ? "" : ", ") + string ("bloom ") + mySchema->getAtts ()[bloomAtts[i]].first +
+			": " + to_string (bloomSkips[i]);
+	}
+	if (total == 0)
+		return "";
+	return to_string (pagesChecked) + " pages, skipped " + to_string (total) + " (" + counts + ")";
+}
+
+void MyDB_ZoneMap :: save (string fileName, size_t fingerprint) {
+
+	ofstream toMe (fileName, ofstream::binary | ofstream::trunc);
+	if (!toMe) {
+		cout << "Could not write the zones to " << fileName << "\n";
+		return;
+	}
+
+	// the layout is written first, so that a file for a different layout is not read
+	toMe.write ((char *) &fingerprint, sizeof (fingerprint));
+	toMe.write ((char *) &bloomWords, sizeof (bloomWords));
+	writeVector (toMe, zoneAtts);
+	writeVector (toMe, bloomAtts);
+	vector <char> hasZoneBytes (hasZone.begin (), hasZone.end ());
+	writeVector (toMe, hasZoneBytes);
+	writeVector (toMe, lows);
+	writeVector (toMe, highs);
+	writeVector (toMe, blooms);
+	writeVector (toMe, stringZoneAtts);
+	writeVector (toMe, stringLows);
+	writeVector (toMe, stringHighs);
+	changed = false;
+}
+
+void MyDB_ZoneMap :: load (string fileName, size_t fingerprint, int numPages) {
+
+	ifstream fromMe (fileName, ifstream::binary);
+	size_t savedFingerprint = 0, savedWords = 0;
+	vector <int> savedZoneAtts, savedBloomAtts, savedStringZoneAtts;
+	vector <char> hasZoneBytes;
+	vector <double> savedLows, savedHighs;
+	vector <uint64_t> savedBlooms, savedStringLows, savedStringHighs;
+	if (!fromMe ||
+		!fromMe.read ((char *) &savedFingerprint, sizeof (savedFingerprint)) ||
+		!fromMe.read ((char *) &savedWords, sizeof (savedWords)) ||
+		savedFingerprint != fingerprint || savedWords != bloomWords ||
+		!readVector (fromMe, savedZoneAtts) || savedZoneAtts != zoneAtts ||
+		!readVector (fromMe, savedBloomAtts) || savedBloomAtts != bloomAtts ||
+		!readVector (fromMe, hasZoneBytes) || (int) hasZoneBytes.size () > numPages ||
+		!readVector (fromMe, savedLows) || savedLows.size () != hasZoneBytes.size () * zoneAtts.size () ||
+		!readVector (fromMe, savedHighs) || savedHighs.size () != savedLows.size () ||
+		!readVector (fromMe, savedBlooms) || savedBlooms.size () != hasZoneBytes.size () * bloomAtts.size () * bloomWords ||
+		!readVector (fromMe, savedStringZoneAtts) || savedStringZoneAtts != stringZoneAtts ||
+		!readVector (fromMe, savedStringLows) || savedStringLows.size () != hasZoneBytes.size () * stringZoneAtts.size () ||
+		!readVector (fromMe, savedStringHighs) || savedStringHighs.size () != savedStringLows.size ())
+		return;
+
+	hasZone.assign (hasZoneBytes.begin (), hasZoneBytes.end ());
+	lows.swap (savedLows);
+	highs.swap (savedHighs);
+	blooms.swap (savedBlooms);
+	stringLows.swap (savedStringLows);
+	stringHighs.swap (savedStringHighs);
+	if (hasZone.size () > 0)
+		forget (hasZone.size () - 1);
+	changed = false;
+}
+
+#endif
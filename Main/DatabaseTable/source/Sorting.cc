@@ -3,6 +3,7 @@
 #define SORT_C
 
 #include <queue>
+#include "MyDB_ConjunctFilter.h"
 #include "MyDB_PageReaderWriter.h"
 #include "MyDB_TableRecIterator.h"
 #include "MyDB_TableRecIteratorAlt.h"
@@ -113,6 +114,7 @@ MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableRea
 		skipPred = true;
 
 	func f = lhs->compileComputation (lhsPred);
+	MyDB_ConjunctFilter prefilter (sortMe.getTable ()->getSchema (), lhsPred);
 
 	// this is the list of all of the pages in the file
 	vector <vector<MyDB_PageReaderWriter>> allPages;
@@ -123,35 +125,43 @@ MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableRea
 	// this is the list of all of the iterators, with one for each run
 	vector <MyDB_RecordIteratorAltPtr> runIters;
 	
-	// process the file 
+	// process the file, skipping the pages that the zone map says cannot have a match
+	function <bool (int)> readPage = sortMe.getPageFilter (lhsPred);
 	MyDB_PageReaderWriter tempPage (true, *sortMe.getBufferMgr ());
 	for (int i = 0; i < sortMe.getNumPages (); i++) {
 		
-		if (sortMe[i].getType () == MyDB_PageType :: RegularPage) {
+		if (readPage (i) && sortMe[i].getType () != MyDB_PageType :: DirectoryPage) {
 
 			if (skipPred) {
 				vector <MyDB_PageReaderWriter> run;
 				run.push_back (*(sortMe[i].sort (comparator, lhs, rhs)));	
 				pagesToSort.push_back (run);
 			} else {
-				MyDB_RecordIteratorAltPtr temp = sortMe[i].getIteratorAlt ();
-				while (temp->advance ()) {
-					temp->getCurrent (lhs);
-
-					if (!f ()->toBool ())
-						continue;
-
-					if (!tempPage.append (lhs)) {
+				// the page is pinned, since sorting a full temp page allocates another one
+				void *batch[MAX_BATCH_SIZE];
+				int selected[MAX_BATCH_SIZE];
+				MyDB_RecordIteratorAltPtr temp = sortMe.getPinned (i).getIteratorAlt ();
+				int numRecs;
+				while ((numRecs = temp->getBatch (batch, MAX_BATCH_SIZE)) > 0) {
+					int numSelected = prefilter.run (batch, numRecs, selected);
+					for (int j = 0; j < numSelected; j++) {
+						lhs->fromBinary (batch[selected[j]]);
+
+						if (!f ()->toBool ())
+							continue;
+
+						if (!tempPage.append (lhs)) {
 	
-						// remember the old page
-						vector <MyDB_PageReaderWriter> run;
-						run.push_back (*(tempPage.sort (comparator, lhs, rhs)));
-						pagesToSort.push_back (run);
+							// remember the old page
+							vector <MyDB_PageReaderWriter> run;
+							run.push_back (*(tempPage.sort (comparator, lhs, rhs)));
+							pagesToSort.push_back (run);
 	
-						// get the new page
-						tempPage = MyDB_PageReaderWriter (true, *sortMe.getBufferMgr ());	
-						temp->getCurrent (lhs);
-						tempPage.append (lhs);
+							// get the new page
+							tempPage = MyDB_PageReaderWriter (true, *sortMe.getBufferMgr ());	
+							lhs->fromBinary (batch[selected[j]]);
+							tempPage.append (lhs);
+						}
 					}
 				}
 			}
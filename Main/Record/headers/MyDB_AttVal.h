@@ -2,7 +2,10 @@
 #ifndef ATT_VAL_H
 #define ATT_VAL_H
 
+#include "MyDB_OverflowFile.h"
+#include "MyDB_StringDictionary.h"
 #include <memory>
+#include <string.h>
 #include <string>
 
 // create a smart pointer for the catalog
@@ -27,10 +30,18 @@ public:
 	virtual double toDouble () = 0;
 	virtual string toString () = 0;
 	virtual bool toBool () = 0;
+
+	// the same text as toString (), but without making a copy if the value is already a
+	// string; the view is good until this att val is changed or asked for another view
+	virtual MyDB_StringView toStringView () = 0;
 	virtual void set (MyDB_AttValPtr toMe) = 0;
 	virtual size_t hash () = 0;
 	virtual MyDB_AttValPtr getCopy () = 0;
 	virtual void fromString (string &fromMe) = 0;
+
+	// same as fromString (), but parses the len characters at start (which do not need to be
+	// followed by a null); this does not allocate memory unless the value itself needs it
+	virtual void fromText (const char *start, size_t len);
 	virtual void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) = 0;
 	virtual ~MyDB_AttVal ();
 
@@ -88,9 +99,11 @@ public:
 	int toInt () override;
 	double toDouble () override;
 	string toString () override;
+	MyDB_StringView toStringView () override;
 	void fromInt (int fromMe) override;
 	bool toBool () override;
 	void fromString (string &fromMe) override;
+	void fromText (const char *start, size_t len) override;
 	void set (MyDB_AttValPtr toMe) override;
 	size_t hash () override;
 	MyDB_AttValPtr getCopy () override;
@@ -102,6 +115,9 @@ public:
 private:
 
 	int value;
+
+	// holds the text for toStringView ()
+	string asString;
 };
 
 class MyDB_DoubleAttVal;
@@ -114,12 +130,14 @@ public:
 	int toInt () override;
 	double toDouble () override;
 	string toString () override;
+	MyDB_StringView toStringView () override;
 	bool toBool () override;
 	void fromInt (int fromMe) override;
 	MyDB_AttValPtr getCopy () override;
 	size_t hash () override;
 	void set (MyDB_AttValPtr toMe) override;
 	void fromString (string &fromMe) override;
+	void fromText (const char *start, size_t len) override;
 	void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) override;
 	void set (double val);
 	MyDB_DoubleAttVal ();
@@ -128,6 +146,89 @@ public:
 private:
 
 	double value;
+
+	// holds the text for toStringView ()
+	string asString;
+};
+
+// the most digits that a DECIMAL (p, s) can have; any such number fits in a 64-bit int
+#define MAX_DECIMAL_PRECISION 18
+
+class MyDB_DecimalAttVal;
+typedef shared_ptr <MyDB_DecimalAttVal> MyDB_DecimalAttValPtr;
+
+// a decimal with scale digits after the decimal point, stored as the 8-byte integer
+// value * 10^scale.  Text is parsed and written out exactly (digits past the scale are rounded
+// off, half away from zero); as a double, it is the closest double to the exact value
+class MyDB_DecimalAttVal : public MyDB_AttVal {
+
+public:
+
+	int toInt () override;
+	double toDouble () override;
+	string toString () override;
+	MyDB_StringView toStringView () override;
+	bool toBool () override;
+	void fromInt (int fromMe) override;
+	void fromString (string &fromMe) override;
+	void fromText (const char *start, size_t len) override;
+
+	// if the value being set is a decimal, this is exact (other than rounding off digits, if
+	// it has a larger scale); otherwise it goes through a double
+	void set (MyDB_AttValPtr toMe) override;
+	size_t hash () override;
+	MyDB_AttValPtr getCopy () override;
+	void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) override;
+
+	// the stored integer, value * 10^scale
+	inline long long getScaled () {
+		void *dataPtr = getDataPointer ();
+		if (dataPtr == nullptr)
+			return scaled;
+		else
+			return *((long long *) dataPtr);
+	}
+
+	inline void setScaled (long long val) {
+		scaled = val;
+		setNotBuffered ();
+	}
+
+	inline int getScale () {
+		return scale;
+	}
+
+	// 10^n, for n from 0 to MAX_DECIMAL_PRECISION
+	static inline long long powerOfTen (int n) {
+		static const long long powers[] = {1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL,
+			10000000LL, 100000000LL, 1000000000LL, 10000000000LL, 100000000000LL, 1000000000000LL,
+			10000000000000LL, 100000000000000LL, 1000000000000000LL, 10000000000000000LL,
+			100000000000000000LL, 1000000000000000000LL};
+		return powers[n];
+	}
+
+	// converts a stored integer with fromScale digits after the decimal point to one with
+	// toScale digits, rounding half away from zero if digits are lost
+	static long long rescale (long long val, int fromScale, int toScale);
+
+	// writes out a stored integer with the given scale, such as "-12.50"
+	static string format (long long val, int scale);
+
+	MyDB_DecimalAttVal (int precision, int scale);
+	~MyDB_DecimalAttVal ();
+
+private:
+
+	// sets the value from the len characters at start; exits if they are not a number that
+	// fits in the precision
+	void setText (const char *start, size_t len);
+
+	long long scaled;
+	int precision;
+	int scale;
+
+	// holds the text for toStringView ()
+	string asString;
 };
 
 class MyDB_StringAttVal;
@@ -140,14 +241,19 @@ public:
 	int toInt () override;
 	double toDouble () override;
 	string toString () override;
+	MyDB_StringView toStringView () override;
 	bool toBool () override;
 	void fromString (string &fromMe) override;
+	void fromText (const char *start, size_t len) override;
 	MyDB_AttValPtr getCopy () override;
 	size_t hash () override;
 	void set (MyDB_AttValPtr toMe) override;
 	void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) override;
 	void fromInt (int fromMe) override;
 	void set (string val);
+
+	// sets the value to lhs followed by rhs, re-using the space that is already allocated
+	void setConcat (MyDB_AttValPtr lhs, MyDB_AttValPtr rhs);
 	MyDB_StringAttVal ();
 	~MyDB_StringAttVal ();
 
@@ -156,6 +262,56 @@ private:
 	string value;
 };
 
+// the widest CHAR (n) attribute that can be declared
+#define MAX_CHAR_WIDTH 255
+
+class MyDB_CharAttVal;
+typedef shared_ptr <MyDB_CharAttVal> MyDB_CharAttValPtr;
+
+// a string of at most width characters, which is stored on a page as width + 1 bytes: the
+// characters, padded with nulls.  Other than that, this acts just like a MyDB_StringAttVal
+class MyDB_CharAttVal : public MyDB_AttVal {
+
+public:
+
+	int toInt () override;
+	double toDouble () override;
+	string toString () override;
+	MyDB_StringView toStringView () override;
+	bool toBool () override;
+	void fromString (string &fromMe) override;
+	void fromText (const char *start, size_t len) override;
+	MyDB_AttValPtr getCopy () override;
+	void set (MyDB_AttValPtr toMe) override;
+	size_t hash () override;
+	void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) override;
+	void fromInt (int fromMe) override;
+
+	// true if the value is the same as padded, which is a string written out just the way that
+	// this attribute is written on a page (width + 1 bytes, padded with nulls)
+	inline bool matches (const char *padded) {
+		void *dataPtr = getDataPointer ();
+		if (dataPtr != nullptr)
+			return memcmp (dataPtr, padded, width + 1) == 0;
+		return memcmp (value.data (), padded, value.size ()) == 0 && padded[value.size ()] == 0;
+	}
+
+	inline int getWidth () {
+		return width;
+	}
+
+	MyDB_CharAttVal (int width);
+	~MyDB_CharAttVal ();
+
+private:
+
+	// sets the value to the len characters at start; exits if there are too many of them
+	void setChars (const char *start, size_t len);
+
+	int width;
+	string value;
+};
+
 class MyDB_BoolAttVal;
 typedef shared_ptr <MyDB_BoolAttVal> MyDB_BoolAttValPtr;
 
@@ -166,6 +322,7 @@ public:
 	int toInt () override;
 	double toDouble () override;
 	string toString () override;
+	MyDB_StringView toStringView () override;
 	bool toBool () override;
 	void fromString (string &fromMe) override;
 	void set (MyDB_AttValPtr toMe) override;
@@ -182,6 +339,144 @@ private:
 	bool value;
 };
 
+class MyDB_DictStringAttVal;
+typedef shared_ptr <MyDB_DictStringAttVal> MyDB_DictStringAttValPtr;
+
+// a dictionary-encoded string: what is stored is the two-byte code that the attribute's
+// dictionary gives to the string.  Other than that, this acts just like a MyDB_StringAttVal
+class MyDB_DictStringAttVal : public MyDB_AttVal {
+
+public:
+
+	int toInt () override;
+	double toDouble () override;
+	string toString () override;
+	MyDB_StringView toStringView () override;
+	bool toBool () override;
+	void fromString (string &fromMe) override;
+	void fromText (const char *start, size_t len) override;
+	MyDB_AttValPtr getCopy () override;
+	void set (MyDB_AttValPtr toMe) override;
+	size_t hash () override;
+	void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) override;
+	void fromInt (int fromMe) override;
+
+	// the code for the value
+	inline int getCode () {
+		void *dataPtr = getDataPointer ();
+		if (dataPtr == nullptr)
+			return code;
+		else
+			return *((unsigned short *) dataPtr);
+	}
+
+	// the dictionary that the code is from
+	inline MyDB_StringDictionaryPtr &getDictionary () {
+		return myDictionary;
+	}
+
+	MyDB_DictStringAttVal (MyDB_StringDictionaryPtr myDictionary);
+	~MyDB_DictStringAttVal ();
+
+private:
+
+	int code;
+	MyDB_StringDictionaryPtr myDictionary;
+};
+
+class MyDB_OverflowAttVal;
+typedef shared_ptr <MyDB_OverflowAttVal> MyDB_OverflowAttValPtr;
+
+// a string that is stored out of line, in the attribute's overflow file: what is stored on the
+// page is the position of the value in the file, and the value is only read from the file when
+// something asks for it.  Setting one of these from another one that uses the same file just
+// copies the position.  Other than that, this acts just like a MyDB_StringAttVal
+class MyDB_OverflowAttVal : public MyDB_AttVal {
+
+public:
+
+	int toInt () override;
+	double toDouble () override;
+	string toString () override;
+	MyDB_StringView toStringView () override;
+	bool toBool () override;
+	void fromString (string &fromMe) override;
+	void fromText (const char *start, size_t len) override;
+	MyDB_AttValPtr getCopy () override;
+	void set (MyDB_AttValPtr toMe) override;
+	size_t hash () override;
+	void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) override;
+	void fromInt (int fromMe) override;
+
+	// the position of the value in the overflow file, or -1 if it has not been written there
+	inline long long getPos () {
+		void *dataPtr = getDataPointer ();
+		if (dataPtr == nullptr)
+			return pos;
+		long long posOnPage;
+		memcpy (&posOnPage, dataPtr, sizeof (posOnPage));
+		return posOnPage;
+	}
+
+	inline MyDB_OverflowFilePtr &getOverflowFile () {
+		return myFile;
+	}
+
+	MyDB_OverflowAttVal (MyDB_OverflowFilePtr myFile);
+	~MyDB_OverflowAttVal ();
+
+private:
+
+	// sets the value to a string that has not been written to the file yet
+	void setValue (const char *start, size_t len);
+
+	long long pos;
+	MyDB_OverflowFilePtr myFile;
+
+	// the value, and the position that it came from (or -1, if it has not been written yet)
+	string value;
+	long long valuePos;
+};
+
+class MyDB_DateAttVal;
+typedef shared_ptr <MyDB_DateAttVal> MyDB_DateAttValPtr;
+
+// a date is stored as a 4-byte int: the number of days since 1970-01-01.  As an int, it is
+// just that number; as a string, it is written (and read) as YYYY-MM-DD
+class MyDB_DateAttVal : public MyDB_AttVal {
+
+public:
+
+	int toInt () override;
+	double toDouble () override;
+	string toString () override;
+	MyDB_StringView toStringView () override;
+	void fromInt (int fromMe) override;
+	bool toBool () override;
+	void fromString (string &fromMe) override;
+	void fromText (const char *start, size_t len) override;
+	void set (MyDB_AttValPtr toMe) override;
+	size_t hash () override;
+	MyDB_AttValPtr getCopy () override;
+	void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) override;
+	void set (int val);
+	MyDB_DateAttVal ();
+	~MyDB_DateAttVal ();
+
+	// converts YYYY-MM-DD to a number of days; returns false if the text is not a valid date
+	static bool parseDate (const char *fromMe, int &days);
+
+	// converts a number of days to YYYY-MM-DD
+	static string formatDate (int days);
+
+private:
+
+	int value;
+
+	// holds the text for toStringView ()
+	string asString;
+};
+
 
 
 #endif
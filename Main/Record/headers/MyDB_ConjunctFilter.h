@@ -0,0 +1,69 @@
+
+#ifndef CONJUNCT_FILTER_H
+#define CONJUNCT_FILTER_H
+
+#include "MyDB_Expr.h"
+#include "MyDB_FilterKernels.h"
+#include "MyDB_Schema.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// This is used to quickly throw out records that cannot possibly be accepted by a selection
+// predicate, before the (compiled) predicate is run on them one record at a time.  It finds
+// the simple conjuncts in the predicate, that is, comparisons such as > ([l_quantity], int[5])
+// or == ([o_orderstatus], string[F]) that are and-ed with the rest of the predicate.  Then, given
+// a batch of records, it decodes the attributes used by those conjuncts into arrays, and runs
+// them using the kernels in MyDB_FilterKernels.
+//
+// Every record that is accepted by the predicate is accepted by the filter, but not the other
+// way around, so the predicate still has to be run on the records that make it through.
+class MyDB_ConjunctFilter {
+
+public:
+
+	// pull the simple conjuncts out of the given predicate, over records with the given schema
+	MyDB_ConjunctFilter (MyDB_SchemaPtr mySchema, string predicate);
+
+	// the number of simple conjuncts that were found
+	int getNumConjuncts ();
+
+	// writes the position (in recs) of each of the records that are accepted by all of the
+	// simple conjuncts into sel, and returns how many there are; if there are no simple
+	// conjuncts, then this just lists all of the records
+	int run (void **recs, int numRecs, int *sel);
+
+private:
+
+	// decodes the value at data into position i of column c
+	void decode (int c, int i, char *data);
+
+	// the simple conjuncts
+	vector <int> whichCol;
+	vector <MyDB_ExprOp> cmps;
+	vector <int> intConstants;
+	vector <double> doubleConstants;
+	vector <string> stringConstants;
+
+	// the attributes that are decoded; there is one column for each, and only the vector
+	// matching the mode is used (a dictionary-encoded attribute is decoded into its codes)
+	vector <int> slotForAtt;
+	vector <MyDB_ExprMode> colModes;
+	vector <bool> isCodes;
+	vector <vector <int>> intCols;
+	vector <vector <double>> doubleCols;
+	vector <vector <char>> prefixCols;
+	int lastAttNeeded;
+
+	// where each column's attribute is in a record, if every attribute up to the last one
+	// needed always takes up the same amount of space; otherwise this is empty
+	vector <int> offsetForCol;
+
+	// the bitmaps
+	vector <uint64_t> bits;
+	vector <uint64_t> moreBits;
+};
+
+#endif
@@ -0,0 +1,95 @@
+
+#ifndef CONJUNCT_ORDER_H
+#define CONJUNCT_ORDER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// create a smart pointer for conjunct orders
+class MyDB_ConjunctOrder;
+typedef shared_ptr <MyDB_ConjunctOrder> MyDB_ConjunctOrderPtr;
+
+// This decides the order in which the conjuncts of an and (such as "&& (&& (A, B), C)") are run,
+// while a scan is in progress.  Whoever runs the conjuncts tells this object how many records
+// each conjunct was given, how many it accepted, and (for some of them) how long it took.  Every
+// so often, the conjuncts are re-ordered so that the one that gets rid of the most records for
+// the least time goes first; that is, by increasing cost per record / (1 - fraction accepted).
+// The counts are then halved, so that the order follows changes in the data as the scan goes.
+//
+// The counts for a conjunct are only for the records that got past the conjuncts before it, so
+// a conjunct that has not been given any records is tried first the next time around.
+//
+// A conjunct can be pinned, if running it on a record that an earlier conjunct rejects could
+// fail (see MyDB_Expr.canFail ()); it is always run after all of the conjuncts that come before
+// it in the list, though the ones after it can still be moved ahead of it
+class MyDB_ConjunctOrder {
+
+public:
+
+	// the conjuncts are described by the given strings; they are initially run in that order,
+	// and are re-ordered after every interval calls to tick ().  pinned[i] says whether
+	// conjunct i is pinned
+	MyDB_ConjunctOrder (vector <string> conjuncts, vector <bool> pinned, int interval);
+
+	// the positions (in the list given to the constructor) of the conjuncts, in the order
+	// they should be run
+	inline vector <int> &getOrder () {
+		return order;
+	}
+
+	// records that the given conjunct was run over numIn records, and accepted numOut of them
+	inline void addCounts (int which, size_t numIn, size_t numOut) {
+		stats[which].numIn += numIn;
+		stats[which].numOut += numOut;
+	}
+
+	// records that the given conjunct took the given number of nanoseconds to run over numIn
+	// records (this may be done for only some of the calls to addCounts ())
+	inline void addTime (int which, size_t numIn, double nanos) {
+		stats[which].numTimed += numIn;
+		stats[which].nanos += nanos;
+	}
+
+	// called once for each batch (or record) that the conjuncts are run over
+	inline void tick () {
+		if (++numTicks == interval) {
+			reorder ();
+			numTicks = 0;
+		}
+	}
+
+	// the number of times that the order has been re-computed
+	int getNumReorders ();
+
+	// adds the counts from another object over the same conjuncts (one that was used by another
+	// worker in the same scan, say) into this one, and re-computes the order
+	void merge (MyDB_ConjunctOrder &fromMe);
+
+	// the current order, along with the fraction of records accepted and the cost per record of
+	// each conjunct, such as "[< ([l_quantity], int[5])] 10% 2.1ns, [...] 50% 30.4ns"
+	string toString ();
+
+private:
+
+	void reorder ();
+
+	struct ConjunctStats {
+		double numIn = 0;
+		double numOut = 0;
+		double numTimed = 0;
+		double nanos = 0;
+	};
+
+	vector <string> conjuncts;
+	vector <bool> pinned;
+	vector <ConjunctStats> stats;
+	vector <int> order;
+	int interval;
+	int numTicks;
+	int numReorders;
+};
+
+#endif
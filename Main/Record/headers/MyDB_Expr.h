@@ -0,0 +1,126 @@
+
+#ifndef EXPR_H
+#define EXPR_H
+
+#include "MyDB_AttType.h"
+#include "MyDB_Schema.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// create a smart pointer for expressions
+class MyDB_Expr;
+typedef shared_ptr <MyDB_Expr> MyDB_ExprPtr;
+
+// the different kinds of nodes in an expression
+enum MyDB_ExprOp {attOp, intOp, doubleOp, stringOp, boolOp, plusOp, minusOp, timesOp, divideOp,
+	gtOp, ltOp, eqOp, neqOp, andOp, orOp, notOp, uMinusOp};
+
+// the domain that a node is evaluated in, once the types of its inputs have been promoted; in
+// decimalMode, values are the integers stored by a MyDB_DecimalAttVal
+enum MyDB_ExprMode {intMode, doubleMode, stringMode, boolMode, decimalMode};
+
+// This is a parsed version of a computation written in the prefix notation that is accepted
+// by MyDB_Record.compileComputation (), such as "&& (> ([att1], int[5]), == ([att2], string[x]))".
+// It is used by code that needs to look at the structure of a computation, rather than just
+// run it one record at a time
+class MyDB_Expr {
+
+public:
+
+	// parses the given computation... this accepts exactly what compileComputation () accepts
+	static MyDB_ExprPtr parse (string fromMe);
+
+	// constructors for binary and unary operations
+	MyDB_Expr (MyDB_ExprOp op, MyDB_ExprPtr lhs, MyDB_ExprPtr rhs);
+	MyDB_Expr (MyDB_ExprOp op, MyDB_ExprPtr child);
+
+	// these build the leaves
+	static MyDB_ExprPtr attribute (string attName);
+	static MyDB_ExprPtr intLiteral (int val);
+	static MyDB_ExprPtr doubleLiteral (double val);
+	static MyDB_ExprPtr stringLiteral (string val);
+	static MyDB_ExprPtr boolLiteral (bool val);
+
+	// looks up every attribute in the schema, and works out the type and the mode of each
+	// node, using the same promotion rules as compileComputation ().  Exits if the
+	// computation does not make sense (such as a minus over strings).  A string literal that
+	// is compared with a date is replaced by an int literal holding that date
+	void resolve (MyDB_SchemaPtr mySchema);
+
+	// writes the expression back out in the prefix notation
+	string toString ();
+
+	// adds the position (in the schema used for resolve ()) of every attribute that is read
+	void getAtts (vector <int> &atts);
+
+	// true if this node is a literal
+	bool isLiteral ();
+
+	// true if running the expression can fail on some records, so that it must not be run on a
+	// record before whatever guards it (as in "b != 0 AND a / b > 1"); that is, if it has an
+	// integer division by anything other than a literal that is not zero or -1.  The modes are
+	// set by resolve (), so this is called after it
+	bool canFail ();
+
+	// turns this node into a copy of the given literal; used for constant folding
+	void becomeLiteral (MyDB_ExprPtr literal);
+
+	// adds each of the top-level conjuncts in the expression to the list; that is, the
+	// children of a chain of && nodes (or just the expression, if it is not an &&)
+	static void getConjuncts (MyDB_ExprPtr fromMe, vector <MyDB_ExprPtr> &conjuncts);
+
+	// true if values of the two types are combined exactly, as decimals: one of them is a
+	// decimal, and the other is a decimal or an int.  If so, the scale of each is returned
+	// (an int has a scale of zero).  The result of a + or a -, and the values compared by a
+	// comparison, have the larger of the two scales; the result of a * has their sum
+	static bool asDecimals (MyDB_AttTypePtr lhs, MyDB_AttTypePtr rhs, int &lhsScale, int &rhsScale);
+
+	// true if this is a simple comparison (>, <, ==, !=) between an attribute and a literal
+	// that can be done without converting the attribute: int vs. int, double vs. int or
+	// double, or string vs. string.  If so, the attribute, the comparison, and the literal
+	// are returned, re-written (if needed) so that the attribute is on the left
+	bool isAttVsLiteral (int &whichAtt, MyDB_ExprOp &cmp, MyDB_ExprPtr &literal);
+
+	// access the parts of the node
+	MyDB_ExprOp getOp ();
+	MyDB_ExprMode getMode ();
+	MyDB_AttTypePtr getType ();
+	MyDB_ExprPtr getLHS ();
+	MyDB_ExprPtr getRHS ();
+	string &getAttName ();
+	int getAttIndex ();
+	int getInt ();
+	double getDouble ();
+	string &getString ();
+	bool getBool ();
+
+private:
+
+	// used by the leaf builders
+	MyDB_Expr (MyDB_ExprOp op);
+
+	// helper for the parser
+	static MyDB_ExprPtr parseHelper (char * &vals);
+	static char *findsymbol (char val, char *input);
+
+	MyDB_ExprOp op;
+	MyDB_ExprMode mode;
+	MyDB_AttTypePtr type;
+	MyDB_ExprPtr lhs;
+	MyDB_ExprPtr rhs;
+
+	// for attribute nodes
+	string attName;
+	int attIndex;
+
+	// for literals
+	int intVal;
+	double doubleVal;
+	string stringVal;
+	bool boolVal;
+};
+
+#endif
@@ -0,0 +1,39 @@
+
+#ifndef FILTER_KERNELS_H
+#define FILTER_KERNELS_H
+
+#include "MyDB_Expr.h"
+#include <stdint.h>
+#include <string>
+
+using namespace std;
+
+// the number of bytes of a string that the string kernels look at
+#define STRING_PREFIX_LEN 16
+
+// These are the kernels used to run simple comparisons (attribute vs. constant) over a lot of
+// values at once.  Each one compares the n values stored contiguously at vals against the
+// constant using cmp (gtOp, ltOp, eqOp or neqOp, with the value on the left), and sets bit
+// i of the output bitmap if the comparison holds for the i^th value.  The bitmap needs to
+// have room for (n + 63) / 64 words; bits past n are cleared.
+//
+// There are AVX2, SSE4.2 and plain C++ versions of each; the best one that the machine
+// supports is picked the first time that one of these is called.
+void compareInts (int *vals, int n, MyDB_ExprOp cmp, int constant, uint64_t *bits);
+void compareDoubles (double *vals, int n, MyDB_ExprOp cmp, double constant, uint64_t *bits);
+
+// for strings, each value is the first STRING_PREFIX_LEN bytes of the string, padded with
+// zeros (as is done by strncpy), and the same goes for the constant.  The result is exact
+// as long as the constant is shorter than STRING_PREFIX_LEN characters
+void compareStringPrefixes (char *vals, int n, MyDB_ExprOp cmp, char *constant, uint64_t *bits);
+
+// ands the first bitmap with the second one
+void andBitmaps (uint64_t *intoMe, uint64_t *fromMe, int n);
+
+// writes the position of each set bit into sel, in order, and returns the count
+int bitmapToSelection (uint64_t *bits, int n, int *sel);
+
+// returns "avx2", "sse4.2", or "scalar", depending upon the kernels that are being used
+string getFilterKernelLevel ();
+
+#endif
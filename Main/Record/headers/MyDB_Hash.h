@@ -0,0 +1,119 @@
+
+#ifndef HASH_H
+#define HASH_H
+
+#include <string.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// These are the hash functions used for attribute values.  All of them produce well-mixed 64-bit
+// values, so that all of the bits (and not just the low ones) can be used by a hash table.
+//
+// Values that compare as equal must hash the same, even when they are of different types,
+// since a join can check an int against a double; so a double that holds a whole number is
+// hashed just like the int, and an int, a bool, and a date are all hashed as integers.
+
+// the 64-bit finalizer from MurmurHash3; every input bit affects every output bit
+inline size_t hashInt (long long hashMe) {
+	unsigned long long h = (unsigned long long) hashMe;
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return h;
+}
+
+inline size_t hashDouble (double hashMe) {
+
+	// whole numbers (including -0.0) hash like the equal int
+	if (hashMe >= -9.2e18 && hashMe <= 9.2e18 && hashMe == (double) (long long) hashMe)
+		return hashInt ((long long) hashMe);
+
+	long long bits;
+	memcpy (&bits, &hashMe, sizeof (bits));
+	return hashInt (bits);
+}
+
+// MurmurHash64A, which consumes the bytes eight at a time
+inline size_t hashBytes (const char *data, size_t length) {
+
+	const unsigned long long m = 0xc6a4a7935bd1e995ULL;
+	const int r = 47;
+	unsigned long long h = 0x8445d61a4e774912ULL ^ (length * m);
+
+	const char *end = data + (length & ~(size_t) 7);
+	for (; data != end; data += 8) {
+		unsigned long long k;
+		memcpy (&k, data, 8);
+		k *= m;
+		k ^= k >> r;
+		k *= m;
+		h ^= k;
+		h *= m;
+	}
+
+	switch (length & 7) {
+	case 7: h ^= (unsigned long long) (unsigned char) data[6] << 48; // fall through
+	case 6: h ^= (unsigned long long) (unsigned char) data[5] << 40; // fall through
+	case 5: h ^= (unsigned long long) (unsigned char) data[4] << 32; // fall through
+	case 4: h ^= (unsigned long long) (unsigned char) data[3] << 24; // fall through
+	case 3: h ^= (unsigned long long) (unsigned char) data[2] << 16; // fall through
+	case 2: h ^= (unsigned long long) (unsigned char) data[1] << 8; // fall through
+	case 1: h ^= (unsigned long long) (unsigned char) data[0];
+		h *= m;
+	}
+
+	h ^= h >> r;
+	h *= m;
+	h ^= h >> r;
+	return h;
+}
+
+// adds the hash of one more column to the hash of a multi-column key (which starts at zero);
+// unlike xor, this depends on the order of the columns, and equal columns do not cancel out
+inline size_t hashCombine (size_t soFar, size_t hashMe) {
+	return hashInt (soFar * 0x9e3779b97f4a7c15ULL + hashMe + 0x632be59bd9b4e019ULL);
+}
+
+// for a hash table that maps a hash value to the list of entries having that value, this counts
+// the lists by length: position i of the result is the number of lists whose length is at least
+// 2^i and less than 2^(i+1).  Long lists mean either that the hash function is colliding, or
+// (in the case of a join) that many records have the same key
+template <class T>
+vector <size_t> getChainHistogram (unordered_map <size_t, vector <T>> &table) {
+	vector <size_t> result;
+	for (auto &chain : table) {
+		size_t len = chain.second.size ();
+		if (len == 0)
+			continue;
+		size_t which = 0;
+		while ((len >> (which + 1)) != 0)
+			which++;
+		if (result.size () <= which)
+			result.resize (which + 1, 0);
+		result[which]++;
+	}
+	return result;
+}
+
+// writes a histogram from getChainHistogram () as, for example, "1:9871 2-3:12 4-7:1"
+inline string chainHistogramToString (vector <size_t> &histogram) {
+	string result;
+	for (size_t i = 0; i < histogram.size (); i++) {
+		if (i > 0)
+			result += " ";
+		size_t low = ((size_t) 1) << i;
+		if (i == 0)
+			result += "1:";
+		else
+			result += to_string (low) + "-" + to_string (2 * low - 1) + ":";
+		result += to_string (histogram[i]);
+	}
+	return result;
+}
+
+#endif
@@ -0,0 +1,83 @@
+
+#ifndef OVERFLOW_FILE_H
+#define OVERFLOW_FILE_H
+
+#include "MyDB_StringView.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// create a smart pointer for overflow files
+class MyDB_OverflowFile;
+typedef shared_ptr <MyDB_OverflowFile> MyDB_OverflowFilePtr;
+
+// This holds the values of a string attribute that is stored out of line (see
+// MyDB_OverflowAttType).  The values are added to the end of the file, each one as its length
+// followed by its characters, and what is stored in the table's records is the position of the
+// value in the file; so a record carries only that, until something asks for the value itself.
+//
+// Like a MyDB_StringDictionary, there is one per attribute, and values are added while a
+// table is loaded in parallel; so the file is read and written directly, and not through the
+// buffer manager.  New values are kept in memory until there are enough of them to write out.
+// There is only one of these for each file (see getFile ()), so that all of the attributes that
+// are stored in a file see the same values
+class MyDB_OverflowFile {
+
+public:
+
+	// the file is not opened (or created) until it is used; use getFile () rather than this,
+	// unless the file is not used by anything else
+	MyDB_OverflowFile (string fileName);
+
+	// returns the MyDB_OverflowFile for the named file, making it if there is not one already
+	static shared_ptr <MyDB_OverflowFile> getFile (string fileName);
+
+	// writes out any values that are still in memory
+	~MyDB_OverflowFile ();
+
+	// adds a value to the end of the file, and returns its position.  Several threads can add
+	// values at once
+	long long put (MyDB_StringView putMe);
+
+	// gets the value at the given position.  Several threads can get values at once; only a
+	// value that has not been written out yet waits for the lock that put () takes
+	void get (long long pos, string &intoMe);
+
+	// throws out all of the values
+	void clear ();
+
+	// writes out any values that are still in memory
+	void flush ();
+
+	// the file that the values are in
+	string &getFileName ();
+
+private:
+
+	// opens the file, if it is not already open
+	void open ();
+
+	// writes out the values in memory; the lock must be held
+	void writeTail ();
+
+	string fileName;
+	atomic <int> fd;
+
+	// the number of bytes that have been written to the file, and the values that have been
+	// added after that; what has been written is never changed (until clear ()), so it is read
+	// without the lock
+	atomic <long long> fileSize;
+	vector <char> tail;
+
+	// each thread keeps the last part of a file that it read, since most of the time the next
+	// value is in it too; this says which file (and which clear () of it) that part came from
+	atomic <long long> id;
+
+	mutex lock;
+};
+
+#endif
@@ -4,8 +4,12 @@
 
 #include <functional>
 #include "MyDB_AttVal.h"
+#include "MyDB_ConjunctOrder.h"
+#include "MyDB_Expr.h"
 #include "MyDB_Schema.h"
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -25,8 +29,9 @@ public:
 	// constructs a record that can hold data for the given schema
 	MyDB_Record (MyDB_SchemaPtr mySchema);
 
-	// read the record from the text string
-	void fromText (string fromMe);
+	// parse the contents of this record from the text between start and end, which holds the
+	// attribute values, each followed by a '|'; the values are parsed in place
+	void fromText (const char *start, const char *end);
 
 	// get the number of bytes required to store the record as a binary string
 	size_t getBinarySize ();
@@ -98,8 +103,33 @@ public:
 	// the entire file, computing the function after each new record is loaded, without
 	// recompiling the function.
 	//
+	// Any part of the computation that does not depend on the record (such as "/ (double[1.0],
+	// int[3])") is computed once, when the computation is compiled.
+	//
 	func compileComputation (string fromMe);
 
+	// compiles a set of computations at once; the i^th function returned computes fromMe[i].
+	// This is just like calling compileComputation () on each of them, except that any
+	// subexpression that appears more than once (in one computation or across several) is
+	// computed only once for each record loaded.  An operator should compile all of the
+	// computations that it runs over one record (its predicate, projections, aggregates, etc.)
+	// with a single call to this method
+	vector <func> compileComputations (vector <string> fromMe);
+
+	// the same, for computations that have already been built (for example, from a parsed SQL
+	// query) rather than written out as strings; they are resolved against this record's schema
+	// and their constants are folded, so they should not be shared with other records
+	vector <func> compileExprs (vector <MyDB_ExprPtr> fromMe);
+
+	// returns the hash of the values of the given computations over the record's current contents,
+	// combined in order using hashCombine (); this is how a multi-column key (for a join or a group
+	// by) is hashed
+	static size_t hashKeys (vector <func> &keys);
+
+	// loads each of n records in turn (the i^th is at recs[which[i]]) and puts the hashKeys () value
+	// for it into hashes[i]; when this returns, the last of the records is the one that is loaded
+	void hashBatch (void **recs, int *which, int n, vector <func> &keys, size_t *hashes);
+
 	// builds a function that returns true if lhs < rhs; the comparison is done by running whatever computation is 
 	// encoded by the string "computation" on both lhs and rhs, and then compariing the results obtained using this
 	// computation over both.  If the result from lhs is < the result from rhs, then the function returned from
@@ -115,6 +145,11 @@ public:
 	// access a particular attribute
 	MyDB_AttValPtr &getAtt (int whichAtt);
 
+	// an and in a computation compiled over this record runs its conjuncts in an order that
+	// changes as records are seen, stopping at the first one that is false; this has the object
+	// that picks the order (see MyDB_ConjunctOrder) for each and compiled so far
+	vector <MyDB_ConjunctOrderPtr> &getConjunctOrders ();
+
 private:
 
 	// for fast reading from a page; the contents of the record are simply copied into this buffer
@@ -126,14 +161,32 @@ private:
 	// the amount of data in the record buffer
 	size_t recSize;
 
-	// helper function for the compilation
-	pair <func, MyDB_AttTypePtr> compileHelper (char * &vals);
+	// compiles a parsed computation that has been resolved against this record's schema.  The
+	// subexpressions in shared (written using MyDB_Expr.toString ()) are computed once per
+	// record; built holds the subexpressions compiled so far, so that they can be re-used
+	pair <func, MyDB_AttTypePtr> compileExpr (MyDB_ExprPtr compileMe, set <string> &shared,
+		map <string, pair <func, MyDB_AttTypePtr>> &built);
+
+	// if the computation is an == or != between a dictionary-encoded attribute and a string
+	// literal, compiles it into a comparison of the codes and returns true
+	bool compileOnCodes (MyDB_ExprPtr compileMe, pair <func, MyDB_AttTypePtr> &res);
+
+	// if the computation is an == or != between a char attribute and a string literal, compiles
+	// it into a comparison of the bytes on the page with the padded literal and returns true
+	bool compileOnChars (MyDB_ExprPtr compileMe, pair <func, MyDB_AttTypePtr> &res);
+
+	// replaces each part of the computation that does not read an attribute with its value
+	void foldConstants (MyDB_ExprPtr foldMe);
+
+	// counts how many times each subexpression (that is not just a literal or an attribute)
+	// appears; a subexpression that appears again is not looked inside of a second time
+	static void countSubexpressions (MyDB_ExprPtr countMe, map <string, int> &counts);
+
+	// returns a number that changes whenever the contents of atts lowAtt through highAtt do
+	long getVersion (int lowAtt, int highAtt);
 
-	// helper function for the compilation
-	char *findsymbol (char val, char *input);
-	
 	// these functions are all used to build up computations over the record
-	pair <func, MyDB_AttTypePtr> fromData (string attName);
+	pair <func, MyDB_AttTypePtr> fromData (int whichAtt, MyDB_AttTypePtr attType);
 	pair <func, MyDB_AttTypePtr> plus (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
 	pair <func, MyDB_AttTypePtr> minus (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
 	pair <func, MyDB_AttTypePtr> times (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
@@ -142,7 +195,8 @@ private:
 	pair <func, MyDB_AttTypePtr> lt (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
 	pair <func, MyDB_AttTypePtr> eq (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
 	pair <func, MyDB_AttTypePtr> neq (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
-	pair <func, MyDB_AttTypePtr> andd (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
+	pair <func, MyDB_AttTypePtr> andd (vector <pair <func, MyDB_AttTypePtr>> conjuncts, vector <string> names,
+		vector <bool> pinned);
 	pair <func, MyDB_AttTypePtr> orr (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
 	pair <func, MyDB_AttTypePtr> unaryMinus (pair <func, MyDB_AttTypePtr> lhs);
 	pair <func, MyDB_AttTypePtr> nott (pair <func, MyDB_AttTypePtr> lhs);
@@ -159,6 +213,15 @@ private:
 	MyDB_SchemaPtr mySchema;
 	vector <MyDB_AttValPtr> values;	
 	vector <MyDB_AttValPtr> scratch;
+	vector <MyDB_ConjunctOrderPtr> conjunctOrders;
+
+	// incremented whenever the contents of the record change; used to know when a shared
+	// subexpression needs to be re-computed
+	long version;
+
+	// if this record was made with buildFrom (), these are the two records that it came from
+	MyDB_RecordPtr leftPart;
+	MyDB_RecordPtr rightPart;
 
 };
 
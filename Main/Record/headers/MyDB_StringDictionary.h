@@ -0,0 +1,83 @@
+
+#ifndef STRING_DICT_H
+#define STRING_DICT_H
+
+#include "MyDB_StringView.h"
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// create a smart pointer for dictionaries
+class MyDB_StringDictionary;
+typedef shared_ptr <MyDB_StringDictionary> MyDB_StringDictionaryPtr;
+
+// This maps each of the distinct values of a dictionary-encoded string attribute to a small
+// integer code (0, 1, 2, ... in the order that the values are first seen) and back again.
+// There is one per attribute of a table; the codes are what is stored on the pages
+class MyDB_StringDictionary {
+
+public:
+
+	// codes are stored in two bytes, so this is the most values that a dictionary can hold
+	static const int MAX_CODES = 65536;
+
+	// a new dictionary; it starts out with just the empty string, as code zero
+	MyDB_StringDictionary ();
+
+	// the code for the string, or -1 if it is not in the dictionary
+	int find (MyDB_StringView findMe);
+
+	// the code for the string, adding it to the dictionary if it is not there yet.  Several
+	// threads can encode at once (as when a table is loaded in parallel), but nothing else
+	// may be called while a thread could be encoding.  If the string is new but the dictionary
+	// already has MAX_CODES values, the string cannot be added: this returns zero (the code for
+	// the empty string), so that the caller always has a good code, and isFull () is true from
+	// then on
+	int encode (MyDB_StringView encodeMe);
+
+	// the number of values in the dictionary
+	int size ();
+
+	// true if encode () has been asked for a new value after the dictionary filled up; the
+	// loader checks this, and stops if it is true (see MyDB_TableReaderWriter.loadFromTextFile ())
+	bool isFull ();
+
+	// the string for a code; this stays good for the life of the dictionary
+	inline const string &decode (int code) {
+		return values[code];
+	}
+
+	// same as decode (code), but as a view
+	inline MyDB_StringView decodeView (int code) {
+		return MyDB_StringView (values[code].data (), values[code].size ());
+	}
+
+	// the hash of the string for a code; it matches MyDB_StringView.hash ()
+	inline size_t getHash (int code) {
+		return hashes[code];
+	}
+
+private:
+
+	// puts the code into the hash table
+	void addToSlots (int code);
+
+	// the values are in a deque, so that adding to the dictionary does not move them
+	deque <string> values;
+	vector <size_t> hashes;
+
+	// an open-addressing hash table holding the code for each value (-1 is an empty slot)
+	vector <int> slots;
+
+	// held while encoding
+	mutex encodeLock;
+
+	// used by isFull ()
+	bool full;
+};
+
+#endif
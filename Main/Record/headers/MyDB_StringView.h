@@ -0,0 +1,41 @@
+
+#ifndef STRING_VIEW_H
+#define STRING_VIEW_H
+
+#include "MyDB_Hash.h"
+#include <string.h>
+#include <string>
+
+using namespace std;
+
+// a read-only view of a string that someone else owns (often, a string sitting on a page).
+// The view is only good until the owner changes
+struct MyDB_StringView {
+
+	const char *data;
+	size_t length;
+
+	MyDB_StringView (const char *dataIn, size_t lengthIn) : data (dataIn), length (lengthIn) {}
+
+	// < 0, 0, or > 0, ordering the strings just like std::string does
+	inline int compare (const MyDB_StringView &other) const {
+		int res = memcmp (data, other.data, length < other.length ? length : other.length);
+		if (res != 0)
+			return res;
+		return (length < other.length) ? -1 : (length > other.length) ? 1 : 0;
+	}
+
+	inline bool operator == (const MyDB_StringView &other) const {
+		return length == other.length && memcmp (data, other.data, length) == 0;
+	}
+
+	inline size_t hash () const {
+		return hashBytes (data, length);
+	}
+
+	inline string toString () const {
+		return string (data, length);
+	}
+};
+
+#endif
@@ -2,15 +2,24 @@
 #ifndef ATT_VAL_C
 #define ATT_VAL_C
 
+#include <ctype.h>
 #include <iostream>
 #include "MyDB_AttVal.h"
+#include <math.h>
 #include <string>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 using namespace std;
 
 MyDB_AttVal :: ~MyDB_AttVal () {}
 
+void MyDB_AttVal :: fromText (const char *start, size_t len) {
+	string temp (start, len);
+	fromString (temp);
+}
+
 int MyDB_IntAttVal :: toInt () {
 	void *dataPtr = getDataPointer ();
 	if (dataPtr == nullptr) 
@@ -40,6 +49,11 @@ string MyDB_IntAttVal :: toString () {
 		return to_string (*((int *) dataPtr));
 }
 
+MyDB_StringView MyDB_IntAttVal :: toStringView () {
+	asString = toString ();
+	return MyDB_StringView (asString.data (), asString.size ());
+}
+
 void MyDB_IntAttVal :: set (MyDB_AttValPtr fromMe) {
 	value = fromMe->toInt ();
 	setNotBuffered ();
@@ -51,7 +65,16 @@ void MyDB_BoolAttVal :: set (MyDB_AttValPtr fromMe) {
 }
 
 void MyDB_StringAttVal :: set (MyDB_AttValPtr fromMe) {
-	value = fromMe->toString ();
+	MyDB_StringView view = fromMe->toStringView ();
+	value.assign (view.data, view.length);
+	setNotBuffered ();
+}
+
+void MyDB_StringAttVal :: setConcat (MyDB_AttValPtr lhs, MyDB_AttValPtr rhs) {
+	MyDB_StringView lhsView = lhs->toStringView ();
+	value.assign (lhsView.data, lhsView.length);
+	MyDB_StringView rhsView = rhs->toStringView ();
+	value.append (rhsView.data, rhsView.length);
 	setNotBuffered ();
 }
 
@@ -65,20 +88,25 @@ void MyDB_IntAttVal :: fromString (string &fromMe) {
 	setNotBuffered ();
 }
 
+void MyDB_IntAttVal :: fromText (const char *start, size_t len) {
+	value = strtol (start, nullptr, 10);
+	setNotBuffered ();
+}
+
 size_t MyDB_IntAttVal :: hash () {
-	return std :: hash <int> () (toInt ());
+	return hashInt (toInt ());
 }
 
 size_t MyDB_DoubleAttVal :: hash () {
-	return std :: hash <int> () (toDouble ());
+	return hashDouble (toDouble ());
 }
 
 size_t MyDB_BoolAttVal :: hash () {
-	return std :: hash <int> () (toBool ());
+	return hashInt (toBool ());
 }
 
 size_t MyDB_StringAttVal :: hash () {
-	return std :: hash <string> () (toString ());
+	return toStringView ().hash ();
 }
 
 bool MyDB_IntAttVal :: toBool () {
@@ -126,6 +154,11 @@ void MyDB_DoubleAttVal :: fromString (string &fromMe) {
 	setNotBuffered ();
 }
 
+void MyDB_DoubleAttVal :: fromText (const char *start, size_t len) {
+	value = strtod (start, nullptr);
+	setNotBuffered ();
+}
+
 double MyDB_DoubleAttVal :: toDouble () {
 	void *dataPtr = getDataPointer ();
 	if (dataPtr == nullptr) 
@@ -142,6 +175,11 @@ string MyDB_DoubleAttVal :: toString () {
 		return to_string (*((double *) dataPtr));
 }
 
+MyDB_StringView MyDB_DoubleAttVal :: toStringView () {
+	asString = toString ();
+	return MyDB_StringView (asString.data (), asString.size ());
+}
+
 bool MyDB_DoubleAttVal :: toBool () {
 	cout << "Oops!  Can't convert int to bool";
 	exit (1);
@@ -182,6 +220,11 @@ void MyDB_StringAttVal :: fromString (string &fromMe) {
 	setNotBuffered ();
 }
 
+void MyDB_StringAttVal :: fromText (const char *start, size_t len) {
+	value.assign (start, len);
+	setNotBuffered ();
+}
+
 double MyDB_StringAttVal :: toDouble () {
         cout << "Oops!  Can't convert int to double";
         exit (1);
@@ -200,6 +243,14 @@ string MyDB_StringAttVal :: toString () {
 		return string ((char *) dataPtr);
 }
 
+MyDB_StringView MyDB_StringAttVal :: toStringView () {
+	void *dataPtr = getDataPointer ();
+	if (dataPtr == nullptr) 
+		return MyDB_StringView (value.data (), value.size ());
+	else
+		return MyDB_StringView ((char *) dataPtr, strlen ((char *) dataPtr));
+}
+
 bool MyDB_StringAttVal :: toBool () {
         cout << "Oops!  Can't convert int to bool";
         exit (1);
@@ -207,14 +258,17 @@ bool MyDB_StringAttVal :: toBool () {
 
 void MyDB_StringAttVal :: serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) {
 
-	string value = toString ();
+	// a string is written up to its first null character, and then terminated
+	MyDB_StringView view = toStringView ();
+	size_t len = strnlen (view.data, view.length);
 
-	extendBuffer (buffer, allocatedSize, totSize, strlen (value.c_str ()) + 1 + sizeof (short));
+	extendBuffer (buffer, allocatedSize, totSize, len + 1 + sizeof (short));
 
-	*((short *) (buffer + totSize)) = (short) (sizeof (short) + strlen (value.c_str ()) + 1);
+	*((short *) (buffer + totSize)) = (short) (sizeof (short) + len + 1);
 	totSize += sizeof (short);
-	memcpy (buffer + totSize, value.c_str (), strlen (value.c_str ()) + 1);
-	totSize += strlen (value.c_str ()) + 1;
+	memcpy (buffer + totSize, view.data, len);
+	buffer[totSize + len] = 0;
+	totSize += len + 1;
 }
 
 void MyDB_StringAttVal :: set (string val) {
@@ -237,6 +291,13 @@ double MyDB_BoolAttVal :: toDouble () {
 	exit (1);
 }
 
+MyDB_StringView MyDB_BoolAttVal :: toStringView () {
+	if (toBool ())
+		return MyDB_StringView ("true", 4);
+	else
+		return MyDB_StringView ("false", 5);
+}
+
 string MyDB_BoolAttVal :: toString () {
 	bool val;
 	void *dataPtr = getDataPointer ();
@@ -328,4 +389,556 @@ MyDB_BoolAttVal :: MyDB_BoolAttVal () {
 
 MyDB_BoolAttVal :: ~MyDB_BoolAttVal () {}
 
+MyDB_DictStringAttVal :: MyDB_DictStringAttVal (MyDB_StringDictionaryPtr myDictionaryIn) {
+	myDictionary = myDictionaryIn;
+	code = 0;
+	setNotBuffered ();
+}
+
+MyDB_DictStringAttVal :: ~MyDB_DictStringAttVal () {}
+
+int MyDB_DictStringAttVal :: toInt () {
+	cout << "Oops!  Can't convert string to int";
+	exit (1);
+}
+
+double MyDB_DictStringAttVal :: toDouble () {
+	cout << "Oops!  Can't convert string to double";
+	exit (1);
+}
+
+bool MyDB_DictStringAttVal :: toBool () {
+	cout << "Oops!  Can't convert string to bool";
+	exit (1);
+}
+
+string MyDB_DictStringAttVal :: toString () {
+	return myDictionary->decode (getCode ());
+}
+
+MyDB_StringView MyDB_DictStringAttVal :: toStringView () {
+	return myDictionary->decodeView (getCode ());
+}
+
+void MyDB_DictStringAttVal :: fromString (string &fromMe) {
+	code = myDictionary->encode (MyDB_StringView (fromMe.data (), fromMe.size ()));
+	setNotBuffered ();
+}
+
+void MyDB_DictStringAttVal :: fromText (const char *start, size_t len) {
+	code = myDictionary->encode (MyDB_StringView (start, len));
+	setNotBuffered ();
+}
+
+void MyDB_DictStringAttVal :: fromInt (int fromMe) {
+	string asString = to_string (fromMe);
+	fromString (asString);
+}
+
+void MyDB_DictStringAttVal :: set (MyDB_AttValPtr fromMe) {
+	code = myDictionary->encode (fromMe->toStringView ());
+	setNotBuffered ();
+}
+
+size_t MyDB_DictStringAttVal :: hash () {
+	return myDictionary->getHash (getCode ());
+}
+
+MyDB_AttValPtr MyDB_DictStringAttVal :: getCopy () {
+	MyDB_DictStringAttValPtr retVal = make_shared <MyDB_DictStringAttVal> (myDictionary);
+	retVal->code = getCode ();
+	return retVal;
+}
+
+void MyDB_DictStringAttVal :: serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) {
+
+	extendBuffer (buffer, allocatedSize, totSize, sizeof (unsigned short) + sizeof (short));
+
+	*((short *) (buffer + totSize)) = (short) (sizeof (short) + sizeof (unsigned short));
+	totSize += sizeof (short);
+	*((unsigned short *) (buffer + totSize)) = (unsigned short) getCode ();
+	totSize += sizeof (unsigned short);
+}
+
+MyDB_OverflowAttVal :: MyDB_OverflowAttVal (MyDB_OverflowFilePtr myFileIn) {
+	myFile = myFileIn;
+	pos = -1;
+	valuePos = -1;
+	setNotBuffered ();
+}
+
+MyDB_OverflowAttVal :: ~MyDB_OverflowAttVal () {}
+
+int MyDB_OverflowAttVal :: toInt () {
+	cout << "Oops!  Can't convert string to int";
+	exit (1);
+}
+
+double MyDB_OverflowAttVal :: toDouble () {
+	cout << "Oops!  Can't convert string to double";
+	exit (1);
+}
+
+bool MyDB_OverflowAttVal :: toBool () {
+	cout << "Oops!  Can't convert string to bool";
+	exit (1);
+}
+
+string MyDB_OverflowAttVal :: toString () {
+	return toStringView ().toString ();
+}
+
+MyDB_StringView MyDB_OverflowAttVal :: toStringView () {
+
+	// the value is only read from the file if it is not the one that we already have
+	long long myPos = getPos ();
+	if (myPos != -1 && myPos != valuePos) {
+		myFile->get (myPos, value);
+		valuePos = myPos;
+	}
+	return MyDB_StringView (value.data (), value.size ());
+}
+
+void MyDB_OverflowAttVal :: setValue (const char *start, size_t len) {
+	value.assign (start, len);
+	valuePos = -1;
+	pos = -1;
+	setNotBuffered ();
+}
+
+void MyDB_OverflowAttVal :: fromString (string &fromMe) {
+	setValue (fromMe.data (), fromMe.size ());
+}
+
+void MyDB_OverflowAttVal :: fromText (const char *start, size_t len) {
+	setValue (start, len);
+}
+
+void MyDB_OverflowAttVal :: fromInt (int fromMe) {
+	string asString = to_string (fromMe);
+	fromString (asString);
+}
+
+void MyDB_OverflowAttVal :: set (MyDB_AttValPtr fromMe) {
+
+	// a value that is already in the same file does not need to be read
+	MyDB_OverflowAttValPtr other = dynamic_pointer_cast <MyDB_OverflowAttVal> (fromMe);
+	if (other != nullptr && other->myFile == myFile && other->getPos () != -1) {
+		pos = other->getPos ();
+		setNotBuffered ();
+		return;
+	}
+	MyDB_StringView view = fromMe->toStringView ();
+	setValue (view.data, view.length);
+}
+
+size_t MyDB_OverflowAttVal :: hash () {
+	return toStringView ().hash ();
+}
+
+MyDB_AttValPtr MyDB_OverflowAttVal :: getCopy () {
+	MyDB_OverflowAttValPtr retVal = make_shared <MyDB_OverflowAttVal> (myFile);
+	retVal->pos = getPos ();
+	if (retVal->pos == -1)
+		retVal->value = value;
+	return retVal;
+}
+
+void MyDB_OverflowAttVal :: serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) {
+
+	// a new value is written to the file the first time that it goes on a page
+	if (getPos () == -1) {
+		pos = myFile->put (MyDB_StringView (value.data (), value.size ()));
+		valuePos = pos;
+	}
+
+	extendBuffer (buffer, allocatedSize, totSize, sizeof (long long) + sizeof (short));
+	*((short *) (buffer + totSize)) = (short) (sizeof (short) + sizeof (long long));
+	totSize += sizeof (short);
+	long long myPos = getPos ();
+	memcpy (buffer + totSize, &myPos, sizeof (myPos));
+	totSize += sizeof (long long);
+}
+
+MyDB_DecimalAttVal :: MyDB_DecimalAttVal (int precisionIn, int scaleIn) {
+	precision = precisionIn;
+	scale = scaleIn;
+	scaled = 0;
+	setNotBuffered ();
+}
+
+MyDB_DecimalAttVal :: ~MyDB_DecimalAttVal () {}
+
+long long MyDB_DecimalAttVal :: rescale (long long val, int fromScale, int toScale) {
+	if (toScale >= fromScale)
+		return val * powerOfTen (toScale - fromScale);
+	long long divisor = powerOfTen (fromScale - toScale);
+	long long quotient = val / divisor;
+	long long remainder = val % divisor;
+	if (2 * (remainder < 0 ? -remainder : remainder) >= divisor)
+		quotient += (val < 0) ? -1 : 1;
+	return quotient;
+}
+
+int MyDB_DecimalAttVal :: toInt () {
+	return (int) (getScaled () / powerOfTen (scale));
+}
+
+double MyDB_DecimalAttVal :: toDouble () {
+	return (double) getScaled () / (double) powerOfTen (scale);
+}
+
+string MyDB_DecimalAttVal :: toString () {
+	return format (getScaled (), scale);
+}
+
+string MyDB_DecimalAttVal :: format (long long val, int scale) {
+	unsigned long long magnitude = (val < 0) ? -(unsigned long long) val : (unsigned long long) val;
+	unsigned long long divisor = powerOfTen (scale);
+	string result = (val < 0) ? "-" : "";
+	result += to_string (magnitude / divisor);
+	if (scale > 0) {
+		string fraction = to_string (magnitude % divisor);
+		result += "." + string (scale - fraction.size (), '0') + fraction;
+	}
+	return result;
+}
+
+MyDB_StringView MyDB_DecimalAttVal :: toStringView () {
+	asString = toString ();
+	return MyDB_StringView (asString.data (), asString.size ());
+}
+
+bool MyDB_DecimalAttVal :: toBool () {
+	cout << "Oops!  Can't convert decimal to bool";
+	exit (1);
+}
+
+void MyDB_DecimalAttVal :: fromInt (int fromMe) {
+	scaled = (long long) fromMe * powerOfTen (scale);
+	setNotBuffered ();
+}
+
+void MyDB_DecimalAttVal :: setText (const char *start, size_t len) {
+
+	const char *pos = start, *end = start + len;
+	while (pos < end && isspace ((unsigned char) *pos))
+		pos++;
+	bool negative = (pos < end && *pos == '-');
+	if (pos < end && (*pos == '-' || *pos == '+'))
+		pos++;
+
+	// the digits before the point (leading zeros do not count against the precision), and
+	// then the ones after it; the first digit past the scale decides the rounding
+	long long val = 0;
+	int numDigits = 0, numFraction = 0;
+	bool sawDigit = false, roundUp = false, tooLong = false;
+	for (; pos < end && isdigit ((unsigned char) *pos); pos++) {
+		sawDigit = true;
+		if (val == 0 && *pos == '0')
+			continue;
+		if (++numDigits > precision - scale)
+			tooLong = true;
+		else
+			val = val * 10 + (*pos - '0');
+	}
+	if (pos < end && *pos == '.') {
+		for (pos++; pos < end && isdigit ((unsigned char) *pos); pos++) {
+			sawDigit = true;
+			if (numFraction < scale)
+				val = val * 10 + (*pos - '0');
+			else if (numFraction == scale)
+				roundUp = (*pos >= '5');
+			numFraction++;
+		}
+	}
+	while (pos < end && isspace ((unsigned char) *pos))
+		pos++;
+
+	if (numFraction < scale)
+		val *= powerOfTen (scale - numFraction);
+	if (roundUp)
+		val++;
+	if (!sawDigit || pos != end || tooLong || val >= powerOfTen (precision)) {
+		cout << "Oops!  " << string (start, len) << " is not a decimal (" << precision << ", " << scale << ")\n";
+		exit (1);
+	}
+	scaled = negative ? -val : val;
+	setNotBuffered ();
+}
+
+void MyDB_DecimalAttVal :: fromString (string &fromMe) {
+	setText (fromMe.data (), fromMe.size ());
+}
+
+void MyDB_DecimalAttVal :: fromText (const char *start, size_t len) {
+	setText (start, len);
+}
+
+void MyDB_DecimalAttVal :: set (MyDB_AttValPtr fromMe) {
+	MyDB_DecimalAttVal *asDecimal = dynamic_cast <MyDB_DecimalAttVal *> (fromMe.get ());
+	if (asDecimal != nullptr)
+		scaled = rescale (asDecimal->getScaled (), asDecimal->scale, scale);
+	else
+		scaled = llround (fromMe->toDouble () * powerOfTen (scale));
+	setNotBuffered ();
+}
+
+// a whole number hashes like the equal int, and anything else like the equal double
+size_t MyDB_DecimalAttVal :: hash () {
+	long long val = getScaled ();
+	if (val % powerOfTen (scale) == 0)
+		return hashInt (val / powerOfTen (scale));
+	return hashDouble (toDouble ());
+}
+
+MyDB_AttValPtr MyDB_DecimalAttVal :: getCopy () {
+	MyDB_DecimalAttValPtr retVal = make_shared <MyDB_DecimalAttVal> (precision, scale);
+	retVal->setScaled (getScaled ());
+	return retVal;
+}
+
+void MyDB_DecimalAttVal :: serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) {
+
+	extendBuffer (buffer, allocatedSize, totSize, sizeof (long long) + sizeof (short));
+
+	*((short *) (buffer + totSize)) = (short) (sizeof (short) + sizeof (long long));
+	totSize += sizeof (short);
+	*((long long *) (buffer + totSize)) = getScaled ();
+	totSize += sizeof (long long);
+}
+
+MyDB_CharAttVal :: MyDB_CharAttVal (int widthIn) {
+	width = widthIn;
+	setNotBuffered ();
+}
+
+MyDB_CharAttVal :: ~MyDB_CharAttVal () {}
+
+int MyDB_CharAttVal :: toInt () {
+	cout << "Oops!  Can't convert string to int";
+	exit (1);
+}
+
+double MyDB_CharAttVal :: toDouble () {
+	cout << "Oops!  Can't convert string to double";
+	exit (1);
+}
+
+bool MyDB_CharAttVal :: toBool () {
+	cout << "Oops!  Can't convert string to bool";
+	exit (1);
+}
+
+string MyDB_CharAttVal :: toString () {
+	MyDB_StringView view = toStringView ();
+	return string (view.data, view.length);
+}
+
+// on a page, the value ends at the first null, or after width characters
+MyDB_StringView MyDB_CharAttVal :: toStringView () {
+	void *dataPtr = getDataPointer ();
+	if (dataPtr == nullptr) 
+		return MyDB_StringView (value.data (), value.size ());
+	else
+		return MyDB_StringView ((char *) dataPtr, strnlen ((char *) dataPtr, width));
+}
+
+void MyDB_CharAttVal :: setChars (const char *start, size_t len) {
+	len = strnlen (start, len);
+	if (len > (size_t) width) {
+		cout << "Oops!  " << string (start, len) << " is too long for a char (" << width << ")\n";
+		exit (1);
+	}
+	value.assign (start, len);
+	setNotBuffered ();
+}
+
+void MyDB_CharAttVal :: fromString (string &fromMe) {
+	setChars (fromMe.data (), fromMe.size ());
+}
+
+void MyDB_CharAttVal :: fromText (const char *start, size_t len) {
+	setChars (start, len);
+}
+
+void MyDB_CharAttVal :: fromInt (int fromMe) {
+	string asString = to_string (fromMe);
+	fromString (asString);
+}
+
+void MyDB_CharAttVal :: set (MyDB_AttValPtr fromMe) {
+	MyDB_StringView view = fromMe->toStringView ();
+	setChars (view.data, view.length);
+}
+
+// the same as for a MyDB_StringAttVal, so that a char can be joined with a string
+size_t MyDB_CharAttVal :: hash () {
+	return toStringView ().hash ();
+}
+
+MyDB_AttValPtr MyDB_CharAttVal :: getCopy () {
+	MyDB_CharAttValPtr retVal = make_shared <MyDB_CharAttVal> (width);
+	MyDB_StringView view = toStringView ();
+	retVal->value.assign (view.data, view.length);
+	return retVal;
+}
+
+void MyDB_CharAttVal :: serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) {
+
+	extendBuffer (buffer, allocatedSize, totSize, width + 1 + sizeof (short));
+
+	MyDB_StringView view = toStringView ();
+	*((short *) (buffer + totSize)) = (short) (sizeof (short) + width + 1);
+	totSize += sizeof (short);
+	memcpy (buffer + totSize, view.data, view.length);
+	memset (buffer + totSize + view.length, 0, width + 1 - view.length);
+	totSize += width + 1;
+}
+
+// the conversions between days and dates are the usual ones for the proleptic Gregorian
+// calendar; they work in 400-year eras, each of which has exactly 146097 days
+bool MyDB_DateAttVal :: parseDate (const char *fromMe, int &days) {
+
+	char *next;
+	int y = strtol (fromMe, &next, 10);
+	if (next == fromMe || *next != '-')
+		return false;
+	const char *start = next + 1;
+	int m = strtol (start, &next, 10);
+	if (next == start || *next != '-')
+		return false;
+	start = next + 1;
+	int d = strtol (start, &next, 10);
+	if (next == start || *next != 0)
+		return false;
+
+	// make sure that the day is in the month (there is no February 30th)
+	static const int monthLengths[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+	if (m < 1 || m > 12 || d < 1)
+		return false;
+	bool isLeap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+	if (d > monthLengths[m - 1] + (m == 2 && isLeap))
+		return false;
+
+	y -= (m <= 2);
+	int era = (y >= 0 ? y : y - 399) / 400;
+	int yearOfEra = y - era * 400;
+	int dayOfYear = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+	int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+	days = era * 146097 + dayOfEra - 719468;
+	return true;
+}
+
+string MyDB_DateAttVal :: formatDate (int days) {
+
+	days += 719468;
+	int era = (days >= 0 ? days : days - 146096) / 146097;
+	int dayOfEra = days - era * 146097;
+	int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+	int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+	int mp = (5 * dayOfYear + 2) / 153;
+	int d = dayOfYear - (153 * mp + 2) / 5 + 1;
+	int m = mp + (mp < 10 ? 3 : -9);
+	int y = yearOfEra + era * 400 + (m <= 2);
+
+	char buf[32];
+	snprintf (buf, sizeof (buf), "%04d-%02d-%02d", y, m, d);
+	return buf;
+}
+
+int MyDB_DateAttVal :: toInt () {
+	void *dataPtr = getDataPointer ();
+	if (dataPtr == nullptr) 
+		return value;
+	else
+		return *((int *) dataPtr);
+}
+
+void MyDB_DateAttVal :: fromInt (int fromMe) {
+	value = fromMe;
+	setNotBuffered ();
+}
+
+double MyDB_DateAttVal :: toDouble () {
+	return (double) toInt ();
+}
+
+string MyDB_DateAttVal :: toString () {
+	return formatDate (toInt ());
+}
+
+MyDB_StringView MyDB_DateAttVal :: toStringView () {
+	asString = formatDate (toInt ());
+	return MyDB_StringView (asString.data (), asString.size ());
+}
+
+bool MyDB_DateAttVal :: toBool () {
+	cout << "Oops!  Can't convert date to bool";
+	exit (1);
+}
+
+void MyDB_DateAttVal :: fromString (string &fromMe) {
+	if (!parseDate (fromMe.c_str (), value)) {
+		cout << "Oops!  " << fromMe << " is not a date (YYYY-MM-DD)\n";
+		exit (1);
+	}
+	setNotBuffered ();
+}
+
+void MyDB_DateAttVal :: fromText (const char *start, size_t len) {
+
+	// parseDate () needs the date to be followed by a null
+	char date[32];
+	if (len < sizeof (date)) {
+		memcpy (date, start, len);
+		date[len] = 0;
+		if (parseDate (date, value)) {
+			setNotBuffered ();
+			return;
+		}
+	}
+
+	// not a date; this reports the error
+	string temp (start, len);
+	fromString (temp);
+}
+
+void MyDB_DateAttVal :: set (MyDB_AttValPtr fromMe) {
+	value = fromMe->toInt ();
+	setNotBuffered ();
+}
+
+size_t MyDB_DateAttVal :: hash () {
+	return hashInt (toInt ());
+}
+
+MyDB_AttValPtr MyDB_DateAttVal :: getCopy () {
+	MyDB_DateAttValPtr retVal = make_shared <MyDB_DateAttVal> ();
+	retVal->set (toInt ());
+	return retVal;	
+}
+
+void MyDB_DateAttVal :: serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) {
+
+	extendBuffer (buffer, allocatedSize, totSize, sizeof (int) + sizeof (short));
+
+	*((short *) (buffer + totSize)) = (short) (sizeof (short) + sizeof (int));
+	totSize += sizeof (short);
+	*((int *) (buffer + totSize)) = toInt ();
+	totSize += sizeof (int);
+}
+
+void MyDB_DateAttVal :: set (int val) {
+	value = val;
+	setNotBuffered ();
+}
+
+MyDB_DateAttVal :: MyDB_DateAttVal () {
+	value = 0;
+	setNotBuffered ();
+}
+
+MyDB_DateAttVal :: ~MyDB_DateAttVal () {}
+
 #endif
@@ -0,0 +1,152 @@
+
+#ifndef CONJUNCT_FILTER_C
+#define CONJUNCT_FILTER_C
+
+#include "MyDB_ConjunctFilter.h"
+#include <string.h>
+
+using namespace std;
+
+MyDB_ConjunctFilter :: MyDB_ConjunctFilter (MyDB_SchemaPtr mySchema, string predicate) {
+
+	slotForAtt.resize (mySchema->getAtts ().size (), -1);
+	lastAttNeeded = -1;
+
+	MyDB_ExprPtr pred = MyDB_Expr :: parse (predicate);
+	pred->resolve (mySchema);
+	vector <MyDB_ExprPtr> conjuncts;
+	MyDB_Expr :: getConjuncts (pred, conjuncts);
+
+	for (auto &c : conjuncts) {
+
+		int whichAtt;
+		MyDB_ExprOp cmp;
+		MyDB_ExprPtr literal;
+		if (!c->isAttVsLiteral (whichAtt, cmp, literal))
+			continue;
+
+		// a dictionary-encoded attribute is decoded into its codes, which can only be used for
+		// == and !=; a string that is not in the dictionary gets a code that matches nothing
+		MyDB_ExprMode mode = c->getMode ();
+		int code = 0;
+		MyDB_DictStringAttTypePtr dictType = dynamic_pointer_cast <MyDB_DictStringAttType> (mySchema->getAtts ()[whichAtt].second);
+		if (dictType != nullptr) {
+			if (cmp != eqOp && cmp != neqOp)
+				continue;
+			string &val = literal->getString ();
+			code = dictType->getDictionary ()->find (MyDB_StringView (val.data (), val.size ()));
+			mode = intMode;
+
+		// the string kernels are only exact for short constants, and they need the characters
+		// to be on the page
+		} else if (mode == stringMode && (literal->getString ().size () >= STRING_PREFIX_LEN ||
+			dynamic_pointer_cast <MyDB_OverflowAttType> (mySchema->getAtts ()[whichAtt].second) != nullptr)) {
+			continue;
+		}
+
+		// get a column for the attribute
+		if (slotForAtt[whichAtt] == -1) {
+			slotForAtt[whichAtt] = colModes.size ();
+			colModes.push_back (mode);
+			isCodes.push_back (dictType != nullptr);
+			intCols.emplace_back ();
+			doubleCols.emplace_back ();
+			prefixCols.emplace_back ();
+			if (whichAtt > lastAttNeeded)
+				lastAttNeeded = whichAtt;
+		}
+
+		// and remember the comparison
+		whichCol.push_back (slotForAtt[whichAtt]);
+		cmps.push_back (cmp);
+		intConstants.push_back (dictType != nullptr ? code : literal->getOp () == intOp ? literal->getInt () : 0);
+		doubleConstants.push_back (literal->getOp () == intOp ? (double) literal->getInt () : literal->getDouble ());
+		string constant (STRING_PREFIX_LEN, 0);
+		if (literal->getOp () == stringOp)
+			strncpy (&constant[0], literal->getString ().c_str (), STRING_PREFIX_LEN);
+		stringConstants.push_back (constant);
+	}
+
+	if (lastAttNeeded != -1 && mySchema->getFixedOffset (lastAttNeeded) != -1) {
+		offsetForCol.resize (colModes.size ());
+		for (int whichAtt = 0; whichAtt <= lastAttNeeded; whichAtt++)
+			if (slotForAtt[whichAtt] != -1)
+				offsetForCol[slotForAtt[whichAtt]] = mySchema->getFixedOffset (whichAtt);
+	}
+}
+
+void MyDB_ConjunctFilter :: decode (int c, int i, char *data) {
+	if (isCodes[c])
+		intCols[c][i] = *((unsigned short *) data);
+	else if (colModes[c] == intMode)
+		memcpy (&intCols[c][i], data, sizeof (int));
+	else if (colModes[c] == doubleMode)
+		memcpy (&doubleCols[c][i], data, sizeof (double));
+	else
+		strncpy (&prefixCols[c][i * STRING_PREFIX_LEN], data, STRING_PREFIX_LEN);
+}
+
+int MyDB_ConjunctFilter :: getNumConjuncts () {
+	return cmps.size ();
+}
+
+int MyDB_ConjunctFilter :: run (void **recs, int numRecs, int *sel) {
+
+	if (cmps.size () == 0) {
+		for (int i = 0; i < numRecs; i++)
+			sel[i] = i;
+		return numRecs;
+	}
+
+	// make sure there is enough space
+	if ((int) bits.size () < (numRecs + 63) / 64) {
+		bits.resize ((numRecs + 63) / 64);
+		moreBits.resize ((numRecs + 63) / 64);
+	}
+	for (int c = 0; c < (int) colModes.size (); c++) {
+		if (colModes[c] == intMode && (int) intCols[c].size () < numRecs)
+			intCols[c].resize (numRecs);
+		else if (colModes[c] == doubleMode && (int) doubleCols[c].size () < numRecs)
+			doubleCols[c].resize (numRecs);
+		else if (colModes[c] == stringMode && (int) prefixCols[c].size () < numRecs * STRING_PREFIX_LEN)
+			prefixCols[c].resize (numRecs * STRING_PREFIX_LEN);
+	}
+
+	// decode the attributes that we need; if they are always in the same place, we go right
+	// to them, and otherwise we hop from one attribute to the next, since each starts with its size
+	if (offsetForCol.size () > 0) {
+		for (int c = 0; c < (int) colModes.size (); c++) {
+			int offset = offsetForCol[c] + sizeof (short);
+			for (int i = 0; i < numRecs; i++)
+				decode (c, i, ((char *) recs[i]) + offset);
+		}
+	} else {
+		for (int i = 0; i < numRecs; i++) {
+			char *pos = ((char *) recs[i]) + sizeof (short);
+			for (int whichAtt = 0; whichAtt <= lastAttNeeded; whichAtt++) {
+				int c = slotForAtt[whichAtt];
+				if (c != -1)
+					decode (c, i, pos + sizeof (short));
+				pos += *((short *) pos);
+			}
+		}
+	}
+
+	// now run each of the conjuncts, and-ing the results together
+	for (int j = 0; j < (int) cmps.size (); j++) {
+		uint64_t *into = (j == 0) ? bits.data () : moreBits.data ();
+		int c = whichCol[j];
+		if (colModes[c] == intMode)
+			compareInts (intCols[c].data (), numRecs, cmps[j], intConstants[j], into);
+		else if (colModes[c] == doubleMode)
+			compareDoubles (doubleCols[c].data (), numRecs, cmps[j], doubleConstants[j], into);
+		else
+			compareStringPrefixes (prefixCols[c].data (), numRecs, cmps[j], &stringConstants[j][0], into);
+		if (j > 0)
+			andBitmaps (bits.data (), moreBits.data (), numRecs);
+	}
+
+	return bitmapToSelection (bits.data (), numRecs, sel);
+}
+
+#endif
@@ -0,0 +1,99 @@
+
+#ifndef CONJUNCT_ORDER_C
+#define CONJUNCT_ORDER_C
+
+#include <algorithm>
+#include <stdio.h>
+#include "MyDB_ConjunctOrder.h"
+
+MyDB_ConjunctOrder :: MyDB_ConjunctOrder (vector <string> conjunctsIn, vector <bool> pinnedIn, int intervalIn) {
+	conjuncts = conjunctsIn;
+	pinned = pinnedIn;
+	stats.resize (conjuncts.size ());
+	for (int i = 0; i < (int) conjuncts.size (); i++)
+		order.push_back (i);
+	interval = intervalIn;
+	numTicks = 0;
+	numReorders = 0;
+}
+
+int MyDB_ConjunctOrder :: getNumReorders () {
+	return numReorders;
+}
+
+void MyDB_ConjunctOrder :: merge (MyDB_ConjunctOrder &fromMe) {
+	for (int i = 0; i < (int) stats.size () && i < (int) fromMe.stats.size (); i++) {
+		stats[i].numIn += fromMe.stats[i].numIn;
+		stats[i].numOut += fromMe.stats[i].numOut;
+		stats[i].numTimed += fromMe.stats[i].numTimed;
+		stats[i].nanos += fromMe.stats[i].nanos;
+	}
+	numReorders += fromMe.numReorders;
+	reorder ();
+}
+
+void MyDB_ConjunctOrder :: reorder () {
+
+	// the rank of a conjunct is its cost per record over the fraction of records it gets rid of;
+	// one that has not seen any records gets a rank of zero, so that it is measured next time
+	vector <double> rank (conjuncts.size ());
+	for (int i = 0; i < (int) conjuncts.size (); i++) {
+		ConjunctStats &s = stats[i];
+		if (s.numIn == 0) {
+			rank[i] = 0.0;
+			continue;
+		}
+		double cost = (s.numTimed == 0) ? 1.0 : s.nanos / s.numTimed;
+		double rejected = 1.0 - s.numOut / s.numIn;
+		rank[i] = (rejected <= 0.0) ? 1e300 : cost / rejected;
+	}
+
+	// the conjuncts are put in order one at a time: the next one is the one with the lowest rank
+	// (or the one that came first last time, if there is a tie), out of the ones that can go
+	// next; a pinned conjunct can only go once all of the ones before it in the list have gone
+	int n = conjuncts.size ();
+	vector <int> lastOrder = order;
+	vector <bool> placed (n, false);
+	order.clear ();
+	while ((int) order.size () < n) {
+		int best = -1;
+		for (int i : lastOrder) {
+			if (placed[i])
+				continue;
+			if (pinned[i] && find (placed.begin (), placed.begin () + i, false) != placed.begin () + i)
+				continue;
+			if (best == -1 || rank[i] < rank[best])
+				best = i;
+		}
+		placed[best] = true;
+		order.push_back (best);
+	}
+
+	for (ConjunctStats &s : stats) {
+		s.numIn /= 2;
+		s.numOut /= 2;
+		s.numTimed /= 2;
+		s.nanos /= 2;
+	}
+	numReorders++;
+}
+
+string MyDB_ConjunctOrder :: toString () {
+	string result;
+	for (int i : order) {
+		ConjunctStats &s = stats[i];
+		char buf[64];
+		if (s.numIn == 0)
+			snprintf (buf, sizeof (buf), " (not run)");
+		else if (s.numTimed == 0)
+			snprintf (buf, sizeof (buf), " %.0f%%", 100.0 * s.numOut / s.numIn);
+		else
+			snprintf (buf, sizeof (buf), " %.0f%% %.1fns", 100.0 * s.numOut / s.numIn, s.nanos / s.numTimed);
+		if (result.size () > 0)
+			result += ", ";
+		result += "[" + conjuncts[i] + "]" + buf;
+	}
+	return result;
+}
+
+#endif
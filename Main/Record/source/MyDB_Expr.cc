@@ -0,0 +1,525 @@
+
+#ifndef EXPR_CC
+#define EXPR_CC
+
+#include "MyDB_Expr.h"
+#include <algorithm>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+
+using namespace std;
+
+MyDB_Expr :: MyDB_Expr (MyDB_ExprOp opIn, MyDB_ExprPtr lhsIn, MyDB_ExprPtr rhsIn) {
+	op = opIn;
+	lhs = lhsIn;
+	rhs = rhsIn;
+	attIndex = -1;
+}
+
+MyDB_Expr :: MyDB_Expr (MyDB_ExprOp opIn, MyDB_ExprPtr child) {
+	op = opIn;
+	lhs = child;
+	attIndex = -1;
+}
+
+MyDB_Expr :: MyDB_Expr (MyDB_ExprOp opIn) {
+	op = opIn;
+	attIndex = -1;
+}
+
+MyDB_ExprPtr MyDB_Expr :: attribute (string attName) {
+	MyDB_ExprPtr returnVal (new MyDB_Expr (attOp));
+	returnVal->attName = attName;
+	return returnVal;
+}
+
+MyDB_ExprPtr MyDB_Expr :: intLiteral (int val) {
+	MyDB_ExprPtr returnVal (new MyDB_Expr (intOp));
+	returnVal->intVal = val;
+	returnVal->mode = intMode;
+	returnVal->type = make_shared <MyDB_IntAttType> ();
+	return returnVal;
+}
+
+MyDB_ExprPtr MyDB_Expr :: doubleLiteral (double val) {
+	MyDB_ExprPtr returnVal (new MyDB_Expr (doubleOp));
+	returnVal->doubleVal = val;
+	returnVal->mode = doubleMode;
+	returnVal->type = make_shared <MyDB_DoubleAttType> ();
+	return returnVal;
+}
+
+MyDB_ExprPtr MyDB_Expr :: stringLiteral (string val) {
+	MyDB_ExprPtr returnVal (new MyDB_Expr (stringOp));
+	returnVal->stringVal = val;
+	returnVal->mode = stringMode;
+	returnVal->type = make_shared <MyDB_StringAttType> ();
+	return returnVal;
+}
+
+MyDB_ExprPtr MyDB_Expr :: boolLiteral (bool val) {
+	MyDB_ExprPtr returnVal (new MyDB_Expr (boolOp));
+	returnVal->boolVal = val;
+	returnVal->mode = boolMode;
+	returnVal->type = make_shared <MyDB_BoolAttType> ();
+	return returnVal;
+}
+
+MyDB_ExprPtr MyDB_Expr :: parse (string fromMe) {
+	char *str = (char *) fromMe.c_str ();
+	return parseHelper (str);
+}
+
+char *MyDB_Expr :: findsymbol (char val, char *input) {
+	while (*input != val) {
+		input++;
+	}
+	return input + 1;
+}
+
+MyDB_ExprPtr MyDB_Expr :: parseHelper (char * &vals) {
+
+	// search for one of the symbols... the order in which they are checked matters,
+	// since (for example) "!=" has to be found before "!"
+	while (true) {
+
+		if (vals[0] == 0) {
+			cout << "Reached end of string while parsing.\n";
+			exit (1);
+		}
+
+		MyDB_ExprOp binaryOp;
+		bool isBinary = true;
+		if (vals[0] == '!' && vals[1] == '=') {
+			binaryOp = neqOp;
+		} else if (vals[0] == '!') {
+			isBinary = false;
+			binaryOp = notOp;
+		} else if (vals[0] == '|' && vals[1] == '|') {
+			binaryOp = orOp;
+		} else if (vals[0] == '+') {
+			binaryOp = plusOp;
+		} else if (vals[0] == '&' && vals[1] == '&') {
+			binaryOp = andOp;
+		} else if (vals[0] == '=' && vals[1] == '=') {
+			binaryOp = eqOp;
+		} else if (vals[0] == '>') {
+			binaryOp = gtOp;
+		} else if (vals[0] == '<') {
+			binaryOp = ltOp;
+		} else if (vals[0] == '*') {
+			binaryOp = timesOp;
+		} else if (vals[0] == '/') {
+			binaryOp = divideOp;
+		} else if (vals[0] == '-') {
+			binaryOp = minusOp;
+		} else if (vals[0] == 'u' && vals[1] == 'm') {
+			isBinary = false;
+			binaryOp = uMinusOp;
+
+		} else if (vals[0] == '[') {
+
+			// find the right bracket and copy the name over
+			vals++;
+			int cnt = 0;
+			for (; vals[cnt] != ']'; cnt++);
+			string name (vals, cnt);
+			vals = findsymbol (']', vals);
+			return attribute (name);
+
+		} else if (strncmp (vals, "int", 3) == 0) {
+
+			vals = findsymbol ('[', vals);
+			int val = stoi (vals);
+			vals = findsymbol (']', vals);
+			return intLiteral (val);
+
+		} else if (strncmp (vals, "double", 6) == 0) {
+
+			vals = findsymbol ('[', vals);
+			double val = stod (vals);
+			vals = findsymbol (']', vals);
+			return doubleLiteral (val);
+
+		} else if (strncmp (vals, "bool", 4) == 0) {
+
+			vals = findsymbol ('[', vals);
+			bool val = (strncmp (vals, "true", 4) == 0);
+			vals = findsymbol (']', vals);
+			return boolLiteral (val);
+
+		} else if (strncmp (vals, "string", 6) == 0) {
+
+			vals = findsymbol ('[', vals);
+			int cnt = 0;
+			for (; vals[cnt] != ']'; cnt++);
+			string val (vals, cnt);
+			vals = findsymbol (']', vals);
+			return stringLiteral (val);
+
+		} else {
+			vals++;
+			continue;
+		}
+
+		// if we got here, we have an operation... find the l-paren
+		vals = findsymbol ('(', vals);
+
+		// unary operations have just one argument
+		if (!isBinary) {
+			MyDB_ExprPtr child = parseHelper (vals);
+			vals = findsymbol (')', vals);
+			return make_shared <MyDB_Expr> (binaryOp, child);
+		}
+
+		// find the left result, the comma, the right result, and the r-paren
+		MyDB_ExprPtr lres = parseHelper (vals);
+		vals = findsymbol (',', vals);
+		MyDB_ExprPtr rres = parseHelper (vals);
+		vals = findsymbol (')', vals);
+		return make_shared <MyDB_Expr> (binaryOp, lres, rres);
+	}
+}
+
+bool MyDB_Expr :: asDecimals (MyDB_AttTypePtr lhs, MyDB_AttTypePtr rhs, int &lhsScale, int &rhsScale) {
+
+	MyDB_DecimalAttTypePtr lhsDecimal = dynamic_pointer_cast <MyDB_DecimalAttType> (lhs);
+	MyDB_DecimalAttTypePtr rhsDecimal = dynamic_pointer_cast <MyDB_DecimalAttType> (rhs);
+	if ((lhsDecimal == nullptr && rhsDecimal == nullptr) || (lhsDecimal == nullptr && !lhs->promotableToInt ()) ||
+		(rhsDecimal == nullptr && !rhs->promotableToInt ()))
+		return false;
+
+	lhsScale = (lhsDecimal == nullptr) ? 0 : lhsDecimal->getScale ();
+	rhsScale = (rhsDecimal == nullptr) ? 0 : rhsDecimal->getScale ();
+	return true;
+}
+
+void MyDB_Expr :: resolve (MyDB_SchemaPtr mySchema) {
+
+	if (lhs != nullptr)
+		lhs->resolve (mySchema);
+	if (rhs != nullptr)
+		rhs->resolve (mySchema);
+
+	MyDB_AttTypePtr l = (lhs == nullptr ? nullptr : lhs->type);
+	MyDB_AttTypePtr r = (rhs == nullptr ? nullptr : rhs->type);
+
+	// a string literal that is compared with a date is turned into that date (as an int) here,
+	// so the comparison is done over ints rather than by writing out each date as a string
+	if ((op == gtOp || op == ltOp || op == eqOp || op == neqOp) && (l->isDate () || r->isDate ())) {
+		int days;
+		if (l->isDate () && rhs->op == stringOp && MyDB_DateAttVal :: parseDate (rhs->stringVal.c_str (), days))
+			rhs->becomeLiteral (intLiteral (days));
+		if (r->isDate () && lhs->op == stringOp && MyDB_DateAttVal :: parseDate (lhs->stringVal.c_str (), days))
+			lhs->becomeLiteral (intLiteral (days));
+		l = lhs->type;
+		r = rhs->type;
+	}
+
+	// the scales of the inputs, for an operation that is done over decimals
+	int lhsScale = 0, rhsScale = 0;
+	switch (op) {
+
+	case attOp:
+	{
+		// the schema has already complained if the attribute is not there
+		auto whichAtt = mySchema->getAttByName (attName);
+		if (whichAtt.first == -1)
+			exit (1);
+		attIndex = whichAtt.first;
+		type = whichAtt.second;
+		if (type->isBool ())
+			mode = boolMode;
+		else if (type->promotableToInt ())
+			mode = intMode;
+		else if (dynamic_pointer_cast <MyDB_DecimalAttType> (type) != nullptr)
+			mode = decimalMode;
+		else if (type->promotableToDouble ())
+			mode = doubleMode;
+		else
+			mode = stringMode;
+		return;
+	}
+
+	case intOp: case doubleOp: case stringOp: case boolOp:
+		return;
+
+	case plusOp:
+		if (l->promotableToInt () && r->promotableToInt ())
+			mode = intMode;
+		else if (asDecimals (l, r, lhsScale, rhsScale))
+			mode = decimalMode;
+		else if (l->promotableToDouble () && r->promotableToDouble ())
+			mode = doubleMode;
+		else if (l->promotableToString () && r->promotableToString ())
+			mode = stringMode;
+		else {
+			cout << "This is bad... cannot do anything with the plus.\n";
+			exit (1);
+		}
+		break;
+
+	// a division of decimals is done over doubles, as is a * whose result would have too many
+	// digits after the decimal point
+	case minusOp: case timesOp: case divideOp:
+		if (l->promotableToInt () && r->promotableToInt ())
+			mode = intMode;
+		else if (op != divideOp && asDecimals (l, r, lhsScale, rhsScale) &&
+			(op == minusOp || lhsScale + rhsScale <= MAX_DECIMAL_PRECISION))
+			mode = decimalMode;
+		else if (l->promotableToDouble () && r->promotableToDouble ())
+			mode = doubleMode;
+		else {
+			cout << "This is bad... cannot do anything with the arithmetic.\n";
+			exit (1);
+		}
+		break;
+
+	case uMinusOp:
+		if (l->promotableToInt ())
+			mode = intMode;
+		else if (asDecimals (l, l, lhsScale, rhsScale))
+			mode = decimalMode;
+		else if (l->promotableToDouble ())
+			mode = doubleMode;
+		else {
+			cout << "This is bad... cannot do anything with the unary minus.\n";
+			exit (1);
+		}
+		break;
+
+	// for the comparisons, the mode is the domain that the comparison is done in
+	case gtOp: case ltOp:
+		if (l->promotableToInt () && r->promotableToInt ())
+			mode = intMode;
+		else if (asDecimals (l, r, lhsScale, rhsScale))
+			mode = decimalMode;
+		else if (l->promotableToDouble () && r->promotableToDouble ())
+			mode = doubleMode;
+		else if (l->promotableToString () && r->promotableToString ())
+			mode = stringMode;
+		else {
+			cout << "This is bad... cannot do anything with the comparison.\n";
+			exit (1);
+		}
+		break;
+
+	case eqOp: case neqOp:
+		if (l->promotableToInt () && r->promotableToInt ())
+			mode = intMode;
+		else if (asDecimals (l, r, lhsScale, rhsScale))
+			mode = decimalMode;
+		else if (l->promotableToDouble () && r->promotableToDouble ())
+			mode = doubleMode;
+		else if (l->isBool () && r->isBool ())
+			mode = boolMode;
+		else if (l->promotableToString () && r->promotableToString ())
+			mode = stringMode;
+		else {
+			cout << "This is bad... cannot do anything with the comparison.\n";
+			exit (1);
+		}
+		break;
+
+	case andOp: case orOp:
+		if (!l->isBool () || !r->isBool ()) {
+			cout << "This is bad... cannot do and/or on non booleans.\n";
+			exit (1);
+		}
+		mode = boolMode;
+		break;
+
+	case notOp:
+		if (!l->isBool ()) {
+			cout << "This is bad... cannot do not on non boolean.\n";
+			exit (1);
+		}
+		mode = boolMode;
+		break;
+	}
+
+	// now figure out the output type
+	if (op == gtOp || op == ltOp || op == eqOp || op == neqOp || op == andOp || op == orOp || op == notOp)
+		type = make_shared <MyDB_BoolAttType> ();
+	else if (mode == intMode)
+		type = make_shared <MyDB_IntAttType> ();
+	else if (mode == decimalMode)
+		type = make_shared <MyDB_DecimalAttType> (MAX_DECIMAL_PRECISION,
+			(op == timesOp) ? lhsScale + rhsScale : max (lhsScale, rhsScale));
+	else if (mode == doubleMode)
+		type = make_shared <MyDB_DoubleAttType> ();
+	else
+		type = make_shared <MyDB_StringAttType> ();
+}
+
+string MyDB_Expr :: toString () {
+
+	switch (op) {
+	case attOp:
+		return "[" + attName + "]";
+	case intOp:
+		return "int[" + to_string (intVal) + "]";
+	case doubleOp:
+	{
+		// print with enough digits that the value survives a round trip
+		char buf[40];
+		snprintf (buf, 40, "%.17g", doubleVal);
+		return string ("double[") + buf + "]";
+	}
+	case stringOp:
+		return "string[" + stringVal + "]";
+	case boolOp:
+		return boolVal ? "bool[true]" : "bool[false]";
+	case notOp:
+		return "!(" + lhs->toString () + ")";
+	case uMinusOp:
+		return "um(" + lhs->toString () + ")";
+	default:
+		break;
+	}
+
+	string symbol;
+	switch (op) {
+	case plusOp: symbol = "+"; break;
+	case minusOp: symbol = "-"; break;
+	case timesOp: symbol = "*"; break;
+	case divideOp: symbol = "/"; break;
+	case gtOp: symbol = ">"; break;
+	case ltOp: symbol = "<"; break;
+	case eqOp: symbol = "=="; break;
+	case neqOp: symbol = "!="; break;
+	case andOp: symbol = "&&"; break;
+	default: symbol = "||"; break;
+	}
+	return symbol + "(" + lhs->toString () + ", " + rhs->toString () + ")";
+}
+
+void MyDB_Expr :: getAtts (vector <int> &atts) {
+	if (op == attOp) {
+		for (int a : atts)
+			if (a == attIndex)
+				return;
+		atts.push_back (attIndex);
+		return;
+	}
+	if (lhs != nullptr)
+		lhs->getAtts (atts);
+	if (rhs != nullptr)
+		rhs->getAtts (atts);
+}
+
+bool MyDB_Expr :: isLiteral () {
+	return op == intOp || op == doubleOp || op == stringOp || op == boolOp;
+}
+
+bool MyDB_Expr :: canFail () {
+	if (op == divideOp && mode == intMode && !(rhs->op == intOp && rhs->intVal != 0 && rhs->intVal != -1))
+		return true;
+	return (lhs != nullptr && lhs->canFail ()) || (rhs != nullptr && rhs->canFail ());
+}
+
+void MyDB_Expr :: becomeLiteral (MyDB_ExprPtr literal) {
+	op = literal->op;
+	mode = literal->mode;
+	type = literal->type;
+	intVal = literal->intVal;
+	doubleVal = literal->doubleVal;
+	stringVal = literal->stringVal;
+	boolVal = literal->boolVal;
+	lhs = nullptr;
+	rhs = nullptr;
+}
+
+void MyDB_Expr :: getConjuncts (MyDB_ExprPtr fromMe, vector <MyDB_ExprPtr> &conjuncts) {
+	if (fromMe->op == andOp) {
+		getConjuncts (fromMe->lhs, conjuncts);
+		getConjuncts (fromMe->rhs, conjuncts);
+	} else {
+		conjuncts.push_back (fromMe);
+	}
+}
+
+bool MyDB_Expr :: isAttVsLiteral (int &whichAtt, MyDB_ExprOp &cmp, MyDB_ExprPtr &literal) {
+
+	if (op != gtOp && op != ltOp && op != eqOp && op != neqOp)
+		return false;
+
+	// get the attribute on the left, flipping the comparison if needed
+	MyDB_ExprPtr att;
+	cmp = op;
+	if (lhs->op == attOp && rhs->isLiteral ()) {
+		att = lhs;
+		literal = rhs;
+	} else if (rhs->op == attOp && lhs->isLiteral ()) {
+		att = rhs;
+		literal = lhs;
+		if (op == gtOp)
+			cmp = ltOp;
+		else if (op == ltOp)
+			cmp = gtOp;
+	} else {
+		return false;
+	}
+
+	// the comparison must be done in the attribute's own mode
+	if (att->mode != mode)
+		return false;
+	if (mode == intMode && literal->op != intOp)
+		return false;
+	if (mode == doubleMode && literal->op != intOp && literal->op != doubleOp)
+		return false;
+	if (mode == stringMode && literal->op != stringOp)
+		return false;
+	if (mode == boolMode || mode == decimalMode)
+		return false;
+
+	whichAtt = att->attIndex;
+	return true;
+}
+
+MyDB_ExprOp MyDB_Expr :: getOp () {
+	return op;
+}
+
+MyDB_ExprMode MyDB_Expr :: getMode () {
+	return mode;
+}
+
+MyDB_AttTypePtr MyDB_Expr :: getType () {
+	return type;
+}
+
+MyDB_ExprPtr MyDB_Expr :: getLHS () {
+	return lhs;
+}
+
+MyDB_ExprPtr MyDB_Expr :: getRHS () {
+	return rhs;
+}
+
+string &MyDB_Expr :: getAttName () {
+	return attName;
+}
+
+int MyDB_Expr :: getAttIndex () {
+	return attIndex;
+}
+
+int MyDB_Expr :: getInt () {
+	return intVal;
+}
+
+double MyDB_Expr :: getDouble () {
+	return doubleVal;
+}
+
+string &MyDB_Expr :: getString () {
+	return stringVal;
+}
+
+bool MyDB_Expr :: getBool () {
+	return boolVal;
+}
+
+#endif
@@ -0,0 +1,241 @@
+
+#ifndef FILTER_KERNELS_C
+#define FILTER_KERNELS_C
+
+#include "MyDB_FilterKernels.h"
+#include <string.h>
+
+#if defined (__x86_64__) || defined (__i386__)
+#define SIMD_KERNELS
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// the plain C++ versions... these are also used to finish up after the SIMD versions,
+// starting at position start (which is always a multiple of 64)
+template <class T>
+static inline bool holds (T val, MyDB_ExprOp cmp, T constant) {
+	switch (cmp) {
+	case gtOp: return val > constant;
+	case ltOp: return val < constant;
+	case eqOp: return val == constant;
+	default: return val != constant;
+	}
+}
+
+template <class T>
+static void compareScalar (T *vals, int start, int n, MyDB_ExprOp cmp, T constant, uint64_t *bits) {
+	for (int w = start / 64; w < (n + 63) / 64; w++)
+		bits[w] = 0;
+	for (int i = start; i < n; i++)
+		bits[i / 64] |= ((uint64_t) holds (vals[i], cmp, constant)) << (i % 64);
+}
+
+static void compareIntsScalar (int *vals, int n, MyDB_ExprOp cmp, int constant, uint64_t *bits) {
+	compareScalar (vals, 0, n, cmp, constant, bits);
+}
+
+static void compareDoublesScalar (double *vals, int n, MyDB_ExprOp cmp, double constant, uint64_t *bits) {
+	compareScalar (vals, 0, n, cmp, constant, bits);
+}
+
+static void compareStringsScalar (char *vals, int n, MyDB_ExprOp cmp, char *constant, uint64_t *bits) {
+	for (int w = 0; w < (n + 63) / 64; w++)
+		bits[w] = 0;
+	for (int i = 0; i < n; i++) {
+		int order = memcmp (vals + i * STRING_PREFIX_LEN, constant, STRING_PREFIX_LEN);
+		bits[i / 64] |= ((uint64_t) holds (order, cmp, 0)) << (i % 64);
+	}
+}
+
+#ifdef SIMD_KERNELS
+
+// the AVX2 versions do 8 ints or 4 doubles at a time
+__attribute__ ((target ("avx2")))
+static void compareIntsAVX2 (int *vals, int n, MyDB_ExprOp cmp, int constant, uint64_t *bits) {
+	__m256i c = _mm256_set1_epi32 (constant);
+	int numWords = n / 64;
+	for (int w = 0; w < numWords; w++) {
+		uint64_t word = 0;
+		for (int j = 0; j < 8; j++) {
+			__m256i v = _mm256_loadu_si256 ((__m256i *) (vals + w * 64 + j * 8));
+			__m256i res;
+			if (cmp == gtOp)
+				res = _mm256_cmpgt_epi32 (v, c);
+			else if (cmp == ltOp)
+				res = _mm256_cmpgt_epi32 (c, v);
+			else
+				res = _mm256_cmpeq_epi32 (v, c);
+			word |= ((uint64_t) _mm256_movemask_ps (_mm256_castsi256_ps (res))) << (j * 8);
+		}
+		bits[w] = (cmp == neqOp) ? ~word : word;
+	}
+	compareScalar (vals, numWords * 64, n, cmp, constant, bits);
+}
+
+__attribute__ ((target ("avx2")))
+static void compareDoublesAVX2 (double *vals, int n, MyDB_ExprOp cmp, double constant, uint64_t *bits) {
+	__m256d c = _mm256_set1_pd (constant);
+	int numWords = n / 64;
+	for (int w = 0; w < numWords; w++) {
+		uint64_t word = 0;
+		for (int j = 0; j < 16; j++) {
+			__m256d v = _mm256_loadu_pd (vals + w * 64 + j * 4);
+			__m256d res;
+			if (cmp == gtOp)
+				res = _mm256_cmp_pd (v, c, _CMP_GT_OQ);
+			else if (cmp == ltOp)
+				res = _mm256_cmp_pd (v, c, _CMP_LT_OQ);
+			else if (cmp == eqOp)
+				res = _mm256_cmp_pd (v, c, _CMP_EQ_OQ);
+			else
+				res = _mm256_cmp_pd (v, c, _CMP_NEQ_UQ);
+			word |= ((uint64_t) _mm256_movemask_pd (res)) << (j * 4);
+		}
+		bits[w] = word;
+	}
+	compareScalar (vals, numWords * 64, n, cmp, constant, bits);
+}
+
+// the SSE4.2 versions do 4 ints or 2 doubles at a time
+__attribute__ ((target ("sse4.2")))
+static void compareIntsSSE42 (int *vals, int n, MyDB_ExprOp cmp, int constant, uint64_t *bits) {
+	__m128i c = _mm_set1_epi32 (constant);
+	int numWords = n / 64;
+	for (int w = 0; w < numWords; w++) {
+		uint64_t word = 0;
+		for (int j = 0; j < 16; j++) {
+			__m128i v = _mm_loadu_si128 ((__m128i *) (vals + w * 64 + j * 4));
+			__m128i res;
+			if (cmp == gtOp)
+				res = _mm_cmpgt_epi32 (v, c);
+			else if (cmp == ltOp)
+				res = _mm_cmplt_epi32 (v, c);
+			else
+				res = _mm_cmpeq_epi32 (v, c);
+			word |= ((uint64_t) _mm_movemask_ps (_mm_castsi128_ps (res))) << (j * 4);
+		}
+		bits[w] = (cmp == neqOp) ? ~word : word;
+	}
+	compareScalar (vals, numWords * 64, n, cmp, constant, bits);
+}
+
+__attribute__ ((target ("sse4.2")))
+static void compareDoublesSSE42 (double *vals, int n, MyDB_ExprOp cmp, double constant, uint64_t *bits) {
+	__m128d c = _mm_set1_pd (constant);
+	int numWords = n / 64;
+	for (int w = 0; w < numWords; w++) {
+		uint64_t word = 0;
+		for (int j = 0; j < 32; j++) {
+			__m128d v = _mm_loadu_pd (vals + w * 64 + j * 2);
+			__m128d res;
+			if (cmp == gtOp)
+				res = _mm_cmpgt_pd (v, c);
+			else if (cmp == ltOp)
+				res = _mm_cmplt_pd (v, c);
+			else if (cmp == eqOp)
+				res = _mm_cmpeq_pd (v, c);
+			else
+				res = _mm_cmpneq_pd (v, c);
+			word |= ((uint64_t) _mm_movemask_pd (res)) << (j * 2);
+		}
+		bits[w] = word;
+	}
+	compareScalar (vals, numWords * 64, n, cmp, constant, bits);
+}
+
+// for strings, PCMPESTRI finds the first byte where the value and the constant differ, and
+// then that one byte decides the order; this is used by both the AVX2 and SSE4.2 kernels
+__attribute__ ((target ("sse4.2")))
+static void compareStringsSSE42 (char *vals, int n, MyDB_ExprOp cmp, char *constant, uint64_t *bits) {
+	__m128i c = _mm_loadu_si128 ((__m128i *) constant);
+	for (int w = 0; w < (n + 63) / 64; w++)
+		bits[w] = 0;
+	for (int i = 0; i < n; i++) {
+		char *val = vals + i * STRING_PREFIX_LEN;
+		__m128i v = _mm_loadu_si128 ((__m128i *) val);
+		int where = _mm_cmpestri (v, STRING_PREFIX_LEN, c, STRING_PREFIX_LEN,
+			_SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_EACH | _SIDD_NEGATIVE_POLARITY | _SIDD_LEAST_SIGNIFICANT);
+		int order = 0;
+		if (where < STRING_PREFIX_LEN)
+			order = (int) (unsigned char) val[where] - (int) (unsigned char) constant[where];
+		bits[i / 64] |= ((uint64_t) holds (order, cmp, 0)) << (i % 64);
+	}
+}
+
+#endif
+
+// this is the set of kernels that is actually used
+struct FilterKernelSet {
+	void (*ints) (int *, int, MyDB_ExprOp, int, uint64_t *);
+	void (*doubles) (double *, int, MyDB_ExprOp, double, uint64_t *);
+	void (*strings) (char *, int, MyDB_ExprOp, char *, uint64_t *);
+	string level;
+};
+
+static FilterKernelSet pickKernels () {
+
+	FilterKernelSet returnVal;
+	returnVal.ints = compareIntsScalar;
+	returnVal.doubles = compareDoublesScalar;
+	returnVal.strings = compareStringsScalar;
+	returnVal.level = "scalar";
+
+#ifdef SIMD_KERNELS
+	__builtin_cpu_init ();
+	if (__builtin_cpu_supports ("avx2")) {
+		returnVal.ints = compareIntsAVX2;
+		returnVal.doubles = compareDoublesAVX2;
+		returnVal.strings = compareStringsSSE42;
+		returnVal.level = "avx2";
+	} else if (__builtin_cpu_supports ("sse4.2")) {
+		returnVal.ints = compareIntsSSE42;
+		returnVal.doubles = compareDoublesSSE42;
+		returnVal.strings = compareStringsSSE42;
+		returnVal.level = "sse4.2";
+	}
+#endif
+
+	return returnVal;
+}
+
+static FilterKernelSet &getKernels () {
+	static FilterKernelSet kernels = pickKernels ();
+	return kernels;
+}
+
+void compareInts (int *vals, int n, MyDB_ExprOp cmp, int constant, uint64_t *bits) {
+	getKernels ().ints (vals, n, cmp, constant, bits);
+}
+
+void compareDoubles (double *vals, int n, MyDB_ExprOp cmp, double constant, uint64_t *bits) {
+	getKernels ().doubles (vals, n, cmp, constant, bits);
+}
+
+void compareStringPrefixes (char *vals, int n, MyDB_ExprOp cmp, char *constant, uint64_t *bits) {
+	getKernels ().strings (vals, n, cmp, constant, bits);
+}
+
+void andBitmaps (uint64_t *intoMe, uint64_t *fromMe, int n) {
+	for (int w = 0; w < (n + 63) / 64; w++)
+		intoMe[w] &= fromMe[w];
+}
+
+int bitmapToSelection (uint64_t *bits, int n, int *sel) {
+	int k = 0;
+	for (int w = 0; w < (n + 63) / 64; w++) {
+		uint64_t word = bits[w];
+		while (word != 0) {
+			sel[k++] = w * 64 + __builtin_ctzll (word);
+			word &= word - 1;
+		}
+	}
+	return k;
+}
+
+string getFilterKernelLevel () {
+	return getKernels ().level;
+}
+
+#endif
@@ -0,0 +1,160 @@
+
+#ifndef OVERFLOW_FILE_C
+#define OVERFLOW_FILE_C
+
+#include "MyDB_OverflowFile.h"
+#include <fcntl.h>
+#include <iostream>
+#include <map>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+// new values are written out once there are this many bytes of them
+#define TAIL_SIZE (1024 * 1024)
+
+// and the file is read this many bytes at a time
+#define BLOCK_SIZE (64 * 1024)
+
+// the overflow files that have been asked for with getFile (), by name
+static map <string, weak_ptr <MyDB_OverflowFile>> allFiles;
+static mutex allFilesLock;
+
+// gives each file (and each clear () of it) its own id
+static atomic <long long> nextId (0);
+
+MyDB_OverflowFile :: MyDB_OverflowFile (string fileNameIn) {
+	fileName = fileNameIn;
+	fd = -1;
+	fileSize = 0;
+	id = nextId++;
+}
+
+MyDB_OverflowFilePtr MyDB_OverflowFile :: getFile (string fileName) {
+	lock_guard <mutex> guard (allFilesLock);
+	MyDB_OverflowFilePtr retVal = allFiles[fileName].lock ();
+	if (retVal == nullptr) {
+		retVal = make_shared <MyDB_OverflowFile> (fileName);
+		allFiles[fileName] = retVal;
+	}
+	return retVal;
+}
+
+MyDB_OverflowFile :: ~MyDB_OverflowFile () {
+	flush ();
+	if (fd >= 0)
+		close (fd);
+}
+
+void MyDB_OverflowFile :: open () {
+	if (fd >= 0)
+		return;
+	int newFd = :: open (fileName.c_str (), O_CREAT | O_RDWR, 0666);
+	struct stat fileInfo;
+	if (newFd < 0 || fstat (newFd, &fileInfo) != 0) {
+		cout << "Could not open the overflow file " << fileName << "\n";
+		exit (1);
+	}
+
+	// the size is set first, so that a thread that sees the file open also sees its size
+	fileSize = fileInfo.st_size;
+	fd = newFd;
+}
+
+long long MyDB_OverflowFile :: put (MyDB_StringView putMe) {
+
+	lock_guard <mutex> guard (lock);
+	open ();
+	long long pos = fileSize + tail.size ();
+	uint32_t len = (uint32_t) putMe.length;
+	tail.insert (tail.end (), (char *) &len, ((char *) &len) + sizeof (len));
+	tail.insert (tail.end (), putMe.data, putMe.data + putMe.length);
+	if (tail.size () >= TAIL_SIZE)
+		writeTail ();
+	return pos;
+}
+
+void MyDB_OverflowFile :: get (long long pos, string &intoMe) {
+
+	// the lock is only needed to open the file, or if the value might not have been written
+	// out yet
+	if (fd < 0 || pos >= fileSize) {
+		lock_guard <mutex> guard (lock);
+		open ();
+		long long written = fileSize;
+		if (pos >= written) {
+			uint32_t len;
+			memcpy (&len, &tail[pos - written], sizeof (len));
+			intoMe.assign (&tail[pos - written + sizeof (len)], len);
+			return;
+		}
+	}
+
+	// see if the length is in the last block that this thread read from the file, and if not,
+	// read the block that starts with it; the block stops where the file did when it was read,
+	// since whatever is after that might be in the middle of being written
+	static thread_local vector <char> block;
+	static thread_local long long blockStart = -1;
+	static thread_local long long blockId = -1;
+	if (blockId != id || pos < blockStart || pos + (long long) sizeof (uint32_t) > blockStart + (long long) block.size ()) {
+		long long toRead = fileSize - pos;
+		if (toRead > BLOCK_SIZE)
+			toRead = BLOCK_SIZE;
+		block.resize (toRead);
+		ssize_t numRead = pread (fd, block.data (), toRead, pos);
+		block.resize (numRead < 0 ? 0 : numRead);
+		blockStart = pos;
+		blockId = id;
+	}
+	uint32_t len = 0;
+	if (pos + (long long) sizeof (len) <= blockStart + (long long) block.size ())
+		memcpy (&len, &block[pos - blockStart], sizeof (len));
+
+	// a value that does not fit in a block is read by itself
+	long long start = pos + sizeof (len);
+	if (start + len <= blockStart + (long long) block.size ()) {
+		intoMe.assign (&block[start - blockStart], len);
+	} else {
+		intoMe.resize (len);
+		if (pread (fd, &intoMe[0], len, start) != (ssize_t) len) {
+			cout << "Could not read position " << pos << " of the overflow file " << fileName << "\n";
+			exit (1);
+		}
+	}
+}
+
+void MyDB_OverflowFile :: clear () {
+	lock_guard <mutex> guard (lock);
+	open ();
+	if (ftruncate (fd, 0) != 0)
+		cout << "Could not empty the overflow file " << fileName << "\n";
+	fileSize = 0;
+	tail.clear ();
+	id = nextId++;
+}
+
+void MyDB_OverflowFile :: flush () {
+	lock_guard <mutex> guard (lock);
+	writeTail ();
+}
+
+void MyDB_OverflowFile :: writeTail () {
+	if (tail.empty ())
+		return;
+	if (pwrite (fd, tail.data (), tail.size (), fileSize) != (ssize_t) tail.size ()) {
+		cout << "Could not write to the overflow file " << fileName << "\n";
+		exit (1);
+	}
+	fileSize += tail.size ();
+	tail.clear ();
+}
+
+string &MyDB_OverflowFile :: getFileName () {
+	return fileName;
+}
+
+#endif
@@ -2,402 +2,318 @@
 #ifndef RECORD_CC
 #define RECORD_CC
 
+#include "MyDB_Hash.h"
 #include "MyDB_Record.h"
 #include "MyDB_Schema.h"
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <string.h>
 
+// the conjuncts of an and are re-ordered after being run over this many records, and the time
+// taken by each conjunct is measured for one record out of every TIME_EVERY
+#define REORDER_RECORDS 4096
+#define TIME_EVERY 64
+
 using namespace std;
 
-char *MyDB_Record :: findsymbol (char val, char *input) {
-	while (*input != val) {
-		input++;
-	}
-	return input + 1;
+func MyDB_Record :: compileComputation (string compileMe) {
+	return compileComputations ({compileMe})[0];
 }
 
-func MyDB_Record :: compileComputation (string compileMe) {
-	char *str = (char *) compileMe.c_str ();
-	return compileHelper (str).first;
+vector <func> MyDB_Record :: compileComputations (vector <string> compileUs) {
+
+	vector <MyDB_ExprPtr> parsed;
+	for (string &s : compileUs)
+		parsed.push_back (MyDB_Expr :: parse (s));
+	return compileExprs (parsed);
 }
 
-pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
-	
-	// search for one of the infix symbols
-	while (true) {
+vector <func> MyDB_Record :: compileExprs (vector <MyDB_ExprPtr> compileUs) {
 
-		if (vals[0] == 0) {
-			cout << "Reached end of string while parsing.\n";
-			exit (1);
-		}
+	// resolve everything, and compute the constant parts
+	vector <MyDB_ExprPtr> parsed;
+	map <string, int> counts;
+	for (MyDB_ExprPtr expr : compileUs) {
+		expr->resolve (mySchema);
+		foldConstants (expr);
+		countSubexpressions (expr, counts);
+		parsed.push_back (expr);
+	}
 
-		// not equal
-		if (vals[0] == '!' && vals[1] == '=') {
-
-			// find the l-paren
-			vals = findsymbol ('(', vals);
-
-			// find the left result
-			auto lres = compileHelper (vals);
-			
-			// and the comma
-			vals = findsymbol (',', vals);
-
-			// find the right result
-			auto rres = compileHelper (vals);
-			
-			// find the r-paren
-			vals = findsymbol (')', vals);
-			
-			// outta here!
-			return neq (lres, rres);
-
-		// not
-		} else if (vals[0] == '!') {
-
-			// find the l-paren
-			vals = findsymbol ('(', vals);
-
-			// find the result
-			auto res = compileHelper (vals);
-			
-			// find the r-paren
-			vals = findsymbol (')', vals);
-			
-			// outta here!
-			return nott (res);
-			
-		// or
-		} else if (vals[0] == '|' && vals[1] == '|') {
-
-			// find the l-paren
-			vals = findsymbol ('(', vals);
-
-			// find the left result
-			auto lres = compileHelper (vals);
-			
-			// and the comma
-			vals = findsymbol (',', vals);
-
-			// find the right result
-			auto rres = compileHelper (vals);
-			
-			// find the r-paren
-			vals = findsymbol (')', vals);
-			
-			// outta here!
-			return orr (lres, rres);
-
-		// plus
-		} else if (vals[0] == '+') {
-
-			// find the l-paren
-			vals = findsymbol ('(', vals);
-
-			// find the left result
-			auto lres = compileHelper (vals);
-			
-			// and the comma
-			vals = findsymbol (',', vals);
-
-			// find the right result
-			auto rres = compileHelper (vals);
-			
-			// find the r-paren
-			vals = findsymbol (')', vals);
-			
-			// outta here!
-			return plus (lres, rres);
-
-		// and
-		} else if (vals[0] == '&' && vals[1] == '&') {
-
-			// find the l-paren
-			vals = findsymbol ('(', vals);
-
-			// find the left result
-			auto lres = compileHelper (vals);
-			
-			// and the comma
-			vals = findsymbol (',', vals);
-
-			// find the right result
-			auto rres = compileHelper (vals);
-			
-			// find the r-paren
-			vals = findsymbol (')', vals);
-			
-			// outta here!
-			return andd (lres, rres);
-
-		// equals
-		} else if (vals[0] == '=' && vals[1] == '=') {
-
-			// find the l-paren
-			vals = findsymbol ('(', vals);
-
-			// find the left result
-			auto lres = compileHelper (vals);
-			
-			// and the comma
-			vals = findsymbol (',', vals);
-
-			// find the right result
-			auto rres = compileHelper (vals);
-			
-			// find the r-paren
-			vals = findsymbol (')', vals);
-			
-			// outta here!
-			return eq (lres, rres);
-
-		// greater than
-		} else if (vals[0] == '>') {
-
-			// find the l-paren
-			vals = findsymbol ('(', vals);
-
-			// find the left result
-			auto lres = compileHelper (vals);
-			
-			// and the comma
-			vals = findsymbol (',', vals);
-
-			// find the right result
-			auto rres = compileHelper (vals);
-			
-			// find the r-paren
-			vals = findsymbol (')', vals);
-			
-			// outta here!
-			return gt (lres, rres);
-
-		// less than
-		} else if (vals[0] == '<') {
-
-			// find the l-paren
-			vals = findsymbol ('(', vals);
-
-			// find the left result
-			auto lres = compileHelper (vals);
-			
-			// and the comma
-			vals = findsymbol (',', vals);
-
-			// find the right result
-			auto rres = compileHelper (vals);
-			
-			// find the r-paren
-			vals = findsymbol (')', vals);
-			
-			// outta here!
-			return lt (lres, rres);
-
-		// times
-		} else if (vals[0] == '*') {
-
-			// find the l-paren
-			vals = findsymbol ('(', vals);
-
-			// find the left result
-			auto lres = compileHelper (vals);
-			
-			// and the comma
-			vals = findsymbol (',', vals);
-
-			// find the right result
-			auto rres = compileHelper (vals);
-			
-			// find the r-paren
-			vals = findsymbol (')', vals);
-			
-			// outta here!
-			return times (lres, rres);
-
-		// divide
-		} else if (vals[0] == '/') {
-
-			// find the l-paren
-			vals = findsymbol ('(', vals);
-
-			// find the left result
-			auto lres = compileHelper (vals);
-			
-			// and the comma
-			vals = findsymbol (',', vals);
-
-			// find the right result
-			auto rres = compileHelper (vals);
-			
-			// find the r-paren
-			vals = findsymbol (')', vals);
-			
-			// outta here!
-			return divide (lres, rres);
-
-		// minus
-		} else if (vals[0] == '-') {
-
-			// find the l-paren
-			vals = findsymbol ('(', vals);
-
-			// find the left result
-			auto lres = compileHelper (vals);
-			
-			// and the comma
-			vals = findsymbol (',', vals);
-
-			// find the right result
-			auto rres = compileHelper (vals);
-			
-			// find the r-paren
-			vals = findsymbol (')', vals);
-			
-			// outta here!
-			return minus (lres, rres);
-
-		// unary minus
-		} else if (vals[0] == 'u' && vals[1] == 'm') {
-
-			// find the l-paren
-			vals = findsymbol ('(', vals);
-
-			// find the result
-			auto res = compileHelper (vals);
-			
-			// find the r-paren
-			vals = findsymbol (')', vals);
-			
-			// outta here!
-			return unaryMinus (res);
-
-		// not equal
-		} else if (vals[0] == '!' && vals[1] == '=') {
-
-			// find the l-paren
-			vals = findsymbol ('(', vals);
-
-			// find the left result
-			auto lres = compileHelper (vals);
-			
-			// and the comma
-			vals = findsymbol (',', vals);
-
-			// find the right result
-			auto rres = compileHelper (vals);
-			
-			// find the r-paren
-			vals = findsymbol (')', vals);
-			
-			// outta here!
-			return neq (lres, rres);
-
-		} else if (vals[0] == '[') {
-
-			// find the right bracket
-			vals++;
-			int cnt = 0;
-			for (; vals[cnt] != ']'; cnt++);
-
-			// copy the string over
-			char name[cnt + 1];
-			for (cnt = 0; vals[cnt] != ']'; cnt++) {
-				name[cnt] = vals[cnt];
-			}	
-			name[cnt] = 0;
-
-			// find the ]
-			vals = findsymbol (']', vals);
-	
-			// and get that attribute
-			return fromData (name);		
+	// anything that appears more than once is shared
+	set <string> shared;
+	for (auto &c : counts)
+		if (c.second > 1)
+			shared.insert (c.first);
+
+	map <string, pair <func, MyDB_AttTypePtr>> built;
+	vector <func> returnVal;
+	for (MyDB_ExprPtr expr : parsed)
+		returnVal.push_back (compileExpr (expr, shared, built).first);
+	return returnVal;
+}
+
+void MyDB_Record :: countSubexpressions (MyDB_ExprPtr countMe, map <string, int> &counts) {
 
-		} else if (strncmp (vals, "int", 3) == 0) {
+	if (countMe->isLiteral () || countMe->getOp () == attOp)
+		return;
 
-			vals = findsymbol ('[', vals);
-			int val = stoi (vals);
-			vals = findsymbol (']', vals);
+	if (counts[countMe->toString ()]++ > 0)
+		return;
 
-			// remember this value
-			MyDB_IntAttValPtr temp = make_shared <MyDB_IntAttVal> ();
-			scratch.push_back (temp);
-			temp->set (val);
+	countSubexpressions (countMe->getLHS (), counts);
+	if (countMe->getRHS () != nullptr)
+		countSubexpressions (countMe->getRHS (), counts);
+}
 
-			// returns a lambda that computes the result
-			return make_pair ([temp] {return temp;}, make_shared <MyDB_IntAttType> ());
+void MyDB_Record :: foldConstants (MyDB_ExprPtr foldMe) {
 
-		} else if (strncmp (vals, "double", 6) == 0) {
+	if (foldMe->isLiteral () || foldMe->getOp () == attOp)
+		return;
 
-			vals = findsymbol ('[', vals);
-			double val = stod (vals);
-			vals = findsymbol (']', vals);
+	// first fold the inputs; we can only go on if they all became literals
+	MyDB_ExprPtr lhs = foldMe->getLHS ();
+	MyDB_ExprPtr rhs = foldMe->getRHS ();
+	foldConstants (lhs);
+	if (rhs != nullptr)
+		foldConstants (rhs);
+	if (!lhs->isLiteral () || (rhs != nullptr && !rhs->isLiteral ()))
+		return;
 
-			// remember this value
-			MyDB_DoubleAttValPtr temp = make_shared <MyDB_DoubleAttVal> ();
-			scratch.push_back (temp);
-			temp->set (val);
+	// an integer division by zero is left alone, so that it fails when it is run, as it always has
+	if (foldMe->getOp () == divideOp && foldMe->getMode () == intMode && rhs->getInt () == 0)
+		return;
 
-			// returns a lambda that computes the result
-			return make_pair ([temp] {return temp;}, make_shared <MyDB_DoubleAttType> ());
+	// compute the value, using the same code that computes it for each record
+	set <string> noneShared;
+	map <string, pair <func, MyDB_AttTypePtr>> built;
+	MyDB_AttValPtr val = compileExpr (foldMe, noneShared, built).first ();
+	MyDB_AttTypePtr type = foldMe->getType ();
+	if (type->isBool ())
+		foldMe->becomeLiteral (MyDB_Expr :: boolLiteral (val->toBool ()));
+	else if (type->promotableToInt ())
+		foldMe->becomeLiteral (MyDB_Expr :: intLiteral (val->toInt ()));
+	else if (type->promotableToDouble ())
+		foldMe->becomeLiteral (MyDB_Expr :: doubleLiteral (val->toDouble ()));
+	else
+		foldMe->becomeLiteral (MyDB_Expr :: stringLiteral (val->toString ()));
+}
 
-		} else if (strncmp (vals, "bool", 4) == 0) {
+// the saved result of a subexpression that is used more than once
+struct SharedResult {
+	long version;
+	MyDB_AttValPtr result;
+};
 
-			vals = findsymbol ('[', vals);
-			bool val = false;
-			if (strncmp (vals, "true", 4) == 0) {
-				val = true;
-			}
-			vals = findsymbol (']', vals);
+pair <func, MyDB_AttTypePtr> MyDB_Record :: compileExpr (MyDB_ExprPtr compileMe, set <string> &shared,
+	map <string, pair <func, MyDB_AttTypePtr>> &built) {
 
-			// remember this value
-			MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-			scratch.push_back (temp);
-			temp->set (val);
+	MyDB_ExprOp op = compileMe->getOp ();
 
-			// returns a lambda that computes the result
-			return make_pair ([temp] {return temp;}, make_shared <MyDB_BoolAttType> ());
+	// attributes
+	if (op == attOp) {
+		return fromData (compileMe->getAttIndex (), compileMe->getType ());
 
-		} else if (strncmp (vals, "string", 6) == 0) {
+	// and literals; each is stored in an att val that the lambda returns
+	} else if (op == intOp) {
+		MyDB_IntAttValPtr temp = make_shared <MyDB_IntAttVal> ();
+		scratch.push_back (temp);
+		temp->set (compileMe->getInt ());
+		return make_pair ([temp] {return temp;}, make_shared <MyDB_IntAttType> ());
 
-			vals = findsymbol ('[', vals);
+	} else if (op == doubleOp) {
+		MyDB_DoubleAttValPtr temp = make_shared <MyDB_DoubleAttVal> ();
+		scratch.push_back (temp);
+		temp->set (compileMe->getDouble ());
+		return make_pair ([temp] {return temp;}, make_shared <MyDB_DoubleAttType> ());
 
-			// find the right bracket
-			int cnt = 0;
-			for (; vals[cnt] != ']'; cnt++);
+	} else if (op == boolOp) {
+		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
+		scratch.push_back (temp);
+		temp->set (compileMe->getBool ());
+		return make_pair ([temp] {return temp;}, make_shared <MyDB_BoolAttType> ());
 
-			// copy the string over
-			char name[cnt + 1];
-			for (cnt = 0; vals[cnt] != ']'; cnt++) {
-				name[cnt] = vals[cnt];
-			}	
-			name[cnt] = 0;
+	} else if (op == stringOp) {
+		MyDB_StringAttValPtr temp = make_shared <MyDB_StringAttVal> ();
+		scratch.push_back (temp);
+		temp->set (compileMe->getString ());
+		return make_pair ([temp] {return temp;}, make_shared <MyDB_StringAttType> ());
+	}
 
-			// find the ]
-			vals = findsymbol (']', vals);
-	
-			// remember this value
-			MyDB_StringAttValPtr temp = make_shared <MyDB_StringAttVal> ();
-			scratch.push_back (temp);
-			temp->set (name);
-
-			// returns a lambda that computes the result
-			return make_pair ([temp] {return temp;}, make_shared <MyDB_StringAttType> ());
-			
+	// see if we have already built this one
+	string key = compileMe->toString ();
+	auto found = built.find (key);
+	if (found != built.end ())
+		return found->second;
+
+	// build the inputs, then the operation (unless it can be done on dictionary codes)
+	pair <func, MyDB_AttTypePtr> res;
+	if (op == andOp) {
+
+		// an and is built over all of its conjuncts at once, so that they can be re-ordered
+		vector <MyDB_ExprPtr> conjunctExprs;
+		MyDB_Expr :: getConjuncts (compileMe, conjunctExprs);
+		vector <pair <func, MyDB_AttTypePtr>> conjuncts;
+		vector <string> names;
+		vector <bool> pinned;
+		for (MyDB_ExprPtr e : conjunctExprs) {
+			conjuncts.push_back (compileExpr (e, shared, built));
+			names.push_back (e->toString ());
+			pinned.push_back (e->canFail ());
+		}
+		res = andd (conjuncts, names, pinned);
+
+	} else if (!compileOnCodes (compileMe, res) && !compileOnChars (compileMe, res)) {
+		auto lres = compileExpr (compileMe->getLHS (), shared, built);
+		if (op == notOp) {
+			res = nott (lres);
+		} else if (op == uMinusOp) {
+			res = unaryMinus (lres);
 		} else {
-			vals++;
+			auto rres = compileExpr (compileMe->getRHS (), shared, built);
+			switch (op) {
+			case plusOp: res = plus (lres, rres); break;
+			case minusOp: res = minus (lres, rres); break;
+			case timesOp: res = times (lres, rres); break;
+			case divideOp: res = divide (lres, rres); break;
+			case gtOp: res = gt (lres, rres); break;
+			case ltOp: res = lt (lres, rres); break;
+			case eqOp: res = eq (lres, rres); break;
+			case neqOp: res = neq (lres, rres); break;
+			default: res = orr (lres, rres); break;
+			}
 		}
 	}
+
+	// if this is used more than once, then it is only re-computed when one of the
+	// attributes that it reads has changed since the last time
+	if (shared.count (key) > 0) {
+		vector <int> atts;
+		compileMe->getAtts (atts);
+		int lowAtt = values.size (), highAtt = -1;
+		for (int a : atts) {
+			lowAtt = min (lowAtt, a);
+			highAtt = max (highAtt, a);
+		}
+
+		func compute = res.first;
+		shared_ptr <SharedResult> saved = make_shared <SharedResult> ();
+		saved->version = -1;
+		res.first = [this, compute, saved, lowAtt, highAtt] {
+			long now = getVersion (lowAtt, highAtt);
+			if (saved->version != now) {
+				saved->result = compute ();
+				saved->version = now;
+			}
+			return saved->result;
+		};
+	}
+
+	built[key] = res;
+	return res;
+}
+
+bool MyDB_Record :: compileOnCodes (MyDB_ExprPtr compileMe, pair <func, MyDB_AttTypePtr> &res) {
+
+	int whichAtt;
+	MyDB_ExprOp cmp;
+	MyDB_ExprPtr literal;
+	if ((compileMe->getOp () != eqOp && compileMe->getOp () != neqOp) ||
+		!compileMe->isAttVsLiteral (whichAtt, cmp, literal))
+		return false;
+
+	MyDB_DictStringAttTypePtr dictType = dynamic_pointer_cast <MyDB_DictStringAttType> (mySchema->getAtts ()[whichAtt].second);
+	if (dictType == nullptr)
+		return false;
+
+	// a string that is not in the dictionary has a code (-1) that matches nothing; since the
+	// string may be added to the dictionary after this is compiled, it is looked up again
+	// until it is found
+	string val = literal->getString ();
+	MyDB_StringDictionaryPtr dictionary = dictType->getDictionary ();
+	shared_ptr <int> code = make_shared <int> (dictionary->find (MyDB_StringView (val.data (), val.size ())));
+	bool isEq = (cmp == eqOp);
+
+	MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
+	scratch.push_back (temp);
+	res = make_pair ([this, temp, whichAtt, code, isEq, val, dictionary] {
+		if (*code < 0)
+			*code = dictionary->find (MyDB_StringView (val.data (), val.size ()));
+		temp->set ((static_pointer_cast <MyDB_DictStringAttVal> (values[whichAtt])->getCode () == *code) == isEq);
+		return temp;}, make_shared <MyDB_BoolAttType> ());
+	return true;
+}
+
+bool MyDB_Record :: compileOnChars (MyDB_ExprPtr compileMe, pair <func, MyDB_AttTypePtr> &res) {
+
+	int whichAtt;
+	MyDB_ExprOp cmp;
+	MyDB_ExprPtr literal;
+	if ((compileMe->getOp () != eqOp && compileMe->getOp () != neqOp) ||
+		!compileMe->isAttVsLiteral (whichAtt, cmp, literal))
+		return false;
+
+	MyDB_CharAttTypePtr charType = dynamic_pointer_cast <MyDB_CharAttType> (mySchema->getAtts ()[whichAtt].second);
+	if (charType == nullptr)
+		return false;
+
+	// a literal that is too long (or has a null in it) cannot match anything
+	string &val = literal->getString ();
+	bool isEq = (cmp == eqOp);
+	MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
+	scratch.push_back (temp);
+	if ((int) val.size () > charType->getWidth () || strlen (val.c_str ()) != val.size ()) {
+		temp->set (!isEq);
+		res = make_pair ([temp] {return temp;}, make_shared <MyDB_BoolAttType> ());
+		return true;
+	}
+
+	shared_ptr <string> padded = make_shared <string> (val);
+	padded->resize (charType->getWidth () + 1, 0);
+	res = make_pair ([this, temp, whichAtt, padded, isEq] {
+		temp->set (static_pointer_cast <MyDB_CharAttVal> (values[whichAtt])->matches (padded->data ()) == isEq);
+		return temp;}, make_shared <MyDB_BoolAttType> ());
+	return true;
+}
+
+long MyDB_Record :: getVersion (int lowAtt, int highAtt) {
+
+	// if this was built from two records, then the atts come from one or both of them
+	long returnVal = version;
+	if (leftPart != nullptr) {
+		int numLeft = leftPart->values.size ();
+		if (lowAtt < numLeft)
+			returnVal += leftPart->getVersion (lowAtt, min (highAtt, numLeft - 1));
+		if (highAtt >= numLeft)
+			returnVal += rightPart->getVersion (max (lowAtt - numLeft, 0), highAtt - numLeft);
+	}
+	return returnVal;
 }
 
-pair <func, MyDB_AttTypePtr> MyDB_Record :: fromData (string attName) {
+pair <func, MyDB_AttTypePtr> MyDB_Record :: fromData (int whichAtt, MyDB_AttTypePtr attType) {
 
-	// just return a particular attribute
-	auto whichAtt = mySchema->getAttByName (attName);
-	return make_pair ([this, whichAtt] {return values[whichAtt.first];}, whichAtt.second);		
+	// just return a particular attribute; its position was found when the computation was resolved
+	return make_pair ([this, whichAtt] {return values[whichAtt];}, attType);
+}
+
+// returns a function that gets the value computed by fromMe (a decimal or an int) as an integer
+// counting units of 10^-toScale, like a MyDB_DecimalAttVal with that scale stores it
+static function <long long ()> scaledValue (pair <func, MyDB_AttTypePtr> fromMe, int toScale) {
+	func compute = fromMe.first;
+	MyDB_DecimalAttTypePtr decimalType = dynamic_pointer_cast <MyDB_DecimalAttType> (fromMe.second);
+	if (decimalType == nullptr) {
+		long long factor = MyDB_DecimalAttVal :: powerOfTen (toScale);
+		return [compute, factor] {return compute ()->toInt () * factor;};
+	}
+	long long factor = MyDB_DecimalAttVal :: powerOfTen (toScale - decimalType->getScale ());
+	return [compute, factor] {return static_cast <MyDB_DecimalAttVal *> (compute ().get ())->getScaled () * factor;};
 }
 
 pair <func, MyDB_AttTypePtr> MyDB_Record :: plus (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
 
+	int lhsScale, rhsScale;
+
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
 		MyDB_IntAttValPtr temp = make_shared <MyDB_IntAttVal> ();
@@ -407,6 +323,18 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: plus (pair <func, MyDB_AttTypePtr> l
 		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () + rhs.first ()->toInt ()); return temp;},
 			make_shared <MyDB_IntAttType> ());
 
+	// otherwise, if both sides can be done exactly as decimals, then do so
+	} else if (MyDB_Expr :: asDecimals (lhs.second, rhs.second, lhsScale, rhsScale)) {
+		int scale = max (lhsScale, rhsScale);
+		MyDB_DecimalAttValPtr temp = make_shared <MyDB_DecimalAttVal> (MAX_DECIMAL_PRECISION, scale);
+		scratch.push_back (temp);
+		function <long long ()> lhsVal = scaledValue (lhs, scale);
+		function <long long ()> rhsVal = scaledValue (rhs, scale);
+
+		// returns a lambda that computes the result
+		return make_pair ([temp, lhsVal, rhsVal] {temp->setScaled (lhsVal () + rhsVal ()); return temp;},
+			make_shared <MyDB_DecimalAttType> (MAX_DECIMAL_PRECISION, scale));
+
 	// otherwise, if both sides can be cast upwards to be doubles, then do so
 	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
 		MyDB_DoubleAttValPtr temp = make_shared <MyDB_DoubleAttVal> ();
@@ -422,7 +350,7 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: plus (pair <func, MyDB_AttTypePtr> l
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () + rhs.first ()->toString ()); return temp;},
+		return make_pair ([temp, lhs, rhs] {temp->setConcat (lhs.first (), rhs.first ()); return temp;},
 			make_shared <MyDB_StringAttType> ());
 
 	} else {
@@ -433,6 +361,8 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: plus (pair <func, MyDB_AttTypePtr> l
 
 pair <func, MyDB_AttTypePtr> MyDB_Record :: minus (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
 
+	int lhsScale, rhsScale;
+
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
 		MyDB_IntAttValPtr temp = make_shared <MyDB_IntAttVal> ();
@@ -442,6 +372,18 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: minus (pair <func, MyDB_AttTypePtr>
 		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () - rhs.first ()->toInt ()); return temp;},
 			make_shared <MyDB_IntAttType> ());
 
+	// otherwise, if both sides can be done exactly as decimals, then do so
+	} else if (MyDB_Expr :: asDecimals (lhs.second, rhs.second, lhsScale, rhsScale)) {
+		int scale = max (lhsScale, rhsScale);
+		MyDB_DecimalAttValPtr temp = make_shared <MyDB_DecimalAttVal> (MAX_DECIMAL_PRECISION, scale);
+		scratch.push_back (temp);
+		function <long long ()> lhsVal = scaledValue (lhs, scale);
+		function <long long ()> rhsVal = scaledValue (rhs, scale);
+
+		// returns a lambda that computes the result
+		return make_pair ([temp, lhsVal, rhsVal] {temp->setScaled (lhsVal () - rhsVal ()); return temp;},
+			make_shared <MyDB_DecimalAttType> (MAX_DECIMAL_PRECISION, scale));
+
 	// otherwise, if both sides can be cast upwards to be doubles, then do so
 	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
 		MyDB_DoubleAttValPtr temp = make_shared <MyDB_DoubleAttVal> ();
@@ -468,6 +410,17 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: unaryMinus (pair <func, MyDB_AttType
 		return make_pair ([temp, lhs] {temp->set (-lhs.first ()->toInt ()); return temp;},
 			make_shared <MyDB_IntAttType> ());
 
+	// otherwise, if it is a decimal, then keep it one
+	} else if (dynamic_pointer_cast <MyDB_DecimalAttType> (lhs.second) != nullptr) {
+		int scale = static_pointer_cast <MyDB_DecimalAttType> (lhs.second)->getScale ();
+		MyDB_DecimalAttValPtr temp = make_shared <MyDB_DecimalAttVal> (MAX_DECIMAL_PRECISION, scale);
+		scratch.push_back (temp);
+		function <long long ()> lhsVal = scaledValue (lhs, scale);
+
+		// returns a lambda that computes the result
+		return make_pair ([temp, lhsVal] {temp->setScaled (-lhsVal ()); return temp;},
+			make_shared <MyDB_DecimalAttType> (MAX_DECIMAL_PRECISION, scale));
+
 	// otherwise, if both sides can be cast upwards to be doubles, then do so
 	} else if (lhs.second->promotableToDouble ()) {
 		MyDB_DoubleAttValPtr temp = make_shared <MyDB_DoubleAttVal> ();
@@ -485,6 +438,8 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: unaryMinus (pair <func, MyDB_AttType
 
 pair <func, MyDB_AttTypePtr> MyDB_Record :: times (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
 
+	int lhsScale, rhsScale;
+
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
 		MyDB_IntAttValPtr temp = make_shared <MyDB_IntAttVal> ();
@@ -494,6 +449,19 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: times (pair <func, MyDB_AttTypePtr>
 		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () * rhs.first ()->toInt ()); return temp;},
 			make_shared <MyDB_IntAttType> ());
 
+	// otherwise, if both sides can be done exactly as decimals, then do so
+	} else if (MyDB_Expr :: asDecimals (lhs.second, rhs.second, lhsScale, rhsScale) &&
+		lhsScale + rhsScale <= MAX_DECIMAL_PRECISION) {
+		int scale = lhsScale + rhsScale;
+		MyDB_DecimalAttValPtr temp = make_shared <MyDB_DecimalAttVal> (MAX_DECIMAL_PRECISION, scale);
+		scratch.push_back (temp);
+		function <long long ()> lhsVal = scaledValue (lhs, lhsScale);
+		function <long long ()> rhsVal = scaledValue (rhs, rhsScale);
+
+		// returns a lambda that computes the result
+		return make_pair ([temp, lhsVal, rhsVal] {temp->setScaled (lhsVal () * rhsVal ()); return temp;},
+			make_shared <MyDB_DecimalAttType> (MAX_DECIMAL_PRECISION, scale));
+
 	// otherwise, if both sides can be cast upwards to be doubles, then do so
 	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
 		MyDB_DoubleAttValPtr temp = make_shared <MyDB_DoubleAttVal> ();
@@ -537,6 +505,8 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: divide (pair <func, MyDB_AttTypePtr>
 
 pair <func, MyDB_AttTypePtr> MyDB_Record :: gt (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
 
+	int lhsScale, rhsScale;
+
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
 		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
@@ -546,6 +516,17 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: gt (pair <func, MyDB_AttTypePtr> lhs
 		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () > rhs.first ()->toInt ()); return temp;},
 			make_shared <MyDB_BoolAttType> ());
 
+	// otherwise, if both sides can be compared exactly as decimals, then do so
+	} else if (MyDB_Expr :: asDecimals (lhs.second, rhs.second, lhsScale, rhsScale)) {
+		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
+		scratch.push_back (temp);
+		function <long long ()> lhsVal = scaledValue (lhs, max (lhsScale, rhsScale));
+		function <long long ()> rhsVal = scaledValue (rhs, max (lhsScale, rhsScale));
+
+		// returns a lambda that computes the result
+		return make_pair ([temp, lhsVal, rhsVal] {temp->set (lhsVal () > rhsVal ()); return temp;},
+			make_shared <MyDB_BoolAttType> ());
+
 	// otherwise, if both sides can be cast upwards to be doubles, then do so
 	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
 		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
@@ -561,7 +542,7 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: gt (pair <func, MyDB_AttTypePtr> lhs
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () > rhs.first ()->toString ()); return temp;},
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toStringView ().compare (rhs.first ()->toStringView ()) > 0); return temp;},
 			make_shared <MyDB_BoolAttType> ());
 
 	} else {
@@ -572,6 +553,8 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: gt (pair <func, MyDB_AttTypePtr> lhs
 
 pair <func, MyDB_AttTypePtr> MyDB_Record :: lt (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
 
+	int lhsScale, rhsScale;
+
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
 		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
@@ -581,6 +564,17 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: lt (pair <func, MyDB_AttTypePtr> lhs
 		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () < rhs.first ()->toInt ()); return temp;},
 			make_shared <MyDB_BoolAttType> ());
 
+	// otherwise, if both sides can be compared exactly as decimals, then do so
+	} else if (MyDB_Expr :: asDecimals (lhs.second, rhs.second, lhsScale, rhsScale)) {
+		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
+		scratch.push_back (temp);
+		function <long long ()> lhsVal = scaledValue (lhs, max (lhsScale, rhsScale));
+		function <long long ()> rhsVal = scaledValue (rhs, max (lhsScale, rhsScale));
+
+		// returns a lambda that computes the result
+		return make_pair ([temp, lhsVal, rhsVal] {temp->set (lhsVal () < rhsVal ()); return temp;},
+			make_shared <MyDB_BoolAttType> ());
+
 	// otherwise, if both sides can be cast upwards to be doubles, then do so
 	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
 		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
@@ -596,7 +590,7 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: lt (pair <func, MyDB_AttTypePtr> lhs
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () < rhs.first ()->toString ()); return temp;},
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toStringView ().compare (rhs.first ()->toStringView ()) < 0); return temp;},
 			make_shared <MyDB_BoolAttType> ());
 
 	} else {
@@ -607,6 +601,8 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: lt (pair <func, MyDB_AttTypePtr> lhs
 
 pair <func, MyDB_AttTypePtr> MyDB_Record :: eq (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
 
+	int lhsScale, rhsScale;
+
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
 		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
@@ -616,6 +612,17 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: eq (pair <func, MyDB_AttTypePtr> lhs
 		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () == rhs.first ()->toInt ()); return temp;},
 			make_shared <MyDB_BoolAttType> ());
 
+	// otherwise, if both sides can be compared exactly as decimals, then do so
+	} else if (MyDB_Expr :: asDecimals (lhs.second, rhs.second, lhsScale, rhsScale)) {
+		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
+		scratch.push_back (temp);
+		function <long long ()> lhsVal = scaledValue (lhs, max (lhsScale, rhsScale));
+		function <long long ()> rhsVal = scaledValue (rhs, max (lhsScale, rhsScale));
+
+		// returns a lambda that computes the result
+		return make_pair ([temp, lhsVal, rhsVal] {temp->set (lhsVal () == rhsVal ()); return temp;},
+			make_shared <MyDB_BoolAttType> ());
+
 	// otherwise, if both sides can be cast upwards to be doubles, then do so
 	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
 		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
@@ -639,7 +646,7 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: eq (pair <func, MyDB_AttTypePtr> lhs
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () == rhs.first ()->toString ()); return temp;},
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toStringView () == rhs.first ()->toStringView ()); return temp;},
 			make_shared <MyDB_BoolAttType> ());
 
 	} else {
@@ -650,6 +657,8 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: eq (pair <func, MyDB_AttTypePtr> lhs
 
 pair <func, MyDB_AttTypePtr> MyDB_Record :: neq (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
 
+	int lhsScale, rhsScale;
+
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
 		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
@@ -659,6 +668,17 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: neq (pair <func, MyDB_AttTypePtr> lh
 		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () != rhs.first ()->toInt ()); return temp;},
 			make_shared <MyDB_BoolAttType> ());
 
+	// otherwise, if both sides can be compared exactly as decimals, then do so
+	} else if (MyDB_Expr :: asDecimals (lhs.second, rhs.second, lhsScale, rhsScale)) {
+		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
+		scratch.push_back (temp);
+		function <long long ()> lhsVal = scaledValue (lhs, max (lhsScale, rhsScale));
+		function <long long ()> rhsVal = scaledValue (rhs, max (lhsScale, rhsScale));
+
+		// returns a lambda that computes the result
+		return make_pair ([temp, lhsVal, rhsVal] {temp->set (lhsVal () != rhsVal ()); return temp;},
+			make_shared <MyDB_BoolAttType> ());
+
 	} else if (lhs.second->isBool () && rhs.second->isBool ()) {
 		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
 		scratch.push_back (temp);
@@ -682,7 +702,7 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: neq (pair <func, MyDB_AttTypePtr> lh
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () != rhs.first ()->toString ()); return temp;},
+		return make_pair ([temp, lhs, rhs] {temp->set (!(lhs.first ()->toStringView () == rhs.first ()->toStringView ())); return temp;},
 			make_shared <MyDB_BoolAttType> ());
 
 	} else {
@@ -708,21 +728,45 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: orr (pair <func, MyDB_AttTypePtr> lh
 	}
 }
 
-pair <func, MyDB_AttTypePtr> MyDB_Record :: andd (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
-
-	// if both sides can be cast upwards to be ints, then do so
-	if (lhs.second->isBool () && rhs.second->isBool ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toBool () && rhs.first ()->toBool ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
+pair <func, MyDB_AttTypePtr> MyDB_Record :: andd (vector <pair <func, MyDB_AttTypePtr>> conjuncts, vector <string> names,
+	vector <bool> pinned) {
 
-	} else {
-		cout << "This is bad... cannot do or on non booleans.\n";
-		exit (1);
+	vector <func> funcs;
+	for (auto &c : conjuncts) {
+		if (!c.second->isBool ()) {
+			cout << "This is bad... cannot do and on non booleans.\n";
+			exit (1);
+		}
+		funcs.push_back (c.first);
 	}
+
+	MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
+	scratch.push_back (temp);
+	MyDB_ConjunctOrderPtr order = make_shared <MyDB_ConjunctOrder> (names, pinned, REORDER_RECORDS);
+	conjunctOrders.push_back (order);
+	shared_ptr <long> numCalls = make_shared <long> (0);
+
+	// returns a lambda that runs the conjuncts in the order picked by order, stopping at the
+	// first one that is false; the time taken by each is only measured once every TIME_EVERY calls
+	return make_pair ([temp, funcs, order, numCalls] {
+			bool timeIt = (++*numCalls % TIME_EVERY == 0);
+			bool result = true;
+			for (int which : order->getOrder ()) {
+				if (timeIt) {
+					auto start = chrono :: steady_clock :: now ();
+					result = funcs[which] ()->toBool ();
+					order->addTime (which, 1, chrono :: duration <double, nano> (chrono :: steady_clock :: now () - start).count ());
+				} else {
+					result = funcs[which] ()->toBool ();
+				}
+				order->addCounts (which, 1, result);
+				if (!result)
+					break;
+			}
+			order->tick ();
+			temp->set (result);
+			return temp;
+		}, make_shared <MyDB_BoolAttType> ());
 }
 
 pair <func, MyDB_AttTypePtr> MyDB_Record :: nott (pair <func, MyDB_AttTypePtr> lhs) {
@@ -752,6 +796,7 @@ size_t MyDB_Record :: getBinarySize () {
 
 void MyDB_Record :: recordContentHasChanged () {
 	bufferOld = true;
+	version++;
 }
 
 void MyDB_Record :: writeAttsToBuffer () {
@@ -773,6 +818,20 @@ void *MyDB_Record :: toBinary (void *toHere) {
 	return ((char *) toHere) + recSize;
 }
 
+size_t MyDB_Record :: hashKeys (vector <func> &keys) {
+	size_t hashVal = 0;
+	for (auto &f : keys)
+		hashVal = hashCombine (hashVal, f ()->hash ());
+	return hashVal;
+}
+
+void MyDB_Record :: hashBatch (void **recs, int *which, int n, vector <func> &keys, size_t *hashes) {
+	for (int i = 0; i < n; i++) {
+		fromBinary (recs[which[i]]);
+		hashes[i] = hashKeys (keys);
+	}
+}
+
 void *MyDB_Record :: fromBinary (void *fromHere) {
 
 	recSize = *((short *) fromHere);
@@ -795,18 +854,26 @@ void *MyDB_Record :: fromBinary (void *fromHere) {
 	}		
 
 	bufferOld = false;
+	version++;
 
 	return ((char *) fromHere) + recSize;
 
 }
 
 void MyDB_Record :: fromString (string res) {	
-	int i = 0;
-        for (int pos = 0; pos < (int) res.size (); pos = (int) res.find ("|", pos + 1) + 1) {
-                string temp = res.substr (pos, res.find ("|", pos + 1) - pos);
-		values[i++]->fromString (temp);
-        }
+	fromText (res.data (), res.data () + res.size ());
+}
+
+void MyDB_Record :: fromText (const char *start, const char *end) {
+	for (int i = 0; i < (int) values.size () && start < end; i++) {
+		const char *bar = (const char *) memchr (start, '|', end - start);
+		if (bar == nullptr)
+			bar = end;
+		values[i]->fromText (start, bar - start);
+		start = bar + 1;
+	}
 	bufferOld = true;
+	version++;
 }
 
 std::ostream& operator<<(std::ostream& os, const MyDB_Record printMe) {
@@ -828,11 +895,13 @@ std::ostream& operator<<(std::ostream& os, const MyDB_RecordPtr printMe) {
 function <bool ()> buildRecordComparator (MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs, string computation) {
 
 	// compile a computation over the LHS and over the RHS
-	char *str = (char *) computation.c_str ();
-	pair <func, MyDB_AttTypePtr> lhsFunc = lhs->compileHelper (str);
-
-	str = (char *) computation.c_str ();
-	pair <func, MyDB_AttTypePtr> rhsFunc = rhs->compileHelper (str);
+	MyDB_ExprPtr expr = MyDB_Expr :: parse (computation);
+	expr->resolve (lhs->mySchema);
+	lhs->foldConstants (expr);
+	set <string> noneShared;
+	map <string, pair <func, MyDB_AttTypePtr>> lhsBuilt, rhsBuilt;
+	pair <func, MyDB_AttTypePtr> lhsFunc = lhs->compileExpr (expr, noneShared, lhsBuilt);
+	pair <func, MyDB_AttTypePtr> rhsFunc = rhs->compileExpr (expr, noneShared, rhsBuilt);
 
 	// and then build a lambda that performs the computatation
 	auto res = lhs->lt (lhsFunc, rhsFunc);
@@ -848,6 +917,7 @@ MyDB_Record :: MyDB_Record (MyDB_SchemaPtr mySchemaIn) {
 	allocatedSize = 256;
 	recSize = 0;
 	bufferOld = true;
+	version = 0;
 
 	if (mySchemaIn == nullptr)
 		return;
@@ -861,6 +931,10 @@ MyDB_SchemaPtr &MyDB_Record :: getSchema () {
 	return mySchema;
 }
 
+vector <MyDB_ConjunctOrderPtr> &MyDB_Record :: getConjunctOrders () {
+	return conjunctOrders;
+}
+
 MyDB_AttValPtr &MyDB_Record :: getAtt (int whichAtt) {
 	return values[whichAtt];
 }
@@ -874,6 +948,9 @@ void MyDB_Record :: buildFrom (MyDB_RecordPtr left, MyDB_RecordPtr right) {
                 newValues.push_back (v);
         }
         values = newValues;
+	leftPart = left;
+	rightPart = right;
+	version++;
 }
 
 MyDB_Record :: ~MyDB_Record () {
@@ -0,0 +1,72 @@
+
+#ifndef STRING_DICT_C
+#define STRING_DICT_C
+
+#include "MyDB_StringDictionary.h"
+#include <iostream>
+
+using namespace std;
+
+MyDB_StringDictionary :: MyDB_StringDictionary () {
+	slots.resize (16, -1);
+	full = false;
+	encode (MyDB_StringView ("", 0));
+}
+
+int MyDB_StringDictionary :: find (MyDB_StringView findMe) {
+
+	// linear probing; the table is never more than half full, so there is always an empty slot
+	size_t hash = findMe.hash ();
+	size_t mask = slots.size () - 1;
+	for (size_t pos = hash & mask; slots[pos] != -1; pos = (pos + 1) & mask) {
+		if (hashes[slots[pos]] == hash && decodeView (slots[pos]) == findMe)
+			return slots[pos];
+	}
+	return -1;
+}
+
+int MyDB_StringDictionary :: encode (MyDB_StringView encodeMe) {
+
+	lock_guard <mutex> guard (encodeLock);
+	int code = find (encodeMe);
+	if (code != -1)
+		return code;
+
+	code = values.size ();
+	if (code >= MAX_CODES) {
+		if (!full)
+			cout << "Too many distinct values for a dictionary-encoded string; there can be at most " << MAX_CODES << ".\n";
+		full = true;
+		return 0;
+	}
+	values.push_back (encodeMe.toString ());
+	hashes.push_back (encodeMe.hash ());
+
+	// if the table is getting full, double it and put all of the codes back in
+	if (values.size () * 2 > slots.size ()) {
+		slots.assign (slots.size () * 2, -1);
+		for (int i = 0; i < (int) values.size (); i++)
+			addToSlots (i);
+	} else {
+		addToSlots (code);
+	}
+	return code;
+}
+
+void MyDB_StringDictionary :: addToSlots (int code) {
+	size_t mask = slots.size () - 1;
+	size_t pos = hashes[code] & mask;
+	while (slots[pos] != -1)
+		pos = (pos + 1) & mask;
+	slots[pos] = code;
+}
+
+int MyDB_StringDictionary :: size () {
+	return values.size ();
+}
+
+bool MyDB_StringDictionary :: isFull () {
+	return full;
+}
+
+#endif
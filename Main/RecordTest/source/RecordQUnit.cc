@@ -11,9 +11,15 @@
 #include "MyDB_Table.h"
 #include "MyDB_TableReaderWriter.h"
 #include "MyDB_Schema.h"
+#include "MyDB_ConjunctFilter.h"
+#include "MyDB_FilterKernels.h"
+#include "MyDB_Hash.h"
 #include "QUnit.h"
+#include <algorithm>
 #include <cstring>
+#include <fstream>
 #include <iostream>
+#include <math.h>
 #include <time.h>
 #include <unistd.h>
 #include <vector>
@@ -463,6 +469,983 @@ int main(int argc, char *argv[]) {
 		QUNIT_IS_FALSE(result);
 	}
 	FALLTHROUGH_INTENDED;
+	case 10:
+	{
+		// the filter kernels and the conjunct filter agree with the compiled predicates
+		cout << "TEST 10 (" << getFilterKernelLevel () << " kernels)..." << flush;
+		initialize();
+		bool result = true;
+		{
+			cout << "check kernels..." << flush;
+			int ints[1000];
+			double doubles[1000];
+			char prefixes[1000 * STRING_PREFIX_LEN];
+			uint64_t bits[16];
+			srand (12);
+			for (int i = 0; i < 1000; i++) {
+				ints[i] = rand () % 50;
+				doubles[i] = ints[i] / 2.0;
+				strncpy (prefixes + i * STRING_PREFIX_LEN, to_string (ints[i]).c_str (), STRING_PREFIX_LEN);
+			}
+			char constant[STRING_PREFIX_LEN] = "25";
+			MyDB_ExprOp cmps[] = {gtOp, ltOp, eqOp, neqOp};
+			for (MyDB_ExprOp cmp : cmps) {
+				for (int n : {1000, 960, 3}) {
+					compareInts (ints, n, cmp, 25, bits);
+					for (int i = 0; i < n; i++) {
+						bool expected = (cmp == gtOp) ? ints[i] > 25 : (cmp == ltOp) ? ints[i] < 25 :
+							(cmp == eqOp) ? ints[i] == 25 : ints[i] != 25;
+						result = result && (((bits[i / 64] >> (i % 64)) & 1) == expected);
+					}
+					compareDoubles (doubles, n, cmp, 12.5, bits);
+					for (int i = 0; i < n; i++) {
+						bool expected = (cmp == gtOp) ? doubles[i] > 12.5 : (cmp == ltOp) ? doubles[i] < 12.5 :
+							(cmp == eqOp) ? doubles[i] == 12.5 : doubles[i] != 12.5;
+						result = result && (((bits[i / 64] >> (i % 64)) & 1) == expected);
+					}
+					compareStringPrefixes (prefixes, n, cmp, constant, bits);
+					for (int i = 0; i < n; i++) {
+						int order = strcmp (prefixes + i * STRING_PREFIX_LEN, constant);
+						bool expected = (cmp == gtOp) ? order > 0 : (cmp == ltOp) ? order < 0 :
+							(cmp == eqOp) ? order == 0 : order != 0;
+						result = result && (((bits[i / 64] >> (i % 64)) & 1) == expected);
+					}
+				}
+			}
+
+			cout << "check conjunct filter..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_TableReaderWriter supplierTable(allTables["supplier"], myMgr);
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord();
+
+			// the last string is too long for the string kernels, so there are two simple conjuncts
+			string pred = "&& (&& (&& (> ([acctbal], int[1000]), || (== ([nationkey], int[3]), < ([suppkey], int[10]))), "
+				"> (string[30], [phone])), < (string[Supplier#000009000], [name]))";
+			MyDB_ConjunctFilter prefilter (allTables["supplier"]->getSchema (), pred);
+			func f = temp->compileComputation (pred);
+			result = result && (prefilter.getNumConjuncts () == 2);
+
+			int numFiltered = 0, numAccepted = 0, numExpected = 0;
+			void *batch[MAX_BATCH_SIZE];
+			int selected[MAX_BATCH_SIZE];
+			MyDB_RecordIteratorAltPtr myIter = supplierTable.getIteratorAlt ();
+			int numRecs;
+			while ((numRecs = myIter->getBatch (batch, MAX_BATCH_SIZE)) > 0) {
+				int numSelected = prefilter.run (batch, numRecs, selected);
+				numFiltered += numSelected;
+				for (int i = 0; i < numSelected; i++) {
+					temp->fromBinary (batch[selected[i]]);
+					numAccepted += f ()->toBool ();
+				}
+				for (int i = 0; i < numRecs; i++) {
+					temp->fromBinary (batch[i]);
+					numExpected += f ()->toBool ();
+				}
+			}
+			cout << numFiltered << " after filter, " << numAccepted << " accepted..." << flush;
+			result = result && (numAccepted == numExpected) && (numFiltered < 10000);
+
+			cout << "shutdown manager..." << flush;
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 11:
+	{
+		// computations compiled together (with shared and constant parts) give the right answers
+		cout << "TEST 11..." << flush;
+		initialize();
+		bool result = true;
+		{
+			cout << "create manager..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_TableReaderWriter supplierTable(allTables["supplier"], myMgr);
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord();
+
+			cout << "compile..." << flush;
+			string shared = "* ([acctbal], - (int[1], / (double[1.0], int[4])))";
+			vector <func> comps = temp->compileComputations ({shared, "+ (" + shared + ", [nationkey])",
+				"> (" + shared + ", double[2000.5])", "+ (string[k], + (int[2], int[3]))"});
+
+			cout << "run..." << flush;
+			int counter = 0;
+			MyDB_RecordIteratorAltPtr myIter = supplierTable.getIteratorAlt ();
+			while (myIter->advance ()) {
+				myIter->getCurrent (temp);
+				double expected = temp->getAtt (5)->toDouble () * 0.75;
+				result = result && (comps[0] ()->toDouble () == expected);
+				result = result && (comps[1] ()->toDouble () == expected + temp->getAtt (3)->toInt ());
+				result = result && (comps[2] ()->toBool () == (expected > 2000.5));
+				result = result && (comps[3] ()->toString () == "k5");
+				counter++;
+			}
+			result = result && (counter == 10000);
+
+			cout << "shutdown manager..." << flush;
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 12:
+	{
+		// dates are stored as a number of days, but they read, print and compare as YYYY-MM-DD
+		cout << "TEST 12..." << flush;
+		bool result = true;
+		{
+			cout << "compile..." << flush;
+			MyDB_SchemaPtr dateSchema = make_shared <MyDB_Schema> ();
+			dateSchema->appendAtt (make_pair ("d", make_shared <MyDB_DateAttType> ()));
+			MyDB_RecordPtr temp = make_shared <MyDB_Record> (dateSchema);
+			vector <func> comps = temp->compileComputations ({"< ([d], string[1995-03-15])",
+				"== (string[1970-01-02], [d])", "+ ([d], string[!])"});
+
+			cout << "run..." << flush;
+			int days;
+			result = result && MyDB_DateAttVal :: parseDate ("1970-01-02", days) && days == 1;
+			result = result && !MyDB_DateAttVal :: parseDate ("1995-02-29", days);
+			vector <string> dates = {"1970-01-02", "1995-03-14", "1995-03-15", "2000-02-29", "1969-12-31"};
+			for (string d : dates) {
+				temp->getAtt (0)->fromString (d);
+				temp->recordContentHasChanged ();
+				result = result && (temp->getAtt (0)->toString () == d);
+				result = result && (comps[0] ()->toBool () == (d < "1995-03-15"));
+				result = result && (comps[1] ()->toBool () == (d == "1970-01-02"));
+				result = result && (comps[2] ()->toString () == d + "!");
+			}
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 13:
+	{
+		// dictionary-encoded strings are stored as codes; == and != against a literal compare codes
+		cout << "TEST 13..." << flush;
+		bool result = true;
+		{
+			cout << "compile..." << flush;
+			MyDB_SchemaPtr dictSchema = make_shared <MyDB_Schema> ();
+			dictSchema->appendAtt (make_pair ("s", make_shared <MyDB_DictStringAttType> ()));
+			MyDB_RecordPtr temp = make_shared <MyDB_Record> (dictSchema);
+			vector <func> comps = temp->compileComputations ({"== ([s], string[AIR])",
+				"!= ([s], string[TRUCK])", "== ([s], string[RAIL])", "+ ([s], string[!])"});
+
+			cout << "run..." << flush;
+			vector <string> modes = {"AIR", "TRUCK", "MAIL|SHIP", "AIR", ""};
+			for (string m : modes) {
+				temp->getAtt (0)->fromString (m);
+				temp->recordContentHasChanged ();
+				result = result && (temp->getAtt (0)->toString () == m);
+				result = result && (temp->getAtt (0)->hash () == MyDB_StringView (m.c_str (), m.size ()).hash ());
+				result = result && (comps[0] ()->toBool () == (m == "AIR"));
+				result = result && (comps[1] ()->toBool () == (m != "TRUCK"));
+				result = result && !comps[2] ()->toBool ();
+				result = result && (comps[3] ()->toString () == m + "!");
+			}
+
+			// the dictionary goes through the catalog with the table
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> ("dictCatFile");
+			MyDB_TablePtr dictTable = make_shared <MyDB_Table> ("dictTable", "dictTable.bin", dictSchema);
+			dictTable->putInCatalog (myCatalog);
+			MyDB_TablePtr again = make_shared <MyDB_Table> ();
+			result = result && again->fromCatalog ("dictTable", myCatalog);
+			MyDB_DictStringAttTypePtr dictType = static_pointer_cast <MyDB_DictStringAttType> (again->getSchema ()->getAtts ()[0].second);
+			for (string m : modes)
+				result = result && (dictType->getDictionary ()->find (MyDB_StringView (m.c_str (), m.size ())) ==
+					static_pointer_cast <MyDB_DictStringAttType> (dictSchema->getAtts ()[0].second)->getDictionary ()->find (MyDB_StringView (m.c_str (), m.size ())));
+
+			// a file with more distinct values than the dictionary can hold is not loaded, and
+			// the table is left empty
+			cout << "overfill..." << flush;
+			{
+				ofstream out ("dictTable.tbl");
+				for (int i = 0; i < MyDB_StringDictionary :: MAX_CODES + 100; i++)
+					out << "v" << i << "|\n";
+			}
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (1024, 16, "tempFile");
+			MyDB_TableReaderWriter dictRW (dictTable, myMgr);
+			pair <vector <size_t>, size_t> res = dictRW.loadFromTextFile ("dictTable.tbl");
+			result = result && (res.second == 0) && static_pointer_cast <MyDB_DictStringAttType> (dictSchema->getAtts ()[0].second)->getDictionary ()->isFull ();
+			result = result && !dictRW.getIteratorAlt ()->advance ();
+			unlink ("dictTable.tbl");
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 14:
+	{
+		// hashes use all of the bits of a value, and multi-column keys are combined in order
+		cout << "TEST 14..." << flush;
+		bool result = true;
+		{
+			MyDB_SchemaPtr hashSchema = make_shared <MyDB_Schema> ();
+			hashSchema->appendAtt (make_pair ("i", make_shared <MyDB_IntAttType> ()));
+			hashSchema->appendAtt (make_pair ("d", make_shared <MyDB_DoubleAttType> ()));
+			hashSchema->appendAtt (make_pair ("e", make_shared <MyDB_DoubleAttType> ()));
+			MyDB_RecordPtr temp = make_shared <MyDB_Record> (hashSchema);
+			vector <func> ab = temp->compileComputations ({"[d]", "[e]"});
+			vector <func> ba = temp->compileComputations ({"[e]", "[d]"});
+
+			temp->fromString ("3|3.0|0.04|");
+			result = result && (temp->getAtt (0)->hash () == temp->getAtt (1)->hash ());
+			size_t hashAB = MyDB_Record :: hashKeys (ab);
+			result = result && (hashAB != MyDB_Record :: hashKeys (ba));
+			temp->fromString ("3|0.05|0.04|");
+			result = result && (temp->getAtt (1)->hash () != temp->getAtt (2)->hash ());
+			result = result && (hashAB != MyDB_Record :: hashKeys (ab));
+			temp->fromString ("3|0.04|0.04|");
+			result = result && (MyDB_Record :: hashKeys (ab) != 0);
+			result = result && (MyDB_StringView ("abcdefghij", 10).hash () != MyDB_StringView ("abcdefghik", 10).hash ());
+
+			unordered_map <size_t, vector <int>> chains;
+			for (int i = 0; i < 10; i++)
+				chains[i % 4].push_back (i);
+			vector <size_t> histogram = getChainHistogram (chains);
+			result = result && (chainHistogramToString (histogram) == "1:0 2-3:4");
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 15:
+	{
+		// statistics are collected when a table is loaded (or analyzed), and they go through the catalog
+		cout << "TEST 15..." << flush;
+		bool result = true;
+		{
+			MyDB_HyperLogLog sketch;
+			for (int i = 0; i < 100000; i++)
+				sketch.add (hashInt (i));
+			result = result && (sketch.estimate () > 90000 && sketch.estimate () < 110000);
+
+			cout << "load..." << flush;
+			ofstream out ("statsTest.tbl");
+			for (int i = 0; i < 20000; i++)
+				out << i % 1000 << "|" << ((i % 2 == 0) ? 7 : i % 100) << "|n" << i % 50 << "|\n";
+			out.close ();
+			MyDB_SchemaPtr statsSchema = make_shared <MyDB_Schema> ();
+			statsSchema->appendAtt (make_pair ("u", make_shared <MyDB_IntAttType> ()));
+			statsSchema->appendAtt (make_pair ("k", make_shared <MyDB_IntAttType> ()));
+			statsSchema->appendAtt (make_pair ("s", make_shared <MyDB_StringAttType> ()));
+			MyDB_TablePtr statsTable = make_shared <MyDB_Table> ("statsTable", "statsTable.bin", statsSchema);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (1024, 16, "tempFile");
+			MyDB_TableReaderWriter statsTableRW (statsTable, myMgr);
+			statsTableRW.loadFromTextFile ("statsTest.tbl");
+			statsTable->setTupleCount (20000);
+
+			cout << "check..." << flush;
+			auto near = [] (double val, double target, double slack) {
+				return val > target - slack && val < target + slack;
+			};
+			result = result && near (statsTable->getAttStats ("u")->getDistinctValues (), 1000, 100);
+			result = result && near (statsTable->getAttStats ("s")->getDistinctValues (), 50, 5);
+			result = result && statsTable->getAttStats ("s")->getLow () == "n0";
+			result = result && near (statsTable->estimateSelectivity ("== ([k], int[7])"), 0.505, 0.03);
+			result = result && near (statsTable->estimateSelectivity ("< ([u], int[250])"), 0.25, 0.03);
+			result = result && near (statsTable->estimateSelectivity ("&& (> ([u], int[499]), == ([s], string[n3]))"), 0.01, 0.005);
+			result = result && statsTable->estimateSelectivity ("> ([u], int[5000])") == 0.0;
+
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> ("dictCatFile");
+			statsTable->putInCatalog (myCatalog);
+			MyDB_TablePtr again = make_shared <MyDB_Table> ();
+			result = result && again->fromCatalog ("statsTable", myCatalog);
+			result = result && (again->estimateSelectivity ("< ([u], int[250])") == statsTable->estimateSelectivity ("< ([u], int[250])"));
+			result = result && (again->getAttStats ("k")->getDistinctValues () == statsTable->getAttStats ("k")->getDistinctValues ());
+
+			cout << "analyze..." << flush;
+			statsTableRW.analyze ();
+			result = result && statsTable->getTupleCount () == 20000;
+			result = result && near (statsTable->estimateSelectivity ("== ([k], int[7])"), 0.505, 0.03);
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 16:
+	{
+		// the conjuncts of an and are re-ordered so that the one that throws out the most records runs first
+		cout << "TEST 16..." << flush;
+		bool result = true;
+		{
+			MyDB_SchemaPtr andSchema = make_shared <MyDB_Schema> ();
+			andSchema->appendAtt (make_pair ("i", make_shared <MyDB_IntAttType> ()));
+			andSchema->appendAtt (make_pair ("s", make_shared <MyDB_StringAttType> ()));
+			MyDB_RecordPtr temp = make_shared <MyDB_Record> (andSchema);
+			func pred = temp->compileComputation ("&& (== ([s], string[always the same]), < ([i], int[10]))");
+
+			int numAccepted = 0;
+			for (int i = 0; i < 10000; i++) {
+				temp->fromString (to_string (i % 1000) + "|always the same|");
+				bool accepted = pred ()->toBool ();
+				result = result && (accepted == (i % 1000 < 10));
+				numAccepted += accepted;
+			}
+			result = result && (numAccepted == 100);
+			result = result && (temp->getConjunctOrders ().size () == 1);
+			MyDB_ConjunctOrderPtr order = temp->getConjunctOrders ()[0];
+			result = result && (order->getNumReorders () > 0) && (order->getOrder ()[0] == 1);
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 17:
+	{
+		// a char (n) always takes up the same space, and == against a literal compares the page bytes
+		cout << "TEST 17..." << flush;
+		bool result = true;
+		{
+			MyDB_SchemaPtr charSchema = make_shared <MyDB_Schema> ();
+			charSchema->appendAtt (make_pair ("i", make_shared <MyDB_IntAttType> ()));
+			charSchema->appendAtt (make_pair ("c", make_shared <MyDB_CharAttType> (4)));
+			charSchema->appendAtt (make_pair ("d", make_shared <MyDB_DoubleAttType> ()));
+			result = result && (charSchema->getFixedOffset (2) == 15);
+			MyDB_RecordPtr temp = make_shared <MyDB_Record> (charSchema);
+			MyDB_RecordPtr other = make_shared <MyDB_Record> (charSchema);
+			func isAir = other->compileComputation ("== ([c], string[AIR])");
+			func notAir = other->compileComputation ("!= (string[AIR], [c])");
+			func tooLong = other->compileComputation ("== ([c], string[AIRSHIP])");
+			func concat = other->compileComputation ("+ ([c], string[!])");
+
+			char page[64];
+			vector <string> modes = {"AIR", "A", "", "RAIL", "AIR"};
+			for (string m : modes) {
+				temp->fromString ("7|" + m + "|2.5|");
+				temp->recordContentHasChanged ();
+				result = result && (temp->getBinarySize () == 25);
+				temp->toBinary (page);
+				other->fromBinary (page);
+				result = result && (other->getAtt (1)->toString () == m);
+				result = result && (other->getAtt (1)->hash () == MyDB_StringView (m.c_str (), m.size ()).hash ());
+				result = result && (isAir ()->toBool () == (m == "AIR"));
+				result = result && (notAir ()->toBool () == (m != "AIR"));
+				result = result && !tooLong ()->toBool ();
+				result = result && (concat ()->toString () == m + "!");
+			}
+
+			// the width goes through the catalog with the table
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> ("dictCatFile");
+			MyDB_TablePtr charTable = make_shared <MyDB_Table> ("charTable", "charTable.bin", charSchema);
+			charTable->putInCatalog (myCatalog);
+			MyDB_TablePtr again = make_shared <MyDB_Table> ();
+			result = result && again->fromCatalog ("charTable", myCatalog);
+			result = result && (again->getSchema ()->getAtts ()[1].second->toString () == "char(4)");
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 18:
+	{
+		// a decimal (p, s) is a scaled integer, so sums are exact; it rounds, prints and compares as a number
+		cout << "TEST 18..." << flush;
+		bool result = true;
+		{
+			MyDB_SchemaPtr decSchema = make_shared <MyDB_Schema> ();
+			decSchema->appendAtt (make_pair ("i", make_shared <MyDB_IntAttType> ()));
+			decSchema->appendAtt (make_pair ("m", make_shared <MyDB_DecimalAttType> (12, 2)));
+			decSchema->appendAtt (make_pair ("n", make_shared <MyDB_DecimalAttType> (12, 2)));
+			decSchema->appendAtt (make_pair ("d", make_shared <MyDB_DoubleAttType> ()));
+			result = result && (decSchema->getFixedOffset (3) == 28);
+			MyDB_RecordPtr temp = make_shared <MyDB_Record> (decSchema);
+			vector <func> comps = temp->compileComputations ({"+ ([m], [n])", "* ([m], [i])", "* ([m], [n])",
+				"> ([m], int[12])", "== ([m], double[12.35])", "< ([m], [d])", "um ([m])"});
+
+			// the parsed values are rounded to the scale
+			vector <pair <string, string>> parsed = {{"0012.345", "12.35"}, {"-0.005", "-0.01"},
+				{"3", "3.00"}, {" 2.5 ", "2.50"}};
+			for (auto &p : parsed) {
+				temp->fromString ("3|" + p.first + "|0.10|12.5|");
+				temp->recordContentHasChanged ();
+				string m = temp->getAtt (1)->toString ();
+				double asDouble = temp->getAtt (1)->toDouble ();
+				result = result && (m == p.second);
+				result = result && (comps[0] ()->toString () == MyDB_DecimalAttVal :: format (llround (asDouble * 100) + 10, 2));
+				result = result && (comps[1] ()->toString () == MyDB_DecimalAttVal :: format (llround (asDouble * 100) * 3, 2));
+				result = result && (comps[2] ()->toString () == MyDB_DecimalAttVal :: format (llround (asDouble * 100) * 10, 4));
+				result = result && (comps[3] ()->toBool () == (asDouble > 12));
+				result = result && (comps[4] ()->toBool () == (m == "12.35"));
+				result = result && (comps[5] ()->toBool () == (asDouble < 12.5));
+				result = result && (comps[6] ()->toDouble () == -asDouble);
+			}
+
+			// adding 0.10 ten times gives exactly 1.00, which hashes just like the int 1
+			MyDB_AttValPtr sum = temp->getAtt (1);
+			string zero = "0", point5 = "0.5";
+			sum->fromString (zero);
+			for (int i = 0; i < 10; i++) {
+				temp->recordContentHasChanged ();
+				sum->set (comps[0] ());
+			}
+			MyDB_IntAttValPtr one = make_shared <MyDB_IntAttVal> ();
+			one->set (1);
+			MyDB_DoubleAttValPtr half = make_shared <MyDB_DoubleAttVal> ();
+			half->set (0.5);
+			result = result && (sum->toString () == "1.00") && (sum->hash () == one->hash ());
+			sum->fromString (point5);
+			result = result && (sum->hash () == half->hash ());
+
+			// the precision and scale go through the catalog with the table
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> ("dictCatFile");
+			MyDB_TablePtr decTable = make_shared <MyDB_Table> ("decTable", "decTable.bin", decSchema);
+			decTable->putInCatalog (myCatalog);
+			MyDB_TablePtr again = make_shared <MyDB_Table> ();
+			result = result && again->fromCatalog ("decTable", myCatalog);
+			result = result && (again->getSchema ()->getAtts ()[1].second->toString () == "decimal(12,2)");
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 19:
+	{
+		// a record can be found by its slot, and sorting a page only re-orders the slot array
+		cout << "TEST 19..." << flush;
+		initialize();
+		bool result = true;
+		{
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_TableReaderWriter supplierTable(allTables["supplier"], myMgr);
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord();
+			MyDB_RecordPtr other = supplierTable.getEmptyRecord();
+
+			// the slots are in the same order as the iterator
+			MyDB_PageReaderWriter page = supplierTable[12].getPinned();
+			MyDB_RecordIteratorAltPtr myIter = page.getIteratorAlt();
+			int numRecs = 0;
+			while (myIter->advance()) {
+				result = result && (myIter->getCurrentPointer() == page.getRecord(numRecs));
+				numRecs++;
+			}
+			result = result && (numRecs > 0) && (numRecs == page.getNumRecords());
+
+			// sort on suppkey, biggest first; the records stay where they are
+			pair <void *, void *> before = MyDB_PageReaderWriter::getRecordBytes(page.getBytes());
+			page.sortInPlace(buildRecordComparator(other, temp, "[suppkey]"), temp, other);
+			pair <void *, void *> after = MyDB_PageReaderWriter::getRecordBytes(page.getBytes());
+			result = result && (before == after) && (numRecs == page.getNumRecords());
+
+			int last = INT_MAX, numBig = 0;
+			myIter = page.getIteratorAlt();
+			while (myIter->advance()) {
+				myIter->getCurrent(temp);
+				result = result && (temp->getAtt(0)->toInt() <= last);
+				last = temp->getAtt(0)->toInt();
+				numBig += (last > 5000);
+			}
+
+			// and then a binary search finds the first suppkey that is at most 5000
+			func isSmall = temp->compileComputation("> (int[5001], [suppkey])");
+			result = result && (page.findFirst([&] () {return isSmall()->toBool();}, temp) == numBig);
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 20:
+	{
+		// a PAX table holds the same records as a heap table, and its values can be read by column
+		cout << "TEST 20..." << flush;
+		initialize();
+		bool result = true;
+		{
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_TableReaderWriter supplierTable(allTables["supplier"], myMgr);
+			MyDB_TablePtr paxTable = make_shared <MyDB_Table>("supplierPAX", "supplierPAX.bin",
+				allTables["supplier"]->getSchema(), "pax", "");
+			MyDB_TableReaderWriter paxRW(paxTable, myMgr);
+			paxRW.loadFromTextFile("supplier.tbl");
+			for (int i = 0; i < paxRW.getNumPages(); i++)
+				result = result && (paxRW[i].getType() == MyDB_PageType::PAXPage);
+
+			// the records come back in the same order as from the heap table
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord();
+			MyDB_RecordPtr other = paxRW.getEmptyRecord();
+			MyDB_RecordIteratorAltPtr heapIter = supplierTable.getIteratorAlt();
+			MyDB_RecordIteratorAltPtr paxIter = paxRW.getIteratorAlt();
+			vector <int> keys, nations;
+			vector <string> phones;
+			int numRecs = 0;
+			while (heapIter->advance()) {
+				result = result && paxIter->advance();
+				heapIter->getCurrent(temp);
+				paxIter->getCurrent(other);
+				for (int i = 0; i < 7; i++)
+					result = result && (temp->getAtt(i)->toString() == other->getAtt(i)->toString());
+				keys.push_back(temp->getAtt(0)->toInt());
+				phones.push_back(temp->getAtt(4)->toString());
+				nations.push_back(temp->getAtt(3)->toInt());
+				numRecs++;
+			}
+			result = result && (numRecs == 10000) && !paxIter->advance();
+
+			// and the columns are read right off of the minipages
+			vector <int> whichAtts = {0, 3, 4};
+			vector <vector <void *>> store(3, vector <void *>(MAX_BATCH_SIZE));
+			vector <void **> values = {store[0].data(), store[1].data(), store[2].data()};
+			paxIter = paxRW.getIteratorAlt();
+			int pos = 0, numInBatch;
+			while ((numInBatch = paxIter->getColumnBatch(whichAtts, values, MAX_BATCH_SIZE)) > 0) {
+				for (int i = 0; i < numInBatch && pos < numRecs; i++, pos++) {
+					result = result && (*((int *) values[0][i]) == keys[pos]);
+					result = result && (*((int *) values[1][i]) == nations[pos]);
+					result = result && (string((char *) values[2][i]) == phones[pos]);
+				}
+			}
+			result = result && (pos == numRecs);
+
+			// appended records go on a regular page, which becomes a PAXPage once it is full
+			int numPages = paxRW.getNumPages();
+			paxIter = supplierTable.getIteratorAlt();
+			while (paxRW.getNumPages() < numPages + 2 && paxIter->advance()) {
+				paxIter->getCurrent(temp);
+				paxRW.append(temp);
+			}
+			result = result && (paxRW[numPages].getType() == MyDB_PageType::PAXPage);
+			result = result && (paxRW[numPages + 1].getType() == MyDB_PageType::RegularPage);
+
+			// the file type goes through the catalog
+			paxTable->putInCatalog(myCatalog);
+			MyDB_TablePtr again = make_shared <MyDB_Table>();
+			result = result && again->fromCatalog("supplierPAX", myCatalog);
+			result = result && (again->getFileType() == "pax");
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 21:
+	{
+		// a scan with a predicate skips the pages whose zones show that they cannot have a match
+		cout << "TEST 21..." << flush;
+		initialize();
+		bool result = true;
+		{
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_TableReaderWriter supplierTable(allTables["supplier"], myMgr);
+			supplierTable.loadFromTextFile("supplier.tbl");
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord();
+			string pred = "&& (> ([suppkey], int[9900]), < ([acctbal], double[5000.0]))";
+			func isIt = temp->compileComputation(pred);
+
+			// every record that is accepted is on one of the pages that is read
+			function <bool (int)> readPage = supplierTable.getPageFilter(pred);
+			int numRead = 0;
+			for (int i = 0; i < supplierTable.getNumPages(); i++)
+				numRead += readPage(i);
+			int numAccepted = 0, numFound = 0;
+			MyDB_RecordIteratorAltPtr myIter = supplierTable.getIteratorAlt();
+			while (myIter->advance()) {
+				myIter->getCurrent(temp);
+				numAccepted += isIt()->toBool();
+			}
+			myIter = supplierTable.getIteratorAlt(readPage);
+			while (myIter->advance()) {
+				myIter->getCurrent(temp);
+				numFound += isIt()->toBool();
+			}
+			result = result && (numAccepted > 0) && (numFound == numAccepted);
+			result = result && (numRead > 0) && (numRead * 10 < supplierTable.getNumPages());
+
+			// an appended record widens the zone of the last page
+			string big = "20000|name|address|1|phone|1.0|comment|";
+			temp->fromString(big);
+			supplierTable.append(temp);
+			result = result && readPage(supplierTable.getNumPages() - 1);
+			result = result && !supplierTable.getPageFilter("== ([suppkey], int[-1])")(supplierTable.getNumPages() - 1);
+
+			// a string's range is over its first eight bytes, so every name on the first page
+			// looks like "Supplier", and only the appended one sorts after "n"
+			result = result && !supplierTable.getPageFilter("> ([name], string[n])")(0);
+			result = result && supplierTable.getPageFilter("> ([name], string[n])")(supplierTable.getNumPages() - 1);
+			result = result && supplierTable.getPageFilter("> ([name], string[Supplier#009999])")(0);
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 22:
+	{
+		// a Bloom filter lets an equality on an attribute that is not clustered skip pages, and
+		// the filters are read back when the table is opened again
+		cout << "TEST 22..." << flush;
+		initialize();
+		bool result = true;
+		{
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			vector <string> bloomAtts = {"name"};
+			allTables["supplier"]->setBloomAtts(bloomAtts);
+			string pred = "== ([name], string[Supplier#000000123])";
+			int numPages = 0;
+			for (int round = 0; round < 2; round++) {
+				MyDB_TableReaderWriter supplierTable(allTables["supplier"], myMgr);
+				if (round == 0)
+					supplierTable.loadFromTextFile("supplier.tbl");
+				numPages = supplierTable.getNumPages();
+				MyDB_RecordPtr temp = supplierTable.getEmptyRecord();
+				func isIt = temp->compileComputation(pred);
+				function <bool (int)> readPage = supplierTable.getPageFilter(pred);
+				int numRead = 0, numFound = 0;
+				for (int i = 0; i < numPages; i++)
+					numRead += readPage(i);
+				MyDB_RecordIteratorAltPtr myIter = supplierTable.getIteratorAlt(readPage);
+				while (myIter->advance()) {
+					myIter->getCurrent(temp);
+					numFound += isIt()->toBool();
+				}
+				result = result && (numFound == 1) && (numRead * 10 < numPages);
+				result = result && (supplierTable.getSkipCounts().find("bloom name") != string::npos);
+			}
+			allTables["supplier"]->putInCatalog(myCatalog);
+			MyDB_TablePtr again = make_shared <MyDB_Table>();
+			result = result && again->fromCatalog("supplier", myCatalog);
+			result = result && (again->getBloomAtts() == bloomAtts);
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 23:
+	{
+		// a string that is stored out of line makes the pages denser, but reads back the same,
+		// both before and after the table goes through the catalog
+		cout << "TEST 23..." << flush;
+		initialize();
+		bool result = true;
+		{
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_TableReaderWriter supplierTable(allTables["supplier"], myMgr);
+			MyDB_SchemaPtr overflowSchema = make_shared <MyDB_Schema>();
+			for (auto &a : allTables["supplier"]->getSchema()->getAtts())
+				overflowSchema->appendAtt(a.first == "comment" ?
+					make_pair(a.first, (MyDB_AttTypePtr) make_shared <MyDB_OverflowAttType>("supplierOut.comment.overflow")) : a);
+			MyDB_TablePtr outTable = make_shared <MyDB_Table>("supplierOut", "supplierOut.bin", overflowSchema);
+			{
+				MyDB_TableReaderWriter outRW(outTable, myMgr);
+				outRW.loadFromTextFile("supplier.tbl");
+				result = result && (outRW.getNumPages() * 3 < supplierTable.getNumPages() * 2);
+			}
+			outTable->putInCatalog(myCatalog);
+			MyDB_TablePtr again = make_shared <MyDB_Table>();
+			result = result && again->fromCatalog("supplierOut", myCatalog);
+			result = result && (again->getSchema()->getAtts()[6].second->toString() == "overflowstring");
+
+			MyDB_TableReaderWriter againRW(again, myMgr);
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord();
+			MyDB_RecordPtr other = againRW.getEmptyRecord();
+			func isIt = other->compileComputation("== ([comment], string[furiously regular instructions impress slyly! carefu])");
+			MyDB_RecordIteratorAltPtr heapIter = supplierTable.getIteratorAlt();
+			MyDB_RecordIteratorAltPtr outIter = againRW.getIteratorAlt();
+			int numRecs = 0, numFound = 0;
+			while (heapIter->advance()) {
+				result = result && outIter->advance();
+				heapIter->getCurrent(temp);
+				outIter->getCurrent(other);
+				for (int i = 0; i < 7; i++)
+					result = result && (temp->getAtt(i)->toString() == other->getAtt(i)->toString());
+				numFound += isIt()->toBool();
+				numRecs++;
+			}
+			result = result && (numRecs == 10000) && !outIter->advance() && (numFound == 1);
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 24:
+	{
+		// a conjunct with an integer division is never moved ahead of the conjuncts before it, even
+		// if it throws out the most records, since those may be what keep it from dividing by zero
+		cout << "TEST 24..." << flush;
+		bool result = true;
+		{
+			MyDB_SchemaPtr divSchema = make_shared <MyDB_Schema> ();
+			divSchema->appendAtt (make_pair ("a", make_shared <MyDB_IntAttType> ()));
+			divSchema->appendAtt (make_pair ("b", make_shared <MyDB_IntAttType> ()));
+			MyDB_RecordPtr temp = make_shared <MyDB_Record> (divSchema);
+			func pred = temp->compileComputation (
+				"&& (&& (!= ([b], int[0]), > (/ ([a], [b]), int[500])), < ([a], int[600]))");
+
+			int numAccepted = 0;
+			for (int i = 0; i < 10000; i++) {
+				temp->fromString (to_string (i % 1000) + "|" + to_string (i % 10) + "|");
+				numAccepted += pred ()->toBool ();
+			}
+			result = result && (numAccepted == 100);
+			result = result && (temp->getConjunctOrders ().size () == 1);
+			MyDB_ConjunctOrderPtr order = temp->getConjunctOrders ()[0];
+			vector <int> &runOrder = order->getOrder ();
+			result = result && (order->getNumReorders () > 0);
+			result = result && (find (runOrder.begin (), runOrder.end (), 0) < find (runOrder.begin (), runOrder.end (), 1));
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 25:
+	{
+		// getBatch () never goes past maxRecs or past the end of a page, and the records come back
+		// in order, whether they are read one at a time, a page at a time, or from a page list that
+		// is bigger than the buffer
+		cout << "TEST 25..." << flush;
+		bool result = true;
+		{
+			MyDB_SchemaPtr batchSchema = make_shared <MyDB_Schema> ();
+			batchSchema->appendAtt (make_pair ("a", make_shared <MyDB_IntAttType> ()));
+			batchSchema->appendAtt (make_pair ("s", make_shared <MyDB_StringAttType> ()));
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (1024, 4, "tempFile");
+			MyDB_TablePtr batchTable = make_shared <MyDB_Table> ("batchTable", "batchTable.bin", batchSchema);
+			MyDB_TableReaderWriter batchRW (batchTable, myMgr);
+			MyDB_RecordPtr temp = batchRW.getEmptyRecord ();
+
+			// the records that are read must be first, first + 1, ..., first + count - 1
+			auto readAll = [&] (MyDB_RecordIteratorAltPtr iter, int maxRecs, int first, int count) {
+				void *recs[MAX_BATCH_SIZE];
+				int numRead = 0;
+				bool ok = true;
+				for (int numRecs; (numRecs = iter->getBatch (recs, maxRecs)) > 0; ) {
+					ok = ok && (numRecs <= maxRecs);
+					for (int i = 0; i < numRecs; i++, numRead++) {
+						temp->fromBinary (recs[i]);
+						int a = first + numRead;
+						ok = ok && (temp->getAtt (0)->toInt () == a) && (temp->getAtt (1)->toString () == string (a % 50, 'x'));
+					}
+				}
+				return ok && (numRead == count);
+			};
+
+			cout << "empty..." << flush;
+			result = result && readAll (batchRW.getIteratorAlt (), MAX_BATCH_SIZE, 0, 0);
+
+			cout << "append..." << flush;
+			for (int i = 0; i < 3000; i++) {
+				temp->fromString (to_string (i) + "|" + string (i % 50, 'x') + "|");
+				batchRW.append (temp);
+			}
+			int numPages = batchRW.getNumPages ();
+			int onFirstPage = batchRW[0].getNumRecords ();
+			int onSecondPage = batchRW[1].getNumRecords ();
+			result = result && (numPages > 4);
+
+			cout << "table..." << flush;
+			for (int maxRecs : {1, 7, onFirstPage, onFirstPage + 1, MAX_BATCH_SIZE})
+				result = result && readAll (batchRW.getIteratorAlt (), maxRecs, 0, 3000);
+
+			// a batch stops at the end of a page, even if there is room for more
+			void *recs[MAX_BATCH_SIZE];
+			MyDB_RecordIteratorAltPtr iter = batchRW.getIteratorAlt ();
+			result = result && (iter->getBatch (recs, onFirstPage + 1) == onFirstPage);
+			result = result && (iter->getBatch (recs, MAX_BATCH_SIZE) == onSecondPage);
+			result = result && readAll (batchRW.getIteratorAlt (1, 1), MAX_BATCH_SIZE, onFirstPage, onSecondPage);
+
+			cout << "page list..." << flush;
+			vector <MyDB_PageReaderWriter> pages;
+			for (int i = 0; i < numPages; i++)
+				pages.push_back (batchRW[i]);
+			result = result && readAll (getIteratorAlt (pages), MAX_BATCH_SIZE, 0, 3000);
+			result = result && readAll (getIteratorAlt (pages), 1, 0, 3000);
+
+			// with a big page, a batch stops at MAX_BATCH_SIZE
+			cout << "big page..." << flush;
+			MyDB_BufferManagerPtr bigMgr = make_shared <MyDB_BufferManager> (65536, 4, "tempFile");
+			MyDB_TablePtr bigTable = make_shared <MyDB_Table> ("batchBig", "batchBig.bin", batchSchema);
+			MyDB_TableReaderWriter bigRW (bigTable, bigMgr);
+			for (int i = 0; i < 3000; i++) {
+				temp->fromString (to_string (i) + "|" + string (i % 50, 'x') + "|");
+				bigRW.append (temp);
+			}
+			MyDB_RecordIteratorAltPtr bigIter = bigRW.getIteratorAlt ();
+			result = result && (bigRW[0].getNumRecords () > MAX_BATCH_SIZE);
+			result = result && (bigIter->getBatch (recs, MAX_BATCH_SIZE) == MAX_BATCH_SIZE);
+			result = result && readAll (bigRW.getIteratorAlt (), MAX_BATCH_SIZE, 0, 3000);
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 26:
+	{
+		// string comparisons, concatenation and hashing over views agree with std::string, both
+		// for values that were parsed and for values that are read in place from a page
+		cout << "TEST 26..." << flush;
+		bool result = true;
+		{
+			MyDB_SchemaPtr strSchema = make_shared <MyDB_Schema> ();
+			strSchema->appendAtt (make_pair ("l", make_shared <MyDB_StringAttType> ()));
+			strSchema->appendAtt (make_pair ("r", make_shared <MyDB_StringAttType> ()));
+			MyDB_RecordPtr temp = make_shared <MyDB_Record> (strSchema);
+			vector <func> comps = temp->compileComputations ({"> ([l], [r])", "< ([l], [r])",
+				"== ([l], [r])", "!= ([l], [r])", "+ ([l], [r])"});
+
+			// the values are compared as unsigned bytes, and a prefix comes first
+			vector <string> vals = {"", "a", "ab", "abc", "abd", "b", "Z", "\xff", "a\xff", string (300, 'q'),
+				string (300, 'q') + "r"};
+			auto check = [&] (string &l, string &r) {
+				bool ok = (temp->getAtt (0)->toString () == l) && (temp->getAtt (1)->toString () == r);
+				ok = ok && (temp->getAtt (0)->toStringView ().toString () == l);
+				ok = ok && (temp->getAtt (0)->hash () == MyDB_StringView (l.data (), l.size ()).hash ());
+				ok = ok && (comps[0] ()->toBool () == (l > r)) && (comps[1] ()->toBool () == (l < r));
+				ok = ok && (comps[2] ()->toBool () == (l == r)) && (comps[3] ()->toBool () == (l != r));
+				return ok && (comps[4] ()->toString () == l + r);
+			};
+
+			cout << "parsed..." << flush;
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (16384, 4, "tempFile");
+			MyDB_PageReaderWriter page (true, *myMgr);
+			for (string &l : vals) {
+				for (string &r : vals) {
+					temp->fromString (l + "|" + r + "|");
+					temp->recordContentHasChanged ();
+					result = result && check (l, r);
+					page.append (temp);
+				}
+			}
+
+			cout << "from page..." << flush;
+			MyDB_RecordIteratorAltPtr iter = page.getIteratorAlt ();
+			for (string &l : vals) {
+				for (string &r : vals) {
+					result = result && iter->advance ();
+					iter->getCurrent (temp);
+					result = result && check (l, r);
+				}
+			}
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 27:
+	{
+		// the loader splits the file into 8MB chunks at line ends, so a file of a few chunks whose
+		// lines straddle the chunk edges, with a blank line and no newline at the end, comes back
+		// whole and in order
+		cout << "TEST 27..." << flush;
+		bool result = true;
+		{
+			cout << "write file..." << flush;
+			const size_t chunkSize = 8 * 1024 * 1024;
+			int numLines = 0;
+			size_t fileSize = 0;
+			vector <bool> lineEndsAtEdge;
+			{
+				ofstream out ("bigLoad.tbl");
+				while (fileSize < 2 * chunkSize + chunkSize / 2) {
+					string line = to_string (numLines) + "|" + string (numLines % 97, 'a' + numLines % 26) + "|";
+					if (numLines == 1000)
+						line += "\n";
+					fileSize += line.size () + 1;
+					lineEndsAtEdge.push_back (fileSize % chunkSize == 0);
+					out << line;
+					if (fileSize < 2 * chunkSize + chunkSize / 2)
+						out << "\n";
+					numLines++;
+				}
+			}
+			result = result && (find (lineEndsAtEdge.begin (), lineEndsAtEdge.end (), true) == lineEndsAtEdge.end ());
+
+			cout << "load..." << flush;
+			MyDB_SchemaPtr loadSchema = make_shared <MyDB_Schema> ();
+			loadSchema->appendAtt (make_pair ("i", make_shared <MyDB_IntAttType> ()));
+			loadSchema->appendAtt (make_pair ("s", make_shared <MyDB_StringAttType> ()));
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (65536, 16, "tempFile");
+			MyDB_TablePtr loadTable = make_shared <MyDB_Table> ("bigLoad", "bigLoad.bin", loadSchema);
+			MyDB_TableReaderWriter loadRW (loadTable, myMgr);
+			pair <vector <size_t>, size_t> res = loadRW.loadFromTextFile ("bigLoad.tbl");
+			result = result && (res.second == (size_t) numLines);
+
+			cout << "check..." << flush;
+			MyDB_RecordPtr temp = loadRW.getEmptyRecord ();
+			MyDB_RecordIteratorAltPtr iter = loadRW.getIteratorAlt ();
+			int numRead = 0;
+			while (iter->advance ()) {
+				iter->getCurrent (temp);
+				result = result && (temp->getAtt (0)->toInt () == numRead) &&
+					(temp->getAtt (1)->toString () == string (numRead % 97, 'a' + numRead % 26));
+				numRead++;
+			}
+			result = result && (numRead == numLines);
+			unlink ("bigLoad.tbl");
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 28:
+	{
+		// a computation that is built as a tree gives the same answers as the same computation
+		// written out and parsed; a double literal keeps all of its bits, and a string literal can
+		// hold characters that mean something in the prefix notation
+		cout << "TEST 28..." << flush;
+		bool result = true;
+		{
+			MyDB_SchemaPtr exprSchema = make_shared <MyDB_Schema> ();
+			exprSchema->appendAtt (make_pair ("a", make_shared <MyDB_IntAttType> ()));
+			exprSchema->appendAtt (make_pair ("d", make_shared <MyDB_DoubleAttType> ()));
+			exprSchema->appendAtt (make_pair ("s", make_shared <MyDB_StringAttType> ()));
+			MyDB_RecordPtr temp = make_shared <MyDB_Record> (exprSchema);
+
+			string odd = "x], [y) z";
+			double third = 1.0 / 3;
+			MyDB_ExprPtr cmp = make_shared <MyDB_Expr> (gtOp,
+				make_shared <MyDB_Expr> (plusOp, MyDB_Expr :: attribute ("a"), MyDB_Expr :: intLiteral (5)),
+				make_shared <MyDB_Expr> (timesOp, MyDB_Expr :: attribute ("a"), MyDB_Expr :: intLiteral (2)));
+			MyDB_ExprPtr sum = make_shared <MyDB_Expr> (plusOp, MyDB_Expr :: attribute ("d"), MyDB_Expr :: doubleLiteral (third));
+			MyDB_ExprPtr eq = make_shared <MyDB_Expr> (eqOp, MyDB_Expr :: attribute ("s"), MyDB_Expr :: stringLiteral (odd));
+			vector <func> fromTrees = temp->compileExprs ({cmp, sum, eq});
+			vector <func> fromStrings = temp->compileComputations ({"> (+ ([a], int[5]), * ([a], int[2]))",
+				"+ ([d], double[0.5])"});
+
+			for (int i = 0; i < 10; i++) {
+				temp->fromString (to_string (i) + "|" + to_string (i) + ".5|" + (i % 2 == 0 ? odd : "x") + "|");
+				temp->recordContentHasChanged ();
+				result = result && (fromTrees[0] ()->toBool () == fromStrings[0] ()->toBool ());
+				result = result && (fromTrees[0] ()->toBool () == (i < 5));
+				result = result && (fromTrees[1] ()->toDouble () == temp->getAtt (1)->toDouble () + third);
+				result = result && (fromStrings[1] ()->toDouble () == i + 1.0);
+				result = result && (fromTrees[2] ()->toBool () == (i % 2 == 0));
+			}
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
 	default:
 		break;
 	}
@@ -20,7 +20,12 @@
 #include "RegularSelection.h"
 #include "ScanJoin.h"
 #include "SortMergeJoin.h"
+#include "JoinPipeline.h"
+#include "VectorizedSelection.h"
+#include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 #include <vector>
 #include <utility>
 
@@ -98,7 +103,7 @@ int main () {
 
 		// now, we count the total number of records 
 		vector <pair <MyDB_AggType, string>> aggsToCompute;
-		aggsToCompute.push_back (make_pair (MyDB_AggType :: cnt, "int[0]"));
+		aggsToCompute.push_back (make_pair (MyDB_AggType :: cntA, "int[0]"));
 
 		vector <string> groupings;
 		MyDB_SchemaPtr mySchemaOutAgain  = make_shared <MyDB_Schema> ();
@@ -150,7 +155,7 @@ int main () {
 
 		// now, we count the total number of records 
 		vector <pair <MyDB_AggType, string>> aggsToCompute;
-		aggsToCompute.push_back (make_pair (MyDB_AggType :: cnt, "int[0]"));
+		aggsToCompute.push_back (make_pair (MyDB_AggType :: cntA, "int[0]"));
 
 		vector <string> groupings;
 		MyDB_SchemaPtr mySchemaOutAgain  = make_shared <MyDB_Schema> ();
@@ -173,6 +178,249 @@ int main () {
 		}
 	}
 	
+	{
+		// This runs a two-way and a three-way join as one JoinPipeline, and checks that it gets
+		// the same records as running a SortMergeJoin (for the two-way join) or two ScanJoins
+		// (for the three-way join) on their own.  The pages are small, so that the pipeline has
+		// to sort the big tables, and only hashes the small one
+		MyDB_BufferManagerPtr smallMgr = make_shared <MyDB_BufferManager> (16384, 64, "tempFileSmall");
+
+		MyDB_SchemaPtr mySchemaS = make_shared <MyDB_Schema> ();
+		for (auto &a : mySchemaL->getAtts ())
+			mySchemaS->appendAtt (make_pair ("s_" + a.first.substr (2), a.second));
+
+		// the third table is the first 2000 suppliers
+		{
+			ifstream from ("supplier.tbl");
+			ofstream to ("supplierThird.tbl");
+			string line;
+			for (int i = 0; i < 2000 && getline (from, line); i++)
+				to << line << "\n";
+		}
+
+		MyDB_TableReaderWriterPtr joinL = make_shared <MyDB_TableReaderWriter> (
+			make_shared <MyDB_Table> ("joinLeft", "joinLeft.bin", mySchemaL), smallMgr);
+		MyDB_TableReaderWriterPtr joinR = make_shared <MyDB_TableReaderWriter> (
+			make_shared <MyDB_Table> ("joinRight", "joinRight.bin", mySchemaR), smallMgr);
+		MyDB_TableReaderWriterPtr joinS = make_shared <MyDB_TableReaderWriter> (
+			make_shared <MyDB_Table> ("joinThird", "joinThird.bin", mySchemaS), smallMgr);
+		joinL->loadFromTextFile ("supplier.tbl");
+		joinR->loadFromTextFile ("supplier.tbl");
+		joinS->loadFromTextFile ("supplierThird.tbl");
+
+		// the records of a table, written out and sorted, so that two tables can be compared
+		auto sortedRecords = [] (MyDB_TableReaderWriterPtr fromMe) {
+			vector <string> result;
+			MyDB_RecordPtr temp = fromMe->getEmptyRecord ();
+			MyDB_RecordIteratorAltPtr myIter = fromMe->getIteratorAlt ();
+			while (myIter->advance ()) {
+				myIter->getCurrent (temp);
+				stringstream ss;
+				ss << temp;
+				result.push_back (ss.str ());
+			}
+			sort (result.begin (), result.end ());
+			return result;
+		};
+
+		// SELECT l_suppkey, r_suppkey, l_acctbal
+		// FROM supplierLeft, supplierRight
+		// WHERE l_nationkey = r_nationkey AND l_suppkey < 200 AND r_suppkey < 300 AND
+		//       l_acctbal < r_acctbal
+		MyDB_SchemaPtr mySchemaOut = make_shared <MyDB_Schema> ();
+		mySchemaOut->appendAtt (make_pair ("l_suppkey", make_shared <MyDB_IntAttType> ()));
+		mySchemaOut->appendAtt (make_pair ("r_suppkey", make_shared <MyDB_IntAttType> ()));
+		mySchemaOut->appendAtt (make_pair ("l_acctbal", make_shared <MyDB_DoubleAttType> ()));
+
+		vector <string> projections;
+		projections.push_back ("[l_suppkey]");
+		projections.push_back ("[r_suppkey]");
+		projections.push_back ("[l_acctbal]");
+
+		MyDB_TableReaderWriterPtr expected = make_shared <MyDB_TableReaderWriter> (
+			make_shared <MyDB_Table> ("joinExpected", "joinExpected.bin", mySchemaOut), smallMgr);
+		SortMergeJoin twoWay (joinL, joinR, expected, "&& (== ([l_nationkey], [r_nationkey]), < ([l_acctbal], [r_acctbal]))",
+			projections, make_pair (string ("[l_nationkey]"), string ("[r_nationkey]")),
+			"< ([l_suppkey], int[200])", "< ([r_suppkey], int[300])");
+		twoWay.run ();
+
+		vector <MyDB_ExprPtr> conjuncts;
+		conjuncts.push_back (MyDB_Expr :: parse ("== ([l_nationkey], [r_nationkey])"));
+		conjuncts.push_back (MyDB_Expr :: parse ("< ([l_suppkey], int[200])"));
+		conjuncts.push_back (MyDB_Expr :: parse ("< ([r_suppkey], int[300])"));
+		conjuncts.push_back (MyDB_Expr :: parse ("< ([l_acctbal], [r_acctbal])"));
+		vector <MyDB_ExprPtr> projectionExprs;
+		for (string &p : projections)
+			projectionExprs.push_back (MyDB_Expr :: parse (p));
+
+		MyDB_TableReaderWriterPtr result = make_shared <MyDB_TableReaderWriter> (
+			make_shared <MyDB_Table> ("joinResult", "joinResult.bin", mySchemaOut), smallMgr);
+		vector <MyDB_TableReaderWriterPtr> inputs = {joinL, joinR};
+		JoinPipeline twoWayPipeline (inputs, result, conjuncts, projectionExprs);
+		twoWayPipeline.run (2);
+
+		vector <string> expectedRecs = sortedRecords (expected);
+		vector <string> resultRecs = sortedRecords (result);
+		cout << "The two-way join pipeline got " << resultRecs.size () << " records; a sort-merge join got "
+			<< expectedRecs.size () << ".\n";
+		QUNIT_IS_TRUE (expectedRecs.size () > 0);
+		QUNIT_IS_TRUE (resultRecs == expectedRecs);
+
+		// now the same, with a third table:
+		//
+		// SELECT l_suppkey, r_suppkey, s_suppkey, l_acctbal
+		// FROM supplierLeft, supplierRight, supplierThird
+		// WHERE l_nationkey = r_nationkey AND l_suppkey < 200 AND r_suppkey < 300 AND
+		//       l_acctbal < r_acctbal AND s_nationkey = l_nationkey AND s_suppkey < 100
+		//
+		// which is run here by joining the first two tables, and then hashing the third one
+		MyDB_SchemaPtr mySchemaLR = make_shared <MyDB_Schema> ();
+		vector <string> allAtts;
+		for (auto &a : mySchemaL->getAtts ()) {
+			mySchemaLR->appendAtt (a);
+			allAtts.push_back ("[" + a.first + "]");
+		}
+		for (auto &a : mySchemaR->getAtts ()) {
+			mySchemaLR->appendAtt (a);
+			allAtts.push_back ("[" + a.first + "]");
+		}
+		MyDB_TableReaderWriterPtr joinLR = make_shared <MyDB_TableReaderWriter> (
+			make_shared <MyDB_Table> ("joinLR", "joinLR.bin", mySchemaLR), smallMgr);
+		vector <pair <string, string>> hashAtts;
+		hashAtts.push_back (make_pair (string ("[l_nationkey]"), string ("[r_nationkey]")));
+		ScanJoin firstJoin (joinL, joinR, joinLR, "&& (== ([l_nationkey], [r_nationkey]), < ([l_acctbal], [r_acctbal]))",
+			allAtts, hashAtts, "< ([l_suppkey], int[200])", "< ([r_suppkey], int[300])");
+		firstJoin.run ();
+
+		MyDB_SchemaPtr mySchemaOut3 = make_shared <MyDB_Schema> ();
+		for (auto &a : mySchemaOut->getAtts ())
+			mySchemaOut3->appendAtt (a);
+		mySchemaOut3->appendAtt (make_pair ("s_suppkey", make_shared <MyDB_IntAttType> ()));
+		projections.push_back ("[s_suppkey]");
+		expected = make_shared <MyDB_TableReaderWriter> (
+			make_shared <MyDB_Table> ("joinExpected3", "joinExpected3.bin", mySchemaOut3), smallMgr);
+		hashAtts.clear ();
+		hashAtts.push_back (make_pair (string ("[s_nationkey]"), string ("[l_nationkey]")));
+		ScanJoin secondJoin (joinS, joinLR, expected, "== ([s_nationkey], [l_nationkey])",
+			projections, hashAtts, "< ([s_suppkey], int[100])", "bool[true]");
+		secondJoin.run ();
+
+		conjuncts.push_back (MyDB_Expr :: parse ("== ([s_nationkey], [l_nationkey])"));
+		conjuncts.push_back (MyDB_Expr :: parse ("< ([s_suppkey], int[100])"));
+		projectionExprs.push_back (MyDB_Expr :: parse ("[s_suppkey]"));
+		result = make_shared <MyDB_TableReaderWriter> (
+			make_shared <MyDB_Table> ("joinResult3", "joinResult3.bin", mySchemaOut3), smallMgr);
+		inputs.push_back (joinS);
+		JoinPipeline threeWayPipeline (inputs, result, conjuncts, projectionExprs);
+		threeWayPipeline.run (2);
+
+		expectedRecs = sortedRecords (expected);
+		resultRecs = sortedRecords (result);
+		cout << "The three-way join pipeline got " << resultRecs.size () << " records; two scan joins got "
+			<< expectedRecs.size () << ".\n";
+		QUNIT_IS_TRUE (expectedRecs.size () > 0);
+		QUNIT_IS_TRUE (resultRecs == expectedRecs);
+	}
+
+	{
+		// This runs a RegularSelection and a BPlusSelection over a table of made-up parts, once
+		// on their own and then on four threads, and checks that the threads get the same
+		// records, in the same order if they are asked to keep it; and likewise for a
+		// VectorizedSelection on one and on four workers
+		MyDB_BufferManagerPtr parMgr = make_shared <MyDB_BufferManager> (16384, 64, "tempFilePar");
+		MyDB_SchemaPtr mySchemaP = make_shared <MyDB_Schema> ();
+		mySchemaP->appendAtt (make_pair ("p_key", make_shared <MyDB_IntAttType> ()));
+		mySchemaP->appendAtt (make_pair ("p_name", make_shared <MyDB_StringAttType> ()));
+		mySchemaP->appendAtt (make_pair ("p_val", make_shared <MyDB_DoubleAttType> ()));
+		MyDB_TableReaderWriterPtr parts = make_shared <MyDB_TableReaderWriter> (
+			make_shared <MyDB_Table> ("parts", "parts.bin", mySchemaP), parMgr);
+		MyDB_BPlusTreeReaderWriterPtr partsTree = make_shared <MyDB_BPlusTreeReaderWriter> ("p_name",
+			make_shared <MyDB_Table> ("partsTree", "partsTree.bin", mySchemaP), parMgr);
+		MyDB_RecordPtr temp = parts->getEmptyRecord ();
+		for (int i = 0; i < 20000; i++) {
+			temp->fromString (to_string (i) + "|name" + to_string (i * 7919 % 20000) + "|" + to_string (i * 37 % 1000 / 10.0) + "|");
+			parts->append (temp);
+			partsTree->append (temp);
+		}
+
+		// the records of a table, in the order that they are stored
+		auto allRecords = [] (MyDB_TableReaderWriterPtr fromMe) {
+			vector <string> result;
+			MyDB_RecordPtr temp = fromMe->getEmptyRecord ();
+			MyDB_RecordIteratorAltPtr myIter = fromMe->getIteratorAlt ();
+			while (myIter->advance ()) {
+				myIter->getCurrent (temp);
+				stringstream ss;
+				ss << temp;
+				result.push_back (ss.str ());
+			}
+			return result;
+		};
+
+		MyDB_SchemaPtr mySchemaOut = make_shared <MyDB_Schema> ();
+		mySchemaOut->appendAtt (make_pair ("p_key", make_shared <MyDB_IntAttType> ()));
+		mySchemaOut->appendAtt (make_pair ("p_name", make_shared <MyDB_StringAttType> ()));
+		vector <string> projections;
+		projections.push_back ("[p_key]");
+		projections.push_back ("+ ([p_name], string[!])");
+		string predicate = "&& (> ([p_val], double[20.0]), < ([p_key], int[15000]))";
+		MyDB_StringAttValPtr low = make_shared <MyDB_StringAttVal> ();
+		MyDB_StringAttValPtr high = make_shared <MyDB_StringAttVal> ();
+		low->set ("name1");
+		high->set ("name5");
+
+		// runs is 0 for run (), 1 for run (4, true), and 2 for run (4, false)
+		vector <vector <string>> scanned, probed;
+		for (int runs = 0; runs < 3; runs++) {
+			string name = "partsOut" + to_string (runs);
+			MyDB_TableReaderWriterPtr out = make_shared <MyDB_TableReaderWriter> (
+				make_shared <MyDB_Table> (name, name + ".bin", mySchemaOut), parMgr);
+			RegularSelection scan (parts, out, predicate, projections);
+			if (runs == 0)
+				scan.run ();
+			else
+				scan.run (4, runs == 1);
+			scanned.push_back (allRecords (out));
+
+			out = make_shared <MyDB_TableReaderWriter> (
+				make_shared <MyDB_Table> (name + "Tree", name + "Tree.bin", mySchemaOut), parMgr);
+			BPlusSelection probe (partsTree, out, low, high, predicate, projections);
+			if (runs == 0)
+				probe.run ();
+			else
+				probe.run (4, runs == 1);
+			probed.push_back (allRecords (out));
+		}
+
+		cout << "The selection got " << scanned[0].size () << " records, and the B+-Tree selection got "
+			<< probed[0].size () << "; on four threads, they got " << scanned[1].size () << " and "
+			<< probed[1].size () << ".\n";
+		QUNIT_IS_TRUE (scanned[0].size () > 0 && probed[0].size () > 0 && probed[0].size () < scanned[0].size ());
+		QUNIT_IS_TRUE (scanned[1] == scanned[0] && probed[1] == probed[0]);
+
+		// a VectorizedSelection is morsel-driven, and its workers' pages are put back in order
+		vector <vector <string>> vectorized;
+		for (int workers : {1, 4}) {
+			string name = "partsVec" + to_string (workers);
+			MyDB_TableReaderWriterPtr out = make_shared <MyDB_TableReaderWriter> (
+				make_shared <MyDB_Table> (name, name + ".bin", mySchemaOut), parMgr);
+			VectorizedSelection vectorScan (parts, out, predicate, projections);
+			if (workers == 1)
+				vectorScan.run ();
+			else
+				vectorScan.run (workers);
+			vectorized.push_back (allRecords (out));
+		}
+		cout << "The vectorized selection got " << vectorized[0].size () << " records; on four workers, it got "
+			<< vectorized[1].size () << ".\n";
+		QUNIT_IS_TRUE (vectorized[0] == scanned[0] && vectorized[1] == scanned[0]);
+
+		for (auto &recs : {&scanned, &probed})
+			for (auto &r : *recs)
+				sort (r.begin (), r.end ());
+		QUNIT_IS_TRUE (scanned[2] == scanned[0] && probed[2] == probed[0]);
+	}
+
 	{
 		
 		// get the output schema and table
@@ -233,7 +481,7 @@ int main () {
 
 		// now, we count the total number of records with each nation name
 		vector <pair <MyDB_AggType, string>> aggsToCompute;
-		aggsToCompute.push_back (make_pair (MyDB_AggType :: cnt, "int[0]"));
+		aggsToCompute.push_back (make_pair (MyDB_AggType :: cntA, "int[0]"));
 
 		vector <string> groupings;
 		groupings.push_back ("[l_name]");
@@ -316,9 +564,9 @@ int main () {
 
 	{
 		vector <pair <MyDB_AggType, string>> aggsToCompute;
-		aggsToCompute.push_back (make_pair (MyDB_AggType :: avg, "* ([r_suppkey], double[1.0])"));
-		aggsToCompute.push_back (make_pair (MyDB_AggType :: avg, "[r_acctbal]"));
-		aggsToCompute.push_back (make_pair (MyDB_AggType :: cnt, "int[0]"));
+		aggsToCompute.push_back (make_pair (MyDB_AggType :: avgA, "* ([r_suppkey], double[1.0])"));
+		aggsToCompute.push_back (make_pair (MyDB_AggType :: avgA, "[r_acctbal]"));
+		aggsToCompute.push_back (make_pair (MyDB_AggType :: cntA, "int[0]"));
 
 		vector <string> groupings;
 		groupings.push_back ("[r_suppkey]");
@@ -358,9 +606,9 @@ int main () {
 
 	{
 		vector <pair <MyDB_AggType, string>> aggsToCompute;
-		aggsToCompute.push_back (make_pair (MyDB_AggType :: avg, "* ([r_suppkey], double[1.0])"));
-		aggsToCompute.push_back (make_pair (MyDB_AggType :: avg, "[r_acctbal]"));
-		aggsToCompute.push_back (make_pair (MyDB_AggType :: cnt, "int[0]"));
+		aggsToCompute.push_back (make_pair (MyDB_AggType :: avgA, "* ([r_suppkey], double[1.0])"));
+		aggsToCompute.push_back (make_pair (MyDB_AggType :: avgA, "[r_acctbal]"));
+		aggsToCompute.push_back (make_pair (MyDB_AggType :: cntA, "int[0]"));
 
 		vector <string> groupings;
 		groupings.push_back ("/ ([r_suppkey], int[100])");
@@ -395,7 +643,7 @@ int main () {
 		}
 
 		aggsToCompute.clear ();
-		aggsToCompute.push_back (make_pair (MyDB_AggType :: sum, "[r_cnt]"));
+		aggsToCompute.push_back (make_pair (MyDB_AggType :: sumA, "[r_cnt]"));
 
 		groupings.clear ();
 		
@@ -484,7 +732,7 @@ int main () {
 
 		// now, we count the total number of records with each nation name
 		vector <pair <MyDB_AggType, string>> aggsToCompute;
-		aggsToCompute.push_back (make_pair (MyDB_AggType :: cnt, "int[0]"));
+		aggsToCompute.push_back (make_pair (MyDB_AggType :: cntA, "int[0]"));
 
 		vector <string> groupings;
 		groupings.push_back ("[nation]");
@@ -565,7 +813,7 @@ int main () {
 
 		// now, we count the total number of records with each nation name
 		vector <pair <MyDB_AggType, string>> aggsToCompute;
-		aggsToCompute.push_back (make_pair (MyDB_AggType :: cnt, "int[0]"));
+		aggsToCompute.push_back (make_pair (MyDB_AggType :: cntA, "int[0]"));
 
 		vector <string> groupings;
 		MyDB_SchemaPtr mySchemaOutAgain  = make_shared <MyDB_Schema> ();
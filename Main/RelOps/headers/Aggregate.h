@@ -2,18 +2,24 @@
 #ifndef AGG_H
 #define AGG_H
 
+#include "MyDB_Expr.h"
 #include "MyDB_TableReaderWriter.h"
+#include "PipelineOp.h"
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 // This class encapulates a simple, hash-based aggregation + group by.  It does not
 // need to work when there is not enough space in the buffer manager to store all of
-// the groups.
+// the groups.  The records can also be pushed into it (see PipelineOp); since no aggregate is
+// known until all of the records have been seen, the output is written by close ().
 
 enum MyDB_AggType {sumA, avgA, cntA};
 
-class Aggregate {
+struct AggregateState;
+
+class Aggregate : public PipelineOp {
 
 public:
 	// This aggregates the table pointed to by input, writing the result to the
@@ -50,17 +56,38 @@ public:
 	Aggregate (MyDB_TableReaderWriterPtr input, MyDB_TableReaderWriterPtr output,
 		vector <pair <MyDB_AggType, string>> aggsToCompute,
 		vector <string> groupings, string selectionPredicate);
+
+	// the same, but the computations have already been built (see MyDB_Expr), so nothing needs
+	// to be parsed; they are resolved against the input records by open ().  The computation for
+	// a count is not looked at, so it can be null
+	Aggregate (MyDB_TableReaderWriterPtr input, MyDB_TableReaderWriterPtr output,
+		vector <pair <MyDB_AggType, MyDB_ExprPtr>> aggsToCompute,
+		vector <MyDB_ExprPtr> groupings, MyDB_ExprPtr selectionPredicate);
 	
 	// execute the aggregation
 	void run ();
 
+	// these push records from the input into the aggregation (see PipelineOp)
+	void open ();
+	void consume (void **recs, int numRecs);
+	void close ();
+
+	// after run () (or close ()), a histogram of the lengths of the lists of records in the hash table that
+	// have the same hash value (see getChainHistogram () in MyDB_Hash.h)
+	vector <size_t> &getChainLengths ();
+
 private:
 
 	MyDB_TableReaderWriterPtr input;
 	MyDB_TableReaderWriterPtr output;
-	vector <pair <MyDB_AggType, string>> aggsToCompute;
-	vector <string> groupings;
-	string selectionPredicate;
+	vector <pair <MyDB_AggType, MyDB_ExprPtr>> aggsToCompute;
+	vector <MyDB_ExprPtr> groupings;
+	MyDB_ExprPtr selectionPredicate;
+	vector <size_t> chainLengths;
+
+	// the records, computations and hash table that are set up by open (); this is null if the
+	// output schema is no good
+	shared_ptr <AggregateState> state;
 
 };
 
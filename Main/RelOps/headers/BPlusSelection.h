@@ -32,6 +32,11 @@ public:
 	// execute the selection operation
 	void run ();
 
+	// execute the selection operation as numThreads tasks on the shared MyDB_TaskScheduler, each one working on its own runs of
+	// leaf pages (see ParallelSelection); if inOrder is true, then the output records are in
+	// the same order as with run ()
+	void run (int numThreads, bool inOrder);
+
 private:
 
 	MyDB_BPlusTreeReaderWriterPtr input;
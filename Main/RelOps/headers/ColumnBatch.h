@@ -0,0 +1,124 @@
+
+#ifndef COLUMN_BATCH_H
+#define COLUMN_BATCH_H
+
+#include "MyDB_AttVal.h"
+#include "MyDB_Expr.h"
+#include "MyDB_RecordIteratorAlt.h"
+#include "MyDB_Schema.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// This holds one value for each record in a batch (so up to MAX_BATCH_SIZE values), all in
+// the same mode.  It is what the vectorized operators pass around: a decoded attribute, or
+// the result of evaluating a computation over a batch.  If isConstant is set, then the only
+// value is held in position zero, and it applies to every record in the batch
+class ColumnVector {
+
+public:
+
+	MyDB_ExprMode mode;
+	bool isConstant;
+
+	// set for a decoded date attribute: the ints are days, but the values are written out
+	// (and promoted to strings) as dates
+	bool isDate;
+
+	// set for a decoded dictionary-encoded attribute: the codes are in ints, and the strings
+	// point into the dictionary
+	MyDB_StringDictionaryPtr dictionary;
+
+	// set for a decoded attribute that is stored out of line: the strings are fetched from
+	// the file into stringStore
+	MyDB_OverflowFilePtr overflowFile;
+
+	// in decimalMode, the number of digits after the decimal point (see MyDB_DecimalAttVal)
+	int scale;
+
+	// only the one matching the mode is used; decimals are in longs
+	vector <int> ints;
+	vector <double> doubles;
+	vector <long long> longs;
+	vector <const char *> strings;
+	vector <char> bools;
+
+	// when strings are computed (rather than pointing into a page) they live here
+	vector <string> stringStore;
+
+	// gets the vector ready to hold values of the given mode (and scale, for decimals)
+	void setUp (MyDB_ExprMode modeIn, bool isConstantIn, int scaleIn);
+
+	// sets the given attribute to the value in position i; this goes through the attribute's
+	// set () method, so the usual conversions happen if the attribute has a different type
+	void writeInto (int i, MyDB_AttValPtr &intoMe);
+
+	// appends a binary version of the value in position i to the string, for use as a hash key
+	// (for a dictionary-encoded attribute, this is just the code)
+	void appendKey (int i, string &toMe);
+
+	// used to get the value for the i^th record, taking care of constants
+	inline int pos (int i) {
+		return isConstant ? 0 : i;
+	}
+
+private:
+
+	// used by writeInto ()
+	MyDB_AttValPtr scratch;
+	MyDB_DateAttValPtr dateScratch;
+};
+
+// This decodes the attributes that a vectorized operator needs from a batch of records
+// (obtained via MyDB_RecordIteratorAlt.getBatch ()), one ColumnVector per attribute.  Strings
+// are not copied; they point into the page that the record came from (or, for a
+// dictionary-encoded attribute, into the dictionary)
+class ColumnBatch {
+
+public:
+
+	// set up to decode the listed attributes (positions in the schema) from records
+	// having the given schema
+	ColumnBatch (MyDB_SchemaPtr mySchema, vector <int> &attsNeeded);
+
+	// decode all of the needed attributes from the given records
+	void load (void **recs, int numRecs);
+
+	// decode all of the needed attributes from the next batch of records from the iterator,
+	// which hands over just the values (see MyDB_RecordIteratorAlt.getColumnBatch ()), so a
+	// PAXPage can be read a column at a time; returns the number of records, or zero if there
+	// are no more records
+	int load (MyDB_RecordIteratorAltPtr fromMe);
+
+	// get the column for the attribute at the given position in the schema
+	ColumnVector *getColumn (int whichAtt);
+
+	// the number of records in the batch, and a selection vector that lists all of them
+	int getNumRecs ();
+	int *getAllRows ();
+
+private:
+
+	// decodes the value at data into position i of the column
+	void decode (ColumnVector &col, int i, char *data);
+
+	vector <ColumnVector> columns;
+	vector <int> slotForAtt;
+	int lastAttNeeded;
+
+	// if every attribute up to the last one needed always takes up the same amount of space
+	// (see MyDB_Schema.getFixedOffset ()), this has where each column's attribute is in a
+	// record, so that the attributes do not need to be walked through; otherwise it is empty
+	vector <int> offsetForSlot;
+
+	// used by load (MyDB_RecordIteratorAltPtr): the attributes needed, in order, and the
+	// locations of each one's values
+	vector <int> attsInOrder;
+	vector <vector <void *>> valueStore;
+	vector <void **> values;
+	int numRecs;
+	vector <int> allRows;
+};
+
+#endif
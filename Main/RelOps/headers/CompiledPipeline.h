@@ -0,0 +1,93 @@
+
+#ifndef COMPILED_PIPELINE_H
+#define COMPILED_PIPELINE_H
+
+#include "Aggregate.h"
+#include "MyDB_Expr.h"
+#include "MyDB_TableReaderWriter.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// This runs a scan->filter->project or a scan->filter->aggregate pipeline by generating C++
+// code that is specialized to the input schema and to the computations, compiling it into a
+// shared object with the system compiler, and then loading it with dlopen () and running it
+// over the input table's pages, a batch of records at a time.
+//
+// The generated code and the shared objects are kept in a cache directory, named using a hash
+// of the code, so a pipeline that has been seen before (in this run or an earlier one) is not
+// compiled again.
+//
+// If code cannot be generated for a pipeline (for example, a computation that would make the
+// interpreted operators exit with an error) or the compiler fails, then run () returns false
+// without writing anything, and the interpreted operators should be used instead.
+
+class CompiledPipeline {
+
+public:
+
+	// a selection; the parameters are the same as for a RegularSelection
+	CompiledPipeline (MyDB_TableReaderWriterPtr input, MyDB_TableReaderWriterPtr output,
+		string selectionPredicate, vector <string> projections);
+
+	// an aggregation; the parameters are the same as for an Aggregate
+	CompiledPipeline (MyDB_TableReaderWriterPtr input, MyDB_TableReaderWriterPtr output,
+		vector <pair <MyDB_AggType, string>> aggsToCompute,
+		vector <string> groupings, string selectionPredicate);
+
+	// the same two, but the computations have already been built (see MyDB_Expr), so nothing
+	// needs to be parsed; the computation for a count is not used, and can be null
+	CompiledPipeline (MyDB_TableReaderWriterPtr input, MyDB_TableReaderWriterPtr output,
+		MyDB_ExprPtr selectionPredicate, vector <MyDB_ExprPtr> projections);
+	CompiledPipeline (MyDB_TableReaderWriterPtr input, MyDB_TableReaderWriterPtr output,
+		vector <pair <MyDB_AggType, MyDB_ExprPtr>> aggsToCompute,
+		vector <MyDB_ExprPtr> groupings, MyDB_ExprPtr selectionPredicate);
+
+	// run the pipeline; returns false if the code could not be generated or compiled
+	bool run ();
+
+	// sets the directory where the generated code is kept (the default is "codegen")
+	static void setCacheDir (string dir);
+
+private:
+
+	// writes the code for the pipeline; returns false if it is not supported
+	bool generate (string &code);
+
+	// writes the code for the decoding of the needed attributes
+	string generateDecode (vector <int> &attsNeeded);
+
+	// writes an expression computing the value of e; its C++ type depends on the mode
+	string generateExpr (MyDB_ExprPtr e);
+
+	// writes an expression converting the value from one mode to another
+	string promote (string value, MyDB_ExprMode fromMode, MyDB_ExprMode toMode);
+
+	// writes a statement that appends the value (in the given mode) to the string out, as an
+	// attribute of the given type; returns false if the conversion is not supported
+	bool generatePut (string out, string value, MyDB_ExprMode fromMode, MyDB_AttTypePtr toType, string &code);
+
+	// compiles the code (or finds it in the cache) and returns the handle from dlopen ()
+	void *load (string &code);
+
+	// called by the generated code for each output record
+	static void emitRecord (void *me, char *rec);
+
+	MyDB_TableReaderWriterPtr input;
+	MyDB_TableReaderWriterPtr output;
+	MyDB_ExprPtr selectionPredicate;
+	vector <MyDB_ExprPtr> projections;
+	vector <pair <MyDB_AggType, MyDB_ExprPtr>> aggsToCompute;
+	vector <MyDB_ExprPtr> groupings;
+	bool isAgg;
+
+	// set to false by generateExpr () if it finds something that it cannot write out
+	bool canGenerate;
+
+	// used to write the output
+	MyDB_RecordPtr outRec;
+};
+
+#endif
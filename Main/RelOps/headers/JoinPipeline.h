@@ -0,0 +1,64 @@
+
+#ifndef JOIN_PIPELINE_H
+#define JOIN_PIPELINE_H
+
+#include "Aggregate.h"
+#include "MyDB_Expr.h"
+#include "MyDB_TableReaderWriter.h"
+#include "PipelineOp.h"
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+// This runs a join of any number of tables as one pipeline (see PipelineOp).  The largest table
+// is scanned morsel-driven by a VectorizedSelection that runs the conjuncts over just that table,
+// and its records are pushed through a join with each of the other tables in turn, and then into
+// the aggregate (or straight into the output).
+//
+// Each of the other tables is hashed by a ScanJoin, or if it is more than half the size of the
+// buffer, sorted by a SortMergeJoin.  The next table to be joined is one that an equality ties
+// to the tables joined so far, if there is one, so that a cross product is only done when the
+// conjuncts ask for one.  The conjuncts over just the new table are run on it before it is
+// hashed (or sorted), and the ones over it and the tables joined so far are run on the joined
+// records; any that are left go to the last join
+class JoinPipeline {
+
+public:
+
+	// the inputs (there are at least two) are joined, and the joined records that are accepted by
+	// all of the conjuncts are written to output, with the given projections.  The conjuncts and
+	// the projections refer to the inputs' attributes by name, so no two inputs can have an
+	// attribute with the same name
+	JoinPipeline (vector <MyDB_TableReaderWriterPtr> inputs, MyDB_TableReaderWriterPtr output,
+		vector <MyDB_ExprPtr> conjuncts, vector <MyDB_ExprPtr> projections);
+
+	// the same, but the joined records are aggregated, just like with an Aggregate
+	JoinPipeline (vector <MyDB_TableReaderWriterPtr> inputs, MyDB_TableReaderWriterPtr output,
+		vector <MyDB_ExprPtr> conjuncts, vector <pair <MyDB_AggType, MyDB_ExprPtr>> aggsToCompute,
+		vector <MyDB_ExprPtr> groupings);
+
+	// runs the join, with the scan of the largest table on numWorkers workers at once; if the
+	// output is a PipelineSink, it is closed once all of the records are written to it
+	void run (int numWorkers);
+
+	// after run (), the pages of the scanned table that were skipped (see MyDB_ZoneMap)
+	string getSkipCounts ();
+
+private:
+
+	// the positions (in inputs) of the tables that the computation reads from
+	set <int> tablesRead (MyDB_ExprPtr expr);
+
+	vector <MyDB_TableReaderWriterPtr> inputs;
+	MyDB_TableReaderWriterPtr output;
+	vector <MyDB_ExprPtr> conjuncts;
+	vector <MyDB_ExprPtr> projections;
+	vector <pair <MyDB_AggType, MyDB_ExprPtr>> aggsToCompute;
+	vector <MyDB_ExprPtr> groupings;
+	bool isAgg;
+	string skipCounts;
+};
+
+#endif
@@ -0,0 +1,93 @@
+
+#ifndef MORSEL_EXEC_H
+#define MORSEL_EXEC_H
+
+#include "MyDB_PageReaderWriter.h"
+#include "MyDB_TableReaderWriter.h"
+#include <functional>
+#include <map>
+#include <mutex>
+#include <vector>
+
+// a morsel is a run of at most this many consecutive pages of a table
+#define MAX_MORSEL_PAGES 4
+
+// the pages of one morsel, which stay pinned until the worker that has the morsel asks for
+// the next one (or says that it is done)
+struct Morsel {
+
+	// the number of the morsel; morsels are numbered in the order of their pages in the table
+	int number = -1;
+
+	// the pinned pages, and for each one, its bytes, and whether it is a PAXPage
+	vector <MyDB_PageReaderWriter> pinned;
+	vector <void *> pages;
+	vector <bool> isPAX;
+};
+
+// This runs a pipeline (scan -> filter -> project, or scan -> filter -> partial aggregate) on
+// all of the workers of the shared MyDB_TaskScheduler at once.  There is no barrier from one
+// group of pages to the next: each worker has its own copy of the pipeline, and it keeps
+// taking the next morsel of the table until there are none left, so a worker that finishes
+// early just takes more morsels.  The operator that drives the executor keeps whatever state
+// each worker's pipeline builds up (a partial aggregate, say) and merges it once run () is done.
+//
+// The buffer manager is not thread-safe, so everything that uses it is done while holding the
+// executor's lock: pinning and unpinning the morsels, and appending page images to an
+// output table.  The records themselves are read right off of the pinned pages, with no lock
+class MorselExecutor {
+
+public:
+
+	// the pages of input for which readPage () returns false are skipped (see
+	// MyDB_TableReaderWriter.getPageFilter ())
+	MorselExecutor (MyDB_TableReaderWriterPtr input, function <bool (int)> readPage);
+
+	// runs numWorkers copies of the pipeline as tasks on the shared scheduler, and waits for them
+	// to finish.  The records on the pages are handed to consume (), a batch of at most
+	// MAX_BATCH_SIZE records at a time, along with the number of the worker (from 0 to
+	// numWorkers - 1; only that worker's pipeline sees the call), and the position of the first
+	// record in the batch.  Positions go up in the same order as the records are in the table,
+	// although they are not consecutive, so that the worker can tell what order things were seen in
+	void run (int numWorkers, function <void (int whichWorker, void **recs, int numRecs, long long firstPos)> consume);
+
+	// the same, but once a worker has handed all of the records in a morsel to consume (), it
+	// calls morselDone () with the number of the morsel, before it takes the next one
+	void run (int numWorkers, function <void (int whichWorker, void **recs, int numRecs, long long firstPos)> consume,
+		function <void (int whichWorker, int whichMorsel)> morselDone);
+
+	// called from inside of consume (): appends a page image to a table, holding the lock
+	void appendPageImage (MyDB_TableReaderWriterPtr output, void *page);
+
+	// called from inside of morselDone (): takes the page images that were written from the given
+	// morsel, and appends them to a table once the ones from all of the morsels before it have
+	// been, so that the records in the table are in the same order as in the input.  The records
+	// on the last page image of a morsel are appended one at a time (using usingMe), so that
+	// they fill up the table's last page, rather than leaving a page that is partly empty
+	void appendInOrder (MyDB_TableReaderWriterPtr output, int whichMorsel, vector <vector <char>> &pages,
+		MyDB_RecordPtr usingMe);
+
+	// the number of workers that run () should be asked for; this is the number of workers
+	// in the shared scheduler, as long as they do not pin too much of the buffer
+	int getNumWorkers ();
+
+private:
+
+	// lets go of the pages in the given morsel and pins the pages of the next one; returns false
+	// if there are no more
+	bool getMorsel (Morsel &intoMe);
+
+	MyDB_TableReaderWriterPtr input;
+	function <bool (int)> readPage;
+	mutex lock;
+	int nextPage;
+	int nextMorsel;
+	int pagesPerMorsel;
+
+	// the page images from the morsels that are done, but that have to wait for a morsel before
+	// them to be appended, and the number of the next morsel to append
+	map <int, vector <vector <char>>> waiting;
+	int nextToAppend;
+};
+
+#endif
@@ -0,0 +1,49 @@
+
+#ifndef PAR_SELECTION_H
+#define PAR_SELECTION_H
+
+#include "MyDB_PageReaderWriter.h"
+#include "MyDB_TableReaderWriter.h"
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// This runs a selection over a list of pages as several tasks at once, on the workers of the
+// shared MyDB_TaskScheduler; it is used by RegularSelection.run (int, bool) and
+// BPlusSelection.run (int, bool).  Only the thread that calls run () uses the buffer manager:
+// in each round, it pins a run of consecutive pages for each task, and each task reads the records right off of its pages, using its own
+// records and compiled computations, and writes the records that it accepts into its own page
+// images.  Once the tasks are done, the page images are appended to the output table.
+//
+// If inOrder is true, the output records are in the same order that the records are on the
+// pages, just like a single-threaded selection; otherwise, each worker keeps filling its last
+// page image from one round to the next, so that there are fewer partly-full pages to append,
+// but the records from the different workers end up mixed together
+
+class ParallelSelection {
+
+public:
+
+	// the records are read from input, and written to output; if makeRangeCheck is not null,
+	// then it is called with each worker's input record, and it returns a function that says if
+	// the record is looked at all (this is how a B+-Tree's range is checked)
+	ParallelSelection (MyDB_TableReaderWriterPtr input, MyDB_TableReaderWriterPtr output,
+		string selectionPredicate, vector <string> projections,
+		function <function <bool ()> (MyDB_RecordPtr)> makeRangeCheck);
+
+	// run the selection over the records on the given pages of input; each page in the list is
+	// let go of once it has been looked at, since a page that has been pinned stays pinned for
+	// as long as anything refers to it
+	void run (vector <MyDB_PageReaderWriter> &pages, int numThreads, bool inOrder);
+
+private:
+
+	MyDB_TableReaderWriterPtr input;
+	MyDB_TableReaderWriterPtr output;
+	string selectionPredicate;
+	vector <string> projections;
+	function <function <bool ()> (MyDB_RecordPtr)> makeRangeCheck;
+};
+
+#endif
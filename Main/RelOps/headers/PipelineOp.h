@@ -0,0 +1,78 @@
+
+#ifndef PIPELINE_OP_H
+#define PIPELINE_OP_H
+
+#include "MyDB_TableReaderWriter.h"
+#include <vector>
+
+// This is the interface to an operator that records can be pushed into, one batch at a time,
+// rather than the operator reading them out of its input table itself.  The operators that are
+// PipelineOps (RegularSelection, Aggregate, ScanJoin and SortMergeJoin) can still be run the
+// usual way with run (), which just pushes all of the records of the input table through the
+// operator; but if an operator's input is a PipelineSink, then the operator that writes to the
+// sink pushes the records straight into it, so that the result of the first operator never has
+// to be written into a table and scanned again.
+//
+// An operator that cannot write any output until it has seen all of its input (an Aggregate, or
+// a SortMergeJoin) is a pipeline breaker: it keeps what it needs in anonymous pages (see
+// MyDB_TempTableReaderWriter) and writes its output from close ()
+class PipelineOp {
+
+public:
+
+	// gets ready for records to be pushed in; this is called before the first call to consume ()
+	virtual void open () = 0;
+
+	// pushes a batch of records into the operator.  Each is in the binary format of a record of
+	// the operator's input (see MyDB_Record.fromBinary ()), and is only good until consume ()
+	// returns.  The calls to consume () are never made by more than one thread at once
+	virtual void consume (void **recs, int numRecs) = 0;
+
+	// says that there are no more records; the operator writes whatever it has left to its
+	// output, and if the output is a PipelineSink, closes it
+	virtual void close () = 0;
+
+	virtual ~PipelineOp () {}
+};
+
+// This is a table that does not keep the records that are appended to it: it gathers them into a
+// page image, and each time the image fills up, the records on it are pushed into the
+// PipelineOp that reads from the table.  It is given as the output of one operator and as the
+// input of the next, and then pushInto () says which operator the records go to.  Nothing can be
+// read from the table itself; only its schema and buffer manager are used
+class PipelineSink;
+typedef shared_ptr <PipelineSink> PipelineSinkPtr;
+
+class PipelineSink : public MyDB_TableReaderWriter {
+
+public:
+
+	// makes a sink for records with the given schema
+	PipelineSink (MyDB_SchemaPtr mySchema, MyDB_BufferManagerPtr myBuffer);
+
+	// says which operator the records are pushed into; this is called before anything is appended
+	void pushInto (PipelineOp *consumer);
+
+	// these add records to the sink, just like with a MyDB_TableReaderWriter
+	void append (MyDB_RecordPtr appendMe);
+	void appendPageImage (void *page);
+
+	// pushes the records that are left, and closes the operator that they are pushed into
+	void close ();
+
+	// if the given table is a PipelineSink, closes it; an operator calls this once it has written
+	// all of its output
+	static void closeIfSink (MyDB_TableReaderWriterPtr output);
+
+private:
+
+	// pushes all of the records in a page image into the consumer, opening it first if need be
+	void push (void *page);
+
+	PipelineOp *consumer;
+	bool opened;
+	size_t pageSize;
+	vector <char> page;
+};
+
+#endif
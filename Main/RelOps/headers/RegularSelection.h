@@ -3,13 +3,18 @@
 #define REG_SELECTION_H
 
 #include "MyDB_TableReaderWriter.h"
+#include "PipelineOp.h"
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
-// this class encapsulates a simple, scan-based selection
+// this class encapsulates a simple, scan-based selection; the records can also be pushed into
+// it (see PipelineOp), in which case the output records are written as the records come in
 
-class RegularSelection {
+class MyDB_ConjunctFilter;
+
+class RegularSelection : public PipelineOp {
 
 public:
 	//
@@ -26,12 +31,30 @@ public:
 	// execute the selection operation
 	void run ();
 
+	// execute the selection operation as numThreads tasks on the shared MyDB_TaskScheduler, each one working on its own runs of
+	// pages (see ParallelSelection); if inOrder is true, then the output records are in the
+	// same order as with run ()
+	void run (int numThreads, bool inOrder);
+
+	// these push records from the input into the selection (see PipelineOp)
+	void open ();
+	void consume (void **recs, int numRecs);
+	void close ();
+
 private:
 
         MyDB_TableReaderWriterPtr input;
         MyDB_TableReaderWriterPtr output;
         string selectionPredicate;
         vector <string> projections;
+
+	// what open () sets up: the records, the compiled computations and predicate, and the
+	// prefilter that runs the simple parts of the predicate over a whole batch at once
+	MyDB_RecordPtr inputRec;
+	MyDB_RecordPtr outputRec;
+	vector <func> finalComputations;
+	func pred;
+	shared_ptr <MyDB_ConjunctFilter> prefilter;
 };
 
 #endif
@@ -3,6 +3,8 @@
 #define SCAN_JOIN_H
 
 #include "MyDB_TableReaderWriter.h"
+#include "PipelineOp.h"
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -12,7 +14,13 @@
 // too large to be stored in the buffer manager in its entirity, then the join
 // will fail.
 //
-class ScanJoin {
+// The records of the table that is scanned can also be pushed into the join (see PipelineOp):
+// if one of the inputs is a PipelineSink, then that one is always the one that is scanned, and
+// the other one is hashed by open ().  Output records are written as the records come in.
+//
+struct ScanJoinState;
+
+class ScanJoin : public PipelineOp {
 
 public:
 	// This creates a scan join of the tables maanged by leftInput and rightInput.
@@ -86,6 +94,15 @@ public:
 	// execute the join
 	void run ();
 
+	// these push records from the input that is scanned into the join (see PipelineOp)
+	void open ();
+	void consume (void **recs, int numRecs);
+	void close ();
+
+	// after run () (or open ()), a histogram of the lengths of the lists of records in the hash table that
+	// have the same hash value (see getChainHistogram () in MyDB_Hash.h)
+	vector <size_t> &getChainLengths ();
+
 private:
 
 	string finalSelectionPredicate;
@@ -97,6 +114,10 @@ private:
 	string leftSelectionPredicate;
 	string rightSelectionPredicate;
 	bool hadToSwapThem;
+	vector <size_t> chainLengths;
+
+	// the hash table, records and computations that are set up by open ()
+	shared_ptr <ScanJoinState> state;
 };
 
 #endif
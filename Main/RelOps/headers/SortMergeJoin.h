@@ -3,6 +3,8 @@
 #define SORT_JOIN_H
 
 #include "MyDB_TableReaderWriter.h"
+#include "MyDB_TempTableReaderWriter.h"
+#include "PipelineOp.h"
 #include <string>
 #include <utility>
 #include <vector>
@@ -10,7 +12,12 @@
 // This class encapulates a sort merge join.  This is to be used in the case that the
 // two input tables are too large to be stored in RAM.
 //
-class SortMergeJoin {
+// The records of one of the inputs can also be pushed into the join (see PipelineOp), if that
+// input is a PipelineSink.  Since both sides have to be sorted before anything can be merged,
+// the join is a pipeline breaker: the records that are pushed in are kept in a
+// MyDB_TempTableReaderWriter, and the join is run by close ().
+//
+class SortMergeJoin : public PipelineOp {
 
 public:
 	// This creates a sort merge join of the tables maanged by leftInput and rightInput.
@@ -42,8 +49,16 @@ public:
 	// execute the join
 	void run ();
 
+	// these push records from the input that is a PipelineSink into the join (see PipelineOp)
+	void open ();
+	void consume (void **recs, int numRecs);
+	void close ();
+
 private:
 
+	// sorts the two tables and merges them, writing the output
+	void merge ();
+
 	int runSize;
 	string finalSelectionPredicate;
 	pair <string, string> equalityCheck;
@@ -53,6 +68,11 @@ private:
 	MyDB_TableReaderWriterPtr rightTable;
 	string leftSelectionPredicate;
 	string rightSelectionPredicate;
+
+	// where the records that are pushed in are kept until close (), and which side they are for
+	MyDB_TempTableReaderWriterPtr pushed;
+	MyDB_RecordPtr pushedRec;
+	bool pushedIsLeft;
 };
 
 #endif
@@ -0,0 +1,90 @@
+
+#ifndef VECTOR_COMP_H
+#define VECTOR_COMP_H
+
+#include "ColumnBatch.h"
+#include "MyDB_ConjunctOrder.h"
+#include "MyDB_Expr.h"
+#include "MyDB_FilterKernels.h"
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+// create a smart pointer for vector computations
+class VectorComputation;
+typedef shared_ptr <VectorComputation> VectorComputationPtr;
+
+// This runs a computation (that has already been parsed and resolved into a MyDB_Expr) over
+// a ColumnBatch, rather than over one record at a time.  All of the work is done by loops
+// over the positions listed in a selection vector, so records that have already been
+// filtered out are never touched.  The semantics (including the promotion rules) are the
+// same as for a computation compiled with MyDB_Record.compileComputation ()
+class VectorComputation {
+
+public:
+
+	// build the computation; the expression must have been resolved
+	VectorComputation (MyDB_ExprPtr myExpr);
+
+	// computes the value for each of the n records whose positions are listed in sel; the
+	// result for the record at position sel[i] is found at position sel[i] of the returned
+	// vector (which is owned by this object and is overwritten on the next call)
+	ColumnVector *evaluate (ColumnBatch &batch, int *sel, int n);
+
+	// for a boolean computation, writes the positions from sel that are accepted into out,
+	// and returns how many there are.  The output is in the same order as the input, and
+	// out can be the same as sel
+	int filter (ColumnBatch &batch, int *sel, int n, int *out);
+
+	// the mode of the result
+	MyDB_ExprMode getMode ();
+
+	// for an and, this decides the order that filter () runs the conjuncts in (see
+	// MyDB_ConjunctOrder); for anything else, it is nullptr
+	MyDB_ConjunctOrderPtr getConjunctOrder ();
+
+private:
+
+	// returns in, converted to the given mode (using the scratch vector if needed)
+	ColumnVector *promote (ColumnVector *in, MyDB_ExprMode toMode, ColumnVector &scratch, int *sel, int n);
+
+	// runs one of the comparisons
+	int compare (ColumnBatch &batch, int *sel, int n, int *out);
+
+	// runs one of the arithmetic operations
+	void arithmetic (ColumnBatch &batch, int *sel, int n);
+
+	MyDB_ExprPtr myExpr;
+	VectorComputationPtr lhs;
+	VectorComputationPtr rhs;
+
+	// the result of evaluate (), and space for promoting the inputs
+	ColumnVector result;
+	ColumnVector lhsPromoted;
+	ColumnVector rhsPromoted;
+
+	// space for selection vectors used by the boolean operations
+	vector <int> selA;
+	vector <int> selB;
+	vector <int> accepted;
+
+	// for an and, the conjuncts (the children of the chain of && nodes), and their order
+	vector <VectorComputationPtr> conjuncts;
+	MyDB_ConjunctOrderPtr conjunctOrder;
+
+	// if this is an int or double attribute vs. a literal, then when the comparison is run over
+	// a whole batch, it is done using the kernels in MyDB_FilterKernels
+	bool useKernel;
+	int kernelAtt;
+	MyDB_ExprOp kernelCmp;
+	MyDB_ExprPtr kernelLiteral;
+	vector <uint64_t> bits;
+
+	// if this is an == or != between a dictionary-encoded attribute and a literal, then it is
+	// done by comparing the codes (in the column's ints) with the literal's code
+	bool onCodes;
+	int literalCode;
+};
+
+#endif
@@ -0,0 +1,101 @@
+
+#ifndef VEC_AGG_H
+#define VEC_AGG_H
+
+#include "Aggregate.h"
+#include "MyDB_ConjunctOrder.h"
+#include "MyDB_Expr.h"
+#include "MyDB_TableReaderWriter.h"
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// This computes the same thing as an Aggregate, but it works a batch of records at a time:
+// the predicate, the grouping computations and the aggregate computations are run over a
+// ColumnBatch using VectorComputation objects, and then the running aggregates are updated
+// one aggregate at a time with a tight loop over the accepted records.  The running
+// aggregates are kept in memory (as ints, doubles or scaled decimals, depending on the type
+// of the output attribute) rather than in aggregate records.
+//
+// If an aggregate cannot be done this way (for example, the output attribute is a string)
+// then this just runs a regular Aggregate.
+
+struct VectorAggPartial;
+
+class VectorizedAggregate {
+
+public:
+
+	// the parameters are the same as for an Aggregate
+	VectorizedAggregate (MyDB_TableReaderWriterPtr input, MyDB_TableReaderWriterPtr output,
+		vector <pair <MyDB_AggType, string>> aggsToCompute,
+		vector <string> groupings, string selectionPredicate);
+
+	// the same, but the computations have already been built (see MyDB_Expr), so nothing needs
+	// to be parsed; they are resolved against the input table's schema by run ().  The
+	// computation for a count is not used, and can be null
+	VectorizedAggregate (MyDB_TableReaderWriterPtr input, MyDB_TableReaderWriterPtr output,
+		vector <pair <MyDB_AggType, MyDB_ExprPtr>> aggsToCompute,
+		vector <MyDB_ExprPtr> groupings, MyDB_ExprPtr selectionPredicate);
+	
+	// execute the aggregation
+	void run ();
+
+	// execute the aggregation on numWorkers workers at once (see MorselExecutor); each worker
+	// aggregates the morsels that it takes into its own groups, and once all of the morsels
+	// have been taken, the groups are merged.  The groups come out in the same order as with
+	// run (), but since the values are added up in a different order, a double can differ in
+	// its last bits
+	void run (int numWorkers);
+
+	// after run (), the order that the conjuncts of the predicate ended up being run in, with
+	// the fraction of records accepted by each and its cost (see MyDB_ConjunctOrder); after
+	// run (numWorkers), the counts from all of the workers are put together.  This is empty if
+	// the predicate is not an and
+	string getConjunctOrder ();
+
+private:
+
+	// runs a regular Aggregate instead, for an aggregate that cannot be done a batch at a time
+	void runRegularAggregate ();
+
+	// makes sure that the output schema has the right number of attributes
+	bool checkOutputSchema ();
+
+	// resolves all of the computations, and figures out the attributes that are needed and how
+	// each aggregate is kept; returns false if a regular Aggregate is needed
+	bool setUp ();
+
+	// makes a set of groups, along with the computations for a pipeline that adds to them
+	shared_ptr <VectorAggPartial> makePartial ();
+
+	// runs the pipeline over the batch of records in the partial's columns; firstPos is the
+	// position in the input of the first one
+	void addBatch (VectorAggPartial &me, int numRecs, long long firstPos);
+
+	// adds a new, empty group to the partial, and returns its number
+	int addGroup (VectorAggPartial &me, string &key, long long firstSeen);
+
+	// adds all of the groups in from into into
+	void merge (VectorAggPartial &into, VectorAggPartial &from);
+
+	// appends the groups to the output, in the order that they were first seen
+	void writeOut (VectorAggPartial &me);
+
+	MyDB_TableReaderWriterPtr input;
+	MyDB_TableReaderWriterPtr output;
+	vector <pair <MyDB_AggType, MyDB_ExprPtr>> aggsToCompute;
+	vector <MyDB_ExprPtr> groupings;
+	MyDB_ExprPtr selectionPredicate;
+	MyDB_ConjunctOrderPtr conjunctOrder;
+
+	// set up by setUp ()
+	int numGroupAtts;
+	int numAggs;
+	vector <int> attsNeeded;
+	vector <bool> isIntAgg;
+	vector <int> decimalScale;
+};
+
+#endif
@@ -0,0 +1,72 @@
+
+#ifndef VEC_SELECTION_H
+#define VEC_SELECTION_H
+
+#include "MyDB_ConjunctOrder.h"
+#include "MyDB_Expr.h"
+#include "MyDB_TableReaderWriter.h"
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// This does exactly what a RegularSelection does, but rather than running the compiled
+// computations one record at a time, it decodes the attributes that are needed into a
+// ColumnBatch, and then runs the predicate and the projections using VectorComputation
+// objects, a whole batch at a time
+
+struct VectorSelectionPipeline;
+
+class VectorizedSelection {
+
+public:
+
+	// the parameters are the same as for a RegularSelection
+	VectorizedSelection (MyDB_TableReaderWriterPtr input, MyDB_TableReaderWriterPtr output,
+		string selectionPredicate, vector <string> projections);
+
+	// the same, but the computations have already been built (see MyDB_Expr), so nothing needs
+	// to be parsed; they are resolved against the input table's schema by run ()
+	VectorizedSelection (MyDB_TableReaderWriterPtr input, MyDB_TableReaderWriterPtr output,
+		MyDB_ExprPtr selectionPredicate, vector <MyDB_ExprPtr> projections);
+	
+	// execute the selection operation
+	void run ();
+
+	// execute the selection operation on numWorkers workers at once (see MorselExecutor); each
+	// worker writes the records that it accepts into its own page images, which are appended to
+	// the output in the order of the morsels that they came from, so the output records are in
+	// the same order as with run ()
+	void run (int numWorkers);
+
+	// after run (), the order that the conjuncts of the predicate ended up being run in, with
+	// the fraction of records accepted by each and its cost (see MyDB_ConjunctOrder); after
+	// run (numWorkers), the counts from all of the workers are put together.  This is empty if
+	// the predicate is not an and
+	string getConjunctOrder ();
+
+private:
+
+	// resolves all of the computations, and figures out which attributes are needed; returns
+	// false if the predicate is not boolean
+	bool setUp ();
+
+	// makes the computations for a pipeline
+	shared_ptr <VectorSelectionPipeline> makePipeline ();
+
+	// runs the predicate and then the projections over the batch of records in the pipeline's
+	// columns, and returns the number accepted, with their positions in selected
+	int selectBatch (VectorSelectionPipeline &me, int numRecs, int *selected);
+
+	// sets the pipeline's output record to the projections of the record at the given position
+	void writeRecord (VectorSelectionPipeline &me, int whichRec);
+
+	MyDB_TableReaderWriterPtr input;
+	MyDB_TableReaderWriterPtr output;
+	MyDB_ExprPtr selectionPredicate;
+	MyDB_ConjunctOrderPtr conjunctOrder;
+	vector <MyDB_ExprPtr> projections;
+	vector <int> attsNeeded;
+};
+
+#endif
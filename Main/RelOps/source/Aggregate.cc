@@ -2,6 +2,8 @@
 #ifndef AGG_CC
 #define AGG_CC
 
+#include "MyDB_Expr.h"
+#include "MyDB_Hash.h"
 #include "MyDB_Record.h"
 #include "MyDB_PageReaderWriter.h"
 #include "MyDB_TableReaderWriter.h"
@@ -14,27 +16,92 @@ Aggregate :: Aggregate (MyDB_TableReaderWriterPtr inputIn, MyDB_TableReaderWrite
                 vector <pair <MyDB_AggType, string>> aggsToComputeIn,
                 vector <string> groupingsIn, string selectionPredicateIn) {
 
+	input = inputIn;
+	output = outputIn;
+
+	// a count does not look at its computation, so it is not parsed
+	for (auto &a : aggsToComputeIn) {
+		MyDB_ExprPtr agg = (a.first == MyDB_AggType :: cntA) ? nullptr : MyDB_Expr :: parse (a.second);
+		aggsToCompute.push_back (make_pair (a.first, agg));
+	}
+	for (string &s : groupingsIn)
+		groupings.push_back (MyDB_Expr :: parse (s));
+	selectionPredicate = MyDB_Expr :: parse (selectionPredicateIn);
+}
+
+Aggregate :: Aggregate (MyDB_TableReaderWriterPtr inputIn, MyDB_TableReaderWriterPtr outputIn,
+                vector <pair <MyDB_AggType, MyDB_ExprPtr>> aggsToComputeIn,
+                vector <MyDB_ExprPtr> groupingsIn, MyDB_ExprPtr selectionPredicateIn) {
+
 	input = inputIn;
 	output = outputIn;
 	aggsToCompute = aggsToComputeIn;
 	groupings = groupingsIn;
 	selectionPredicate = selectionPredicateIn;
-
 }
 
+// everything that open () sets up, and that the records pushed into the aggregate are run through
+struct AggregateState {
+
+	int numGroups;
+
+	// the input record, the aggregate record, and the record that combines them
+	MyDB_RecordPtr inputRec;
+	MyDB_RecordPtr aggRec;
+	MyDB_RecordPtr combinedRec;
+
+	// this is the current page where we are writing aggregate records, and the list of all of
+	// the pages used to store aggregate records
+	MyDB_PageReaderWriter lastPage;
+	vector <MyDB_PageReaderWriter> allPages;
+
+	// this is the hash index for all of the aggregate records
+	unordered_map <size_t, vector <void *>> myHash;
+
+	// the groupings, the check that the groupings match an aggregate record, the update of each
+	// of the aggregates (followed by the count), the selection predicate, and what computes the
+	// final value of each aggregate
+	vector <func> groupingComps;
+	func checkGroups;
+	vector <func> aggComps;
+	func inputPred;
+	vector <func> finalAggComps;
+
+	MyDB_AttValPtr zero;
+};
+
 void Aggregate :: run () {
 
+	open ();
+	if (state != nullptr) {
+		void *batch[MAX_BATCH_SIZE];
+		MyDB_RecordIteratorAltPtr myIter = input->getIteratorAlt (input->getPageFilter (selectionPredicate));
+		int numRecs;
+		while ((numRecs = myIter->getBatch (batch, MAX_BATCH_SIZE)) > 0)
+			consume (batch, numRecs);
+	}
+	close ();
+}
+
+void Aggregate :: open () {
+
+	state = nullptr;
+
 	// make sure that the number of attributes is OK
 	if (output->getTable ()->getSchema ()->getAtts ().size () != aggsToCompute.size () + groupings.size ()) {
 		cout << "error, the output schema needs to have the same number of atts as (# of aggs to compute + # groups).\n";
 		return;
 	}
 
+	state = make_shared <AggregateState> ();
+	AggregateState &me = *state;
+
 	// first, we create a schema for the aggregate records... this is all grouping atts,
 	// followed by all aggregate atts, followed by the count att
 	MyDB_SchemaPtr aggSchema = make_shared <MyDB_Schema> ();
 	int i = 0;
 	int numGroups = groupings.size ();
+	me.numGroups = numGroups;
 	for (auto &a : output->getTable ()->getSchema ()->getAtts ()) {
 		if (i < numGroups) 
 			aggSchema->appendAtt (make_pair ("MyDB_GroupAtt" + to_string (i++), a.second));
@@ -51,102 +118,93 @@ void Aggregate :: run () {
 		combinedSchema->appendAtt (a);
 
 	// now, get an intput rec, an agg rec, and a combined rec
-	MyDB_RecordPtr inputRec = input->getEmptyRecord ();
-	MyDB_RecordPtr aggRec = make_shared <MyDB_Record> (aggSchema);
-	MyDB_RecordPtr combinedRec = make_shared <MyDB_Record> (combinedSchema);
-	combinedRec->buildFrom (inputRec, aggRec);
+	me.inputRec = input->getEmptyRecord ();
+	me.aggRec = make_shared <MyDB_Record> (aggSchema);
+	me.combinedRec = make_shared <MyDB_Record> (combinedSchema);
+	me.combinedRec->buildFrom (me.inputRec, me.aggRec);
 	
-	// this is the current page where we are writing aggregate records
-	MyDB_PageReaderWriter lastPage (true, *(input->getBufferMgr ()));
-
-	// this is the list all of the pages used to store aggregate records
-	vector <MyDB_PageReaderWriter> allPages;
-	allPages.push_back (lastPage);
-
-	// this is the hash index for all of the aggregate records
-	unordered_map <size_t, vector <void *>> myHash;
+	// the aggregate records are written to anonymous pages
+	me.lastPage = MyDB_PageReaderWriter (true, *(input->getBufferMgr ()));
+	me.allPages.push_back (me.lastPage);
 
-	// this will compute each of the groupings
-	vector <func> groupingComps;
-	for (auto &s : groupings) {
-		groupingComps.push_back (inputRec->compileComputation (s));
-	}
-
-	// and this will verify that each of the groupings match up
-	func checkGroups;
-	string groupCheck;
-	i = 0;
+	// everything that is run over each input record is compiled together over the combined
+	// record, so that any subexpression that they have in common is only computed once; these
+	// are the groupings, the check that the groupings match an aggregate record, the update of
+	// each of the aggregates (followed by the count), and the selection predicate
+	vector <MyDB_ExprPtr> computations = groupings;
 
 	// in case there is not a grouping...
-	groupCheck = "bool[true]";
+	MyDB_ExprPtr groupCheck = MyDB_Expr :: boolLiteral (true);
 
-	for (auto &s : groupings) {
-		string curClause = "== (" + s + ", [MyDB_GroupAtt" + to_string (i) + "])";
+	i = 0;
+	for (auto &g : groupings) {
+		MyDB_ExprPtr curClause = make_shared <MyDB_Expr> (eqOp, g, MyDB_Expr :: attribute ("MyDB_GroupAtt" + to_string (i)));
 		if (i == 0) {
 			groupCheck = curClause;
 		} else {
-			groupCheck = "&& (" + curClause + ", " + groupCheck + ")";
+			groupCheck = make_shared <MyDB_Expr> (andOp, curClause, groupCheck);
 		}
 		i++;
 	}
-	checkGroups = combinedRec->compileComputation (groupCheck);	
-
-	// this will compute each of the aggregates for updating the aggregate record
-	vector <func> aggComps;
-
-	// this will compute the final aggregate value for each output record
-	vector <func> finalAggComps;
+	computations.push_back (groupCheck);
 
 	i = 0;
 	for (auto &s : aggsToCompute) {
+		MyDB_ExprPtr aggAtt = MyDB_Expr :: attribute ("MyDB_AggAtt" + to_string (i));
 		if (s.first == MyDB_AggType :: sumA || s.first == MyDB_AggType :: avgA) {
-			aggComps.push_back (combinedRec->compileComputation ("+ (" + s.second + 
-				", [MyDB_AggAtt" + to_string (i) + "])"));
+			computations.push_back (make_shared <MyDB_Expr> (plusOp, s.second, aggAtt));
 		} else if (s.first == MyDB_AggType :: cntA) {
-			aggComps.push_back (combinedRec->compileComputation ("+ ( int[1], [MyDB_AggAtt"
-				+ to_string (i) + "])"));
+			computations.push_back (make_shared <MyDB_Expr> (plusOp, MyDB_Expr :: intLiteral (1), aggAtt));
 		}
 
 		if (s.first == MyDB_AggType :: avgA) {
-			finalAggComps.push_back (combinedRec->compileComputation ("/ ([MyDB_AggAtt" + to_string (i++) + "], [MyDB_CntAtt])"));
+			me.finalAggComps.push_back (me.combinedRec->compileComputation ("/ ([MyDB_AggAtt" + to_string (i++) + "], [MyDB_CntAtt])"));
 		} else {
-			finalAggComps.push_back (combinedRec->compileComputation ("[MyDB_AggAtt" + to_string (i++) + "]"));
+			me.finalAggComps.push_back (me.combinedRec->compileComputation ("[MyDB_AggAtt" + to_string (i++) + "]"));
 		}
 	}
-	aggComps.push_back (combinedRec->compileComputation ("+ ( int[1], [MyDB_CntAtt])"));
+	computations.push_back (make_shared <MyDB_Expr> (plusOp, MyDB_Expr :: intLiteral (1), MyDB_Expr :: attribute ("MyDB_CntAtt")));
+	computations.push_back (selectionPredicate);
+
+	vector <func> compiled = me.combinedRec->compileExprs (computations);
+	me.groupingComps = vector <func> (compiled.begin (), compiled.begin () + numGroups);
+	me.checkGroups = compiled[numGroups];
+	me.aggComps = vector <func> (compiled.begin () + numGroups + 1, compiled.end () - 1);
+	me.inputPred = compiled.back ();
+	me.zero = make_shared <MyDB_IntAttVal> ();
+}
 
-	// and this runs the selection on the input records
-	func inputPred = inputRec->compileComputation (selectionPredicate);
+void Aggregate :: consume (void **batch, int numRecs) {
 
-	// at this point, we are ready to go!!
-	MyDB_RecordIteratorPtr myIter = input->getIterator (inputRec);
-	MyDB_AttValPtr zero = make_shared <MyDB_IntAttVal> ();
-	while (myIter->hasNext ()) {
+	if (state == nullptr)
+		return;
+	AggregateState &me = *state;
+	int numGroups = me.numGroups;
+	int i;
+
+	for (int r = 0; r < numRecs; r++) {
 
-		myIter->getNext ();
+		me.inputRec->fromBinary (batch[r]);
 
 		// see if it is accepted by the preicate
-		if (!inputPred ()->toBool ()) {
+		if (!me.inputPred ()->toBool ()) {
 			continue;
 		}
 
 		// hash the current record
-		size_t hashVal = 0;
-		for (auto &f : groupingComps) {
-			hashVal ^= f ()->hash ();
-		}
+		size_t hashVal = MyDB_Record :: hashKeys (me.groupingComps);
 
 		// if there is a match, then get the list of matches
-		vector <void *> &potentialMatches = myHash [hashVal];
+		vector <void *> &potentialMatches = me.myHash [hashVal];
 		void *loc = nullptr;
 
 		// and iterate though the potential matches, checking each of them
 		for (auto &v : potentialMatches) {	
 
-			aggRec->fromBinary (v);
+			me.aggRec->fromBinary (v);
 
 			// check to see if it matches
-			if (!checkGroups ()->toBool ()) {
+			if (!me.checkGroups ()->toBool ()) {
 				continue;
 			}
 
@@ -159,63 +217,91 @@ void Aggregate :: run () {
 
 			// set up the record...
 			i = 0;
-			for (auto &f : groupingComps) {
-				aggRec->getAtt (i++)->set (f ());
+			for (auto &f : me.groupingComps) {
+				me.aggRec->getAtt (i++)->set (f ());
 			}
-			for (int j = 0; j < aggComps.size (); j++) {
-				aggRec->getAtt (i++)->set (zero);
+			for (size_t j = 0; j < me.aggComps.size (); j++) {
+				me.aggRec->getAtt (i++)->set (me.zero);
 			}
+			me.aggRec->recordContentHasChanged ();
 		}
 
 		// update each of the aggregates
 		i = 0;
-		for (auto &f : aggComps) {
-			aggRec->getAtt (numGroups + i++)->set (f ());
+		for (auto &f : me.aggComps) {
+			me.aggRec->getAtt (numGroups + i++)->set (f ());
 		}
 
 		// if we did not find a match, write to a new location...
-		aggRec->recordContentHasChanged ();
+		me.aggRec->recordContentHasChanged ();
 		if (loc == nullptr) {
-			loc = lastPage.appendAndReturnLocation (aggRec);
+			loc = me.lastPage.appendAndReturnLocation (me.aggRec);
 
 			// if we could not write, then the page was full
 			if (loc == nullptr) {
 				MyDB_PageReaderWriter nextPage (true, *(input->getBufferMgr ()));
-				lastPage = nextPage;
-				allPages.push_back (lastPage);
-				loc = lastPage.appendAndReturnLocation (aggRec);	
+				me.lastPage = nextPage;
+				me.allPages.push_back (me.lastPage);
+				loc = me.lastPage.appendAndReturnLocation (me.aggRec);	
 			}
 
-			aggRec->fromBinary (loc);
-			myHash [hashVal].push_back (loc);
+			me.aggRec->fromBinary (loc);
+			me.myHash [hashVal].push_back (loc);
 
 		// otherwise, re-write to the old location
 		} else {
-			aggRec->toBinary (loc);
+			me.aggRec->toBinary (loc);
 		}
 	}
+}
+
+void Aggregate :: close () {
+
+	if (state == nullptr) {
+		PipelineSink :: closeIfSink (output);
+		return;
+	}
+	AggregateState &me = *state;
+	int numGroups = me.numGroups;
+	chainLengths = getChainHistogram (me.myHash);
 
 	// now, we have processed all of the database records... so we can output the aggregates
-	MyDB_RecordIteratorAltPtr myIterAgain = getIteratorAlt (allPages);	
+	void *batch[MAX_BATCH_SIZE];
+	MyDB_RecordIteratorAltPtr myIterAgain = getIteratorAlt (me.allPages);	
 
 	// loop through all of the aggregate records
 	MyDB_RecordPtr outRec = output->getEmptyRecord ();
-	while (myIterAgain->advance ()) {
+	int numRecs;
+	while ((numRecs = myIterAgain->getBatch (batch, MAX_BATCH_SIZE)) > 0) {
 
-		myIterAgain->getCurrent (aggRec);
+		for (int r = 0; r < numRecs; r++) {
 
-		// set the grouping atts
-		for (i = 0; i < numGroups; i++) {
-			outRec->getAtt (i)->set (aggRec->getAtt (i));
-		}
+			me.aggRec->fromBinary (batch[r]);
+
+			// set the grouping atts
+			int i;
+			for (i = 0; i < numGroups; i++) {
+				outRec->getAtt (i)->set (me.aggRec->getAtt (i));
+			}
 
-		// set the aggregate atts
-		for (auto &a : finalAggComps) {
-			outRec->getAtt (i++)->set (a ());
+			// set the aggregate atts
+			for (auto &a : me.finalAggComps) {
+				outRec->getAtt (i++)->set (a ());
+			}
+			outRec->recordContentHasChanged ();
+			output->append (outRec);
 		}
-		outRec->recordContentHasChanged ();
-		output->append (outRec);
 	}
+
+	// the pages holding the aggregate records are let go of before the output is closed, since
+	// whatever the output is pushed into may need them
+	myIterAgain = nullptr;
+	state = nullptr;
+	PipelineSink :: closeIfSink (output);
+}
+
+vector <size_t> &Aggregate :: getChainLengths () {
+	return chainLengths;
 }
 
 #endif
@@ -3,6 +3,7 @@
 #define BPLUS_SELECTION_C
 
 #include "BPlusSelection.h"
+#include "ParallelSelection.h"
 
 BPlusSelection :: BPlusSelection (MyDB_BPlusTreeReaderWriterPtr inputIn, MyDB_TableReaderWriterPtr outputIn,
                 MyDB_AttValPtr lowIn, MyDB_AttValPtr highIn,
@@ -21,33 +22,49 @@ void BPlusSelection :: run () {
 	MyDB_RecordPtr inputRec = input->getEmptyRecord ();
 	MyDB_RecordPtr outputRec = output->getEmptyRecord ();
 	
-	// compile all of the coputations that we need here
-	vector <func> finalComputations;
-	for (string s : projections) {
-		finalComputations.push_back (inputRec->compileComputation (s));
-	}
-	func pred = inputRec->compileComputation (selectionPredicate);
+	// compile all of the coputations that we need here, all at once so that they share work
+	vector <string> computations = projections;
+	computations.push_back (selectionPredicate);
+	vector <func> finalComputations = inputRec->compileComputations (computations);
+	func pred = finalComputations.back ();
+	finalComputations.pop_back ();
 
-	// now, iterate through the B+-tree query results
+	// now, iterate through the B+-tree query results, a batch of records at a time
+	void *batch[MAX_BATCH_SIZE];
 	MyDB_RecordIteratorAltPtr myIter = input->getRangeIteratorAlt (low, high);
-	while (myIter->advance ()) {
+	int numRecs;
+	while ((numRecs = myIter->getBatch (batch, MAX_BATCH_SIZE)) > 0) {
 
-		myIter->getCurrent (inputRec);
+		for (int j = 0; j < numRecs; j++) {
 
-		// see if it is accepted by the predicate
-		if (!pred()->toBool ()) {
-			continue;
-		}
+			inputRec->fromBinary (batch[j]);
 
-		// run all of the computations
-		int i = 0;
-		for (auto &f : finalComputations) {
-			outputRec->getAtt (i++)->set (f());
-		}
+			// see if it is accepted by the predicate
+			if (!pred()->toBool ()) {
+				continue;
+			}
+
+			// run all of the computations
+			int i = 0;
+			for (auto &f : finalComputations) {
+				outputRec->getAtt (i++)->set (f());
+			}
 
-		outputRec->recordContentHasChanged ();
-		output->append (outputRec);
+			outputRec->recordContentHasChanged ();
+			output->append (outputRec);
+		}
 	}
 }
 
+void BPlusSelection :: run (int numThreads, bool inOrder) {
+
+	// each worker checks that its records are in the range, since the pages may hold others
+	vector <MyDB_PageReaderWriter> pages = input->getRangePages (low, high);
+	MyDB_BPlusTreeReaderWriterPtr tree = input;
+	MyDB_AttValPtr lowKey = low, highKey = high;
+	ParallelSelection parallel (input, output, selectionPredicate, projections,
+		[tree, lowKey, highKey] (MyDB_RecordPtr checkMe) {return tree->getRangeCheck (checkMe, lowKey, highKey);});
+	parallel.run (pages, numThreads, inOrder);
+}
+
 #endif
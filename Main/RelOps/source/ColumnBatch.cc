@@ -0,0 +1,208 @@
+
+#ifndef COLUMN_BATCH_C
+#define COLUMN_BATCH_C
+
+#include "ColumnBatch.h"
+#include <string.h>
+
+void ColumnVector :: setUp (MyDB_ExprMode modeIn, bool isConstantIn, int scaleIn) {
+
+	mode = modeIn;
+	isConstant = isConstantIn;
+	scale = scaleIn;
+	isDate = false;
+	dictionary = nullptr;
+	overflowFile = nullptr;
+	int size = isConstant ? 1 : MAX_BATCH_SIZE;
+	if (mode == intMode) {
+		ints.resize (size);
+		scratch = make_shared <MyDB_IntAttVal> ();
+		dateScratch = make_shared <MyDB_DateAttVal> ();
+	} else if (mode == doubleMode) {
+		doubles.resize (size);
+		scratch = make_shared <MyDB_DoubleAttVal> ();
+	} else if (mode == decimalMode) {
+		longs.resize (size);
+		scratch = make_shared <MyDB_DecimalAttVal> (MAX_DECIMAL_PRECISION, scale);
+	} else if (mode == stringMode) {
+		strings.resize (size);
+		stringStore.resize (size);
+		scratch = make_shared <MyDB_StringAttVal> ();
+	} else {
+		bools.resize (size);
+		scratch = make_shared <MyDB_BoolAttVal> ();
+	}
+}
+
+void ColumnVector :: writeInto (int i, MyDB_AttValPtr &intoMe) {
+
+	i = pos (i);
+	if (mode == intMode && isDate) {
+		dateScratch->set (ints[i]);
+		intoMe->set (dateScratch);
+		return;
+	} else if (mode == intMode) {
+		static_pointer_cast <MyDB_IntAttVal> (scratch)->set (ints[i]);
+	} else if (mode == doubleMode) {
+		static_pointer_cast <MyDB_DoubleAttVal> (scratch)->set (doubles[i]);
+	} else if (mode == decimalMode) {
+		static_pointer_cast <MyDB_DecimalAttVal> (scratch)->setScaled (longs[i]);
+	} else if (mode == stringMode) {
+		static_pointer_cast <MyDB_StringAttVal> (scratch)->set (strings[i]);
+	} else {
+		static_pointer_cast <MyDB_BoolAttVal> (scratch)->set (bools[i] != 0);
+	}
+	intoMe->set (scratch);
+}
+
+void ColumnVector :: appendKey (int i, string &toMe) {
+
+	i = pos (i);
+	if (mode == intMode) {
+		toMe.append ((char *) &ints[i], sizeof (int));
+	} else if (mode == doubleMode) {
+		toMe.append ((char *) &doubles[i], sizeof (double));
+	} else if (mode == decimalMode) {
+		toMe.append ((char *) &longs[i], sizeof (long long));
+	} else if (dictionary != nullptr) {
+		toMe.append ((char *) &ints[i], sizeof (int));
+	} else if (mode == stringMode) {
+		toMe.append (strings[i], strlen (strings[i]) + 1);
+	} else {
+		toMe.push_back (bools[i]);
+	}
+}
+
+ColumnBatch :: ColumnBatch (MyDB_SchemaPtr mySchema, vector <int> &attsNeeded) {
+
+	auto &atts = mySchema->getAtts ();
+	slotForAtt.resize (atts.size (), -1);
+	columns.resize (attsNeeded.size ());
+	lastAttNeeded = -1;
+	numRecs = 0;
+
+	int slot = 0;
+	for (int whichAtt : attsNeeded) {
+
+		// figure out the mode that we decode into, just like MyDB_Expr does for attributes
+		MyDB_AttTypePtr type = atts[whichAtt].second;
+		MyDB_DecimalAttTypePtr decimalType = dynamic_pointer_cast <MyDB_DecimalAttType> (type);
+		MyDB_ExprMode mode;
+		if (type->isBool ())
+			mode = boolMode;
+		else if (type->promotableToInt ())
+			mode = intMode;
+		else if (decimalType != nullptr)
+			mode = decimalMode;
+		else if (type->promotableToDouble ())
+			mode = doubleMode;
+		else
+			mode = stringMode;
+
+		columns[slot].setUp (mode, false, decimalType == nullptr ? 0 : decimalType->getScale ());
+		columns[slot].isDate = type->isDate ();
+		MyDB_DictStringAttTypePtr dictType = dynamic_pointer_cast <MyDB_DictStringAttType> (type);
+		if (dictType != nullptr) {
+			columns[slot].dictionary = dictType->getDictionary ();
+			columns[slot].ints.resize (MAX_BATCH_SIZE);
+		}
+		MyDB_OverflowAttTypePtr overflowType = dynamic_pointer_cast <MyDB_OverflowAttType> (type);
+		if (overflowType != nullptr)
+			columns[slot].overflowFile = overflowType->getOverflowFile ();
+		slotForAtt[whichAtt] = slot++;
+		if (whichAtt > lastAttNeeded)
+			lastAttNeeded = whichAtt;
+	}
+
+	if (lastAttNeeded != -1 && mySchema->getFixedOffset (lastAttNeeded) != -1) {
+		offsetForSlot.resize (columns.size ());
+		for (int whichAtt = 0; whichAtt <= lastAttNeeded; whichAtt++)
+			if (slotForAtt[whichAtt] != -1)
+				offsetForSlot[slotForAtt[whichAtt]] = mySchema->getFixedOffset (whichAtt);
+	}
+
+	for (int whichAtt = 0; whichAtt <= lastAttNeeded; whichAtt++)
+		if (slotForAtt[whichAtt] != -1)
+			attsInOrder.push_back (whichAtt);
+	valueStore.resize (attsInOrder.size (), vector <void *> (MAX_BATCH_SIZE));
+	for (auto &v : valueStore)
+		values.push_back (v.data ());
+
+	allRows.resize (MAX_BATCH_SIZE);
+	for (int i = 0; i < MAX_BATCH_SIZE; i++)
+		allRows[i] = i;
+}
+
+void ColumnBatch :: decode (ColumnVector &col, int i, char *data) {
+	if (col.mode == intMode)
+		memcpy (&col.ints[i], data, sizeof (int));
+	else if (col.mode == doubleMode)
+		memcpy (&col.doubles[i], data, sizeof (double));
+	else if (col.mode == decimalMode)
+		memcpy (&col.longs[i], data, sizeof (long long));
+	else if (col.dictionary != nullptr) {
+		col.ints[i] = *((unsigned short *) data);
+		col.strings[i] = col.dictionary->decode (col.ints[i]).c_str ();
+	} else if (col.overflowFile != nullptr) {
+		long long pos;
+		memcpy (&pos, data, sizeof (long long));
+		col.overflowFile->get (pos, col.stringStore[i]);
+		col.strings[i] = col.stringStore[i].c_str ();
+	} else if (col.mode == stringMode)
+		col.strings[i] = data;
+	else
+		col.bools[i] = (*data == 1);
+}
+
+void ColumnBatch :: load (void **recs, int numRecsIn) {
+
+	numRecs = numRecsIn;
+
+	// if the attributes are always in the same place, go right to them, a column at a time
+	if (offsetForSlot.size () > 0) {
+		for (int slot = 0; slot < (int) columns.size (); slot++) {
+			int offset = offsetForSlot[slot] + sizeof (short);
+			for (int i = 0; i < numRecs; i++)
+				decode (columns[slot], i, ((char *) recs[i]) + offset);
+		}
+		return;
+	}
+
+	for (int i = 0; i < numRecs; i++) {
+
+		// skip the record size, then walk through the attributes; each one starts
+		// with its own size, so we can hop over the ones that we do not need
+		char *pos = ((char *) recs[i]) + sizeof (short);
+		for (int whichAtt = 0; whichAtt <= lastAttNeeded; whichAtt++) {
+			int slot = slotForAtt[whichAtt];
+			if (slot != -1)
+				decode (columns[slot], i, pos + sizeof (short));
+			pos += *((short *) pos);
+		}
+	}
+}
+
+int ColumnBatch :: load (MyDB_RecordIteratorAltPtr fromMe) {
+
+	numRecs = fromMe->getColumnBatch (attsInOrder, values, MAX_BATCH_SIZE);
+	for (size_t k = 0; k < attsInOrder.size (); k++) {
+		ColumnVector &col = columns[slotForAtt[attsInOrder[k]]];
+		for (int i = 0; i < numRecs; i++)
+			decode (col, i, (char *) values[k][i]);
+	}
+	return numRecs;
+}
+
+ColumnVector *ColumnBatch :: getColumn (int whichAtt) {
+	return &columns[slotForAtt[whichAtt]];
+}
+
+int ColumnBatch :: getNumRecs () {
+	return numRecs;
+}
+
+int *ColumnBatch :: getAllRows () {
+	return allRows.data ();
+}
+
+#endif
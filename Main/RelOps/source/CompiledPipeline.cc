@@ -0,0 +1,550 @@
+
+#ifndef COMPILED_PIPELINE_C
+#define COMPILED_PIPELINE_C
+
+#include "CompiledPipeline.h"
+#include "MyDB_RecordIteratorAlt.h"
+#include <cmath>
+#include <dlfcn.h>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+
+using namespace std;
+
+// the entry points exported by the generated code
+typedef void (*EmitFunc) (void *, char *);
+typedef void *(*OpenFunc) ();
+typedef void (*ConsumeFunc) (void *, void **, int, EmitFunc, void *);
+typedef void (*CloseFunc) (void *, EmitFunc, void *);
+
+// where the generated code is kept, and the shared objects that have already been loaded
+static string cacheDir = "codegen";
+static unordered_map <string, void *> loadedPipelines;
+
+// this is at the start of every generated file
+static const char *prelude =
+	"#include <string.h>\n"
+	"#include <string>\n"
+	"#include <unordered_map>\n"
+	"#include <vector>\n"
+	"\n"
+	"typedef void (*EmitFunc) (void *, char *);\n"
+	"\n"
+	"static inline const char *cs (const char *s) {return s;}\n"
+	"static inline const char *cs (const std::string &s) {return s.c_str ();}\n"
+	"\n"
+	"static inline void putInt (std::string &out, int v) {\n"
+	"\tshort len = sizeof (short) + sizeof (int);\n"
+	"\tout.append ((char *) &len, sizeof (short));\n"
+	"\tout.append ((char *) &v, sizeof (int));\n"
+	"}\n"
+	"\n"
+	"static inline void putDouble (std::string &out, double v) {\n"
+	"\tshort len = sizeof (short) + sizeof (double);\n"
+	"\tout.append ((char *) &len, sizeof (short));\n"
+	"\tout.append ((char *) &v, sizeof (double));\n"
+	"}\n"
+	"\n"
+	"static inline void putString (std::string &out, const char *v) {\n"
+	"\tshort len = sizeof (short) + strlen (v) + 1;\n"
+	"\tout.append ((char *) &len, sizeof (short));\n"
+	"\tout.append (v, strlen (v) + 1);\n"
+	"}\n"
+	"\n"
+	"static inline void putBool (std::string &out, bool v) {\n"
+	"\tshort len = sizeof (short) + sizeof (char);\n"
+	"\tout.append ((char *) &len, sizeof (short));\n"
+	"\tout.push_back (v ? 1 : 0);\n"
+	"}\n"
+	"\n"
+	"static inline void keyInt (std::string &key, int v) {key.append ((char *) &v, sizeof (int));}\n"
+	"static inline void keyDouble (std::string &key, double v) {key.append ((char *) &v, sizeof (double));}\n"
+	"static inline void keyString (std::string &key, const char *v) {key.append (v, strlen (v) + 1);}\n"
+	"static inline void keyBool (std::string &key, bool v) {key.push_back (v ? 1 : 0);}\n"
+	"\n"
+	"// fills in the record size, and sends the record back to the database\n"
+	"static inline void emitRecord (std::string &out, EmitFunc emit, void *emitArg) {\n"
+	"\tshort len = out.size ();\n"
+	"\tmemcpy (&out[0], &len, sizeof (short));\n"
+	"\temit (emitArg, &out[0]);\n"
+	"}\n"
+	"\n";
+
+// the mode that values of the given type are handled in, just like MyDB_Expr does for attributes
+static MyDB_ExprMode modeForType (MyDB_AttTypePtr type) {
+	if (type->isBool ())
+		return boolMode;
+	else if (type->promotableToInt ())
+		return intMode;
+	else if (type->promotableToDouble ())
+		return doubleMode;
+	else
+		return stringMode;
+}
+
+// the mode of the value that is produced by the node
+static MyDB_ExprMode resultMode (MyDB_ExprPtr e) {
+	if (e->getType ()->isBool ())
+		return boolMode;
+	return e->getMode ();
+}
+
+// true if the value produced by the node is a date that would have to be turned into a string;
+// the generated code does not know how to write out a date, so the pipeline is not compiled
+static bool isDateAsString (MyDB_ExprPtr e, MyDB_ExprMode toMode) {
+	return e->getType ()->isDate () && toMode == stringMode;
+}
+
+CompiledPipeline :: CompiledPipeline (MyDB_TableReaderWriterPtr inputIn, MyDB_TableReaderWriterPtr outputIn,
+	string selectionPredicateIn, vector <string> projectionsIn) {
+
+	input = inputIn;
+	output = outputIn;
+	selectionPredicate = MyDB_Expr :: parse (selectionPredicateIn);
+	for (string &s : projectionsIn)
+		projections.push_back (MyDB_Expr :: parse (s));
+	isAgg = false;
+}
+
+CompiledPipeline :: CompiledPipeline (MyDB_TableReaderWriterPtr inputIn, MyDB_TableReaderWriterPtr outputIn,
+	vector <pair <MyDB_AggType, string>> aggsToComputeIn,
+	vector <string> groupingsIn, string selectionPredicateIn) {
+
+	input = inputIn;
+	output = outputIn;
+
+	// a count does not look at its computation, so it is not parsed
+	for (auto &a : aggsToComputeIn) {
+		MyDB_ExprPtr agg = (a.first == MyDB_AggType :: cntA) ? nullptr : MyDB_Expr :: parse (a.second);
+		aggsToCompute.push_back (make_pair (a.first, agg));
+	}
+	for (string &s : groupingsIn)
+		groupings.push_back (MyDB_Expr :: parse (s));
+	selectionPredicate = MyDB_Expr :: parse (selectionPredicateIn);
+	isAgg = true;
+}
+
+CompiledPipeline :: CompiledPipeline (MyDB_TableReaderWriterPtr inputIn, MyDB_TableReaderWriterPtr outputIn,
+	MyDB_ExprPtr selectionPredicateIn, vector <MyDB_ExprPtr> projectionsIn) {
+
+	input = inputIn;
+	output = outputIn;
+	selectionPredicate = selectionPredicateIn;
+	projections = projectionsIn;
+	isAgg = false;
+}
+
+CompiledPipeline :: CompiledPipeline (MyDB_TableReaderWriterPtr inputIn, MyDB_TableReaderWriterPtr outputIn,
+	vector <pair <MyDB_AggType, MyDB_ExprPtr>> aggsToComputeIn,
+	vector <MyDB_ExprPtr> groupingsIn, MyDB_ExprPtr selectionPredicateIn) {
+
+	input = inputIn;
+	output = outputIn;
+	aggsToCompute = aggsToComputeIn;
+	groupings = groupingsIn;
+	selectionPredicate = selectionPredicateIn;
+	isAgg = true;
+}
+
+void CompiledPipeline :: setCacheDir (string dir) {
+	cacheDir = dir;
+}
+
+bool CompiledPipeline :: run () {
+
+	string code;
+	if (!generate (code))
+		return false;
+
+	void *handle = load (code);
+	if (handle == nullptr)
+		return false;
+
+	OpenFunc openPipeline = (OpenFunc) dlsym (handle, "pipelineOpen");
+	ConsumeFunc consume = (ConsumeFunc) dlsym (handle, "pipelineConsume");
+	CloseFunc closePipeline = (CloseFunc) dlsym (handle, "pipelineClose");
+	if (openPipeline == nullptr || consume == nullptr || closePipeline == nullptr) {
+		cout << "the compiled pipeline is missing an entry point.\n";
+		return false;
+	}
+
+	// now just hand the records to the compiled code, a batch at a time
+	outRec = output->getEmptyRecord ();
+	void *state = openPipeline ();
+	void *batch[MAX_BATCH_SIZE];
+	MyDB_RecordIteratorAltPtr myIter = input->getIteratorAlt (input->getPageFilter (selectionPredicate));
+	int numRecs;
+	while ((numRecs = myIter->getBatch (batch, MAX_BATCH_SIZE)) > 0)
+		consume (state, batch, numRecs, emitRecord, this);
+	closePipeline (state, emitRecord, this);
+	return true;
+}
+
+void CompiledPipeline :: emitRecord (void *meIn, char *rec) {
+	CompiledPipeline *me = (CompiledPipeline *) meIn;
+	me->outRec->fromBinary (rec);
+	me->output->append (me->outRec);
+}
+
+string CompiledPipeline :: generateDecode (vector <int> &attsNeeded) {
+
+	vector <bool> needed;
+	for (int whichAtt : attsNeeded) {
+		if (whichAtt >= (int) needed.size ())
+			needed.resize (whichAtt + 1, false);
+		needed[whichAtt] = true;
+	}
+
+	// each attribute starts with its own size, so we hop over the ones that we do not need;
+	// if all of the attributes before one always take up the same space, we go right to it
+	MyDB_SchemaPtr inputSchema = input->getTable ()->getSchema ();
+	auto &atts = inputSchema->getAtts ();
+	string code = "\t\tchar *pos = ((char *) recs[i]) + sizeof (short);\n";
+	for (int whichAtt = 0; whichAtt < (int) needed.size (); whichAtt++) {
+		if (needed[whichAtt]) {
+			string name = "att" + to_string (whichAtt);
+			MyDB_ExprMode mode = modeForType (atts[whichAtt].second);
+
+			// the generated code cannot get at a dictionary or an overflow file, so dictionary-encoded
+			// and out-of-line strings are not supported; and it has no scaled arithmetic, so
+			// neither are decimals
+			if (dynamic_pointer_cast <MyDB_DictStringAttType> (atts[whichAtt].second) != nullptr ||
+				dynamic_pointer_cast <MyDB_OverflowAttType> (atts[whichAtt].second) != nullptr ||
+				dynamic_pointer_cast <MyDB_DecimalAttType> (atts[whichAtt].second) != nullptr)
+				canGenerate = false;
+			if (mode == intMode)
+				code += "\t\tint " + name + ";\n\t\tmemcpy (&" + name + ", pos + sizeof (short), sizeof (int));\n";
+			else if (mode == doubleMode)
+				code += "\t\tdouble " + name + ";\n\t\tmemcpy (&" + name + ", pos + sizeof (short), sizeof (double));\n";
+			else if (mode == stringMode)
+				code += "\t\tconst char *" + name + " = pos + sizeof (short);\n";
+			else
+				code += "\t\tbool " + name + " = (pos[sizeof (short)] == 1);\n";
+		}
+		if (whichAtt + 1 < (int) needed.size ()) {
+			int offset = inputSchema->getFixedOffset (whichAtt + 1);
+			if (offset != -1)
+				code += "\t\tpos = ((char *) recs[i]) + " + to_string (offset) + ";\n";
+			else
+				code += "\t\tpos += *((short *) pos);\n";
+		}
+	}
+	return code;
+}
+
+string CompiledPipeline :: promote (string value, MyDB_ExprMode fromMode, MyDB_ExprMode toMode) {
+
+	if (fromMode == toMode)
+		return value;
+	if (toMode == doubleMode)
+		return "((double) " + value + ")";
+	if (fromMode == boolMode)
+		return "(" + value + " ? \"true\" : \"false\")";
+	return "std::to_string (" + value + ")";
+}
+
+string CompiledPipeline :: generateExpr (MyDB_ExprPtr e) {
+
+	MyDB_ExprOp op = e->getOp ();
+	MyDB_ExprMode mode = e->getMode ();
+
+	// the leaves
+	if (op == attOp) {
+		return "att" + to_string (e->getAttIndex ());
+
+	} else if (op == intOp) {
+		return "((int) " + to_string (e->getInt ()) + ")";
+
+	} else if (op == doubleOp) {
+
+		// an infinity or a NaN has no literal
+		if (!isfinite (e->getDouble ()))
+			canGenerate = false;
+		char buf[64];
+		snprintf (buf, sizeof (buf), "%.17g", e->getDouble ());
+		string val = buf;
+		if (val.find_first_of (".e") == string :: npos)
+			val += ".0";
+		return "((double) " + val + ")";
+
+	} else if (op == stringOp) {
+
+		// everything other than letters, digits and spaces is written as an octal escape
+		string val = "\"";
+		for (char c : e->getString ()) {
+			if (isalnum ((unsigned char) c) || c == ' ') {
+				val += c;
+			} else {
+				char buf[8];
+				snprintf (buf, sizeof (buf), "\\%03o", (unsigned char) c);
+				val += buf;
+			}
+		}
+		return val + "\"";
+
+	} else if (op == boolOp) {
+		return e->getBool () ? "true" : "false";
+	}
+
+	// the operations; the inputs are promoted to the mode of the node first
+	if (isDateAsString (e->getLHS (), mode) || (e->getRHS () != nullptr && isDateAsString (e->getRHS (), mode)))
+		canGenerate = false;
+	string lhs = promote (generateExpr (e->getLHS ()), resultMode (e->getLHS ()), mode);
+	if (op == uMinusOp)
+		return "(-" + lhs + ")";
+	if (op == notOp)
+		return "(!" + lhs + ")";
+
+	string rhs = promote (generateExpr (e->getRHS ()), resultMode (e->getRHS ()), mode);
+	switch (op) {
+
+	case plusOp:
+		if (mode == stringMode)
+			return "(std::string (cs (" + lhs + ")) + cs (" + rhs + "))";
+		return "(" + lhs + " + " + rhs + ")";
+	case minusOp: return "(" + lhs + " - " + rhs + ")";
+	case timesOp: return "(" + lhs + " * " + rhs + ")";
+	case divideOp: return "(" + lhs + " / " + rhs + ")";
+	case andOp: return "(" + lhs + " && " + rhs + ")";
+	case orOp: return "(" + lhs + " || " + rhs + ")";
+	default: break;
+	}
+
+	// the only thing left is a comparison
+	string cmp = (op == gtOp) ? ">" : (op == ltOp) ? "<" : (op == eqOp) ? "==" : "!=";
+	if (mode == stringMode)
+		return "(strcmp (cs (" + lhs + "), cs (" + rhs + ")) " + cmp + " 0)";
+	return "(" + lhs + " " + cmp + " " + rhs + ")";
+}
+
+bool CompiledPipeline :: generatePut (string out, string value, MyDB_ExprMode fromMode, MyDB_AttTypePtr toType, string &code) {
+
+	// a dictionary-encoded string would have to be added to the dictionary, an out-of-line
+	// string to its file, a char would have to be checked against its width, and a decimal
+	// would have to be rounded to its scale
+	if (dynamic_pointer_cast <MyDB_DictStringAttType> (toType) != nullptr ||
+		dynamic_pointer_cast <MyDB_OverflowAttType> (toType) != nullptr ||
+		dynamic_pointer_cast <MyDB_CharAttType> (toType) != nullptr ||
+		dynamic_pointer_cast <MyDB_DecimalAttType> (toType) != nullptr)
+		return false;
+
+	// these are the conversions that MyDB_AttVal.set () allows; the others exit
+	MyDB_ExprMode toMode = modeForType (toType);
+	if (toMode == intMode) {
+		if (fromMode == intMode)
+			code += "putInt (" + out + ", " + value + ");\n";
+		else if (fromMode == doubleMode)
+			code += "putInt (" + out + ", (int) " + value + ");\n";
+		else
+			return false;
+	} else if (toMode == doubleMode) {
+		if (fromMode == intMode || fromMode == doubleMode)
+			code += "putDouble (" + out + ", " + value + ");\n";
+		else
+			return false;
+	} else if (toMode == stringMode) {
+		code += "putString (" + out + ", cs (" + promote (value, fromMode, stringMode) + "));\n";
+	} else {
+		if (fromMode == boolMode)
+			code += "putBool (" + out + ", " + value + ");\n";
+		else
+			return false;
+	}
+	return true;
+}
+
+bool CompiledPipeline :: generate (string &code) {
+
+	MyDB_SchemaPtr inputSchema = input->getTable ()->getSchema ();
+	vector <pair <string, MyDB_AttTypePtr>> &outAtts = output->getTable ()->getSchema ()->getAtts ();
+	vector <int> attsNeeded;
+	canGenerate = true;
+
+	MyDB_ExprPtr pred = selectionPredicate;
+	pred->resolve (inputSchema);
+	pred->getAtts (attsNeeded);
+	if (!pred->getType ()->isBool ())
+		return false;
+
+	string state = "struct PipelineState {\n\tstd::string out;\n";
+	string perRecord = "\t\tif (!" + generateExpr (pred) + ")\n\t\t\tcontinue;\n\n";
+	string atClose;
+
+	if (!isAgg) {
+
+		// a selection writes out each accepted record right away
+		if (outAtts.size () != projections.size ())
+			return false;
+
+		perRecord += "\t\tstd::string &out = state->out;\n\t\tout.resize (sizeof (short));\n";
+		for (int j = 0; j < (int) projections.size (); j++) {
+			MyDB_ExprPtr proj = projections[j];
+			proj->resolve (inputSchema);
+			proj->getAtts (attsNeeded);
+			if (isDateAsString (proj, modeForType (outAtts[j].second)))
+				return false;
+			perRecord += "\t\t";
+			if (!generatePut ("out", generateExpr (proj), resultMode (proj), outAtts[j].second, perRecord))
+				return false;
+		}
+		perRecord += "\t\temitRecord (out, emit, emitArg);\n";
+
+	} else {
+
+		// an aggregation finds the group (numbered in the order that the groups are first seen),
+		// updates the running values, and writes out all of the groups at the end
+		int numGroupAtts = groupings.size ();
+		if (outAtts.size () != aggsToCompute.size () + groupings.size ())
+			return false;
+
+		state += "\tstd::string key;\n\tstd::unordered_map <std::string, int> groupIds;\n"
+			"\tstd::vector <std::string> groupVals;\n\tstd::vector <int> counts;\n";
+		string newGroup = "\t\t\tgroup = state->counts.size ();\n\t\t\tstate->groupIds[key] = group;\n"
+			"\t\t\tstate->counts.push_back (0);\n\t\t\tstd::string vals;\n";
+		string update = "\t\tstate->counts[group]++;\n";
+		atClose = "\tfor (int group = 0; group < (int) state->counts.size (); group++) {\n"
+			"\t\tstd::string &out = state->out;\n\t\tout.resize (sizeof (short));\n"
+			"\t\tout += state->groupVals[group];\n";
+
+		// the groups are looked up using the binary version of the grouping values, and the
+		// values are converted to the output types when the group is created
+		perRecord += "\t\tstd::string &key = state->key;\n\t\tkey.clear ();\n";
+		for (int j = 0; j < numGroupAtts; j++) {
+			MyDB_ExprPtr group = groupings[j];
+			group->resolve (inputSchema);
+			group->getAtts (attsNeeded);
+			MyDB_ExprMode mode = resultMode (group);
+			string value = generateExpr (group);
+			if (mode == intMode)
+				perRecord += "\t\tkeyInt (key, " + value + ");\n";
+			else if (mode == doubleMode)
+				perRecord += "\t\tkeyDouble (key, " + value + ");\n";
+			else if (mode == stringMode)
+				perRecord += "\t\tkeyString (key, cs (" + value + "));\n";
+			else
+				perRecord += "\t\tkeyBool (key, " + value + ");\n";
+			if (isDateAsString (group, modeForType (outAtts[j].second)))
+				return false;
+			newGroup += "\t\t\t";
+			if (!generatePut ("vals", value, mode, outAtts[j].second, newGroup))
+				return false;
+		}
+
+		// the running value of an aggregate is an int if the output attribute is an int, and a
+		// double otherwise, and it is updated just like VectorizedAggregate does
+		for (int j = 0; j < (int) aggsToCompute.size (); j++) {
+			MyDB_AttTypePtr outType = outAtts[numGroupAtts + j].second;
+			if (outType->isBool () || !outType->promotableToDouble () ||
+				dynamic_pointer_cast <MyDB_DecimalAttType> (outType) != nullptr)
+				return false;
+			bool isInt = outType->promotableToInt ();
+			string agg = "state->agg" + to_string (j);
+			state += string ("\tstd::vector <") + (isInt ? "int" : "double") + "> agg" + to_string (j) + ";\n";
+			newGroup += "\t\t\t" + agg + ".push_back (0);\n";
+
+			if (aggsToCompute[j].first == MyDB_AggType :: cntA) {
+				update += "\t\t" + agg + "[group] += 1;\n";
+			} else {
+				MyDB_ExprPtr aggExpr = aggsToCompute[j].second;
+				aggExpr->resolve (inputSchema);
+				aggExpr->getAtts (attsNeeded);
+				MyDB_ExprMode mode = resultMode (aggExpr);
+				if (mode != intMode && mode != doubleMode)
+					return false;
+				string value = generateExpr (aggExpr);
+				if (isInt && mode == doubleMode)
+					update += "\t\t" + agg + "[group] = (int) (" + value + " + " + agg + "[group]);\n";
+				else
+					update += "\t\t" + agg + "[group] += " + value + ";\n";
+			}
+
+			// an average over ints is done with integer division
+			if (aggsToCompute[j].first == MyDB_AggType :: avgA)
+				atClose += string ("\t\t") + (isInt ? "putInt" : "putDouble") + " (out, " + agg + "[group] / state->counts[group]);\n";
+			else
+				atClose += string ("\t\t") + (isInt ? "putInt" : "putDouble") + " (out, " + agg + "[group]);\n";
+		}
+
+		perRecord += "\t\tint group;\n\t\tauto found = state->groupIds.find (key);\n"
+			"\t\tif (found != state->groupIds.end ()) {\n\t\t\tgroup = found->second;\n\t\t} else {\n" +
+			newGroup + "\t\t\tstate->groupVals.push_back (vals);\n\t\t}\n" + update;
+		atClose += "\t\temitRecord (out, emit, emitArg);\n\t}\n";
+	}
+	state += "};\n\n";
+
+	string decode = generateDecode (attsNeeded);
+	if (!canGenerate)
+		return false;
+
+	// put it all together
+	code = string (prelude) + state +
+		"extern \"C\" void *pipelineOpen () {\n\treturn new PipelineState;\n}\n\n"
+		"extern \"C\" void pipelineConsume (void *stateIn, void **recs, int numRecs, EmitFunc emit, void *emitArg) {\n"
+		"\tPipelineState *state = (PipelineState *) stateIn;\n"
+		"\tfor (int i = 0; i < numRecs; i++) {\n\n" +
+		decode + "\n" + perRecord +
+		"\t}\n}\n\n"
+		"extern \"C\" void pipelineClose (void *stateIn, EmitFunc emit, void *emitArg) {\n"
+		"\tPipelineState *state = (PipelineState *) stateIn;\n" + atClose +
+		"\tdelete state;\n}\n";
+	return true;
+}
+
+void *CompiledPipeline :: load (string &code) {
+
+	char name[64];
+	snprintf (name, sizeof (name), "pipeline%016zx", hash <string> () (code));
+
+	// see if we already loaded it
+	auto found = loadedPipelines.find (name);
+	if (found != loadedPipelines.end ())
+		return found->second;
+
+	// see if an earlier run built a shared object from exactly the same code
+	string base = cacheDir + "/" + name;
+	ifstream oldCode (base + ".cc");
+	stringstream oldContents;
+	oldContents << oldCode.rdbuf ();
+	if (!oldCode || oldContents.str () != code || access ((base + ".so").c_str (), R_OK) != 0) {
+
+		mkdir (cacheDir.c_str (), 0777);
+		ofstream newCode (base + ".cc");
+		newCode << code;
+		newCode.close ();
+		if (!newCode) {
+			cout << "could not write the code for the pipeline to " << base << ".cc.\n";
+			return nullptr;
+		}
+
+		// compile into a temporary file, so that a failed compile never leaves a broken .so behind
+		const char *compiler = getenv ("CXX");
+		string command = string (compiler == nullptr ? "c++" : compiler) +
+			" -std=c++11 -O3 -fwrapv -shared -fPIC -o '" + base + ".tmp.so' '" + base + ".cc' 2> '" + base + ".err'";
+		if (system (command.c_str ()) != 0 || rename ((base + ".tmp.so").c_str (), (base + ".so").c_str ()) != 0) {
+			cout << "could not compile the pipeline; see " << base << ".err.\n";
+			return nullptr;
+		}
+		unlink ((base + ".err").c_str ());
+	}
+
+	// dlopen () only looks in the library path for names without a slash
+	string path = base + ".so";
+	if (path[0] != '/' && path[0] != '.')
+		path = "./" + path;
+	void *handle = dlopen (path.c_str (), RTLD_NOW | RTLD_LOCAL);
+	if (handle == nullptr) {
+		cout << "could not load the compiled pipeline: " << dlerror () << "\n";
+		return nullptr;
+	}
+	loadedPipelines[name] = handle;
+	return handle;
+}
+
+#endif
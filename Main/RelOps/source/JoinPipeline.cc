@@ -0,0 +1,203 @@
+
+#ifndef JOIN_PIPELINE_C
+#define JOIN_PIPELINE_C
+
+#include "JoinPipeline.h"
+#include "ScanJoin.h"
+#include "SortMergeJoin.h"
+#include "VectorizedSelection.h"
+#include <algorithm>
+
+JoinPipeline :: JoinPipeline (vector <MyDB_TableReaderWriterPtr> inputsIn, MyDB_TableReaderWriterPtr outputIn,
+	vector <MyDB_ExprPtr> conjunctsIn, vector <MyDB_ExprPtr> projectionsIn) {
+
+	inputs = inputsIn;
+	output = outputIn;
+	conjuncts = conjunctsIn;
+	projections = projectionsIn;
+	isAgg = false;
+}
+
+JoinPipeline :: JoinPipeline (vector <MyDB_TableReaderWriterPtr> inputsIn, MyDB_TableReaderWriterPtr outputIn,
+	vector <MyDB_ExprPtr> conjunctsIn, vector <pair <MyDB_AggType, MyDB_ExprPtr>> aggsToComputeIn,
+	vector <MyDB_ExprPtr> groupingsIn) {
+
+	inputs = inputsIn;
+	output = outputIn;
+	conjuncts = conjunctsIn;
+	aggsToCompute = aggsToComputeIn;
+	groupings = groupingsIn;
+	isAgg = true;
+}
+
+set <int> JoinPipeline :: tablesRead (MyDB_ExprPtr expr) {
+
+	set <int> result;
+	if (expr == nullptr)
+		return result;
+
+	if (expr->getOp () == attOp) {
+		for (size_t i = 0; i < inputs.size (); i++)
+			for (auto &att : inputs[i]->getTable ()->getSchema ()->getAtts ())
+				if (att.first == expr->getAttName ())
+					result.insert (i);
+		return result;
+	}
+
+	set <int> lhs = tablesRead (expr->getLHS ());
+	set <int> rhs = tablesRead (expr->getRHS ());
+	result.insert (lhs.begin (), lhs.end ());
+	result.insert (rhs.begin (), rhs.end ());
+	return result;
+}
+
+string JoinPipeline :: getSkipCounts () {
+	return skipCounts;
+}
+
+void JoinPipeline :: run (int numWorkers) {
+
+	MyDB_BufferManagerPtr buffer = inputs[0]->getBufferMgr ();
+
+	// the tables that each of the conjuncts reads from
+	vector <set <int>> readsFrom;
+	for (auto &c : conjuncts)
+		readsFrom.push_back (tablesRead (c));
+	vector <bool> used (conjuncts.size (), false);
+
+	// the conjuncts over the table that is scanned are run as it is scanned
+	int first = 0;
+	for (int i = 1; i < (int) inputs.size (); i++)
+		if (inputs[i]->getNumPages () > inputs[first]->getNumPages ())
+			first = i;
+
+	MyDB_ExprPtr scanPredicate = nullptr;
+	for (size_t i = 0; i < conjuncts.size (); i++) {
+		if (readsFrom[i] == set <int> {first}) {
+			scanPredicate = (scanPredicate == nullptr) ? conjuncts[i] : make_shared <MyDB_Expr> (andOp, scanPredicate, conjuncts[i]);
+			used[i] = true;
+		}
+	}
+	if (scanPredicate == nullptr)
+		scanPredicate = MyDB_Expr :: boolLiteral (true);
+
+	MyDB_SchemaPtr scanSchema = make_shared <MyDB_Schema> ();
+	vector <MyDB_ExprPtr> scanProjections;
+	for (auto &att : inputs[first]->getTable ()->getSchema ()->getAtts ()) {
+		scanSchema->appendAtt (att);
+		scanProjections.push_back (MyDB_Expr :: attribute (att.first));
+	}
+	PipelineSinkPtr scanned = make_shared <PipelineSink> (scanSchema, buffer);
+
+	// now the joins, each of which reads from the sink that the one before it writes to
+	vector <shared_ptr <PipelineOp>> ops;
+	PipelineSinkPtr in = scanned;
+	set <int> joined = {first};
+	while (joined.size () < inputs.size ()) {
+
+		// find the equalities between the tables joined so far and each of the others; the first
+		// table that has any is joined next
+		int next = -1;
+		vector <pair <string, string>> equalityChecks;
+		for (int t = 0; t < (int) inputs.size () && (next == -1 || equalityChecks.empty ()); t++) {
+
+			if (joined.count (t) > 0)
+				continue;
+
+			vector <pair <string, string>> checks;
+			for (size_t i = 0; i < conjuncts.size (); i++) {
+				if (used[i] || conjuncts[i]->getOp () != eqOp)
+					continue;
+				set <int> lhs = tablesRead (conjuncts[i]->getLHS ());
+				set <int> rhs = tablesRead (conjuncts[i]->getRHS ());
+				bool lhsJoined = !lhs.empty () && includes (joined.begin (), joined.end (), lhs.begin (), lhs.end ());
+				bool rhsJoined = !rhs.empty () && includes (joined.begin (), joined.end (), rhs.begin (), rhs.end ());
+				if (lhsJoined && rhs == set <int> {t})
+					checks.push_back (make_pair (conjuncts[i]->getLHS ()->toString (), conjuncts[i]->getRHS ()->toString ()));
+				else if (rhsJoined && lhs == set <int> {t})
+					checks.push_back (make_pair (conjuncts[i]->getRHS ()->toString (), conjuncts[i]->getLHS ()->toString ()));
+			}
+			if (next == -1 || !checks.empty ()) {
+				next = t;
+				equalityChecks = checks;
+			}
+		}
+		joined.insert (next);
+		bool isLast = (joined.size () == inputs.size ());
+
+		// the conjuncts over just the new table are run before it is hashed (or sorted); the ones
+		// that read from it and from the tables joined so far are run on the joined records, as
+		// are any that are left over once all of the tables are joined
+		string rightPredicate = "";
+		string finalPredicate = "";
+		auto andWith = [] (string &predicate, MyDB_ExprPtr conjunct) {
+			predicate = (predicate == "") ? conjunct->toString () : "&& (" + predicate + ", " + conjunct->toString () + ")";
+		};
+		for (size_t i = 0; i < conjuncts.size (); i++) {
+			if (used[i])
+				continue;
+			if (readsFrom[i] == set <int> {next}) {
+				andWith (rightPredicate, conjuncts[i]);
+				used[i] = true;
+			} else if (isLast || (readsFrom[i].count (next) > 0 &&
+					includes (joined.begin (), joined.end (), readsFrom[i].begin (), readsFrom[i].end ()))) {
+				andWith (finalPredicate, conjuncts[i]);
+				used[i] = true;
+			}
+		}
+		rightPredicate = (rightPredicate == "") ? "bool[true]" : rightPredicate;
+		finalPredicate = (finalPredicate == "") ? "bool[true]" : finalPredicate;
+
+		// the last join writes the projections to the output, unless there is an aggregate after
+		// it; otherwise, all of the attributes are kept
+		MyDB_SchemaPtr joinSchema = make_shared <MyDB_Schema> ();
+		vector <string> joinProjections;
+		for (auto &att : in->getTable ()->getSchema ()->getAtts ()) {
+			joinSchema->appendAtt (att);
+			joinProjections.push_back ("[" + att.first + "]");
+		}
+		for (auto &att : inputs[next]->getTable ()->getSchema ()->getAtts ()) {
+			joinSchema->appendAtt (att);
+			joinProjections.push_back ("[" + att.first + "]");
+		}
+
+		MyDB_TableReaderWriterPtr out;
+		PipelineSinkPtr outSink = nullptr;
+		if (isLast && !isAgg) {
+			joinProjections.clear ();
+			for (auto &p : projections)
+				joinProjections.push_back (p->toString ());
+			out = output;
+		} else {
+			outSink = make_shared <PipelineSink> (joinSchema, buffer);
+			out = outSink;
+		}
+
+		shared_ptr <PipelineOp> op;
+		if (!equalityChecks.empty () && inputs[next]->getNumPages () > (int) buffer->getNumPages () / 2)
+			op = make_shared <SortMergeJoin> (in, inputs[next], out, finalPredicate, joinProjections,
+				equalityChecks[0], "bool[true]", rightPredicate);
+		else
+			op = make_shared <ScanJoin> (in, inputs[next], out, finalPredicate, joinProjections,
+				equalityChecks, "bool[true]", rightPredicate);
+		in->pushInto (op.get ());
+		ops.push_back (op);
+		in = outSink;
+	}
+
+	// the aggregate is fed by the last join
+	if (isAgg) {
+		shared_ptr <Aggregate> agg = make_shared <Aggregate> (in, output, aggsToCompute, groupings, MyDB_Expr :: boolLiteral (true));
+		in->pushInto (agg.get ());
+		ops.push_back (agg);
+	}
+
+	// the scan pushes the records all of the way through; once it is done, closing its sink
+	// closes each operator in turn, down to the output
+	VectorizedSelection scan (inputs[first], scanned, scanPredicate, scanProjections);
+	scan.run (numWorkers);
+	skipCounts = inputs[first]->getSkipCounts ();
+	scanned->close ();
+}
+
+#endif
@@ -0,0 +1,141 @@
+
+#ifndef MORSEL_EXEC_C
+#define MORSEL_EXEC_C
+
+#include "MorselExecutor.h"
+#include "MyDB_TaskScheduler.h"
+#include <algorithm>
+
+MorselExecutor :: MorselExecutor (MyDB_TableReaderWriterPtr inputIn, function <bool (int)> readPageIn) {
+	input = inputIn;
+	readPage = readPageIn;
+	nextPage = 0;
+	nextMorsel = 0;
+	pagesPerMorsel = MAX_MORSEL_PAGES;
+	nextToAppend = 0;
+}
+
+int MorselExecutor :: getNumWorkers () {
+
+	// each worker has one morsel pinned at a time, and at most a quarter of the buffer is used
+	int maxWorkers = max (1, (int) input->getBufferMgr ()->getNumPages () / 4);
+	return min (maxWorkers, MyDB_TaskScheduler :: getScheduler ().getNumWorkers ());
+}
+
+bool MorselExecutor :: getMorsel (Morsel &intoMe) {
+
+	lock_guard <mutex> guard (lock);
+
+	// the last morsel is let go of first, so that its pages can be used for this one
+	intoMe.pinned.clear ();
+	intoMe.pages.clear ();
+	intoMe.isPAX.clear ();
+
+	// the pages that the page filter rules out, and the pages of a B+-Tree that are not
+	// leaves, are skipped
+	int numPages = input->getNumPages ();
+	while (nextPage < numPages && (int) intoMe.pinned.size () < pagesPerMorsel) {
+		int whichPage = nextPage++;
+		if (!readPage (whichPage))
+			continue;
+		MyDB_PageReaderWriter page = input->getPinned (whichPage);
+		if (page.getType () == MyDB_PageType :: DirectoryPage)
+			continue;
+		intoMe.pinned.push_back (page);
+		intoMe.pages.push_back (page.getBytes ());
+		intoMe.isPAX.push_back (page.getType () == MyDB_PageType :: PAXPage);
+	}
+
+	if (intoMe.pinned.empty ())
+		return false;
+	intoMe.number = nextMorsel++;
+	return true;
+}
+
+void MorselExecutor :: appendPageImage (MyDB_TableReaderWriterPtr output, void *page) {
+	lock_guard <mutex> guard (lock);
+	output->appendPageImage (page);
+}
+
+void MorselExecutor :: appendInOrder (MyDB_TableReaderWriterPtr output, int whichMorsel, vector <vector <char>> &pages,
+	MyDB_RecordPtr usingMe) {
+
+	lock_guard <mutex> guard (lock);
+	waiting[whichMorsel].swap (pages);
+	size_t pageSize = output->getBufferMgr ()->getPageSize ();
+	while (!waiting.empty () && waiting.begin ()->first == nextToAppend) {
+		vector <vector <char>> &toAppend = waiting.begin ()->second;
+		for (size_t i = 0; i < toAppend.size (); i++) {
+			void *page = toAppend[i].data ();
+			if (i + 1 < toAppend.size ()) {
+				output->appendPageImage (page);
+				continue;
+			}
+			int numOnPage = MyDB_PageReaderWriter :: getNumRecords (page, pageSize);
+			for (int j = 0; j < numOnPage; j++) {
+				usingMe->fromBinary (MyDB_PageReaderWriter :: getRecord (page, pageSize, j));
+				output->append (usingMe);
+			}
+		}
+		waiting.erase (waiting.begin ());
+		nextToAppend++;
+	}
+}
+
+void MorselExecutor :: run (int numWorkers, function <void (int, void **, int, long long)> consume) {
+	run (numWorkers, consume, [] (int, int) {});
+}
+
+void MorselExecutor :: run (int numWorkers, function <void (int, void **, int, long long)> consume,
+	function <void (int, int)> morselDone) {
+
+	// a morsel should be big enough that the lock is seldom taken, but small enough that all of
+	// the workers' morsels fit in a quarter of the buffer
+	numWorkers = max (1, numWorkers);
+	int bufferPages = input->getBufferMgr ()->getNumPages ();
+	pagesPerMorsel = max (1, min (MAX_MORSEL_PAGES, bufferPages / (4 * numWorkers)));
+	nextPage = 0;
+	nextMorsel = 0;
+	nextToAppend = 0;
+	waiting.clear ();
+
+	size_t pageSize = input->getBufferMgr ()->getPageSize ();
+	MyDB_TaskGroupPtr tasks = MyDB_TaskScheduler :: getScheduler ().makeGroup ();
+	for (int whichWorker = 0; whichWorker < numWorkers; whichWorker++) {
+		tasks->submit ([this, whichWorker, pageSize, &consume, &morselDone] {
+
+			Morsel morsel;
+			void *batch[MAX_BATCH_SIZE];
+			char *rows = nullptr;
+			while (getMorsel (morsel)) {
+
+				// the positions of the records in a morsel come after those in the morsels before it
+				long long pos = ((long long) morsel.number) << 32;
+				for (size_t i = 0; i < morsel.pages.size (); i++) {
+
+					// a PAXPage is written into a RegularPage image in the worker's scratch memory
+					void *page = morsel.pages[i];
+					if (morsel.isPAX[i]) {
+						if (rows == nullptr)
+							rows = (char *) MyDB_TaskScheduler :: getScratch ().allocate (pageSize);
+						MyDB_PageReaderWriter :: fromPAX (page, rows, pageSize);
+						page = rows;
+					}
+
+					int numOnPage = MyDB_PageReaderWriter :: getNumRecords (page, pageSize);
+					for (int first = 0; first < numOnPage; first += MAX_BATCH_SIZE) {
+						int numRecs = min (MAX_BATCH_SIZE, numOnPage - first);
+						for (int j = 0; j < numRecs; j++)
+							batch[j] = MyDB_PageReaderWriter :: getRecord (page, pageSize, first + j);
+						consume (whichWorker, batch, numRecs, pos);
+						pos += numRecs;
+					}
+				}
+				morselDone (whichWorker, morsel.number);
+			}
+		});
+	}
+	tasks->join ();
+}
+
+#endif
@@ -0,0 +1,171 @@
+
+#ifndef PAR_SELECTION_C
+#define PAR_SELECTION_C
+
+#include "MyDB_ConjunctFilter.h"
+#include "MyDB_TaskScheduler.h"
+#include "ParallelSelection.h"
+#include <algorithm>
+
+// a worker gets at most this many pages in a round
+#define MAX_PAGES_PER_WORKER 16
+
+// everything that one worker uses: its own records, computations and prefilter, and the page
+// images that it writes its output records into
+struct SelectionWorker {
+	MyDB_RecordPtr inputRec;
+	MyDB_RecordPtr outputRec;
+	func pred;
+	vector <func> computations;
+	function <bool ()> inRange;
+	shared_ptr <MyDB_ConjunctFilter> prefilter;
+	vector <char> pages;
+	size_t numPages = 0;
+};
+
+// runs the selection over the records on the given pages (each of which is a RegularPage image)
+static void selectFromPages (vector <void *> &pages, size_t inPageSize, size_t outPageSize, SelectionWorker &me) {
+
+	void *batch[MAX_BATCH_SIZE];
+	int selected[MAX_BATCH_SIZE];
+	for (void *page : pages) {
+		int numOnPage = MyDB_PageReaderWriter :: getNumRecords (page, inPageSize);
+		for (int first = 0; first < numOnPage; first += MAX_BATCH_SIZE) {
+
+			int numRecs = min (MAX_BATCH_SIZE, numOnPage - first);
+			for (int i = 0; i < numRecs; i++)
+				batch[i] = MyDB_PageReaderWriter :: getRecord (page, inPageSize, first + i);
+
+			int numSelected = me.prefilter->run (batch, numRecs, selected);
+			for (int j = 0; j < numSelected; j++) {
+
+				me.inputRec->fromBinary (batch[selected[j]]);
+
+				// see if it is accepted by the predicate
+				if ((me.inRange != nullptr && !me.inRange ()) || !me.pred ()->toBool ())
+					continue;
+
+				// run all of the computations
+				int i = 0;
+				for (auto &f : me.computations)
+					me.outputRec->getAtt (i++)->set (f ());
+				me.outputRec->recordContentHasChanged ();
+
+				// and write the record, starting a new page image if needed
+				char *out = (me.numPages == 0) ? nullptr : &me.pages[(me.numPages - 1) * outPageSize];
+				if (out == nullptr || !MyDB_PageReaderWriter :: append (out, outPageSize, me.outputRec)) {
+					me.pages.resize (++me.numPages * outPageSize);
+					out = &me.pages[(me.numPages - 1) * outPageSize];
+					MyDB_PageReaderWriter :: clear (out, outPageSize);
+					MyDB_PageReaderWriter :: append (out, outPageSize, me.outputRec);
+				}
+			}
+		}
+	}
+}
+
+// appends a worker's page images to the output table.  All but the last one are full, and are
+// appended as they are; the records on the last one are appended one at a time (so that they
+// go onto the output's last page, if there is room), unless keepLast is true, in which case it
+// becomes the worker's first page image for the next round
+static void appendPages (SelectionWorker &me, MyDB_TableReaderWriterPtr output, size_t outPageSize, bool keepLast) {
+
+	if (me.numPages == 0)
+		return;
+
+	for (size_t i = 0; i + 1 < me.numPages; i++)
+		output->appendPageImage (&me.pages[i * outPageSize]);
+
+	char *last = &me.pages[(me.numPages - 1) * outPageSize];
+	if (keepLast) {
+		memmove (me.pages.data (), last, outPageSize);
+		me.numPages = 1;
+		return;
+	}
+
+	int numRecs = MyDB_PageReaderWriter :: getNumRecords (last, outPageSize);
+	for (int i = 0; i < numRecs; i++) {
+		me.outputRec->fromBinary (MyDB_PageReaderWriter :: getRecord (last, outPageSize, i));
+		output->append (me.outputRec);
+	}
+	me.numPages = 0;
+}
+
+ParallelSelection :: ParallelSelection (MyDB_TableReaderWriterPtr inputIn, MyDB_TableReaderWriterPtr outputIn,
+	string selectionPredicateIn, vector <string> projectionsIn,
+	function <function <bool ()> (MyDB_RecordPtr)> makeRangeCheckIn) {
+
+	input = inputIn;
+	output = outputIn;
+	selectionPredicate = selectionPredicateIn;
+	projections = projectionsIn;
+	makeRangeCheck = makeRangeCheckIn;
+}
+
+void ParallelSelection :: run (vector <MyDB_PageReaderWriter> &pages, int numThreads, bool inOrder) {
+
+	// at most a quarter of the buffer is pinned for the workers at once, since each PAXPage that
+	// is pinned needs another page to hold its rows
+	int pagesPerRound = max (1, (int) input->getBufferMgr ()->getNumPages () / 4);
+	numThreads = max (1, min (numThreads, pagesPerRound));
+	pagesPerRound = min (pagesPerRound, numThreads * MAX_PAGES_PER_WORKER);
+
+	// each worker gets its own records and computations, all compiled at once so that they share work
+	vector <SelectionWorker> workers (numThreads);
+	for (auto &w : workers) {
+		w.inputRec = input->getEmptyRecord ();
+		w.outputRec = output->getEmptyRecord ();
+		vector <string> computations = projections;
+		computations.push_back (selectionPredicate);
+		w.computations = w.inputRec->compileComputations (computations);
+		w.pred = w.computations.back ();
+		w.computations.pop_back ();
+		w.prefilter = make_shared <MyDB_ConjunctFilter> (input->getTable ()->getSchema (), selectionPredicate);
+		if (makeRangeCheck != nullptr)
+			w.inRange = makeRangeCheck (w.inputRec);
+	}
+
+	size_t inPageSize = input->getBufferMgr ()->getPageSize ();
+	size_t outPageSize = output->getBufferMgr ()->getPageSize ();
+	for (size_t pos = 0; pos < pages.size ();) {
+
+		// the pages in this round are split evenly among the workers, each getting a run of
+		// consecutive pages; the pages of a B+-Tree that are not leaves are skipped, and
+		// PAXPages are first written into RegularPages
+		size_t numInRound = min ((size_t) pagesPerRound, pages.size () - pos);
+		vector <MyDB_PageReaderWriter> pinned;
+		vector <vector <void *>> bytes (numThreads);
+		for (int i = 0; i < numThreads; i++) {
+			size_t end = pos + numInRound * (i + 1) / numThreads;
+			for (size_t j = pos + numInRound * i / numThreads; j < end; j++) {
+				if (pages[j].getType () == MyDB_PageType :: DirectoryPage)
+					continue;
+				pinned.push_back (pages[j].getPinned ().getRows ());
+				bytes[i].push_back (pinned.back ().getBytes ());
+			}
+		}
+
+		MyDB_TaskGroupPtr tasks = MyDB_TaskScheduler :: getScheduler ().makeGroup ();
+		for (int i = 0; i < numThreads; i++) {
+			vector <void *> &myPages = bytes[i];
+			SelectionWorker &me = workers[i];
+			tasks->submit ([&myPages, inPageSize, outPageSize, &me] {selectFromPages (myPages, inPageSize, outPageSize, me);});
+		}
+		tasks->join ();
+
+		// now the pages in this round can be unpinned
+		pinned.clear ();
+		for (size_t j = pos; j < pos + numInRound; j++)
+			pages[j] = MyDB_PageReaderWriter ();
+		pos += numInRound;
+
+		// the output is appended in the order of the workers, so the records stay in order
+		for (auto &w : workers)
+			appendPages (w, output, outPageSize, !inOrder);
+	}
+
+	for (auto &w : workers)
+		appendPages (w, output, outPageSize, false);
+}
+
+#endif
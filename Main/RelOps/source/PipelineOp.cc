@@ -0,0 +1,76 @@
+
+#ifndef PIPELINE_OP_C
+#define PIPELINE_OP_C
+
+#include "MyDB_PageReaderWriter.h"
+#include "PipelineOp.h"
+#include <algorithm>
+
+PipelineSink :: PipelineSink (MyDB_SchemaPtr mySchema, MyDB_BufferManagerPtr myBuffer) :
+	MyDB_TableReaderWriter (mySchema, myBuffer) {
+
+	consumer = nullptr;
+	opened = false;
+	pageSize = myBuffer->getPageSize ();
+	page.resize (pageSize);
+	MyDB_PageReaderWriter :: clear (page.data (), pageSize);
+}
+
+void PipelineSink :: pushInto (PipelineOp *consumerIn) {
+	consumer = consumerIn;
+}
+
+void PipelineSink :: push (void *fromMe) {
+
+	if (!opened) {
+		consumer->open ();
+		opened = true;
+	}
+
+	void *batch[MAX_BATCH_SIZE];
+	int numOnPage = MyDB_PageReaderWriter :: getNumRecords (fromMe, pageSize);
+	for (int first = 0; first < numOnPage; first += MAX_BATCH_SIZE) {
+		int numRecs = min (MAX_BATCH_SIZE, numOnPage - first);
+		for (int i = 0; i < numRecs; i++)
+			batch[i] = MyDB_PageReaderWriter :: getRecord (fromMe, pageSize, first + i);
+		consumer->consume (batch, numRecs);
+	}
+}
+
+void PipelineSink :: append (MyDB_RecordPtr appendMe) {
+
+	// once the page image is full, its records are pushed, and it is used again
+	if (!MyDB_PageReaderWriter :: append (page.data (), pageSize, appendMe)) {
+		push (page.data ());
+		MyDB_PageReaderWriter :: clear (page.data (), pageSize);
+		MyDB_PageReaderWriter :: append (page.data (), pageSize, appendMe);
+	}
+}
+
+void PipelineSink :: appendPageImage (void *fromMe) {
+
+	// the records that came first are pushed first
+	if (MyDB_PageReaderWriter :: getNumRecords (page.data (), pageSize) > 0) {
+		push (page.data ());
+		MyDB_PageReaderWriter :: clear (page.data (), pageSize);
+	}
+	push (fromMe);
+}
+
+void PipelineSink :: close () {
+
+	// the consumer is opened even if nothing was ever pushed into it, so that open () and close ()
+	// always go together
+	push (page.data ());
+	MyDB_PageReaderWriter :: clear (page.data (), pageSize);
+	consumer->close ();
+	opened = false;
+}
+
+void PipelineSink :: closeIfSink (MyDB_TableReaderWriterPtr output) {
+	PipelineSinkPtr sink = dynamic_pointer_cast <PipelineSink> (output);
+	if (sink != nullptr)
+		sink->close ();
+}
+
+#endif
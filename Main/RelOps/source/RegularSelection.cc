@@ -2,6 +2,8 @@
 #ifndef REG_SELECTION_C                                        
 #define REG_SELECTION_C
 
+#include "MyDB_ConjunctFilter.h"
+#include "ParallelSelection.h"
 #include "RegularSelection.h"
 
 RegularSelection :: RegularSelection (MyDB_TableReaderWriterPtr inputIn, MyDB_TableReaderWriterPtr outputIn,
@@ -15,21 +17,40 @@ RegularSelection :: RegularSelection (MyDB_TableReaderWriterPtr inputIn, MyDB_Ta
 
 void RegularSelection :: run () {
 
-	MyDB_RecordPtr inputRec = input->getEmptyRecord ();
-	MyDB_RecordPtr outputRec = output->getEmptyRecord ();
+	// iterate through the input table, a batch of records at a time, skipping the pages that the
+	// zone map says cannot have a match
+	open ();
+	void *batch[MAX_BATCH_SIZE];
+	MyDB_RecordIteratorAltPtr myIter = input->getIteratorAlt (input->getPageFilter (selectionPredicate));
+	int numRecs;
+	while ((numRecs = myIter->getBatch (batch, MAX_BATCH_SIZE)) > 0)
+		consume (batch, numRecs);
+	close ();
+}
+
+void RegularSelection :: open () {
+
+	inputRec = input->getEmptyRecord ();
+	outputRec = output->getEmptyRecord ();
 	
-	// compile all of the coputations that we need here
-	vector <func> finalComputations;
-	for (string s : projections) {
-		finalComputations.push_back (inputRec->compileComputation (s));
-	}
-	func pred = inputRec->compileComputation (selectionPredicate);
+	// compile all of the coputations that we need here, all at once so that they share work
+	vector <string> computations = projections;
+	computations.push_back (selectionPredicate);
+	finalComputations = inputRec->compileComputations (computations);
+	pred = finalComputations.back ();
+	finalComputations.pop_back ();
+
+	// this runs the simple parts of the predicate over a whole batch at once
+	prefilter = make_shared <MyDB_ConjunctFilter> (input->getTable ()->getSchema (), selectionPredicate);
+}
+
+void RegularSelection :: consume (void **batch, int numRecs) {
 
-	// now, iterate through the B+-tree query results
-	MyDB_RecordIteratorAltPtr myIter = input->getIteratorAlt ();
-	while (myIter->advance ()) {
+	int selected[MAX_BATCH_SIZE];
+	int numSelected = prefilter->run (batch, numRecs, selected);
+	for (int j = 0; j < numSelected; j++) {
 
-		myIter->getCurrent (inputRec);
+		inputRec->fromBinary (batch[selected[j]]);
 
 		// see if it is accepted by the predicate
 		if (!pred()->toBool ()) {
@@ -47,4 +68,22 @@ void RegularSelection :: run () {
 	}
 }
 
+void RegularSelection :: close () {
+	PipelineSink :: closeIfSink (output);
+}
+
+void RegularSelection :: run (int numThreads, bool inOrder) {
+
+	// the pages that the zone map says cannot have a match are skipped
+	function <bool (int)> readPage = input->getPageFilter (selectionPredicate);
+	vector <MyDB_PageReaderWriter> pages;
+	for (int i = 0; i < input->getNumPages (); i++)
+		if (readPage (i))
+			pages.push_back ((*input)[i]);
+
+	ParallelSelection parallel (input, output, selectionPredicate, projections, nullptr);
+	parallel.run (pages, numThreads, inOrder);
+	PipelineSink :: closeIfSink (output);
+}
+
 #endif
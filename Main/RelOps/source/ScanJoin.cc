@@ -2,6 +2,8 @@
 #ifndef SCAN_JOIN_C
 #define SCAN_JOIN_C
 
+#include "MyDB_ConjunctFilter.h"
+#include "MyDB_Hash.h"
 #include "MyDB_Record.h"
 #include "MyDB_PageReaderWriter.h"
 #include "MyDB_TableReaderWriter.h"
@@ -20,10 +22,13 @@ ScanJoin :: ScanJoin (MyDB_TableReaderWriterPtr leftInputIn, MyDB_TableReaderWri
 	finalSelectionPredicate = finalSelectionPredicateIn;
 	projections = projectionsIn;
 
-	// we need to make sure that the left table is smaller
+	// we need to make sure that the left table is smaller, although the records of a table that
+	// are pushed in cannot be hashed, since they are not all there until the end
 
 	// see which table is bigger 
-	if (leftInputIn->getNumPages () < rightInputIn->getNumPages ()) {
+	bool leftIsPushed = dynamic_pointer_cast <PipelineSink> (leftInputIn) != nullptr;
+	bool rightIsPushed = dynamic_pointer_cast <PipelineSink> (rightInputIn) != nullptr;
+	if (rightIsPushed || (!leftIsPushed && leftInputIn->getNumPages () < rightInputIn->getNumPages ())) {
 
 		// if the left is smaller, we are good
 		equalityChecks = equalityChecksIn;
@@ -49,67 +54,112 @@ ScanJoin :: ScanJoin (MyDB_TableReaderWriterPtr leftInputIn, MyDB_TableReaderWri
 	}
 }
 
-void ScanJoin :: run () {
+// everything that open () sets up, and that the records of the right table are run through
+struct ScanJoinState {
 
-	// this is the hash map we'll use to look up data... the key is the hashed value
-	// of all of the records' join keys, and the value is a list of pointers were all
-	// of the records with that hsah value are located
+	// this is the hash map we'll use to look up data... the key is the hashed value of all of
+	// the records' join keys, and the value is a list of pointers were all of the records with
+	// that hsah value are located; the pages of the left table stay pinned while it is used
 	unordered_map <size_t, vector <void *>> myHash;
-
-	// get all of the pages
 	vector <MyDB_PageReaderWriter> allData;
+
+	// the input records, and the one that combines them
+	MyDB_RecordPtr leftInputRec;
+	MyDB_RecordPtr rightInputRec;
+	MyDB_RecordPtr combinedRec;
+
+	// the functions over the right record whose output we'll hash, and the predicate over it
+	vector <func> rightEqualities;
+	func rightPred;
+	shared_ptr <MyDB_ConjunctFilter> rightPrefilter;
+
+	// the computations that build the output record, and the final predicate
+	vector <func> finalComputations;
+	func finalPredicate;
+	MyDB_RecordPtr outputRec;
+};
+
+void ScanJoin :: run () {
+
+	open ();
+
+	// now, iterate through the right table
+	void *batch[MAX_BATCH_SIZE];
+	MyDB_RecordIteratorAltPtr myIterAgain = rightTable->getIteratorAlt (rightTable->getPageFilter (rightSelectionPredicate));
+	int numRecs;
+	while ((numRecs = myIterAgain->getBatch (batch, MAX_BATCH_SIZE)) > 0)
+		consume (batch, numRecs);
+	close ();
+}
+
+void ScanJoin :: open () {
+
+	state = make_shared <ScanJoinState> ();
+	ScanJoinState &me = *state;
+
+	// get all of the pages, other than the ones that the zone map says cannot have a match
+	function <bool (int)> readLeftPage = leftTable->getPageFilter (leftSelectionPredicate);
 	for (int i = 0; i < leftTable->getNumPages (); i++) {
+		if (!readLeftPage (i))
+			continue;
 		MyDB_PageReaderWriter temp = leftTable->getPinned (i);
-		if (temp.getType () == MyDB_PageType :: RegularPage)
-			allData.push_back (leftTable->getPinned (i));
+		if (temp.getType () != MyDB_PageType :: DirectoryPage)
+			me.allData.push_back (temp.getRows ());
 	}
 	
 	// get the left input record 
-	MyDB_RecordPtr leftInputRec = leftTable->getEmptyRecord ();
+	me.leftInputRec = leftTable->getEmptyRecord ();
 
-	// and get the various functions whose output we'll hash
-	vector <func> leftEqualities;
+	// and get the various functions whose output we'll hash, and the predicate
+	vector <string> leftComputations;
 	for (auto &p : equalityChecks) {
-		leftEqualities.push_back (leftInputRec->compileComputation (p.first));
+		leftComputations.push_back (p.first);
 	}
-
-	// now get the predicate
-	func leftPred = leftInputRec->compileComputation (leftSelectionPredicate);
+	leftComputations.push_back (leftSelectionPredicate);
+	vector <func> leftEqualities = me.leftInputRec->compileComputations (leftComputations);
+	func leftPred = leftEqualities.back ();
+	leftEqualities.pop_back ();
+	MyDB_ConjunctFilter leftPrefilter (leftTable->getTable ()->getSchema (), leftSelectionPredicate);
 
 	// add all of the records to the hash table
-	MyDB_RecordIteratorAltPtr myIter = getIteratorAlt (allData);
-
-	while (myIter->advance ()) {
-
-		// hash the current record
-		myIter->getCurrent (leftInputRec);
-
-		// see if it is accepted by the preicate
-		if (!leftPred ()->toBool ()) {
-			continue;
+	void *batch[MAX_BATCH_SIZE];
+	int selected[MAX_BATCH_SIZE];
+	size_t hashes[MAX_BATCH_SIZE];
+	MyDB_RecordIteratorAltPtr myIter = me.allData.empty () ? nullptr : getIteratorAlt (me.allData);
+	int numRecs;
+	while (myIter != nullptr && (numRecs = myIter->getBatch (batch, MAX_BATCH_SIZE)) > 0) {
+
+		// keep the records that are accepted by the predicate
+		int numSelected = leftPrefilter.run (batch, numRecs, selected);
+		int numAccepted = 0;
+		for (int j = 0; j < numSelected; j++) {
+			me.leftInputRec->fromBinary (batch[selected[j]]);
+			if (leftPred ()->toBool ()) {
+				selected[numAccepted++] = selected[j];
+			}
 		}
 
-		// compute its hash
-		size_t hashVal = 0;
-		for (auto &f : leftEqualities) {
-			hashVal ^= f ()->hash ();
+		// and hash them
+		me.leftInputRec->hashBatch (batch, selected, numAccepted, leftEqualities, hashes);
+		for (int j = 0; j < numAccepted; j++) {
+			me.myHash [hashes[j]].push_back (batch[selected[j]]);
 		}
-
-		// see if it is in the hash table
-		myHash [hashVal].push_back (myIter->getCurrentPointer ());
 	}
+	chainLengths = getChainHistogram (me.myHash);
 
-	// and now we iterate through the other table
+	// and now we get ready for the other table
 	
 	// get the right input record, and get the various functions over it
-	MyDB_RecordPtr rightInputRec = rightTable->getEmptyRecord ();
-	vector <func> rightEqualities;
+	me.rightInputRec = rightTable->getEmptyRecord ();
+	vector <string> rightComputations;
 	for (auto &p : equalityChecks) {
-		rightEqualities.push_back (rightInputRec->compileComputation (p.second));
+		rightComputations.push_back (p.second);
 	}
-
-	// now get the predicate
-	func rightPred = rightInputRec->compileComputation (rightSelectionPredicate);
+	rightComputations.push_back (rightSelectionPredicate);
+	me.rightEqualities = me.rightInputRec->compileComputations (rightComputations);
+	me.rightPred = me.rightEqualities.back ();
+	me.rightEqualities.pop_back ();
+	me.rightPrefilter = make_shared <MyDB_ConjunctFilter> (rightTable->getTable ()->getSchema (), rightSelectionPredicate);
 
 	// and get the schema that results from combining the left and right records
 	MyDB_SchemaPtr mySchemaOut = make_shared <MyDB_Schema> ();
@@ -119,60 +169,64 @@ void ScanJoin :: run () {
 		mySchemaOut->appendAtt (p);
 
 	// get the combined record
-	MyDB_RecordPtr combinedRec = make_shared <MyDB_Record> (mySchemaOut);
-	combinedRec->buildFrom (leftInputRec, rightInputRec);
+	me.combinedRec = make_shared <MyDB_Record> (mySchemaOut);
+	me.combinedRec->buildFrom (me.leftInputRec, me.rightInputRec);
 
-	// now, get the final predicate over it
-	func finalPredicate = combinedRec->compileComputation (finalSelectionPredicate);
-
-	// and get the final set of computatoins that will be used to buld the output record
-	vector <func> finalComputations;
-	for (string s : projections) {
-		finalComputations.push_back (combinedRec->compileComputation (s));
-	}
+	// now, get the final set of computatoins that will be used to buld the output record, and
+	// the final predicate over it
+	vector <string> computations = projections;
+	computations.push_back (finalSelectionPredicate);
+	me.finalComputations = me.combinedRec->compileComputations (computations);
+	me.finalPredicate = me.finalComputations.back ();
+	me.finalComputations.pop_back ();
 
 	// this is the output record
-	MyDB_RecordPtr outputRec = output->getEmptyRecord ();
-	
-	// now, iterate through the right table
-	MyDB_RecordIteratorPtr myIterAgain = rightTable->getIterator (rightInputRec);
-	while (myIterAgain->hasNext ()) {
+	me.outputRec = output->getEmptyRecord ();
+}
 
-		myIterAgain->getNext ();
+void ScanJoin :: consume (void **batch, int numRecs) {
 
-		// see if it is accepted by the preicate
-		if (!rightPred ()->toBool ()) {
-			continue;
-		}
+	ScanJoinState &me = *state;
+	int selected[MAX_BATCH_SIZE];
+	size_t hashes[MAX_BATCH_SIZE];
 
-		// hash the current record
-		size_t hashVal = 0;
-		for (auto &f : rightEqualities) {
-			hashVal ^= f ()->hash ();
+	// keep the records that are accepted by the predicate, and hash them
+	int numSelected = me.rightPrefilter->run (batch, numRecs, selected);
+	int numAccepted = 0;
+	for (int j = 0; j < numSelected; j++) {
+		me.rightInputRec->fromBinary (batch[selected[j]]);
+		if (me.rightPred ()->toBool ()) {
+			selected[numAccepted++] = selected[j];
 		}
+	}
+	me.rightInputRec->hashBatch (batch, selected, numAccepted, me.rightEqualities, hashes);
+
+	for (int j = 0; j < numAccepted; j++) {
 
 		// get the list of potential matches... first verify that there IS
 		// a match in there
-		if (myHash.count (hashVal) == 0) {
+		auto found = me.myHash.find (hashes[j]);
+		if (found == me.myHash.end ()) {
 			continue;
 		}
 
 		// if there is a match, then get the list of matches
-		vector <void *> &potentialMatches = myHash [hashVal];
-		
+		vector <void *> &potentialMatches = found->second;
+		me.rightInputRec->fromBinary (batch[selected[j]]);
+	
 		// and iterate though the potential matches, checking each of them
 		for (auto &v : potentialMatches) {
 
 			// build the combined record
-			leftInputRec->fromBinary (v);
+			me.leftInputRec->fromBinary (v);
 
 			// check to see if it is accepted by the join predicate
-			if (finalPredicate ()->toBool ()) {
+			if (me.finalPredicate ()->toBool ()) {
 
 				// run all of the computations
 				int i = 0;
-				for (auto &f : finalComputations) {
-					outputRec->getAtt (i++)->set (f());
+				for (auto &f : me.finalComputations) {
+					me.outputRec->getAtt (i++)->set (f());
 				}
 
 				// the record's content has changed because it 
@@ -180,12 +234,23 @@ void ScanJoin :: run () {
 				// has changed via a read... we have to tell it this,
 				// or else the record's internal buffer may cause it
 				// to write old values
-				outputRec->recordContentHasChanged ();
-				output->append (outputRec);	
+				me.outputRec->recordContentHasChanged ();
+				output->append (me.outputRec);	
 			}
 		}
 	}
 }
 
+void ScanJoin :: close () {
+
+	// the pages of the left table are unpinned before the output is closed
+	state = nullptr;
+	PipelineSink :: closeIfSink (output);
+}
+
+vector <size_t> &ScanJoin :: getChainLengths () {
+	return chainLengths;
+}
+
 #endif
 
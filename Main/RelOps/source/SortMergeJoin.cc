@@ -28,6 +28,40 @@ SortMergeJoin :: SortMergeJoin (MyDB_TableReaderWriterPtr leftInputIn, MyDB_Tabl
 }
 
 void SortMergeJoin :: run () {
+	merge ();
+	PipelineSink :: closeIfSink (output);
+}
+
+void SortMergeJoin :: open () {
+
+	// the records are kept in anonymous pages, with the schema of the side that they are for
+	pushedIsLeft = dynamic_pointer_cast <PipelineSink> (rightTable) == nullptr;
+	MyDB_TableReaderWriterPtr pushedSide = pushedIsLeft ? leftTable : rightTable;
+	pushed = make_shared <MyDB_TempTableReaderWriter> (pushedSide->getTable ()->getSchema (), pushedSide->getBufferMgr ());
+	pushedRec = pushed->getEmptyRecord ();
+}
+
+void SortMergeJoin :: consume (void **recs, int numRecs) {
+	for (int i = 0; i < numRecs; i++) {
+		pushedRec->fromBinary (recs[i]);
+		pushed->append (pushedRec);
+	}
+}
+
+void SortMergeJoin :: close () {
+
+	// the join is run with the records that were pushed in standing in for the sink
+	MyDB_TableReaderWriterPtr &pushedSide = pushedIsLeft ? leftTable : rightTable;
+	MyDB_TableReaderWriterPtr sink = pushedSide;
+	pushedSide = pushed;
+	merge ();
+	pushedSide = sink;
+	pushed = nullptr;
+	pushedRec = nullptr;
+	PipelineSink :: closeIfSink (output);
+}
+
+void SortMergeJoin :: merge () {
 
 	// get two left input records
 	MyDB_RecordPtr leftInputRec = leftTable->getEmptyRecord ();
@@ -40,13 +74,23 @@ void SortMergeJoin :: run () {
 	// build comparators over them
 	function <bool ()> leftComp = buildRecordComparator (leftInputRec, leftInputRecOther, equalityCheck.first);
 	function <bool ()> leftCompRev = buildRecordComparator (leftInputRecOther, leftInputRec, equalityCheck.first);
-	function <bool ()> rightComp = buildRecordComparator (rightInputRec, rightInputRecOther, equalityCheck.second);
+
+	// the iterators over the sorted runs load the records at the heads of the runs into their own
+	// pair of records to compare them, so they get records other than the ones used by the merge;
+	// otherwise, once there is more than one run, advancing an iterator would overwrite the record
+	// that the current group is compared with
+	MyDB_RecordPtr leftSortRec = leftTable->getEmptyRecord ();
+	MyDB_RecordPtr leftSortRecOther = leftTable->getEmptyRecord ();
+	MyDB_RecordPtr rightSortRec = rightTable->getEmptyRecord ();
+	MyDB_RecordPtr rightSortRecOther = rightTable->getEmptyRecord ();
+	function <bool ()> leftSortComp = buildRecordComparator (leftSortRec, leftSortRecOther, equalityCheck.first);
+	function <bool ()> rightSortComp = buildRecordComparator (rightSortRec, rightSortRecOther, equalityCheck.second);
 
 	// now, sort the left and the right
-	MyDB_RecordIteratorAltPtr right = buildItertorOverSortedRuns (runSize, *rightTable, rightComp, rightInputRec, 
-		rightInputRecOther, rightSelectionPredicate);
-	MyDB_RecordIteratorAltPtr left = buildItertorOverSortedRuns (runSize, *leftTable, leftComp, leftInputRec, 
-		leftInputRecOther, leftSelectionPredicate);
+	MyDB_RecordIteratorAltPtr right = buildItertorOverSortedRuns (runSize, *rightTable, rightSortComp, rightSortRec, 
+		rightSortRecOther, rightSelectionPredicate);
+	MyDB_RecordIteratorAltPtr left = buildItertorOverSortedRuns (runSize, *leftTable, leftSortComp, leftSortRec, 
+		leftSortRecOther, leftSelectionPredicate);
 
 	// and get the schema that results from combining the left and right records
 	MyDB_SchemaPtr mySchemaOut = make_shared <MyDB_Schema> ();
@@ -59,19 +103,22 @@ void SortMergeJoin :: run () {
 	MyDB_RecordPtr combinedRec = make_shared <MyDB_Record> (mySchemaOut);
 	combinedRec->buildFrom (leftInputRec, rightInputRec);
 
-	// now, get the final predicate over it
-	func finalPredicate = combinedRec->compileComputation (finalSelectionPredicate);
-
-	// and get the final set of computatoins that will be used to buld the output record
-	vector <func> finalComputations;
-	for (string s : projections) {
-		finalComputations.push_back (combinedRec->compileComputation (s));
-	}
-	
-	// compares the two input recs
-	func leftSmaller = combinedRec->compileComputation (" < (" + equalityCheck.first + ", " + equalityCheck.second + ")");
-	func rightSmaller = combinedRec->compileComputation (" > (" + equalityCheck.first + ", " + equalityCheck.second + ")");
-	func areEqual = combinedRec->compileComputation (" == (" + equalityCheck.first + ", " + equalityCheck.second + ")");
+	// now, get the final set of computatoins that will be used to buld the output record, the
+	// final predicate over it, and the comparisons of the two input recs
+	vector <string> computations = projections;
+	computations.push_back (finalSelectionPredicate);
+	computations.push_back (" < (" + equalityCheck.first + ", " + equalityCheck.second + ")");
+	computations.push_back (" > (" + equalityCheck.first + ", " + equalityCheck.second + ")");
+	computations.push_back (" == (" + equalityCheck.first + ", " + equalityCheck.second + ")");
+	vector <func> finalComputations = combinedRec->compileComputations (computations);
+	func areEqual = finalComputations.back ();
+	finalComputations.pop_back ();
+	func rightSmaller = finalComputations.back ();
+	finalComputations.pop_back ();
+	func leftSmaller = finalComputations.back ();
+	finalComputations.pop_back ();
+	func finalPredicate = finalComputations.back ();
+	finalComputations.pop_back ();
 	
 	// this is the output record
 	MyDB_RecordPtr outputRec = output->getEmptyRecord ();
@@ -79,6 +126,7 @@ void SortMergeJoin :: run () {
 	// it is time to run the merge!!
 	MyDB_PageReaderWriter lastPage (true, *(leftTable->getBufferMgr ()));
 	vector <MyDB_PageReaderWriter> allPages;
+	void *batch[MAX_BATCH_SIZE];
 
 	// if we have no results...
 	if (!left->advance () || !right->advance ())
@@ -160,16 +208,19 @@ void SortMergeJoin :: run () {
 					}
 
 					// check for a match
-					while (myIterAgain->advance ()) {
-						myIterAgain->getCurrent (leftInputRec);		
-						if (finalPredicate ()->toBool ()) {
-							// got one!!
-							int i = 0;
-							for (auto &f : finalComputations) {
-								outputRec->getAtt (i++)->set (f());
+					int numRecs;
+					while ((numRecs = myIterAgain->getBatch (batch, MAX_BATCH_SIZE)) > 0) {
+						for (int r = 0; r < numRecs; r++) {
+							leftInputRec->fromBinary (batch[r]);
+							if (finalPredicate ()->toBool ()) {
+								// got one!!
+								int i = 0;
+								for (auto &f : finalComputations) {
+									outputRec->getAtt (i++)->set (f());
+								}
+								outputRec->recordContentHasChanged ();
+								output->append (outputRec);	
 							}
-							outputRec->recordContentHasChanged ();
-							output->append (outputRec);	
 						}
 					}
 					
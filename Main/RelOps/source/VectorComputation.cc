@@ -0,0 +1,439 @@
+
+#ifndef VECTOR_COMP_C
+#define VECTOR_COMP_C
+
+#include "VectorComputation.h"
+#include <chrono>
+#include <string.h>
+
+using namespace std;
+
+// the conjuncts of an and are re-ordered after this many batches
+#define REORDER_BATCHES 16
+
+// the loops used for the comparisons... each writes position s to out, and then only moves
+// on if the comparison was true, so that there is no branch inside of the loop
+template <class T, class Pred>
+static int compareLoop (ColumnVector *l, T *lVals, ColumnVector *r, T *rVals, int *sel, int n, int *out, Pred pred) {
+
+	int k = 0;
+	if (l->isConstant && r->isConstant) {
+		if (!pred (lVals[0], rVals[0]))
+			return 0;
+		for (int i = 0; i < n; i++)
+			out[i] = sel[i];
+		return n;
+	} else if (r->isConstant) {
+		T rVal = rVals[0];
+		for (int i = 0; i < n; i++) {
+			int s = sel[i];
+			out[k] = s;
+			k += pred (lVals[s], rVal);
+		}
+	} else if (l->isConstant) {
+		T lVal = lVals[0];
+		for (int i = 0; i < n; i++) {
+			int s = sel[i];
+			out[k] = s;
+			k += pred (lVal, rVals[s]);
+		}
+	} else {
+		for (int i = 0; i < n; i++) {
+			int s = sel[i];
+			out[k] = s;
+			k += pred (lVals[s], rVals[s]);
+		}
+	}
+	return k;
+}
+
+template <class T>
+static int compareNumbers (MyDB_ExprOp op, ColumnVector *l, T *lVals, ColumnVector *r, T *rVals, int *sel, int n, int *out) {
+	switch (op) {
+	case gtOp: return compareLoop (l, lVals, r, rVals, sel, n, out, [] (T a, T b) {return a > b;});
+	case ltOp: return compareLoop (l, lVals, r, rVals, sel, n, out, [] (T a, T b) {return a < b;});
+	case eqOp: return compareLoop (l, lVals, r, rVals, sel, n, out, [] (T a, T b) {return a == b;});
+	default: return compareLoop (l, lVals, r, rVals, sel, n, out, [] (T a, T b) {return a != b;});
+	}
+}
+
+static int compareStrings (MyDB_ExprOp op, ColumnVector *l, ColumnVector *r, int *sel, int n, int *out) {
+	const char **lVals = l->strings.data ();
+	const char **rVals = r->strings.data ();
+	switch (op) {
+	case gtOp: return compareLoop (l, lVals, r, rVals, sel, n, out, [] (const char *a, const char *b) {return strcmp (a, b) > 0;});
+	case ltOp: return compareLoop (l, lVals, r, rVals, sel, n, out, [] (const char *a, const char *b) {return strcmp (a, b) < 0;});
+	case eqOp: return compareLoop (l, lVals, r, rVals, sel, n, out, [] (const char *a, const char *b) {return strcmp (a, b) == 0;});
+	default: return compareLoop (l, lVals, r, rVals, sel, n, out, [] (const char *a, const char *b) {return strcmp (a, b) != 0;});
+	}
+}
+
+// the loops used for arithmetic
+template <class T, class Op>
+static void arithLoop (ColumnVector *l, T *lVals, ColumnVector *r, T *rVals, T *res, int *sel, int n, Op op) {
+
+	if (r->isConstant) {
+		T rVal = rVals[0];
+		for (int i = 0; i < n; i++) {
+			int s = sel[i];
+			res[s] = op (lVals[l->pos (s)], rVal);
+		}
+	} else if (l->isConstant) {
+		T lVal = lVals[0];
+		for (int i = 0; i < n; i++) {
+			int s = sel[i];
+			res[s] = op (lVal, rVals[s]);
+		}
+	} else {
+		for (int i = 0; i < n; i++) {
+			int s = sel[i];
+			res[s] = op (lVals[s], rVals[s]);
+		}
+	}
+}
+
+template <class T>
+static void arithNumbers (MyDB_ExprOp op, ColumnVector *l, T *lVals, ColumnVector *r, T *rVals, T *res, int *sel, int n) {
+	switch (op) {
+	case plusOp: arithLoop (l, lVals, r, rVals, res, sel, n, [] (T a, T b) {return a + b;}); break;
+	case minusOp: arithLoop (l, lVals, r, rVals, res, sel, n, [] (T a, T b) {return a - b;}); break;
+	case timesOp: arithLoop (l, lVals, r, rVals, res, sel, n, [] (T a, T b) {return a * b;}); break;
+	default: arithLoop (l, lVals, r, rVals, res, sel, n, [] (T a, T b) {return a / b;}); break;
+	}
+}
+
+// the number of digits after the decimal point for a value of the given type; zero if it is not a decimal
+static int scaleOf (MyDB_AttTypePtr type) {
+	MyDB_DecimalAttTypePtr decimalType = dynamic_pointer_cast <MyDB_DecimalAttType> (type);
+	return (decimalType == nullptr) ? 0 : decimalType->getScale ();
+}
+
+VectorComputation :: VectorComputation (MyDB_ExprPtr myExprIn) {
+
+	myExpr = myExprIn;
+	MyDB_ExprOp op = myExpr->getOp ();
+	useKernel = false;
+
+	// attributes come right out of the batch
+	if (op == attOp)
+		return;
+
+	// literals are stored as constant vectors
+	if (myExpr->isLiteral ()) {
+		result.setUp (myExpr->getMode (), true, 0);
+		if (op == intOp) {
+			result.ints[0] = myExpr->getInt ();
+		} else if (op == doubleOp) {
+			result.doubles[0] = myExpr->getDouble ();
+		} else if (op == stringOp) {
+			result.stringStore[0] = myExpr->getString ();
+			result.strings[0] = result.stringStore[0].c_str ();
+		} else {
+			result.bools[0] = myExpr->getBool ();
+		}
+		return;
+	}
+
+	// everything else has at least one input; if the work is done over decimals, then the
+	// inputs are brought to the same scale first, except for a *
+	MyDB_ExprMode mode = myExpr->getMode ();
+	int lhsScale = scaleOf (myExpr->getLHS ()->getType ());
+	int rhsScale = (myExpr->getRHS () == nullptr) ? lhsScale : scaleOf (myExpr->getRHS ()->getType ());
+	if (op != timesOp)
+		lhsScale = rhsScale = max (lhsScale, rhsScale);
+
+	result.setUp (getMode (), false, scaleOf (myExpr->getType ()));
+	lhs = make_shared <VectorComputation> (myExpr->getLHS ());
+	if (lhs->getMode () != mode || mode == decimalMode)
+		lhsPromoted.setUp (mode, myExpr->getLHS ()->isLiteral (), lhsScale);
+	if (myExpr->getRHS () != nullptr) {
+		rhs = make_shared <VectorComputation> (myExpr->getRHS ());
+		if (rhs->getMode () != mode || mode == decimalMode)
+			rhsPromoted.setUp (mode, myExpr->getRHS ()->isLiteral (), rhsScale);
+	}
+
+	selA.resize (MAX_BATCH_SIZE);
+	selB.resize (MAX_BATCH_SIZE);
+	accepted.resize (MAX_BATCH_SIZE);
+
+	// an and is filtered one conjunct at a time, in an order that is picked as the scan goes
+	if (op == andOp) {
+		vector <MyDB_ExprPtr> conjunctExprs;
+		vector <string> names;
+		vector <bool> pinned;
+		MyDB_Expr :: getConjuncts (myExpr, conjunctExprs);
+		for (MyDB_ExprPtr e : conjunctExprs) {
+			conjuncts.push_back (make_shared <VectorComputation> (e));
+			names.push_back (e->toString ());
+			pinned.push_back (e->canFail ());
+		}
+		conjunctOrder = make_shared <MyDB_ConjunctOrder> (names, pinned, REORDER_BATCHES);
+	}
+
+	// see if we can use the comparison kernels
+	useKernel = myExpr->isAttVsLiteral (kernelAtt, kernelCmp, kernelLiteral) &&
+		(myExpr->getMode () == intMode || myExpr->getMode () == doubleMode);
+	if (useKernel)
+		bits.resize ((MAX_BATCH_SIZE + 63) / 64);
+
+	// see if we can compare dictionary codes; a string that is not in the dictionary gets a
+	// code that matches nothing
+	onCodes = false;
+	if ((op == eqOp || op == neqOp) && myExpr->isAttVsLiteral (kernelAtt, kernelCmp, kernelLiteral)) {
+		MyDB_ExprPtr att = (myExpr->getLHS ()->getOp () == attOp) ? myExpr->getLHS () : myExpr->getRHS ();
+		MyDB_DictStringAttTypePtr dictType = dynamic_pointer_cast <MyDB_DictStringAttType> (att->getType ());
+		if (dictType != nullptr) {
+			string &val = kernelLiteral->getString ();
+			literalCode = dictType->getDictionary ()->find (MyDB_StringView (val.data (), val.size ()));
+			onCodes = true;
+			bits.resize ((MAX_BATCH_SIZE + 63) / 64);
+		}
+	}
+}
+
+MyDB_ExprMode VectorComputation :: getMode () {
+	if (myExpr->getType ()->isBool ())
+		return boolMode;
+	return myExpr->getMode ();
+}
+
+ColumnVector *VectorComputation :: promote (ColumnVector *in, MyDB_ExprMode toMode, ColumnVector &scratch, int *sel, int n) {
+
+	if (in->mode == toMode && (toMode != decimalMode || in->scale == scratch.scale))
+		return in;
+
+	// a constant has just the one value
+	int zero = 0;
+	if (in->isConstant) {
+		sel = &zero;
+		n = 1;
+	}
+
+	// an int or a decimal is brought to a (larger) scale by multiplying by a power of ten
+	if (toMode == decimalMode) {
+		long long factor = MyDB_DecimalAttVal :: powerOfTen (scratch.scale - (in->mode == decimalMode ? in->scale : 0));
+		for (int i = 0; i < n; i++) {
+			int s = sel[i];
+			scratch.longs[s] = (in->mode == decimalMode ? in->longs[s] : in->ints[s]) * factor;
+		}
+		return &scratch;
+	}
+
+	for (int i = 0; i < n; i++) {
+		int s = sel[i];
+		if (toMode == doubleMode && in->mode == decimalMode) {
+			scratch.doubles[s] = (double) in->longs[s] / (double) MyDB_DecimalAttVal :: powerOfTen (in->scale);
+		} else if (toMode == doubleMode) {
+			scratch.doubles[s] = (double) in->ints[s];
+		} else if (in->mode == boolMode) {
+			scratch.strings[s] = in->bools[s] ? "true" : "false";
+		} else {
+			if (in->isDate)
+				scratch.stringStore[s] = MyDB_DateAttVal :: formatDate (in->ints[s]);
+			else if (in->mode == decimalMode)
+				scratch.stringStore[s] = MyDB_DecimalAttVal :: format (in->longs[s], in->scale);
+			else
+				scratch.stringStore[s] = (in->mode == intMode) ? to_string (in->ints[s]) : to_string (in->doubles[s]);
+			scratch.strings[s] = scratch.stringStore[s].c_str ();
+		}
+	}
+	return &scratch;
+}
+
+ColumnVector *VectorComputation :: evaluate (ColumnBatch &batch, int *sel, int n) {
+
+	MyDB_ExprOp op = myExpr->getOp ();
+	if (op == attOp)
+		return batch.getColumn (myExpr->getAttIndex ());
+
+	if (myExpr->isLiteral ())
+		return &result;
+
+	if (op == plusOp || op == minusOp || op == timesOp || op == divideOp || op == uMinusOp) {
+		arithmetic (batch, sel, n);
+		return &result;
+	}
+
+	// if we got here, we have a boolean operation, so run it as a filter
+	int k = filter (batch, sel, n, accepted.data ());
+	char *bools = result.bools.data ();
+	for (int i = 0; i < n; i++)
+		bools[sel[i]] = 0;
+	for (int i = 0; i < k; i++)
+		bools[accepted[i]] = 1;
+	return &result;
+}
+
+void VectorComputation :: arithmetic (ColumnBatch &batch, int *sel, int n) {
+
+	MyDB_ExprOp op = myExpr->getOp ();
+	MyDB_ExprMode mode = myExpr->getMode ();
+	ColumnVector *l = promote (lhs->evaluate (batch, sel, n), mode, lhsPromoted, sel, n);
+
+	if (op == uMinusOp) {
+		for (int i = 0; i < n; i++) {
+			int s = sel[i];
+			if (mode == intMode)
+				result.ints[s] = -l->ints[l->pos (s)];
+			else if (mode == decimalMode)
+				result.longs[s] = -l->longs[l->pos (s)];
+			else
+				result.doubles[s] = -l->doubles[l->pos (s)];
+		}
+		return;
+	}
+
+	ColumnVector *r = promote (rhs->evaluate (batch, sel, n), mode, rhsPromoted, sel, n);
+	if (mode == intMode) {
+		arithNumbers (op, l, l->ints.data (), r, r->ints.data (), result.ints.data (), sel, n);
+	} else if (mode == doubleMode) {
+		arithNumbers (op, l, l->doubles.data (), r, r->doubles.data (), result.doubles.data (), sel, n);
+	} else if (mode == decimalMode) {
+		arithNumbers (op, l, l->longs.data (), r, r->longs.data (), result.longs.data (), sel, n);
+
+	// the only operation over strings is concatenation; the storage is re-used from batch to batch
+	} else {
+		for (int i = 0; i < n; i++) {
+			int s = sel[i];
+			string &store = result.stringStore[s];
+			store.assign (l->strings[l->pos (s)]);
+			store.append (r->strings[r->pos (s)]);
+			result.strings[s] = store.c_str ();
+		}
+	}
+}
+
+int VectorComputation :: compare (ColumnBatch &batch, int *sel, int n, int *out) {
+
+	MyDB_ExprOp op = myExpr->getOp ();
+	MyDB_ExprMode mode = myExpr->getMode ();
+
+	// if we are looking at the whole batch, then the values are contiguous, so use a kernel
+	if (useKernel && sel == batch.getAllRows ()) {
+		ColumnVector *col = batch.getColumn (kernelAtt);
+		if (mode == intMode)
+			compareInts (col->ints.data (), n, kernelCmp, kernelLiteral->getInt (), bits.data ());
+		else if (kernelLiteral->getOp () == intOp)
+			compareDoubles (col->doubles.data (), n, kernelCmp, kernelLiteral->getInt (), bits.data ());
+		else
+			compareDoubles (col->doubles.data (), n, kernelCmp, kernelLiteral->getDouble (), bits.data ());
+		return bitmapToSelection (bits.data (), n, out);
+	}
+
+	if (onCodes) {
+		int *codes = batch.getColumn (kernelAtt)->ints.data ();
+		if (sel == batch.getAllRows ()) {
+			compareInts (codes, n, kernelCmp, literalCode, bits.data ());
+			return bitmapToSelection (bits.data (), n, out);
+		}
+		int k = 0;
+		bool isEq = (kernelCmp == eqOp);
+		for (int i = 0; i < n; i++) {
+			int s = sel[i];
+			out[k] = s;
+			k += ((codes[s] == literalCode) == isEq);
+		}
+		return k;
+	}
+
+	ColumnVector *l = promote (lhs->evaluate (batch, sel, n), mode, lhsPromoted, sel, n);
+	ColumnVector *r = promote (rhs->evaluate (batch, sel, n), mode, rhsPromoted, sel, n);
+
+	if (mode == intMode)
+		return compareNumbers (op, l, l->ints.data (), r, r->ints.data (), sel, n, out);
+	else if (mode == doubleMode)
+		return compareNumbers (op, l, l->doubles.data (), r, r->doubles.data (), sel, n, out);
+	else if (mode == decimalMode)
+		return compareNumbers (op, l, l->longs.data (), r, r->longs.data (), sel, n, out);
+	else if (mode == boolMode)
+		return compareNumbers (op, l, l->bools.data (), r, r->bools.data (), sel, n, out);
+	else
+		return compareStrings (op, l, r, sel, n, out);
+}
+
+MyDB_ConjunctOrderPtr VectorComputation :: getConjunctOrder () {
+	return conjunctOrder;
+}
+
+int VectorComputation :: filter (ColumnBatch &batch, int *sel, int n, int *out) {
+
+	MyDB_ExprOp op = myExpr->getOp ();
+
+	if (op == boolOp) {
+		if (!myExpr->getBool ())
+			return 0;
+		if (out != sel)
+			memcpy (out, sel, n * sizeof (int));
+		return n;
+	}
+
+	// a boolean attribute... just use the values in the batch
+	if (op == attOp) {
+		char *bools = evaluate (batch, sel, n)->bools.data ();
+		int k = 0;
+		for (int i = 0; i < n; i++) {
+			int s = sel[i];
+			out[k] = s;
+			k += bools[s];
+		}
+		return k;
+	}
+
+	if (op == gtOp || op == ltOp || op == eqOp || op == neqOp)
+		return compare (batch, sel, n, out);
+
+	// for an and, each conjunct only needs to look at the records accepted by the ones before
+	// it; each is timed, so that the conjuncts can be re-ordered
+	if (op == andOp) {
+		int k = n;
+		int *in = sel;
+		for (int which : conjunctOrder->getOrder ()) {
+			auto start = chrono :: steady_clock :: now ();
+			int numOut = conjuncts[which]->filter (batch, in, k, out);
+			double nanos = chrono :: duration <double, nano> (chrono :: steady_clock :: now () - start).count ();
+			conjunctOrder->addCounts (which, k, numOut);
+			conjunctOrder->addTime (which, k, nanos);
+			k = numOut;
+			in = out;
+			if (k == 0)
+				break;
+		}
+		conjunctOrder->tick ();
+		return k;
+	}
+
+	// for an or, the right side only needs to look at the records rejected by the left,
+	// and then the two (sorted) lists are merged
+	if (op == orOp) {
+		int numLeft = lhs->filter (batch, sel, n, selA.data ());
+		int numRest = 0;
+		for (int i = 0, j = 0; i < n; i++) {
+			if (j < numLeft && selA[j] == sel[i])
+				j++;
+			else
+				selB[numRest++] = sel[i];
+		}
+		int numRight = rhs->filter (batch, selB.data (), numRest, selB.data ());
+		int i = 0, j = 0, k = 0;
+		while (i < numLeft && j < numRight)
+			out[k++] = (selA[i] < selB[j]) ? selA[i++] : selB[j++];
+		while (i < numLeft)
+			out[k++] = selA[i++];
+		while (j < numRight)
+			out[k++] = selB[j++];
+		return k;
+	}
+
+	// if we got here, it is a not; output everything rejected by the child
+	int numChild = lhs->filter (batch, sel, n, selA.data ());
+	int k = 0;
+	for (int i = 0, j = 0; i < n; i++) {
+		if (j < numChild && selA[j] == sel[i])
+			j++;
+		else
+			out[k++] = sel[i];
+	}
+	return k;
+}
+
+#endif
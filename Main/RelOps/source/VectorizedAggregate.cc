@@ -0,0 +1,423 @@
+
+#ifndef VEC_AGG_CC
+#define VEC_AGG_CC
+
+#include "ColumnBatch.h"
+#include "MorselExecutor.h"
+#include "MyDB_Expr.h"
+#include "VectorComputation.h"
+#include "VectorizedAggregate.h"
+#include <algorithm>
+#include <math.h>
+#include <unordered_map>
+
+using namespace std;
+
+VectorizedAggregate :: VectorizedAggregate (MyDB_TableReaderWriterPtr inputIn, MyDB_TableReaderWriterPtr outputIn,
+                vector <pair <MyDB_AggType, string>> aggsToComputeIn,
+                vector <string> groupingsIn, string selectionPredicateIn) {
+
+	input = inputIn;
+	output = outputIn;
+
+	// a count does not look at its computation, so it is not parsed
+	for (auto &a : aggsToComputeIn) {
+		MyDB_ExprPtr agg = (a.first == MyDB_AggType :: cntA) ? nullptr : MyDB_Expr :: parse (a.second);
+		aggsToCompute.push_back (make_pair (a.first, agg));
+	}
+	for (string &s : groupingsIn)
+		groupings.push_back (MyDB_Expr :: parse (s));
+	selectionPredicate = MyDB_Expr :: parse (selectionPredicateIn);
+}
+
+VectorizedAggregate :: VectorizedAggregate (MyDB_TableReaderWriterPtr inputIn, MyDB_TableReaderWriterPtr outputIn,
+                vector <pair <MyDB_AggType, MyDB_ExprPtr>> aggsToComputeIn,
+                vector <MyDB_ExprPtr> groupingsIn, MyDB_ExprPtr selectionPredicateIn) {
+
+	input = inputIn;
+	output = outputIn;
+	aggsToCompute = aggsToComputeIn;
+	groupings = groupingsIn;
+	selectionPredicate = selectionPredicateIn;
+}
+
+void VectorizedAggregate :: runRegularAggregate () {
+
+	// the Aggregate resolves the computations against its own records; anything that has been
+	// resolved already still means the same thing (a date literal that was turned into an int is
+	// still compared as an int)
+	Aggregate regularAgg (input, output, aggsToCompute, groupings, selectionPredicate);
+	regularAgg.run ();
+}
+
+string VectorizedAggregate :: getConjunctOrder () {
+	if (conjunctOrder == nullptr)
+		return "";
+	return conjunctOrder->toString ();
+}
+
+// the groups that one pipeline has seen, with the running aggregates for each, along with the
+// computations that the pipeline runs (which hold the vectors that they compute into, so each
+// pipeline needs its own)
+struct VectorAggPartial {
+
+	shared_ptr <VectorComputation> predComp;
+	vector <VectorComputationPtr> groupingComps;
+	vector <VectorComputationPtr> aggComps;
+	shared_ptr <ColumnBatch> columns;
+	MyDB_RecordPtr outRec;
+
+	// this maps the binary version of the grouping values to the group's number; for each group,
+	// there is its key, and the position of the first record in the group, since the groups are
+	// output in the order that they are first seen
+	unordered_map <string, int> groupIds;
+	vector <string> keys;
+	vector <long long> firstSeen;
+	vector <MyDB_AttValPtr> groupVals;
+	vector <int> counts;
+	vector <vector <int>> intAggs;
+	vector <vector <double>> doubleAggs;
+	vector <vector <long long>> decimalAggs;
+};
+
+bool VectorizedAggregate :: setUp () {
+
+	MyDB_SchemaPtr inputSchema = input->getTable ()->getSchema ();
+	vector <pair <string, MyDB_AttTypePtr>> &outAtts = output->getTable ()->getSchema ()->getAtts ();
+	numGroupAtts = groupings.size ();
+	numAggs = aggsToCompute.size ();
+	attsNeeded.clear ();
+	isIntAgg.clear ();
+	decimalScale.clear ();
+
+	// resolve the predicate and the groupings
+	selectionPredicate->resolve (inputSchema);
+	selectionPredicate->getAtts (attsNeeded);
+	for (MyDB_ExprPtr group : groupings) {
+		group->resolve (inputSchema);
+		group->getAtts (attsNeeded);
+	}
+
+	// and the aggregates; the running value of an aggregate is an int if the output attribute
+	// is an int, a scaled integer if it is a decimal (so that a sum is exact), and a double
+	// otherwise.  If an aggregate is over something other than numbers, or the output
+	// attribute cannot hold a number, a regular Aggregate is needed
+	for (int i = 0; i < numAggs; i++) {
+		MyDB_AttTypePtr outType = outAtts[numGroupAtts + i].second;
+		if (outType->isBool () || !outType->promotableToDouble ())
+			return false;
+		isIntAgg.push_back (outType->promotableToInt ());
+		MyDB_DecimalAttTypePtr decimalType = dynamic_pointer_cast <MyDB_DecimalAttType> (outType);
+		decimalScale.push_back (decimalType == nullptr ? -1 : decimalType->getScale ());
+
+		// a count does not need to look at the computation at all
+		if (aggsToCompute[i].first == MyDB_AggType :: cntA)
+			continue;
+
+		MyDB_ExprPtr agg = aggsToCompute[i].second;
+		agg->resolve (inputSchema);
+		if (agg->getType ()->isBool () || agg->getMode () == stringMode)
+			return false;
+		agg->getAtts (attsNeeded);
+	}
+	return true;
+}
+
+shared_ptr <VectorAggPartial> VectorizedAggregate :: makePartial () {
+
+	shared_ptr <VectorAggPartial> me = make_shared <VectorAggPartial> ();
+	me->predComp = make_shared <VectorComputation> (selectionPredicate);
+	for (MyDB_ExprPtr group : groupings)
+		me->groupingComps.push_back (make_shared <VectorComputation> (group));
+	for (auto &a : aggsToCompute) {
+		if (a.first == MyDB_AggType :: cntA)
+			me->aggComps.push_back (nullptr);
+		else
+			me->aggComps.push_back (make_shared <VectorComputation> (a.second));
+	}
+	me->columns = make_shared <ColumnBatch> (input->getTable ()->getSchema (), attsNeeded);
+	me->outRec = output->getEmptyRecord ();
+	me->intAggs.resize (numAggs);
+	me->doubleAggs.resize (numAggs);
+	me->decimalAggs.resize (numAggs);
+	return me;
+}
+
+int VectorizedAggregate :: addGroup (VectorAggPartial &me, string &key, long long firstSeen) {
+
+	int newGroup = me.counts.size ();
+	me.groupIds[key] = newGroup;
+	me.keys.push_back (key);
+	me.firstSeen.push_back (firstSeen);
+	me.counts.push_back (0);
+	for (int j = 0; j < numAggs; j++) {
+		if (isIntAgg[j])
+			me.intAggs[j].push_back (0);
+		else if (decimalScale[j] >= 0)
+			me.decimalAggs[j].push_back (0);
+		else
+			me.doubleAggs[j].push_back (0);
+	}
+	return newGroup;
+}
+
+void VectorizedAggregate :: addBatch (VectorAggPartial &me, int numRecs, long long firstPos) {
+
+	ColumnBatch &columns = *me.columns;
+	int selected[MAX_BATCH_SIZE];
+	int groupOf[MAX_BATCH_SIZE];
+	vector <ColumnVector *> groupCols (numGroupAtts);
+	vector <ColumnVector *> aggCols (numAggs);
+
+	// run the predicate over the decoded batch
+	int numSelected = me.predComp->filter (columns, columns.getAllRows (), numRecs, selected);
+	if (numSelected == 0)
+		return;
+
+	// run the groupings and the aggregate computations over the accepted records
+	for (int j = 0; j < numGroupAtts; j++)
+		groupCols[j] = me.groupingComps[j]->evaluate (columns, selected, numSelected);
+	for (int j = 0; j < numAggs; j++)
+		if (me.aggComps[j] != nullptr)
+			aggCols[j] = me.aggComps[j]->evaluate (columns, selected, numSelected);
+
+	// find the group for each record
+	string key;
+	for (int i = 0; i < numSelected; i++) {
+
+		key.clear ();
+		for (auto col : groupCols)
+			col->appendKey (selected[i], key);
+
+		auto found = me.groupIds.find (key);
+		if (found != me.groupIds.end ()) {
+			groupOf[i] = found->second;
+			continue;
+		}
+
+		// if we did not find a match, then set up a new group; the grouping atts are converted
+		// to the output types, just as in an Aggregate
+		groupOf[i] = addGroup (me, key, firstPos + selected[i]);
+		for (int j = 0; j < numGroupAtts; j++) {
+			groupCols[j]->writeInto (selected[i], me.outRec->getAtt (j));
+			me.groupVals.push_back (me.outRec->getAtt (j)->getCopy ());
+		}
+	}
+
+	// now update the aggregates, one at a time; the conversions match the ones that an
+	// Aggregate does when it computes "+ (computation, [MyDB_AggAtt])"
+	for (int i = 0; i < numSelected; i++)
+		me.counts[groupOf[i]]++;
+
+	for (int j = 0; j < numAggs; j++) {
+
+		int *intAgg = me.intAggs[j].data ();
+		double *doubleAgg = me.doubleAggs[j].data ();
+		long long *decimalAgg = me.decimalAggs[j].data ();
+		ColumnVector *col = aggCols[j];
+
+		// a decimal aggregate is kept at the scale of the output attribute; the Aggregate adds
+		// a decimal to it at the larger of the two scales, and then rounds back to this one
+		if (decimalScale[j] >= 0) {
+			int scale = decimalScale[j];
+			long long unit = MyDB_DecimalAttVal :: powerOfTen (scale);
+			if (col == nullptr) {
+				for (int i = 0; i < numSelected; i++)
+					decimalAgg[groupOf[i]] += unit;
+			} else if (col->mode == intMode) {
+				for (int i = 0; i < numSelected; i++)
+					decimalAgg[groupOf[i]] += col->ints[col->pos (selected[i])] * unit;
+			} else if (col->mode == decimalMode && col->scale <= scale) {
+				long long factor = MyDB_DecimalAttVal :: powerOfTen (scale - col->scale);
+				for (int i = 0; i < numSelected; i++)
+					decimalAgg[groupOf[i]] += col->longs[col->pos (selected[i])] * factor;
+			} else if (col->mode == decimalMode) {
+				long long factor = MyDB_DecimalAttVal :: powerOfTen (col->scale - scale);
+				for (int i = 0; i < numSelected; i++) {
+					long long sum = decimalAgg[groupOf[i]] * factor + col->longs[col->pos (selected[i])];
+					decimalAgg[groupOf[i]] = MyDB_DecimalAttVal :: rescale (sum, col->scale, scale);
+				}
+			} else {
+				for (int i = 0; i < numSelected; i++)
+					decimalAgg[groupOf[i]] = llround ((col->doubles[col->pos (selected[i])] +
+						decimalAgg[groupOf[i]] / (double) unit) * unit);
+			}
+			continue;
+		}
+
+		// otherwise, a decimal that goes into an int or a double is added just as a double
+		// would be, except that it is truncated when it goes into an int
+		if (col != nullptr && col->mode == decimalMode) {
+			long long unit = MyDB_DecimalAttVal :: powerOfTen (col->scale);
+			if (isIntAgg[j])
+				for (int i = 0; i < numSelected; i++)
+					intAgg[groupOf[i]] = (int) ((col->longs[col->pos (selected[i])] + intAgg[groupOf[i]] * unit) / unit);
+			else
+				for (int i = 0; i < numSelected; i++)
+					doubleAgg[groupOf[i]] += col->longs[col->pos (selected[i])] / (double) unit;
+		} else if (col == nullptr) {
+			if (isIntAgg[j])
+				for (int i = 0; i < numSelected; i++)
+					intAgg[groupOf[i]]++;
+			else
+				for (int i = 0; i < numSelected; i++)
+					doubleAgg[groupOf[i]] += 1.0;
+		} else if (col->mode == intMode) {
+			if (isIntAgg[j])
+				for (int i = 0; i < numSelected; i++)
+					intAgg[groupOf[i]] += col->ints[col->pos (selected[i])];
+			else
+				for (int i = 0; i < numSelected; i++)
+					doubleAgg[groupOf[i]] += (double) col->ints[col->pos (selected[i])];
+		} else {
+			if (isIntAgg[j])
+				for (int i = 0; i < numSelected; i++)
+					intAgg[groupOf[i]] = (int) (col->doubles[col->pos (selected[i])] + intAgg[groupOf[i]]);
+			else
+				for (int i = 0; i < numSelected; i++)
+					doubleAgg[groupOf[i]] += col->doubles[col->pos (selected[i])];
+		}
+	}
+}
+
+void VectorizedAggregate :: merge (VectorAggPartial &into, VectorAggPartial &from) {
+
+	for (int g = 0; g < (int) from.counts.size (); g++) {
+
+		// find the group, or add it, taking the grouping atts along
+		int intoGroup;
+		auto found = into.groupIds.find (from.keys[g]);
+		if (found != into.groupIds.end ()) {
+			intoGroup = found->second;
+			into.firstSeen[intoGroup] = min (into.firstSeen[intoGroup], from.firstSeen[g]);
+		} else {
+			intoGroup = addGroup (into, from.keys[g], from.firstSeen[g]);
+			for (int j = 0; j < numGroupAtts; j++)
+				into.groupVals.push_back (from.groupVals[g * numGroupAtts + j]);
+		}
+
+		// every aggregate is kept as a sum, so the partial aggregates are just added up
+		into.counts[intoGroup] += from.counts[g];
+		for (int j = 0; j < numAggs; j++) {
+			if (isIntAgg[j])
+				into.intAggs[j][intoGroup] += from.intAggs[j][g];
+			else if (decimalScale[j] >= 0)
+				into.decimalAggs[j][intoGroup] += from.decimalAggs[j][g];
+			else
+				into.doubleAggs[j][intoGroup] += from.doubleAggs[j][g];
+		}
+	}
+}
+
+void VectorizedAggregate :: writeOut (VectorAggPartial &me) {
+
+	// the groups are written in the order that they were first seen
+	vector <int> order (me.counts.size ());
+	for (int g = 0; g < (int) order.size (); g++)
+		order[g] = g;
+	sort (order.begin (), order.end (), [&me] (int a, int b) {return me.firstSeen[a] < me.firstSeen[b];});
+
+	MyDB_RecordPtr outRec = me.outRec;
+	MyDB_IntAttValPtr intVal = make_shared <MyDB_IntAttVal> ();
+	MyDB_DoubleAttValPtr doubleVal = make_shared <MyDB_DoubleAttVal> ();
+	vector <MyDB_DecimalAttValPtr> decimalVals;
+	for (int j = 0; j < numAggs; j++)
+		decimalVals.push_back (make_shared <MyDB_DecimalAttVal> (MAX_DECIMAL_PRECISION, max (decimalScale[j], 0)));
+	for (int g : order) {
+
+		// set the grouping atts
+		int i;
+		for (i = 0; i < numGroupAtts; i++) {
+			outRec->getAtt (i)->set (me.groupVals[g * numGroupAtts + i]);
+		}
+
+		// set the aggregate atts; an average over ints is done with integer division, and an
+		// average that goes into a decimal is done as a double
+		for (int j = 0; j < numAggs; j++) {
+			bool isAvg = (aggsToCompute[j].first == MyDB_AggType :: avgA);
+			if (decimalScale[j] >= 0 && isAvg) {
+				doubleVal->set (me.decimalAggs[j][g] / (double) MyDB_DecimalAttVal :: powerOfTen (decimalScale[j]) / me.counts[g]);
+				outRec->getAtt (i++)->set (doubleVal);
+			} else if (decimalScale[j] >= 0) {
+				decimalVals[j]->setScaled (me.decimalAggs[j][g]);
+				outRec->getAtt (i++)->set (decimalVals[j]);
+			} else if (isIntAgg[j]) {
+				intVal->set (isAvg ? me.intAggs[j][g] / me.counts[g] : me.intAggs[j][g]);
+				outRec->getAtt (i++)->set (intVal);
+			} else {
+				doubleVal->set (isAvg ? me.doubleAggs[j][g] / me.counts[g] : me.doubleAggs[j][g]);
+				outRec->getAtt (i++)->set (doubleVal);
+			}
+		}
+		outRec->recordContentHasChanged ();
+		output->append (outRec);
+	}
+}
+
+bool VectorizedAggregate :: checkOutputSchema () {
+	vector <pair <string, MyDB_AttTypePtr>> &outAtts = output->getTable ()->getSchema ()->getAtts ();
+	if (outAtts.size () != aggsToCompute.size () + groupings.size ()) {
+		cout << "error, the output schema needs to have the same number of atts as (# of aggs to compute + # groups).\n";
+		return false;
+	}
+	return true;
+}
+
+void VectorizedAggregate :: run () {
+
+	if (!checkOutputSchema ())
+		return;
+	if (!setUp ()) {
+		runRegularAggregate ();
+		return;
+	}
+
+	// at this point, we are ready to go!!
+	shared_ptr <VectorAggPartial> me = makePartial ();
+	conjunctOrder = me->predComp->getConjunctOrder ();
+	MyDB_RecordIteratorAltPtr myIter = input->getIteratorAlt (input->getPageFilter (selectionPredicate));
+	long long pos = 0;
+	int numRecs;
+	while ((numRecs = me->columns->load (myIter)) > 0) {
+		addBatch (*me, numRecs, pos);
+		pos += numRecs;
+	}
+
+	// now, we have processed all of the database records... so we can output the aggregates
+	writeOut (*me);
+}
+
+void VectorizedAggregate :: run (int numWorkers) {
+
+	if (!checkOutputSchema ())
+		return;
+	if (!setUp ()) {
+		runRegularAggregate ();
+		return;
+	}
+
+	// each worker gets its own pipeline, which aggregates into its own groups
+	MorselExecutor executor (input, input->getPageFilter (selectionPredicate));
+	numWorkers = max (1, min (numWorkers, executor.getNumWorkers ()));
+	vector <shared_ptr <VectorAggPartial>> partials;
+	for (int i = 0; i < numWorkers; i++)
+		partials.push_back (makePartial ());
+
+	executor.run (numWorkers, [this, &partials] (int whichWorker, void **recs, int numRecs, long long firstPos) {
+		VectorAggPartial &me = *partials[whichWorker];
+		me.columns->load (recs, numRecs);
+		addBatch (me, numRecs, firstPos);
+	});
+
+	// the aggregation is a pipeline breaker, so the workers' groups are merged, and then output;
+	// so are the counts that each worker used to re-order the conjuncts
+	conjunctOrder = partials[0]->predComp->getConjunctOrder ();
+	for (int i = 1; i < numWorkers; i++) {
+		merge (*partials[0], *partials[i]);
+		if (conjunctOrder != nullptr)
+			conjunctOrder->merge (*partials[i]->predComp->getConjunctOrder ());
+	}
+	writeOut (*partials[0]);
+}
+
+#endif
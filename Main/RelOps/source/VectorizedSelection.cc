@@ -0,0 +1,166 @@
+
+#ifndef VEC_SELECTION_C
+#define VEC_SELECTION_C
+
+#include "ColumnBatch.h"
+#include "MorselExecutor.h"
+#include "MyDB_Expr.h"
+#include "VectorComputation.h"
+#include "VectorizedSelection.h"
+#include <algorithm>
+
+VectorizedSelection :: VectorizedSelection (MyDB_TableReaderWriterPtr inputIn, MyDB_TableReaderWriterPtr outputIn,
+                string selectionPredicateIn, vector <string> projectionsIn) {
+
+	input = inputIn;
+	output = outputIn;
+	selectionPredicate = MyDB_Expr :: parse (selectionPredicateIn);
+	for (string &s : projectionsIn)
+		projections.push_back (MyDB_Expr :: parse (s));
+}
+
+VectorizedSelection :: VectorizedSelection (MyDB_TableReaderWriterPtr inputIn, MyDB_TableReaderWriterPtr outputIn,
+                MyDB_ExprPtr selectionPredicateIn, vector <MyDB_ExprPtr> projectionsIn) {
+
+	input = inputIn;
+	output = outputIn;
+	selectionPredicate = selectionPredicateIn;
+	projections = projectionsIn;
+}
+
+string VectorizedSelection :: getConjunctOrder () {
+	if (conjunctOrder == nullptr)
+		return "";
+	return conjunctOrder->toString ();
+}
+
+// the computations that one pipeline runs (they hold the vectors that they compute into, so
+// each pipeline needs its own) and their results for the last batch, and the page images that
+// it writes the output records from its current morsel into
+struct VectorSelectionPipeline {
+	shared_ptr <VectorComputation> predComp;
+	vector <VectorComputationPtr> finalComputations;
+	vector <ColumnVector *> results;
+	shared_ptr <ColumnBatch> columns;
+	MyDB_RecordPtr outputRec;
+	vector <vector <char>> pages;
+};
+
+bool VectorizedSelection :: setUp () {
+
+	// resolve all of the computations, and figure out which attributes we need to decode
+	MyDB_SchemaPtr inputSchema = input->getTable ()->getSchema ();
+	attsNeeded.clear ();
+	selectionPredicate->resolve (inputSchema);
+	selectionPredicate->getAtts (attsNeeded);
+	if (!selectionPredicate->getType ()->isBool ()) {
+		cout << "error, the selection predicate needs to be boolean.\n";
+		return false;
+	}
+	for (MyDB_ExprPtr proj : projections) {
+		proj->resolve (inputSchema);
+		proj->getAtts (attsNeeded);
+	}
+	return true;
+}
+
+shared_ptr <VectorSelectionPipeline> VectorizedSelection :: makePipeline () {
+	shared_ptr <VectorSelectionPipeline> me = make_shared <VectorSelectionPipeline> ();
+	me->predComp = make_shared <VectorComputation> (selectionPredicate);
+	for (MyDB_ExprPtr proj : projections)
+		me->finalComputations.push_back (make_shared <VectorComputation> (proj));
+	me->results.resize (projections.size ());
+	me->columns = make_shared <ColumnBatch> (input->getTable ()->getSchema (), attsNeeded);
+	me->outputRec = output->getEmptyRecord ();
+	return me;
+}
+
+int VectorizedSelection :: selectBatch (VectorSelectionPipeline &me, int numRecs, int *selected) {
+
+	// run the predicate over the decoded batch
+	ColumnBatch &columns = *me.columns;
+	int numSelected = me.predComp->filter (columns, columns.getAllRows (), numRecs, selected);
+
+	// run all of the computations, just over the accepted records
+	for (int j = 0; j < (int) me.finalComputations.size () && numSelected > 0; j++)
+		me.results[j] = me.finalComputations[j]->evaluate (columns, selected, numSelected);
+	return numSelected;
+}
+
+void VectorizedSelection :: writeRecord (VectorSelectionPipeline &me, int whichRec) {
+	for (int j = 0; j < (int) me.results.size (); j++)
+		me.results[j]->writeInto (whichRec, me.outputRec->getAtt (j));
+	me.outputRec->recordContentHasChanged ();
+}
+
+void VectorizedSelection :: run () {
+
+	if (!setUp ())
+		return;
+
+	shared_ptr <VectorSelectionPipeline> me = makePipeline ();
+	conjunctOrder = me->predComp->getConjunctOrder ();
+
+	// now, iterate through the input table, a batch of records at a time
+	int selected[MAX_BATCH_SIZE];
+	MyDB_RecordIteratorAltPtr myIter = input->getIteratorAlt (input->getPageFilter (selectionPredicate));
+	int numRecs;
+	while ((numRecs = me->columns->load (myIter)) > 0) {
+
+		// and write out the results
+		int numSelected = selectBatch (*me, numRecs, selected);
+		for (int i = 0; i < numSelected; i++) {
+			writeRecord (*me, selected[i]);
+			output->append (me->outputRec);
+		}
+	}
+}
+
+void VectorizedSelection :: run (int numWorkers) {
+
+	if (!setUp ())
+		return;
+
+	// each worker gets its own pipeline
+	MorselExecutor executor (input, input->getPageFilter (selectionPredicate));
+	numWorkers = max (1, min (numWorkers, executor.getNumWorkers ()));
+	size_t pageSize = output->getBufferMgr ()->getPageSize ();
+	vector <shared_ptr <VectorSelectionPipeline>> pipelines;
+	for (int i = 0; i < numWorkers; i++)
+		pipelines.push_back (makePipeline ());
+
+	// the output records are written into page images, which are appended to the output once
+	// the morsel is done and the morsels before it have been appended, so that the output is in
+	// the same order as with run ()
+	auto newPage = [pageSize] (VectorSelectionPipeline &me) {
+		me.pages.push_back (vector <char> (pageSize));
+		MyDB_PageReaderWriter :: clear (me.pages.back ().data (), pageSize);
+	};
+	executor.run (numWorkers, [this, &pipelines, pageSize, newPage] (int whichWorker, void **recs, int numRecs, long long) {
+		VectorSelectionPipeline &me = *pipelines[whichWorker];
+		int selected[MAX_BATCH_SIZE];
+		me.columns->load (recs, numRecs);
+		int numSelected = selectBatch (me, numRecs, selected);
+		for (int i = 0; i < numSelected; i++) {
+			writeRecord (me, selected[i]);
+			if (me.pages.empty ())
+				newPage (me);
+			if (MyDB_PageReaderWriter :: append (me.pages.back ().data (), pageSize, me.outputRec))
+				continue;
+			newPage (me);
+			MyDB_PageReaderWriter :: append (me.pages.back ().data (), pageSize, me.outputRec);
+		}
+	}, [this, &pipelines, &executor] (int whichWorker, int whichMorsel) {
+		VectorSelectionPipeline &me = *pipelines[whichWorker];
+		executor.appendInOrder (output, whichMorsel, me.pages, me.outputRec);
+		me.pages.clear ();
+	});
+
+	// each worker re-ordered the conjuncts using only the records that it saw, so their counts
+	// are put together to get the order for the whole scan
+	conjunctOrder = pipelines[0]->predComp->getConjunctOrder ();
+	for (int i = 1; i < numWorkers && conjunctOrder != nullptr; i++)
+		conjunctOrder->merge (*pipelines[i]->predComp->getConjunctOrder ());
+}
+
+#endif
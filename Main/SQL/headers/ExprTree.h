@@ -4,6 +4,9 @@
 
 #include "MyDB_AttType.h"
 #include "MyDB_Catalog.h"
+#include "MyDB_Expr.h"
+#include <algorithm>
+#include <stdio.h>
 #include <string>
 #include <vector>
 #include <set>
@@ -25,6 +28,11 @@ public:
 public:
 
 	virtual string toString () = 0;
+
+	// builds the computation that this expression describes, which is the same as the one
+	// written out by toString (), without writing it out and parsing it again
+	virtual MyDB_ExprPtr toExpr () = 0;
+
 	virtual ~ExprTree () {}
 	// For checking.
 	virtual bool check() = 0;
@@ -57,10 +65,28 @@ public:
 	}
 
 
+	// a date can be compared with another date, or with a string (which is taken as a date)
+	bool checkDateMatch(ExprTreePtr lhs, ExprTreePtr rhs) {
+	    return (lhs->getType() == "date" && (rhs->getType() == "date" || rhs->getType() == "string")) ||
+                (rhs->getType() == "date" && lhs->getType() == "string");
+    }
+
 	bool checkTypeEqual(ExprTreePtr opn, string type) {
 		return (opn->getType() == type) ? true : false;
 	}
 
+	// if an arithmetic operation over the two expressions is done exactly, as decimals (see
+	// MyDB_Expr::asDecimals), then this is the type of the result; otherwise it is nullptr
+	MyDB_AttTypePtr decimalResult(ExprTreePtr lhs, ExprTreePtr rhs, bool isTimes) {
+		int lhsScale, rhsScale;
+		if (!MyDB_Expr :: asDecimals (lhs->getAttSchema("").second, rhs->getAttSchema("").second, lhsScale, rhsScale))
+			return nullptr;
+		int scale = isTimes ? lhsScale + rhsScale : max(lhsScale, rhsScale);
+		if (scale > MAX_DECIMAL_PRECISION)
+			return nullptr;
+		return make_shared<MyDB_DecimalAttType>(MAX_DECIMAL_PRECISION, scale);
+	}
+
 	void errorMessage(ExprTreePtr lhs, ExprTreePtr rhs, string opr) {
 		cerr << "This operator \'" << opr << "\' cannot be used between "
 			<< lhs->toString() << " and " << rhs->toString() << "." << endl;
@@ -94,6 +120,10 @@ public:
 		}
 	}	
 
+	MyDB_ExprPtr toExpr () {
+		return MyDB_Expr :: boolLiteral (myVal);
+	}
+
 	bool check() {
 		return true;
 	};
@@ -128,6 +158,10 @@ public:
 		return "double[" + to_string (myVal) + "]";
 	}	
 
+	MyDB_ExprPtr toExpr () {
+		return MyDB_Expr :: doubleLiteral (myVal);
+	}
+
 	bool check() {
 		return true;
 	};
@@ -164,6 +198,10 @@ public:
 		return "int[" + to_string (myVal) + "]";
 	}
 
+	MyDB_ExprPtr toExpr () {
+		return MyDB_Expr :: intLiteral (myVal);
+	}
+
 	bool check() {
 		return true;
 	};
@@ -200,6 +238,10 @@ public:
 		return "string[" + myVal + "]";
 	}
 
+	MyDB_ExprPtr toExpr () {
+		return MyDB_Expr :: stringLiteral (myVal);
+	}
+
 	bool check() {
 		return true;
 	};
@@ -238,6 +280,10 @@ public:
 		return "[" + tableName + "_" + attName + "]";
 	}	
 
+	MyDB_ExprPtr toExpr () {
+		return MyDB_Expr :: attribute (tableName + "_" + attName);
+	}
+
 	bool check() {
 	    // check table name
 	    bool tableExist = false;
@@ -283,10 +329,12 @@ public:
 			return "boolean";
 		if (attType == "int")
 			return "int";
-		if (attType == "double")
+		if (attType == "double" || attType.compare(0, 8, "decimal(") == 0)
 		    return "double";
-		if (attType == "string")
+		if (attType == "string" || attType == "dictstring" || attType == "overflowstring" || attType.compare(0, 5, "char(") == 0)
 			return "string";
+		if (attType == "date")
+			return "date";
 		return "(Unable to recognize this type)";
 		
 	}
@@ -298,14 +346,19 @@ public:
 	 }
 
 	pair<string, MyDB_AttTypePtr> getAttSchema (string name) {
+		int precision, scale;
 		if (attType == "bool") {
 			return make_pair("[" + attName + "]"+name, make_shared<MyDB_BoolAttType>());
-		} else if (attType == "string") {
+		} else if (attType == "string" || attType == "dictstring" || attType == "overflowstring" || attType.compare(0, 5, "char(") == 0) {
 			return make_pair("[" + attName + "]"+name, make_shared<MyDB_StringAttType>());
 		} else if (attType == "int") {
 			return make_pair("[" + attName + "]"+name, make_shared<MyDB_IntAttType>());
 		} else if (attType == "double") {
 			return make_pair("[" + attName + "]"+name, make_shared<MyDB_DoubleAttType>());
+		} else if (attType == "date") {
+			return make_pair("[" + attName + "]"+name, make_shared<MyDB_DateAttType>());
+		} else if (sscanf(attType.c_str(), "decimal(%d,%d)", &precision, &scale) == 2) {
+			return make_pair("[" + attName + "]"+name, make_shared<MyDB_DecimalAttType>(precision, scale));
 		}
 		return make_pair("[" + attName + "]"+name, make_shared<MyDB_BoolAttType>());
 	}
@@ -331,6 +384,10 @@ public:
 		return "- (" + lhs->toString () + ", " + rhs->toString () + ")";
 	}	
 
+	MyDB_ExprPtr toExpr () {
+		return make_shared <MyDB_Expr> (minusOp, lhs->toExpr (), rhs->toExpr ());
+	}
+
 	bool check() {
 	    if (!lhs->check() || !rhs->check()) {
 	        return false;
@@ -348,6 +405,8 @@ public:
 	pair<string, MyDB_AttTypePtr> getAttSchema (string name) {
 		if (getType() == "int") {
 			return make_pair(name, make_shared<MyDB_IntAttType>());
+		} else if (decimalResult(lhs, rhs, false) != nullptr) {
+			return make_pair(name, decimalResult(lhs, rhs, false));
 		} else if (getType() == "double") {
 			return make_pair(name, make_shared<MyDB_DoubleAttType>());
 		} else {
@@ -394,6 +453,10 @@ public:
 		return "+ (" + lhs->toString () + ", " + rhs->toString () + ")";
 	}	
 
+	MyDB_ExprPtr toExpr () {
+		return make_shared <MyDB_Expr> (plusOp, lhs->toExpr (), rhs->toExpr ());
+	}
+
 	bool check() {
         if (!lhs->check() || !rhs->check()) {
             return false;
@@ -414,6 +477,8 @@ public:
 		string x = getType();
 		if (x == "int") {
 			return make_pair(name, make_shared<MyDB_IntAttType>());
+		} else if (x == "double" && decimalResult(lhs, rhs, false) != nullptr) {
+			return make_pair(name, decimalResult(lhs, rhs, false));
 		} else if (x == "double") {
 			return make_pair(name, make_shared<MyDB_DoubleAttType>());
 		} else {
@@ -469,6 +534,10 @@ public:
 		return "* (" + lhs->toString () + ", " + rhs->toString () + ")";
 	}	
 
+	MyDB_ExprPtr toExpr () {
+		return make_shared <MyDB_Expr> (timesOp, lhs->toExpr (), rhs->toExpr ());
+	}
+
 	bool check() {
         if (!lhs->check() || !rhs->check()) {
             return false;
@@ -494,6 +563,8 @@ public:
 		string x = getType();
 		if (x == "int") {
 			return make_pair(name, make_shared<MyDB_IntAttType>());
+		} else if (decimalResult(lhs, rhs, true) != nullptr) {
+			return make_pair(name, decimalResult(lhs, rhs, true));
 		} else {
 			return make_pair(name, make_shared<MyDB_DoubleAttType>());
 		}
@@ -532,6 +603,10 @@ public:
 		return "/ (" + lhs->toString () + ", " + rhs->toString () + ")";
 	}	
 
+	MyDB_ExprPtr toExpr () {
+		return make_shared <MyDB_Expr> (divideOp, lhs->toExpr (), rhs->toExpr ());
+	}
+
 	ExprTreePtr getlhs() {
 		 return lhs;
 	 }
@@ -600,6 +675,10 @@ public:
 		return "> (" + lhs->toString () + ", " + rhs->toString () + ")";
 	}	
 
+	MyDB_ExprPtr toExpr () {
+		return make_shared <MyDB_Expr> (gtOp, lhs->toExpr (), rhs->toExpr ());
+	}
+
 	bool check() {
 		if (!lhs->check() || !rhs->check()) {
 			return false;
@@ -608,7 +687,8 @@ public:
 		if (!checkTypeEqual(lhs, rhs, "double")
 		&& !checkTypeEqual(lhs, rhs, "int")
 		&& !checkNumberTypeEqual(lhs, rhs)
-		&& !checkTypeEqual(lhs, rhs, "string")) {
+		&& !checkTypeEqual(lhs, rhs, "string")
+		&& !checkDateMatch(lhs, rhs)) {
 			errorMessage(lhs, rhs, ">");
 			return false;
 		}
@@ -624,7 +704,8 @@ public:
 		if (checkTypeEqual(lhs, rhs, "int")
 		|| checkTypeEqual(lhs, rhs, "double")
 		|| checkNumberTypeEqual(lhs, rhs)
-		|| checkTypeEqual(lhs, rhs, "string")) {
+		|| checkTypeEqual(lhs, rhs, "string")
+		|| checkDateMatch(lhs, rhs)) {
 			return "boolean";
 		}
 		return "(Unable to recognize this type)";
@@ -657,6 +738,10 @@ public:
 		return "< (" + lhs->toString () + ", " + rhs->toString () + ")";
 	}	
 
+	MyDB_ExprPtr toExpr () {
+		return make_shared <MyDB_Expr> (ltOp, lhs->toExpr (), rhs->toExpr ());
+	}
+
 	bool check() {
 		if (!lhs->check() || !rhs->check()) {
 			return false;
@@ -665,7 +750,8 @@ public:
         if (!checkTypeEqual(lhs, rhs, "double")
         && !checkTypeEqual(lhs, rhs, "int")
         && !checkNumberTypeEqual(lhs, rhs)
-        && !checkTypeEqual(lhs, rhs, "string")) {
+        && !checkTypeEqual(lhs, rhs, "string")
+        && !checkDateMatch(lhs, rhs)) {
 			errorMessage(lhs, rhs, "<");
 			return false;
 		}
@@ -681,7 +767,8 @@ public:
         if (checkTypeEqual(lhs, rhs, "int")
         || checkTypeEqual(lhs, rhs, "double")
         || checkNumberTypeEqual(lhs, rhs)
-        || checkTypeEqual(lhs, rhs, "string")) {
+        || checkTypeEqual(lhs, rhs, "string")
+        || checkDateMatch(lhs, rhs)) {
 			return "boolean";
 		}
 		return "(Unable to recognize this type)";
@@ -714,12 +801,16 @@ public:
 		return "!= (" + lhs->toString () + ", " + rhs->toString () + ")";
 	}	
 
+	MyDB_ExprPtr toExpr () {
+		return make_shared <MyDB_Expr> (neqOp, lhs->toExpr (), rhs->toExpr ());
+	}
+
 	bool check() {
 		if (!lhs->check() || !rhs->check()) {
 			return false;
 		}
 		if (lhs->getType() != rhs->getType()) {
-		    if(checkNumberTypeEqual(lhs, rhs)) {
+		    if(checkNumberTypeEqual(lhs, rhs) || checkDateMatch(lhs, rhs)) {
                 return true;
             }
 			errorMessage(lhs, rhs, "!=");
@@ -730,7 +821,7 @@ public:
 	};
 
 	string getType() {
-	    if(checkNumberTypeEqual(lhs, rhs)) {
+	    if(checkNumberTypeEqual(lhs, rhs) || checkDateMatch(lhs, rhs)) {
 	        return "boolean";
 	    }
 
@@ -772,6 +863,10 @@ public:
 		return "|| (" + lhs->toString () + ", " + rhs->toString () + ")";
 	}	
 
+	MyDB_ExprPtr toExpr () {
+		return make_shared <MyDB_Expr> (orOp, lhs->toExpr (), rhs->toExpr ());
+	}
+
 	bool check() {
 		if (!lhs->check() || !rhs->check()) {
 			return false;
@@ -823,12 +918,16 @@ public:
 		return "== (" + lhs->toString () + ", " + rhs->toString () + ")";
 	}	
 
+	MyDB_ExprPtr toExpr () {
+		return make_shared <MyDB_Expr> (eqOp, lhs->toExpr (), rhs->toExpr ());
+	}
+
 	bool check() {
 		if (!lhs->check() || !rhs->check()) {
 			return false;
 		}
 		if (lhs->getType() != rhs->getType()) {
-		    if (checkNumberTypeEqual(lhs, rhs)) {
+		    if (checkNumberTypeEqual(lhs, rhs) || checkDateMatch(lhs, rhs)) {
 		        return true;
 		    }
 			errorMessage(lhs, rhs, "==");
@@ -839,7 +938,7 @@ public:
 	};
 
 	string getType() {
-	    if (checkNumberTypeEqual(lhs, rhs)) {
+	    if (checkNumberTypeEqual(lhs, rhs) || checkDateMatch(lhs, rhs)) {
 	        return "boolean";
 	    }
 
@@ -879,6 +978,10 @@ public:
 		return "!(" + child->toString () + ")";
 	}	
 
+	MyDB_ExprPtr toExpr () {
+		return make_shared <MyDB_Expr> (notOp, child->toExpr ());
+	}
+
 	bool check() {
 		if (!child->check()) {
 			return false;
@@ -922,6 +1025,11 @@ public:
 		return "sum(" + child->toString () + ")";
 	}	
 
+	// the computation that is aggregated; the aggregate itself is done by the operator
+	MyDB_ExprPtr toExpr () {
+		return child->toExpr ();
+	}
+
 	ExprTreePtr getlhs() {
 		 return nullptr;
 	 }
@@ -952,9 +1060,13 @@ public:
 	}
 
 	pair<string, MyDB_AttTypePtr> getAttSchema (string name) {
+		// a sum over decimals is exact, so it is a decimal, with as many digits as can be held
 		string x = getType();
+		MyDB_DecimalAttTypePtr decimalType = dynamic_pointer_cast <MyDB_DecimalAttType> (child->getAttSchema("").second);
 		if (x == "int") {
 			return make_pair("sum"+name, make_shared <MyDB_IntAttType>());
+		} else if (decimalType != nullptr) {
+			return make_pair("sum"+name, make_shared <MyDB_DecimalAttType>(MAX_DECIMAL_PRECISION, decimalType->getScale()));
 		} else {
 			return make_pair("sum"+name, make_shared <MyDB_DoubleAttType>());
 		}
@@ -985,6 +1097,11 @@ public:
 		return "avg(" + child->toString () + ")";
 	}	
 
+	// the computation that is aggregated; the aggregate itself is done by the operator
+	MyDB_ExprPtr toExpr () {
+		return child->toExpr ();
+	}
+
 	bool check() {
 		if (!child->check()) {
 			return false;
@@ -6,7 +6,10 @@ friend struct SQLStatement *makeSelectQuery (struct SFWQuery *fromMe);
 friend struct SQLStatement *makeCreateTable (struct CreateTable *fromMe);
 friend struct CreateTable *makeTableRegular (char *tableName, struct AttList *fromMe);
 friend struct CreateTable *makeTableBPlusTree (char *tableName, struct AttList *fromMe, char *attName);
+friend struct CreateTable *makeTablePAX (char *tableName, struct AttList *fromMe);
 friend struct AttList *makeAttList (char *attName, int whichType);
+friend struct AttList *makeCharAttList (char *attName, int width);
+friend struct AttList *makeDecimalAttList (char *attName, int precision, int scale);
 friend struct FromList *makeFromList (char *tableName, char *aliasName);
 friend struct FromList *appendFromList (struct FromList *appendToMe, char *tableName, char *aliasName);
 friend struct AttList *appendAttList (struct AttList *appendToMe, struct AttList *appendMe);
@@ -62,9 +62,18 @@ struct CreateTable *makeTableRegular (char *tableName, struct AttList *fromMe);
 // makes a B+-Tree table
 struct CreateTable *makeTableBPlusTree (char *tableName, struct AttList *fromMe, char *attName);
 
+// makes a regular database table whose pages keep each attribute's values together
+struct CreateTable *makeTablePAX (char *tableName, struct AttList *fromMe);
+
 // makes an attribute list out of a single attribute
 struct AttList *makeAttList (char *attName, int whichType);
 
+// the same, for a CHAR (width); returns nullptr if the width is out of range
+struct AttList *makeCharAttList (char *attName, int width);
+
+// the same, for a DECIMAL (precision, scale); returns nullptr if either is out of range
+struct AttList *makeDecimalAttList (char *attName, int precision, int scale);
+
 // makes a from list
 struct FromList *makeFromList (char *tableName, char *aliasName);
 
@@ -103,20 +103,30 @@ private:
 	// the attribute to organize the B+-Tree on
 	string sortAtt;
 
+	// true if we create a regular file whose pages are PAXPages
+	bool isPAX;
+
 public:
 	string addToCatalog (string storageDir, MyDB_CatalogPtr addToMe) {
 
-		// make the schema
+		// make the schema; an attribute that is stored out of line gets a file next to the table
 		MyDB_SchemaPtr mySchema = make_shared <MyDB_Schema>();
 		for (auto a : attsToCreate) {
+			if (dynamic_pointer_cast <MyDB_OverflowAttType> (a.second) != nullptr)
+				a.second = make_shared <MyDB_OverflowAttType> (storageDir + "/" + tableName + "." + a.first + ".overflow");
 			mySchema->appendAtt (a);
 		}
 
 		// now, make the table
 		MyDB_TablePtr myTable;
 
+		// a regular file made of PAXPages
+		if (isPAX) {
+			myTable =  make_shared <MyDB_Table> (tableName, 
+				storageDir + "/" + tableName + ".bin", mySchema, "pax", "");	
+
 		// just a regular file
-		if (!isBPlusTree) {
+		} else if (!isBPlusTree) {
 			myTable =  make_shared <MyDB_Table> (tableName, 
 				storageDir + "/" + tableName + ".bin", mySchema);	
 
@@ -144,12 +154,14 @@ public:
 		tableName = tableNameIn;
 		attsToCreate = atts;
 		isBPlusTree = false;
+		isPAX = false;
 	}
 
 	CreateTable (string tableNameIn, vector <pair <string, MyDB_AttTypePtr>> atts, string sortAttIn) {
 		tableName = tableNameIn;
 		attsToCreate = atts;
 		isBPlusTree = true;
+		isPAX = false;
 		sortAtt = sortAttIn;
 	}
 	
@@ -1,8 +1,14 @@
 #include "ParserTypes.h"
 #include "MyDB_TableReaderWriter.h"
+#include "MyDB_TaskScheduler.h"
 #include "Aggregate.h"
+#include "CompiledPipeline.h"
+#include "JoinPipeline.h"
+#include "PipelineOp.h"
 #include "RegularSelection.h"
 #include "ScanJoin.h"
+#include "VectorizedAggregate.h"
+#include "VectorizedSelection.h"
 
 class RunOp
 {
@@ -11,9 +17,9 @@ private:
     SFWQuery query;
     map<string, MyDB_TableReaderWriterPtr> tables;
     MyDB_BufferManagerPtr buffer;
-    vector<string> groupings;
-    vector<pair<MyDB_AggType, string>> aggsToCompute;
-    vector<string> projection;
+    vector<MyDB_ExprPtr> groupings;
+    vector<pair<MyDB_AggType, MyDB_ExprPtr>> aggsToCompute;
+    vector<MyDB_ExprPtr> projection;
     MyDB_SchemaPtr schemaOut;
     MyDB_SchemaPtr schemaSp;
     MyDB_CatalogPtr cata;
@@ -21,9 +27,15 @@ private:
     bool sp;
     int rem;
 
+    // runs a query over more than one table, pushing the results into output
+    void runJoin(PipelineSinkPtr output);
+
 public:
     RunOp(SQLStatement *query, MyDB_BufferManagerPtr buffer,
         map<string, MyDB_TableReaderWriterPtr> tables, MyDB_CatalogPtr catalog);
     void run();
     MyDB_TableReaderWriterPtr copyyyy(MyDB_TableReaderWriterPtr input, string alias, string name);
+
+    // if set, queries are first tried as a compiled pipeline ("set codegen on;" in the shell)
+    static bool useCodegen;
 };
@@ -47,9 +47,15 @@
 %token INT
 %token BOOL
 %token BPLUSTREE
+%token PAX
 %token CREATE
 %token DOUBLE
 %token STRING
+%token DATE
+%token DICTSTRING
+%token OVERFLOWSTRING
+%token CHAR
+%token DECIMAL
 %token ON
 %token TABLE
 
@@ -104,6 +110,12 @@ CreateTable: CREATE TABLE IDENTIFIER '('
 	$$ = makeTableBPlusTree ($3, $5, $10);
 }
 
+| CREATE TABLE IDENTIFIER '(' 
+		AttList ')' AS PAX
+{
+	$$ = makeTablePAX ($3, $5);
+}
+
 AttList : AttList ',' Att 
 {
 	$$ = appendAttList ($1, $3);
@@ -135,6 +147,39 @@ Att : IDENTIFIER INT
 	$$ = makeAttList ($1, BOOL);
 }
 
+| IDENTIFIER DATE
+{
+	$$ = makeAttList ($1, DATE);
+}
+
+| IDENTIFIER DICTSTRING
+{
+	$$ = makeAttList ($1, DICTSTRING);
+}
+
+| IDENTIFIER OVERFLOWSTRING
+{
+	$$ = makeAttList ($1, OVERFLOWSTRING);
+}
+
+| IDENTIFIER CHAR '(' INTEGER ')'
+{
+	$$ = makeCharAttList ($1, $4);
+	if ($$ == nullptr) {
+		yyerror (scanner, myStatement, "the width of a CHAR is out of range");
+		YYERROR;
+	}
+}
+
+| IDENTIFIER DECIMAL '(' INTEGER ',' INTEGER ')'
+{
+	$$ = makeDecimalAttList ($1, $4, $6);
+	if ($$ == nullptr) {
+		yyerror (scanner, myStatement, "the precision or scale of a DECIMAL is out of range");
+		YYERROR;
+	}
+}
+
 //********* SELECT-FROM-WHERE Query
 
 SelectQuery: SELECT ValueList
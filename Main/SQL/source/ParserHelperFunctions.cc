@@ -37,11 +37,31 @@ struct AttList *makeAttList (char *attName, int whichType) {
 		return new AttList (string (attName), make_shared <MyDB_IntAttType> ());
 	} else if (whichType == STRING) {
 		return new AttList (string (attName), make_shared <MyDB_StringAttType> ());
+	} else if (whichType == DATE) {
+		return new AttList (string (attName), make_shared <MyDB_DateAttType> ());
+	} else if (whichType == DICTSTRING) {
+		return new AttList (string (attName), make_shared <MyDB_DictStringAttType> ());
+	} else if (whichType == OVERFLOWSTRING) {
+
+		// the file is named when the table is added to the catalog
+		return new AttList (string (attName), make_shared <MyDB_OverflowAttType> (""));
 	} else {
 		return nullptr;
 	}
 }
 
+struct AttList *makeCharAttList (char *attName, int width) {
+	if (width < 1 || width > MAX_CHAR_WIDTH)
+		return nullptr;
+	return new AttList (string (attName), make_shared <MyDB_CharAttType> (width));
+}
+
+struct AttList *makeDecimalAttList (char *attName, int precision, int scale) {
+	if (precision < 1 || precision > MAX_DECIMAL_PRECISION || scale < 0 || scale > precision)
+		return nullptr;
+	return new AttList (string (attName), make_shared <MyDB_DecimalAttType> (precision, scale));
+}
+
 struct FromList *appendFromList (struct FromList *appendToMe, char *tableName, char *aliasName) {
 	appendToMe->aliases.push_back (make_pair (string (tableName), string (aliasName)));
 	free (tableName);
@@ -222,6 +242,14 @@ struct CreateTable *makeTableBPlusTree (char *tableName, struct AttList *fromMe,
 	return returnVal;
 }
 
+struct CreateTable *makeTablePAX (char *tableName, struct AttList *fromMe) {
+	auto returnVal = new CreateTable (string (tableName), fromMe->atts);
+	returnVal->isPAX = true;
+	free (tableName);
+	delete fromMe;
+	return returnVal;
+}
+
 // structure that stores a list of aliases from a FROM clause
 } // extern
 
@@ -1,4 +1,48 @@
 #include "RunOp.h"
+#include <sstream>
+
+bool RunOp::useCodegen = false;
+
+// the end of the pipeline: counts the result records that are pushed in, and keeps the first 30
+// so that they can be printed once the query is done
+class PrintResults : public PipelineOp
+{
+private:
+    MyDB_RecordPtr rec;
+    vector<string> firstRecs;
+    int count;
+
+public:
+    PrintResults(MyDB_SchemaPtr schema) {
+        rec = make_shared<MyDB_Record>(schema);
+        count = 0;
+    }
+
+    void open() {
+        firstRecs.clear();
+        count = 0;
+    }
+
+    void consume(void **recs, int numRecs) {
+        for (int i = 0; i < numRecs; i++) {
+            ++count;
+            if (count <= 30) {
+                rec->fromBinary(recs[i]);
+                stringstream ss;
+                ss << rec;
+                firstRecs.push_back(ss.str());
+            }
+        }
+    }
+
+    void close() {
+        printf("----------------Results Below---------------\n");
+        for (auto &r : firstRecs) {
+            cout << r << endl;
+        }
+        printf("Count Result: %d records.\n", count);
+    }
+};
 
 RunOp::RunOp(SQLStatement *query, MyDB_BufferManagerPtr buffer,
         map<string, MyDB_TableReaderWriterPtr> tables, MyDB_CatalogPtr catalog)
@@ -10,26 +54,32 @@ RunOp::RunOp(SQLStatement *query, MyDB_BufferManagerPtr buffer,
     this->schemaOut = make_shared<MyDB_Schema> ();
     this->schemaSp = make_shared<MyDB_Schema> ();
     this->cata = catalog;
-    // this->sp = false;
+    this->sp = false;
     // vector<string> projectSp;
     int count = 0;
     for (auto s : this->query.valuesToSelect) {
         
+        // the output attributes are named by their positions, since the names that the parser
+        // gives them can have brackets in them, and then the reorder could not refer to them
+        pair<string, MyDB_AttTypePtr> att = s->getAttSchema(to_string(count));
+        string kind = att.first;
+        att.first = "att" + to_string(count);
+
         // if (s->getAttSchema().first != "sp") {
-            schemaOut->appendAtt(s->getAttSchema(to_string(count)));
-            projection.push_back(s->toString());
+            schemaOut->appendAtt(att);
+            projection.push_back(s->toExpr());
         // }
-        schemaSp->appendAtt(s->getAttSchema(to_string(count)));
+        schemaSp->appendAtt(att);
         // cout << s->toString() << endl;
 
-        if (s->getAttSchema(to_string(count)).first.substr(0,3) == "sum") {
-            aggsToCompute.push_back(make_pair(MyDB_AggType::sumA, s->toString().substr(3)));
+        if (kind.substr(0,3) == "sum") {
+            aggsToCompute.push_back(make_pair(MyDB_AggType::sumA, s->toExpr()));
             // projectSp.push_back("sum");
-        } else if (s->getAttSchema(to_string(count)).first.substr(0,3) == "avg") {
-            aggsToCompute.push_back(make_pair(MyDB_AggType::avgA, s->toString().substr(3)));
+        } else if (kind.substr(0,3) == "avg") {
+            aggsToCompute.push_back(make_pair(MyDB_AggType::avgA, s->toExpr()));
             // projectSp.push_back("avg");
         } else {
-            groupings.push_back(s->toString());
+            groupings.push_back(s->toExpr());
             // projectSp.push_back(s->toString());
             // this->sp = true;
             // auto& atts = schemaOut->getAtts();
@@ -79,11 +129,28 @@ void RunOp::run() {
     map<string, MyDB_TableReaderWriterPtr> inputTemp;
     MyDB_TableReaderWriterPtr input;
     MyDB_TableReaderWriterPtr finalInput;
-    MyDB_TablePtr outputTable = make_shared<MyDB_Table>("output", "output.bin", schemaOut);
-    MyDB_TableReaderWriterPtr output = make_shared<MyDB_TableReaderWriter>(outputTable, buffer);
+
+    // the result is never written to a table: the records are pushed straight to the end of the
+    // pipeline, which prints them.  With a GROUP BY, the aggregate puts the grouping attributes
+    // first, so its records are pushed through a selection that puts them back in the order that
+    // they were asked for
+    PrintResults printer(schemaSp);
+    PipelineSinkPtr toPrinter = make_shared<PipelineSink>(schemaSp, buffer);
+    toPrinter->pushInto(&printer);
+    PipelineSinkPtr output = toPrinter;
+    vector<string> projectionSp;
+    for (auto m : schemaSp->getAtts()) {
+        projectionSp.push_back("["+m.first+"]");
+    }
+    PipelineSinkPtr toReorder = make_shared<PipelineSink>(schemaOut, buffer);
+    RegularSelection reorder(toReorder, toPrinter, "bool[true]", projectionSp);
+    if (sp) {
+        toReorder->pushInto(&reorder);
+        output = toReorder;
+    }
     if (tablesToProcess.size() != 1) {
-        // TODO: join and result in finalInput.
-        cout << "Join and process" << endl;
+        runJoin(output);
+        return;
     } else {
 
         input = tables[tablesToProcess[0].first];
@@ -96,97 +163,85 @@ void RunOp::run() {
         // }
     }
 
-    string predicates = "";
+    // the WHERE clause is built straight from the parsed query, so it does not need to be
+    // written out and parsed again; with no WHERE clause, everything is accepted
+    MyDB_ExprPtr predicates = MyDB_Expr::boolLiteral(true);
     int i = 0;
     for (auto p : query.allDisjunctions) {
         if (i == 0) {
-            predicates += p->toString();
+            predicates = p->toExpr();
         } else {
-            predicates = "&& (" + predicates + "," + p->toString() + ")";
+            predicates = make_shared<MyDB_Expr>(andOp, predicates, p->toExpr());
         }
         ++i;
     }
 
-    if (isAgg) {
-        Aggregate op(finalInput, output, aggsToCompute, groupings, predicates);
-        op.run();
-    } else {
-        RegularSelection op(finalInput, output, predicates, projection);
-        op.run();
-    }
-
-    //Output
-    if (!sp) {
-        int count = 0;
-        MyDB_RecordPtr recOut = output->getEmptyRecord();
-        MyDB_RecordIteratorAltPtr it = output->getIteratorAlt();
-
-        printf("----------------Results Below---------------\n");
-        while (it->advance()) {
-            it->getCurrent(recOut);
-            ++count;
-            if (count <= 30) {
-                cout << recOut << endl;
-            }
+    // single-table queries are scan->filter->aggregate, so they run on the vectorized operators,
+    // unless codegen is on and the pipeline can be compiled
+    bool compiled = false;
+    if (useCodegen) {
+        if (isAgg) {
+            compiled = CompiledPipeline(finalInput, output, aggsToCompute, groupings, predicates).run();
+        } else {
+            compiled = CompiledPipeline(finalInput, output, predicates, projection).run();
         }
-        printf("Count Result: %d records.\n", count);
-        // for (auto m : projection) {
-        //     cout << m << " ";
-        // }
-    } else {
-        int count = 0;
-        // MyDB_RecordPtr recOut = output->getEmptyRecord();
-        // MyDB_RecordIteratorAltPtr it = output->getIteratorAlt();
-
-        // printf("----------------Results Below---------------\n");
-        // while (it->advance()) {
-        //     it->getCurrent(recOut);
-        //     ++count;
-        //     if (count <= 30) {
-        //         cout << recOut << endl;
-        //     }
-        // }
-        // for (auto m : output->getTable()->getSchema()->getAtts()) {
-        //     cout << m.first << " ";
-        // }
-        // printf("Count Result: %d records.\n", count);
-
-        MyDB_TablePtr outputTableSp = make_shared<MyDB_Table>("outputSp", "outputSp.bin", schemaSp);
-        MyDB_TableReaderWriterPtr outputSp = make_shared<MyDB_TableReaderWriter>(outputTableSp, buffer);
-        vector<string> projectionSp;
-
-        // for (auto m : schemaOut->getAtts()) {
-        //     cout << m.first << " ";
-        // }
-        // cout << endl;
-        
-        for (auto m : schemaSp->getAtts()) {
-            projectionSp.push_back("["+m.first+"]");
-            // cout << m.first << " ";
+        if (!compiled) {
+            cout << "Could not compile the query; using the interpreted operators.\n";
         }
-        // cout << endl;
+    }
 
-        // for (auto m : projection) {
-        //     cout << m << " ";
-        // }
-        // cout << endl;
+    // the interpreted operators are run morsel-driven, on all of the shared scheduler's workers
+    // ("set workers N;" in the shell)
+    int numWorkers = MyDB_TaskScheduler::getScheduler().getNumWorkers();
+
+    // the order that the conjuncts of the WHERE clause ended up being run in
+    string conjunctOrder;
+    if (!compiled && isAgg) {
+        VectorizedAggregate op(finalInput, output, aggsToCompute, groupings, predicates);
+        op.run(numWorkers);
+        conjunctOrder = op.getConjunctOrder();
+    } else if (!compiled) {
+        VectorizedSelection op(finalInput, output, predicates, projection);
+        op.run(numWorkers);
+        conjunctOrder = op.getConjunctOrder();
+    }
+    if (conjunctOrder != "") {
+        cout << "Predicate order: " << conjunctOrder << endl;
+    }
+    string skipCounts = finalInput->getSkipCounts();
+    if (skipCounts != "") {
+        cout << "Pages skipped: " << skipCounts << endl;
+    }
 
-        RegularSelection opSp(output, outputSp, "== (string[T], string[T])", projectionSp);
-        opSp.run();
-        count = 0;
-        MyDB_RecordPtr recOutt = outputSp->getEmptyRecord();
-        MyDB_RecordIteratorAltPtr itt = outputSp->getIteratorAlt();
+    // the last of the records are pushed through, and the results are printed
+    output->close();
+}
 
-        printf("----------------Results Below---------------\n");
-        while (itt->advance()) {
-            itt->getCurrent(recOutt);
-            ++count;
-            if (count <= 30) {
-                cout << recOutt << endl;
-            }
-        }
-        printf("Count Result: %d records.\n", count);
+// a query over more than one table is run as one pipeline of joins (see JoinPipeline), with the
+// tables' attributes renamed to start with each table's alias
+void RunOp::runJoin(PipelineSinkPtr output) {
+    vector<pair<string, string> >& tablesToProcess = query.tablesToProcess;
+    vector<MyDB_TableReaderWriterPtr> inputs;
+    for (auto &t : tablesToProcess) {
+        inputs.push_back(copyyyy(tables[t.first], t.second, t.first));
+    }
+    vector<MyDB_ExprPtr> conjuncts;
+    for (auto p : query.allDisjunctions) {
+        conjuncts.push_back(p->toExpr());
     }
-    
 
-}
\ No newline at end of file
+    int numWorkers = MyDB_TaskScheduler::getScheduler().getNumWorkers();
+    string skipCounts;
+    if (isAgg) {
+        JoinPipeline op(inputs, output, conjuncts, aggsToCompute, groupings);
+        op.run(numWorkers);
+        skipCounts = op.getSkipCounts();
+    } else {
+        JoinPipeline op(inputs, output, conjuncts, projection);
+        op.run(numWorkers);
+        skipCounts = op.getSkipCounts();
+    }
+    if (skipCounts != "") {
+        cout << "Pages skipped: " << skipCounts << endl;
+    }
+}
@@ -4,6 +4,7 @@
 #include "ParserTypes.h"
 #include "MyDB_BufferManager.h"
 #include "MyDB_TableReaderWriter.h"
+#include "MyDB_TaskScheduler.h"
 #include "MyDB_BPlusTreeReaderWriter.h"
 #include "RunOp.h"
 #include <string>      
@@ -49,7 +50,7 @@ int main (int numArgs, char **args) {
 
 	// load 'em up
 	for (auto &a : allTables) {
-		if (a.second->getFileType () == "heap") {
+		if (a.second->getFileType () == "heap" || a.second->getFileType () == "pax") {
 			allTableReaderWriters[a.first] =  make_shared <MyDB_TableReaderWriter> (a.second, myMgr);
 		} else if (a.second->getFileType () == "bplustree") {
 			allBPlusReaderWriters[a.first] = make_shared <MyDB_BPlusTreeReaderWriter> (a.second->getSortAtt (), a.second, myMgr);
@@ -116,6 +117,53 @@ int main (int numArgs, char **args) {
 					}
 				}
 
+				// see if we got an "analyze soandso"
+				if (tokens.size () == 2 && toLower (tokens[0]) == "analyze") {
+
+					// make sure the table is there
+					if (allTableReaderWriters.count (tokens[1]) == 0) {
+						cout << "Could not find table " << tokens[1] << ".\n";
+						break;
+					} else {
+						allTableReaderWriters[tokens[1]]->analyze ();
+						MyDB_TablePtr table = allTableReaderWriters[tokens[1]]->getTable ();
+						cout << "OK, analyzed " << tokens[1] << "; about " << table->getTupleCount () << " records.\n";
+						for (auto &a : table->getSchema ()->getAtts ()) {
+							MyDB_AttStatsPtr stats = table->getAttStats (a.first);
+							cout << "\t" << a.first << ": " << stats->getDistinctValues () << " distinct, from "
+								<< stats->getLow () << " to " << stats->getHigh () << "\n";
+						}
+						break;
+					}
+				}
+
+				// see if we got a "set codegen on" or "set codegen off"
+				if (tokens.size () == 3 && toLower (tokens[0]) == "set" && toLower (tokens[1]) == "codegen" &&
+					(toLower (tokens[2]) == "on" || toLower (tokens[2]) == "off")) {
+					RunOp :: useCodegen = (toLower (tokens[2]) == "on");
+					cout << "OK, codegen is " << toLower (tokens[2]) << ".\n";
+					break;
+				}
+
+				// see if we got a "set workers N", which changes the number of threads that the
+				// parallel parts of the system share
+				if (tokens.size () == 3 && toLower (tokens[0]) == "set" && toLower (tokens[1]) == "workers") {
+					int numWorkers = atoi (tokens[2].c_str ());
+					if (numWorkers < 1) {
+						cout << "The number of workers must be at least one.\n";
+						break;
+					}
+					MyDB_TaskScheduler :: getScheduler ().setNumWorkers (numWorkers);
+					cout << "OK, " << numWorkers << " workers.\n";
+					break;
+				}
+
+				// see if we got a "show workers", which says how busy each worker has been
+				if (tokens.size () == 2 && toLower (tokens[0]) == "show" && toLower (tokens[1]) == "workers") {
+					cout << MyDB_TaskScheduler :: getScheduler ().getUtilization ();
+					break;
+				}
+
 				// get the string to parse
 				string parseMe = ss.str ();
 
@@ -154,7 +202,8 @@ int main (int numArgs, char **args) {
 						string tableName = final->addToCatalog (args[2], myCatalog);
 						if (tableName != "nothing") {
 							allTables = MyDB_Table :: getAllTables (myCatalog);
-							if (allTables [tableName]->getFileType () == "heap") {
+							if (allTables [tableName]->getFileType () == "heap" || 
+								allTables [tableName]->getFileType () == "pax") {
 								allTableReaderWriters[tableName] = 
 									make_shared <MyDB_TableReaderWriter> (allTables [tableName], myMgr);
 							} else if (allTables [tableName]->getFileType () == "bplustree") {
@@ -0,0 +1,496 @@
+
+#ifndef VECTOR_BENCH_CC
+#define VECTOR_BENCH_CC
+
+#include "MyDB_AttType.h"
+#include "MyDB_BufferManager.h"
+#include "MyDB_Hash.h"
+#include "MyDB_Record.h"
+#include "MyDB_Schema.h"
+#include "MyDB_Table.h"
+#include "MyDB_TableReaderWriter.h"
+#include "MyDB_TaskScheduler.h"
+#include "Aggregate.h"
+#include "CompiledPipeline.h"
+#include "PipelineOp.h"
+#include "RegularSelection.h"
+#include "ScanJoin.h"
+#include "SortMergeJoin.h"
+#include "VectorizedAggregate.h"
+#include "VectorizedSelection.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <math.h>
+#include <iostream>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// This runs the scan->filter->aggregate shape of SQLQueries/2, /3 and /5 three times, once using
+// the regular (record at a time) operators, once using the vectorized ones, and once as a
+// compiled pipeline.  It reports the time taken by each, and checks that they produce the same
+// output.  The time for the compiled pipeline includes generating and compiling the code, unless
+// it was found in the cache (in the directory "codegen") from an earlier run.
+//
+// Then it runs RegularSelection on 1, 2, 4 and 8 threads, over the predicate from SQLQueries/2
+// and over one that accepts about half of lineitem, and checks that the output is the same as
+// with one thread (keeping the records in order, and then without doing so).
+//
+// Then it runs the vectorized operators morsel-driven (see MorselExecutor) with 1, 2, 4 and 8
+// workers in the shared scheduler, over SQLQueries/5 and over the selection that accepts about
+// half of lineitem, and checks that the output is the same as with run ().
+//
+// Then it runs a selection over lineitem whose output goes into an Aggregate, a ScanJoin and a
+// SortMergeJoin, first writing the output to a table, and then pushing it straight into the
+// operator (see PipelineOp), and checks that the results are the same.
+//
+// Then it loads a copy of lineitem whose pages are compressed by the buffer manager, and reports
+// how much smaller the pages are, how fast they are decompressed, and the time to scan each copy.
+//
+// Usage: vectorBench lineitem.tbl orders.tbl
+
+// counts the records in the table, and computes an order-sensitive hash of their contents
+static pair <long, size_t> summarize (MyDB_TableReaderWriterPtr table) {
+	MyDB_RecordPtr rec = table->getEmptyRecord ();
+	MyDB_RecordIteratorAltPtr myIter = table->getIteratorAlt ();
+	long count = 0;
+	size_t hashVal = 0;
+	while (myIter->advance ()) {
+		myIter->getCurrent (rec);
+		stringstream ss;
+		ss << rec;
+		hashVal = hashVal * 31 + std :: hash <string> () (ss.str ());
+		count++;
+	}
+	return make_pair (count, hashVal);
+}
+
+// like summarize (), but the hash does not depend on the order of the records
+static pair <long, size_t> summarizeAnyOrder (MyDB_TableReaderWriterPtr table) {
+	MyDB_RecordPtr rec = table->getEmptyRecord ();
+	MyDB_RecordIteratorAltPtr myIter = table->getIteratorAlt ();
+	long count = 0;
+	size_t hashVal = 0;
+	while (myIter->advance ()) {
+		myIter->getCurrent (rec);
+		stringstream ss;
+		ss << rec;
+		hashVal += std :: hash <string> () (ss.str ());
+		count++;
+	}
+	return make_pair (count, hashVal);
+}
+
+// checks that the two tables have the same records in the same order, except that a double
+// may differ in its last bits (as when the same values are added up in a different order)
+static bool sameUpToRounding (MyDB_TableReaderWriterPtr lhs, MyDB_TableReaderWriterPtr rhs) {
+	vector <pair <string, MyDB_AttTypePtr>> &atts = lhs->getTable ()->getSchema ()->getAtts ();
+	MyDB_RecordPtr lhsRec = lhs->getEmptyRecord ();
+	MyDB_RecordPtr rhsRec = rhs->getEmptyRecord ();
+	MyDB_RecordIteratorAltPtr lhsIter = lhs->getIteratorAlt ();
+	MyDB_RecordIteratorAltPtr rhsIter = rhs->getIteratorAlt ();
+	while (true) {
+		bool lhsMore = lhsIter->advance ();
+		if (lhsMore != rhsIter->advance ())
+			return false;
+		if (!lhsMore)
+			return true;
+		lhsIter->getCurrent (lhsRec);
+		rhsIter->getCurrent (rhsRec);
+		for (size_t i = 0; i < atts.size (); i++) {
+			bool isDouble = atts[i].second->promotableToDouble () && !atts[i].second->promotableToInt ();
+			double lhsVal = isDouble ? lhsRec->getAtt (i)->toDouble () : 0;
+			double rhsVal = isDouble ? rhsRec->getAtt (i)->toDouble () : 0;
+			if (isDouble && fabs (lhsVal - rhsVal) > 1e-9 * max (fabs (lhsVal), fabs (rhsVal)))
+				return false;
+			if (!isDouble && lhsRec->getAtt (i)->toString () != rhsRec->getAtt (i)->toString ())
+				return false;
+		}
+	}
+}
+
+// runs one operator, returning the number of seconds taken
+static double timeIt (function <void ()> runMe) {
+	auto start = chrono :: steady_clock :: now ();
+	runMe ();
+	auto end = chrono :: steady_clock :: now ();
+	return chrono :: duration <double> (end - start).count ();
+}
+
+// runs all versions of one of the queries, and reports on what happened
+static bool compare (string name, MyDB_TableReaderWriterPtr regularOut, MyDB_TableReaderWriterPtr vectorOut,
+	MyDB_TableReaderWriterPtr compiledOut, function <void ()> regular, function <void ()> vectorized,
+	function <bool ()> compiled) {
+
+	double regularTime = timeIt (regular);
+	double vectorTime = timeIt (vectorized);
+	bool compiledOK;
+	double compiledTime = timeIt ([&] {compiledOK = compiled ();});
+	pair <long, size_t> regularRes = summarize (regularOut);
+	pair <long, size_t> vectorRes = summarize (vectorOut);
+	pair <long, size_t> compiledRes = summarize (compiledOut);
+	bool same = (regularRes == vectorRes) && compiledOK && (regularRes == compiledRes);
+	cout << name << ": regular " << regularTime << "s, vectorized " << vectorTime << "s (" <<
+		regularTime / vectorTime << "x), compiled " << compiledTime << "s (" << regularTime / compiledTime <<
+		"x), " << regularRes.first << " vs " << vectorRes.first << " vs " << compiledRes.first <<
+		" records... " << (same ? "results match" : "RESULTS DIFFER") << "\n";
+	return same;
+}
+
+// scans the table, returning the number of records and a hash of the values of one attribute
+static pair <long, size_t> scan (MyDB_TableReaderWriterPtr table, int whichAtt) {
+	MyDB_RecordPtr rec = table->getEmptyRecord ();
+	MyDB_RecordIteratorAltPtr myIter = table->getIteratorAlt ();
+	long count = 0;
+	size_t hashVal = 0;
+	while (myIter->advance ()) {
+		myIter->getCurrent (rec);
+		hashVal += rec->getAtt (whichAtt)->hash ();
+		count++;
+	}
+	return make_pair (count, hashVal);
+}
+
+static MyDB_TableReaderWriterPtr makeTable (string name, MyDB_SchemaPtr schema, MyDB_BufferManagerPtr myMgr) {
+	MyDB_TablePtr table = make_shared <MyDB_Table> (name, name + ".bin", schema);
+	return make_shared <MyDB_TableReaderWriter> (table, myMgr);
+}
+
+// the selection over lineitem whose output is given to another operator by comparePipelined ()
+struct PipelineTest {
+	MyDB_TableReaderWriterPtr lineitem;
+	MyDB_SchemaPtr selSchema;
+	string selPred;
+	vector <string> selProjections;
+	MyDB_BufferManagerPtr myMgr;
+};
+
+// runs the selection, with its output going into the operator made by makeOp (), once by writing
+// the output to a table that the operator reads, and once by pushing it straight into the
+// operator (see PipelineOp); it reports the time taken by each, and checks that the operator's
+// output is the same (up to rounding, if inOrder is true, and in any order otherwise)
+template <class Op>
+static bool comparePipelined (string name, PipelineTest &test, MyDB_SchemaPtr outSchema, bool inOrder,
+	function <shared_ptr <Op> (MyDB_TableReaderWriterPtr, MyDB_TableReaderWriterPtr)> makeOp) {
+
+	MyDB_TableReaderWriterPtr selOut = makeTable ("pipeSel" + name, test.selSchema, test.myMgr);
+	MyDB_TableReaderWriterPtr matOut = makeTable ("pipeMat" + name, outSchema, test.myMgr);
+	double matTime = timeIt ([&] {
+		RegularSelection (test.lineitem, selOut, test.selPred, test.selProjections).run ();
+		makeOp (selOut, matOut)->run ();
+	});
+
+	MyDB_TableReaderWriterPtr pipeOut = makeTable ("pipePushed" + name, outSchema, test.myMgr);
+	double pipeTime = timeIt ([&] {
+		PipelineSinkPtr sink = make_shared <PipelineSink> (test.selSchema, test.myMgr);
+		shared_ptr <Op> op = makeOp (sink, pipeOut);
+		sink->pushInto (op.get ());
+		RegularSelection (test.lineitem, sink, test.selPred, test.selProjections).run ();
+	});
+
+	pair <long, size_t> matRes = summarizeAnyOrder (matOut);
+	bool same = inOrder ? sameUpToRounding (matOut, pipeOut) : (summarizeAnyOrder (pipeOut) == matRes);
+	cout << "pipelined " << name << ": materialized " << matTime << "s, pipelined " << pipeTime << "s (" <<
+		matTime / pipeTime << "x), " << matRes.first << " records... " << (same ? "results match" : "RESULTS DIFFER") << "\n";
+	return same;
+}
+
+int main (int argc, char *argv[]) {
+
+	if (argc < 3) {
+		cout << "Usage: vectorBench lineitem.tbl orders.tbl\n";
+		return 1;
+	}
+
+	MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (131072, 1024, "tempFile");
+	MyDB_AttTypePtr intType = make_shared <MyDB_IntAttType> ();
+	MyDB_AttTypePtr doubleType = make_shared <MyDB_DoubleAttType> ();
+	MyDB_AttTypePtr stringType = make_shared <MyDB_StringAttType> ();
+	MyDB_AttTypePtr dateType = make_shared <MyDB_DateAttType> ();
+
+	// these are the schemas from CreateTables-4-2.sql
+	MyDB_SchemaPtr lineitemSchema = make_shared <MyDB_Schema> ();
+	lineitemSchema->appendAtt (make_pair ("l_orderkey", intType));
+	lineitemSchema->appendAtt (make_pair ("l_partkey", intType));
+	lineitemSchema->appendAtt (make_pair ("l_suppkey", intType));
+	lineitemSchema->appendAtt (make_pair ("l_linenumber", intType));
+	lineitemSchema->appendAtt (make_pair ("l_quantity", intType));
+	lineitemSchema->appendAtt (make_pair ("l_extendedprice", doubleType));
+	lineitemSchema->appendAtt (make_pair ("l_discount", doubleType));
+	lineitemSchema->appendAtt (make_pair ("l_tax", doubleType));
+	lineitemSchema->appendAtt (make_pair ("l_returnflag", stringType));
+	lineitemSchema->appendAtt (make_pair ("l_linestatus", stringType));
+	lineitemSchema->appendAtt (make_pair ("l_shipdate", dateType));
+	lineitemSchema->appendAtt (make_pair ("l_commitdate", dateType));
+	lineitemSchema->appendAtt (make_pair ("l_receiptdate", dateType));
+	lineitemSchema->appendAtt (make_pair ("l_shipinstruct", stringType));
+	lineitemSchema->appendAtt (make_pair ("l_shipmode", stringType));
+	lineitemSchema->appendAtt (make_pair ("l_comment", stringType));
+
+	MyDB_SchemaPtr ordersSchema = make_shared <MyDB_Schema> ();
+	ordersSchema->appendAtt (make_pair ("o_orderkey", intType));
+	ordersSchema->appendAtt (make_pair ("o_custkey", intType));
+	ordersSchema->appendAtt (make_pair ("o_orderstatus", stringType));
+	ordersSchema->appendAtt (make_pair ("o_totalprice", doubleType));
+	ordersSchema->appendAtt (make_pair ("o_orderdate", dateType));
+	ordersSchema->appendAtt (make_pair ("o_orderpriority", stringType));
+	ordersSchema->appendAtt (make_pair ("o_clerk", stringType));
+	ordersSchema->appendAtt (make_pair ("o_shippriority", intType));
+	ordersSchema->appendAtt (make_pair ("o_comment", stringType));
+
+	MyDB_TableReaderWriterPtr lineitem = makeTable ("lineitem", lineitemSchema, myMgr);
+	MyDB_TableReaderWriterPtr orders = makeTable ("orders", ordersSchema, myMgr);
+	cout << "loading lineitem.\n";
+	lineitem->loadFromTextFile (argv[1]);
+	cout << "loading orders.\n";
+	orders->loadFromTextFile (argv[2]);
+
+	bool allMatch = true;
+
+	// SQLQueries/2
+	{
+		MyDB_SchemaPtr outSchema = make_shared <MyDB_Schema> ();
+		outSchema->appendAtt (make_pair ("l_orderkey", intType));
+		MyDB_TableReaderWriterPtr regularOut = makeTable ("q2Regular", outSchema, myMgr);
+		MyDB_TableReaderWriterPtr vectorOut = makeTable ("q2Vector", outSchema, myMgr);
+		MyDB_TableReaderWriterPtr compiledOut = makeTable ("q2Compiled", outSchema, myMgr);
+
+		string pred = "&& (&& (== ([l_shipinstruct], string[TAKE BACK RETURN]), "
+			"> (/ ([l_extendedprice], [l_quantity]), double[1759.6])), "
+			"< (/ ([l_extendedprice], [l_quantity]), double[1759.8]))";
+		vector <string> projections = {"[l_orderkey]"};
+
+		RegularSelection regular (lineitem, regularOut, pred, projections);
+		VectorizedSelection vectorized (lineitem, vectorOut, pred, projections);
+		CompiledPipeline compiled (lineitem, compiledOut, pred, projections);
+		allMatch &= compare ("Q2", regularOut, vectorOut, compiledOut, [&] {regular.run ();}, [&] {vectorized.run ();},
+			[&] {return compiled.run ();});
+	}
+
+	// SQLQueries/3
+	{
+		MyDB_SchemaPtr outSchema = make_shared <MyDB_Schema> ();
+		outSchema->appendAtt (make_pair ("sum1", intType));
+		outSchema->appendAtt (make_pair ("avg2", doubleType));
+		MyDB_TableReaderWriterPtr regularOut = makeTable ("q3Regular", outSchema, myMgr);
+		MyDB_TableReaderWriterPtr vectorOut = makeTable ("q3Vector", outSchema, myMgr);
+		MyDB_TableReaderWriterPtr compiledOut = makeTable ("q3Compiled", outSchema, myMgr);
+
+		string pred = "&& (== ([o_orderstatus], string[F]), "
+			"|| (< ([o_orderpriority], string[2-HIGH]), == ([o_orderpriority], string[2-HIGH])))";
+		vector <pair <MyDB_AggType, string>> aggs = {
+			make_pair (MyDB_AggType :: sumA, "int[1]"),
+			make_pair (MyDB_AggType :: avgA, "/ (- ([o_totalprice], double[32592.14]), double[32592.14])")};
+		vector <string> groupings;
+
+		Aggregate regular (orders, regularOut, aggs, groupings, pred);
+		VectorizedAggregate vectorized (orders, vectorOut, aggs, groupings, pred);
+		CompiledPipeline compiled (orders, compiledOut, aggs, groupings, pred);
+		allMatch &= compare ("Q3", regularOut, vectorOut, compiledOut, [&] {regular.run ();}, [&] {vectorized.run ();},
+			[&] {return compiled.run ();});
+	}
+
+	// SQLQueries/5
+	{
+		MyDB_SchemaPtr outSchema = make_shared <MyDB_Schema> ();
+		outSchema->appendAtt (make_pair ("flag", stringType));
+		outSchema->appendAtt (make_pair ("sum_qty", intType));
+		outSchema->appendAtt (make_pair ("sum_base_price", doubleType));
+		outSchema->appendAtt (make_pair ("sum_disc_price", doubleType));
+		outSchema->appendAtt (make_pair ("sum_charge", doubleType));
+		outSchema->appendAtt (make_pair ("avg_qty", doubleType));
+		outSchema->appendAtt (make_pair ("avg_price", doubleType));
+		outSchema->appendAtt (make_pair ("avg_disc", doubleType));
+		outSchema->appendAtt (make_pair ("count_order", intType));
+		MyDB_TableReaderWriterPtr regularOut = makeTable ("q5Regular", outSchema, myMgr);
+		MyDB_TableReaderWriterPtr vectorOut = makeTable ("q5Vector", outSchema, myMgr);
+		MyDB_TableReaderWriterPtr compiledOut = makeTable ("q5Compiled", outSchema, myMgr);
+
+		string pred = "&& (< ([l_shipdate], string[1998-12-01]), > ([l_shipdate], string[1998-06-01]))";
+		vector <pair <MyDB_AggType, string>> aggs = {
+			make_pair (MyDB_AggType :: sumA, "[l_quantity]"),
+			make_pair (MyDB_AggType :: sumA, "[l_extendedprice]"),
+			make_pair (MyDB_AggType :: sumA, "* ([l_extendedprice], - (int[1], [l_discount]))"),
+			make_pair (MyDB_AggType :: sumA, "* (* ([l_extendedprice], - (int[1], [l_discount])), + (int[1], [l_tax]))"),
+			make_pair (MyDB_AggType :: avgA, "[l_quantity]"),
+			make_pair (MyDB_AggType :: avgA, "[l_extendedprice]"),
+			make_pair (MyDB_AggType :: avgA, "[l_discount]"),
+			make_pair (MyDB_AggType :: sumA, "int[1]")};
+		vector <string> groupings = {"+ (string[return flag was ], [l_returnflag])"};
+
+		Aggregate regular (lineitem, regularOut, aggs, groupings, pred);
+		VectorizedAggregate vectorized (lineitem, vectorOut, aggs, groupings, pred);
+		CompiledPipeline compiled (lineitem, compiledOut, aggs, groupings, pred);
+		allMatch &= compare ("Q5", regularOut, vectorOut, compiledOut, [&] {regular.run ();}, [&] {vectorized.run ();},
+			[&] {return compiled.run ();});
+		cout << "Q5: hash chain lengths " << chainHistogramToString (regular.getChainLengths ()) << "\n";
+
+		// morsel-driven; the groups come out in the same order as with run (), but the sums are
+		// added up in a different order
+		MyDB_TableReaderWriterPtr serialOut = makeTable ("q5Serial", outSchema, myMgr);
+		VectorizedAggregate serial (lineitem, serialOut, aggs, groupings, pred);
+		double serialTime = timeIt ([&] {serial.run ();});
+		pair <long, size_t> serialRes = summarize (serialOut);
+		cout << "morsel Q5: serial " << serialTime << "s";
+		bool same = true;
+		int defaultWorkers = MyDB_TaskScheduler :: getScheduler ().getNumWorkers ();
+		for (int numWorkers = 1; numWorkers <= 8; numWorkers *= 2) {
+			MyDB_TaskScheduler :: getScheduler ().setNumWorkers (numWorkers);
+			MyDB_TableReaderWriterPtr morselOut = makeTable ("q5Morsel" + to_string (numWorkers), outSchema, myMgr);
+			VectorizedAggregate morsel (lineitem, morselOut, aggs, groupings, pred);
+			double morselTime = timeIt ([&] {morsel.run (numWorkers);});
+			same &= sameUpToRounding (morselOut, serialOut);
+			cout << ", " << numWorkers << " workers " << morselTime << "s (" << serialTime / morselTime << "x)";
+		}
+		MyDB_TaskScheduler :: getScheduler ().setNumWorkers (defaultWorkers);
+		cout << ", " << serialRes.first << " groups... " << (same ? "results match" : "RESULTS DIFFER") << "\n";
+		allMatch &= same;
+	}
+
+	// the morsel-driven selection; the records from the different workers are put back in scan order
+	{
+		MyDB_SchemaPtr outSchema = make_shared <MyDB_Schema> ();
+		outSchema->appendAtt (make_pair ("l_orderkey", intType));
+		outSchema->appendAtt (make_pair ("l_extendedprice", doubleType));
+		vector <string> projections = {"[l_orderkey]", "[l_extendedprice]"};
+		string pred = "> ([l_quantity], int[25])";
+
+		MyDB_TableReaderWriterPtr serialOut = makeTable ("halfSerial", outSchema, myMgr);
+		VectorizedSelection serial (lineitem, serialOut, pred, projections);
+		double serialTime = timeIt ([&] {serial.run ();});
+		pair <long, size_t> serialRes = summarize (serialOut);
+		cout << "morsel half: serial " << serialTime << "s";
+		bool same = true;
+		int defaultWorkers = MyDB_TaskScheduler :: getScheduler ().getNumWorkers ();
+		for (int numWorkers = 1; numWorkers <= 8; numWorkers *= 2) {
+			MyDB_TaskScheduler :: getScheduler ().setNumWorkers (numWorkers);
+			MyDB_TableReaderWriterPtr morselOut = makeTable ("halfMorsel" + to_string (numWorkers), outSchema, myMgr);
+			VectorizedSelection morsel (lineitem, morselOut, pred, projections);
+			double morselTime = timeIt ([&] {morsel.run (numWorkers);});
+			same &= (summarize (morselOut) == serialRes);
+			cout << ", " << numWorkers << " workers " << morselTime << "s (" << serialTime / morselTime << "x)";
+		}
+		MyDB_TaskScheduler :: getScheduler ().setNumWorkers (defaultWorkers);
+		cout << ", " << serialRes.first << " records... " << (same ? "results match" : "RESULTS DIFFER") << "\n";
+		allMatch &= same;
+	}
+
+	// the parallel selection
+	{
+		MyDB_SchemaPtr outSchema = make_shared <MyDB_Schema> ();
+		outSchema->appendAtt (make_pair ("l_orderkey", intType));
+		outSchema->appendAtt (make_pair ("l_extendedprice", doubleType));
+		vector <string> projections = {"[l_orderkey]", "[l_extendedprice]"};
+		vector <pair <string, string>> preds = {
+			make_pair ("Q2", "&& (&& (== ([l_shipinstruct], string[TAKE BACK RETURN]), "
+				"> (/ ([l_extendedprice], [l_quantity]), double[1759.6])), "
+				"< (/ ([l_extendedprice], [l_quantity]), double[1759.8]))"),
+			make_pair ("half", "> ([l_quantity], int[25])")};
+
+		for (auto &pred : preds) {
+			MyDB_TableReaderWriterPtr serialOut = makeTable ("parSerial" + pred.first, outSchema, myMgr);
+			RegularSelection serial (lineitem, serialOut, pred.second, projections);
+			double serialTime = timeIt ([&] {serial.run ();});
+			pair <long, size_t> serialRes = summarize (serialOut);
+			cout << "parallel " << pred.first << ": serial " << serialTime << "s";
+
+			bool same = true;
+			for (int numThreads = 1; numThreads <= 8; numThreads *= 2) {
+				MyDB_TableReaderWriterPtr parOut = makeTable ("par" + pred.first + to_string (numThreads), outSchema, myMgr);
+				RegularSelection parallel (lineitem, parOut, pred.second, projections);
+				double parTime = timeIt ([&] {parallel.run (numThreads, true);});
+				same &= (summarize (parOut) == serialRes);
+				cout << ", " << numThreads << " threads " << parTime << "s (" << serialTime / parTime << "x)";
+			}
+
+			MyDB_TableReaderWriterPtr anyOrderOut = makeTable ("parAnyOrder" + pred.first, outSchema, myMgr);
+			RegularSelection anyOrder (lineitem, anyOrderOut, pred.second, projections);
+			double anyOrderTime = timeIt ([&] {anyOrder.run (8, false);});
+			same &= (summarizeAnyOrder (anyOrderOut) == summarizeAnyOrder (serialOut));
+			cout << ", 8 threads in any order " << anyOrderTime << "s, " << serialRes.first << " records... " <<
+				(same ? "results match" : "RESULTS DIFFER") << "\n";
+			allMatch &= same;
+		}
+	}
+
+	// a selection over lineitem whose output goes into an Aggregate, a ScanJoin and a
+	// SortMergeJoin, once by writing it to a table that the next operator reads, and once by
+	// pushing it straight into the next operator (see PipelineOp)
+	{
+		MyDB_SchemaPtr selSchema = make_shared <MyDB_Schema> ();
+		selSchema->appendAtt (make_pair ("l_orderkey", intType));
+		selSchema->appendAtt (make_pair ("l_quantity", intType));
+		selSchema->appendAtt (make_pair ("l_extendedprice", doubleType));
+		selSchema->appendAtt (make_pair ("l_returnflag", stringType));
+		vector <string> selProjections = {"[l_orderkey]", "[l_quantity]", "[l_extendedprice]", "[l_returnflag]"};
+		string selPred = "&& (< ([l_shipdate], string[1998-12-01]), > ([l_shipdate], string[1998-06-01]))";
+
+		MyDB_SchemaPtr aggSchema = make_shared <MyDB_Schema> ();
+		aggSchema->appendAtt (make_pair ("flag", stringType));
+		aggSchema->appendAtt (make_pair ("sum_qty", intType));
+		aggSchema->appendAtt (make_pair ("avg_price", doubleType));
+		vector <pair <MyDB_AggType, string>> aggs = {
+			make_pair (MyDB_AggType :: sumA, "[l_quantity]"),
+			make_pair (MyDB_AggType :: avgA, "[l_extendedprice]")};
+		vector <string> groupings = {"[l_returnflag]"};
+
+		MyDB_SchemaPtr joinSchema = make_shared <MyDB_Schema> ();
+		joinSchema->appendAtt (make_pair ("o_orderdate", dateType));
+		joinSchema->appendAtt (make_pair ("l_extendedprice", doubleType));
+		vector <string> joinProjections = {"[o_orderdate]", "[l_extendedprice]"};
+		string joinPred = "== ([o_orderkey], [l_orderkey])";
+
+		PipelineTest test = {lineitem, selSchema, selPred, selProjections, myMgr};
+		allMatch &= comparePipelined <Aggregate> ("aggregate", test, aggSchema, true,
+			[&] (MyDB_TableReaderWriterPtr in, MyDB_TableReaderWriterPtr out) {
+				return make_shared <Aggregate> (in, out, aggs, groupings, "bool[true]");});
+
+		// the joins may hash or sort the two sides differently, so the order is not checked
+		vector <pair <string, string>> hashAtts = {make_pair (string ("[o_orderkey]"), string ("[l_orderkey]"))};
+		allMatch &= comparePipelined <ScanJoin> ("scanjoin", test, joinSchema, false,
+			[&] (MyDB_TableReaderWriterPtr in, MyDB_TableReaderWriterPtr out) {
+				return make_shared <ScanJoin> (orders, in, out, joinPred, joinProjections, hashAtts, "bool[true]", "bool[true]");});
+		allMatch &= comparePipelined <SortMergeJoin> ("smj", test, joinSchema, false,
+			[&] (MyDB_TableReaderWriterPtr in, MyDB_TableReaderWriterPtr out) {
+				return make_shared <SortMergeJoin> (orders, in, out, joinPred, joinProjections, hashAtts[0], "bool[true]", "bool[true]");});
+	}
+
+	// lineitem, with compressed pages
+	{
+		MyDB_TableReaderWriterPtr compressed = makeTable ("lineitemCompressed", lineitemSchema, myMgr);
+		compressed->getTable ()->setCompressed (true);
+		cout << "loading compressed lineitem.\n";
+		compressed->loadFromTextFile (argv[1]);
+
+		// the uncompressed scan goes first, so that it pushes the compressed pages out of the buffer
+		pair <long, size_t> plainRes, compressedRes;
+		double plainTime = timeIt ([&] {plainRes = scan (lineitem, 15);});
+		double compressedTime = timeIt ([&] {compressedRes = scan (compressed, 15);});
+		size_t bytesIn, bytesOut, bytesDecompressed;
+		double decompressSeconds;
+		myMgr->getCompressionCounts (bytesIn, bytesOut, bytesDecompressed, decompressSeconds);
+		bool same = (plainRes == compressedRes);
+
+		// if the table fits in the buffer, no page is written (or read back), so there are no ratios
+		stringstream ratio, speed;
+		if (bytesOut > 0)
+			ratio << (double) bytesIn / bytesOut << "x";
+		else
+			ratio << "n/a";
+		if (bytesDecompressed > 0 && decompressSeconds > 0)
+			speed << bytesDecompressed / 1048576 / decompressSeconds << " MB/s";
+		else
+			speed << "n/a";
+		cout << "compression: " << bytesIn / 1048576 << " MB of pages written as " << bytesOut / 1048576 << " MB (" <<
+			ratio.str () << "), decompressed at " << speed.str () << "; scan " << plainTime << "s uncompressed vs " << compressedTime << "s compressed, " << plainRes.first <<
+			" vs " << compressedRes.first << " records... " << (same ? "results match" : "RESULTS DIFFER") << "\n";
+		allMatch &= same;
+	}
+
+	return allMatch ? 0 : 1;
+}
+
+#endif